@@ -0,0 +1,77 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : bench
+ * @created     : domenica ott 18, 2026 12:48:09 CEST
+ * @license     : MIT
+ */
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace bench
+{
+
+// Runs `f` `repetitions` times and returns the best time per iteration, in nanoseconds
+template <typename F>
+double measure(std::size_t iterations, F && f, int repetitions = 5)
+{
+    auto best = std::chrono::nanoseconds::max();
+    for (int i = 0; i < repetitions; ++i) {
+        auto const start = std::chrono::steady_clock::now();
+        f();
+        auto const elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+    }
+    return static_cast<double>(best.count()) / static_cast<double>(iterations);
+}
+
+inline void report(char const * name, std::size_t n, double ns_per_op)
+{
+    std::printf("%-48s n = %9zu  %10.2f ns/op\n", name, n, ns_per_op);
+}
+
+inline std::vector<int> shuffled(std::size_t n, unsigned seed = 42)
+{
+    auto v = std::vector<int>(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v[i] = static_cast<int>(i);
+    }
+    std::shuffle(v.begin(), v.end(), std::mt19937{seed});
+    return v;
+}
+
+// Counts the bytes allocated through it and its copies, and not yet freed, to report the memory per element
+template <typename T>
+struct counting_allocator
+{
+    using value_type = T;
+
+    std::size_t * bytes;
+
+    explicit counting_allocator(std::size_t * b) noexcept : bytes{b} {}
+    template <typename U>
+    counting_allocator(counting_allocator<U> const & other) noexcept : bytes{other.bytes} {}
+
+    T * allocate(std::size_t n) { *bytes += n * sizeof(T); return std::allocator<T>{}.allocate(n); }
+    void deallocate(T * p, std::size_t n) noexcept { *bytes -= n * sizeof(T); std::allocator<T>{}.deallocate(p, n); }
+
+    friend bool operator==(counting_allocator const & lhs, counting_allocator const & rhs) noexcept
+    { return lhs.bytes == rhs.bytes; }
+};
+
+template <typename T>
+inline void do_not_optimize(T const & value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace bench
+
+#endif /* BENCH_HPP */
@@ -0,0 +1,49 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : churn_bench
+ * @created     : lunedì ott 19, 2026 07:05:18 CEST
+ * @license     : MIT
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/tree_stats.hpp"
+#include "forest/wavl_tree.hpp"
+
+// Keeps `n` elements in the tree while each round inserts a new element and erases a random one, so that half
+// of the updates are erasures; reports the time per update and the rotations and rebalancing steps it took
+template <template <class, class, class, class> class Tree>
+void churn(char const * name, std::size_t n)
+{
+    using tree_type = Tree<int, std::less<>, std::allocator<int>, forest::tree_stats>;
+    auto const values = bench::shuffled(2 * n);
+    auto const rounds = std::min<std::size_t>(n, 100'000);
+    auto tree = tree_type(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(n));
+    // The tree holds the `n` values starting from `next`, cyclically
+    auto next = std::size_t{0};
+    auto const time = bench::measure(2 * rounds, [&] {
+        tree.reset_stats();
+        for (std::size_t i = 0; i < rounds; ++i, next = (next + 1) % values.size()) {
+            tree.insert(values[(next + n) % values.size()]);
+            tree.erase(tree.find(values[next]));
+        }
+        bench::do_not_optimize(tree.size());
+    });
+    auto const rotations = tree.stats().rotations;
+    auto const steps = tree.stats().rebalance_steps;
+    bench::report((std::string{name} + " insert + erase").c_str(), n, time);
+    std::printf("%-48s %10.3f rotations/op  %6.3f steps/op\n", "",
+                static_cast<double>(rotations) / static_cast<double>(2 * rounds),
+                static_cast<double>(steps) / static_cast<double>(2 * rounds));
+}
+
+int main()
+{
+    for (auto n : {1'000UL, 100'000UL, 1'000'000UL}) {
+        churn<forest::avl_tree>("avl_tree", n);
+        churn<forest::wavl_tree>("wavl_tree", n);
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : compact_bench
+ * @created     : lunedì ott 19, 2026 12:52:36 CEST
+ * @license     : MIT
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/compact_avl_tree.hpp"
+
+template <class T>
+using avl_tree = forest::avl_tree<T, std::less<>, bench::counting_allocator<T>>;
+template <class T>
+using compact_avl_tree = forest::compact_avl_tree<T, std::less<>, bench::counting_allocator<T>>;
+template <class T>
+using packed_avl_tree = forest::compact_avl_tree<T, std::less<>, bench::counting_allocator<T>, forest::packed_balance>;
+
+template <class Tree>
+void run(char const * name, std::size_t n)
+{
+    using value = typename Tree::value_type;
+    auto const values = bench::shuffled(n);
+    auto bytes = std::size_t{0};
+    auto const alloc = bench::counting_allocator<value>{&bytes};
+
+    auto const insert = bench::measure(n, [&] {
+        auto tree = Tree{alloc};
+        for (auto x : values) {
+            tree.insert(static_cast<value>(x));
+        }
+        bench::do_not_optimize(tree.size());
+    });
+    bench::report((std::string{name} + " insert").c_str(), n, insert);
+
+    auto tree = Tree{alloc};
+    for (auto x : values) {
+        tree.insert(static_cast<value>(x));
+    }
+    std::printf("%-48s n = %9zu  %10.2f bytes/element\n", (std::string{name} + " memory").c_str(), n,
+                static_cast<double>(bytes) / static_cast<double>(n));
+
+    auto const find = bench::measure(n, [&] {
+        auto hits = std::size_t{0};
+        for (auto x : values) {
+            hits += tree.contains(static_cast<value>(x));
+        }
+        bench::do_not_optimize(hits);
+    });
+    bench::report((std::string{name} + " find").c_str(), n, find);
+
+    auto const scan = bench::measure(n, [&] {
+        auto sum = std::uint64_t{0};
+        for (auto x : tree) {
+            sum += x;
+        }
+        bench::do_not_optimize(sum);
+    });
+    bench::report((std::string{name} + " scan").c_str(), n, scan);
+
+    auto const erase = bench::measure(n, [&] {
+        auto copy = tree;
+        for (auto x : values) {
+            copy.erase(copy.find(static_cast<value>(x)));
+        }
+        bench::do_not_optimize(copy.size());
+    }, 3);
+    bench::report((std::string{name} + " copy + erase").c_str(), n, erase);
+}
+
+// The compact nodes have no parent link; with `std::uint32_t` they fit the height in the padding left by the
+// value, while with `std::uint64_t` only the packed ones, which keep the balance in the links, save it too
+int main()
+{
+    for (auto n : {1'000UL, 100'000UL, 1'000'000UL}) {
+        run<avl_tree<std::uint32_t>>("avl_tree<uint32_t>", n);
+        run<compact_avl_tree<std::uint32_t>>("compact_avl_tree<uint32_t>", n);
+        run<packed_avl_tree<std::uint32_t>>("packed_avl_tree<uint32_t>", n);
+        run<avl_tree<std::uint64_t>>("avl_tree<uint64_t>", n);
+        run<compact_avl_tree<std::uint64_t>>("compact_avl_tree<uint64_t>", n);
+        run<packed_avl_tree<std::uint64_t>>("packed_avl_tree<uint64_t>", n);
+    }
+}
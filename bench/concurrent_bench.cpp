@@ -0,0 +1,96 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : concurrent_bench
+ * @created     : domenica ott 18, 2026 20:58:12 CEST
+ * @license     : MIT
+ */
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/concurrent_avl_tree.hpp"
+
+namespace
+{
+constexpr auto size = 100'000;
+constexpr auto duration = std::chrono::milliseconds{200};
+
+// An avl_tree behind a std::shared_mutex, as done before concurrent_avl_tree
+struct locked_avl_tree
+{
+    forest::avl_tree<int> tree;
+    mutable std::shared_mutex mutex;
+
+    bool contains(int x) const { auto const lock = std::shared_lock{mutex}; return tree.contains(x); }
+    void insert(int x) { auto const lock = std::unique_lock{mutex}; tree.insert(x); }
+    void erase(int x) { auto const lock = std::unique_lock{mutex}; tree.erase(x); }
+};
+
+// `readers` threads look up random values while a writer inserts and erases; returns the time per lookup,
+// over all the readers
+template <typename Tree>
+double run(Tree & tree, int readers)
+{
+    auto stop = std::atomic<bool>{false};
+    auto lookups = std::atomic<std::size_t>{0};
+
+    auto writer = std::thread{[&] {
+        auto const values = bench::shuffled(size, 7);
+        for (std::size_t i = 0; not stop.load(std::memory_order_relaxed); i = (i + 1) % values.size()) {
+            tree.insert(values[i] * 2 + 1);
+            if (i >= 64) {
+                tree.erase(values[i - 64] * 2 + 1);
+            }
+        }
+    }};
+    auto threads = std::vector<std::thread>{};
+    for (auto r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            auto const values = bench::shuffled(size, static_cast<unsigned>(r));
+            auto found = std::size_t{0};
+            auto count = std::size_t{0};
+            for (; not stop.load(std::memory_order_relaxed); ++count) {
+                found += tree.contains(values[count % values.size()]) ? 1 : 0;
+            }
+            bench::do_not_optimize(found);
+            lookups += count;
+        });
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto & t : threads) {
+        t.join();
+    }
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    writer.join();
+    auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return static_cast<double>(ns) / static_cast<double>(lookups.load());
+}
+
+template <typename Tree>
+void lookups(char const * name)
+{
+    for (auto readers : {1, 2, 4, 8, 16, 32, 64}) {
+        auto tree = Tree{};
+        for (auto x : bench::shuffled(size)) {
+            tree.insert(x * 2);
+        }
+        auto const label = std::string{name} + " lookups, threads: " + std::to_string(readers) + " + 1 writer";
+        bench::report(label.c_str(), size, run(tree, readers));
+    }
+}
+} // namespace
+
+int main()
+{
+    lookups<locked_avl_tree>("avl_tree + shared_mutex");
+    lookups<forest::concurrent_avl_tree<int>>("concurrent_avl_tree");
+}
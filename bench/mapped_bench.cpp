@@ -0,0 +1,63 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : mapped_bench
+ * @created     : lunedì ott 19, 2026 03:31:55 CEST
+ * @license     : MIT
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/mapped_set.hpp"
+#include "forest/serialization.hpp"
+
+namespace
+{
+constexpr auto lookups = 100'000;
+
+// Opens the index and runs `lookups` lookups on it, as a freshly started process would
+template <typename Open>
+double startup(std::size_t size, Open && open)
+{
+    auto const values = bench::shuffled(static_cast<std::size_t>(lookups), 3);
+    return bench::measure(1, [&] {
+        auto const index = open();
+        auto found = std::size_t{0};
+        for (auto x : values) {
+            found += index.contains(static_cast<int>(static_cast<std::size_t>(x) * 2 % (2 * size))) ? 1 : 0;
+        }
+        bench::do_not_optimize(found);
+    }) / 1e6;
+}
+} // namespace
+
+int main()
+{
+    auto const directory = std::filesystem::temp_directory_path();
+    auto const saved = directory / "forest_mapped_bench.tree";
+    auto const mapped = directory / "forest_mapped_bench.map";
+    for (auto size : {100'000u, 1'000'000u, 10'000'000u}) {
+        auto tree = forest::avl_tree<int>{};
+        for (auto x : bench::shuffled(size)) {
+            tree.insert(x * 2);
+        }
+        {
+            auto os = std::ofstream{saved, std::ios::binary};
+            forest::save(tree, os);
+            auto ms = std::ofstream{mapped, std::ios::binary};
+            forest::save_mapped(tree, ms);
+        }
+        auto const loaded = startup(size, [&] {
+            auto is = std::ifstream{saved, std::ios::binary};
+            return forest::load<forest::avl_tree<int>>(is);
+        });
+        auto const opened = startup(size, [&] { return forest::mapped_set<int>{mapped}; });
+        std::printf("%-48s n = %9u  %10.2f ms\n", "forest::load + lookups", size, loaded);
+        std::printf("%-48s n = %9u  %10.2f ms\n", "mapped_set + lookups", size, opened);
+    }
+    std::filesystem::remove(saved);
+    std::filesystem::remove(mapped);
+}
@@ -0,0 +1,47 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : scan_bench
+ * @created     : domenica ott 18, 2026 12:55:40 CEST
+ * @license     : MIT
+ */
+
+#include <numeric>
+#include <string>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/threaded_avl_tree.hpp"
+
+template <typename Tree>
+void scan(char const * name, std::size_t n)
+{
+    auto const values = bench::shuffled(n);
+    auto const tree = Tree(values.begin(), values.end());
+
+    auto const full = bench::measure(n, [&] {
+        bench::do_not_optimize(std::accumulate(tree.begin(), tree.end(), 0L));
+    });
+    bench::report((std::string{name} + " full scan").c_str(), n, full);
+
+    auto const width = 64;
+    auto const queries = std::min<std::size_t>(n / width, 10'000);
+    auto const ranges = bench::measure(queries * width, [&] {
+        auto sum = 0L;
+        for (std::size_t i = 0; i < queries; ++i) {
+            auto const lo = values[i];
+            auto const f = tree.lower_bound(lo);
+            auto const l = tree.upper_bound(lo + width - 1);
+            sum = std::accumulate(f, l, sum);
+        }
+        bench::do_not_optimize(sum);
+    });
+    bench::report((std::string{name} + " range walk (64)").c_str(), n, ranges);
+}
+
+int main()
+{
+    for (auto n : {1'000UL, 100'000UL, 1'000'000UL}) {
+        scan<forest::avl_tree<int>>("avl_tree", n);
+        scan<forest::threaded_avl_tree<int>>("threaded_avl_tree", n);
+    }
+}
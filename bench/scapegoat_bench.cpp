@@ -0,0 +1,66 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : scapegoat_bench
+ * @created     : lunedì ott 19, 2026 11:12:40 CEST
+ * @license     : MIT
+ */
+
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/binary_search_tree.hpp"
+
+template <typename Tree>
+void inserts(char const * name, char const * order, std::vector<int> const & values)
+{
+    auto const n = values.size();
+    auto const insert = bench::measure(n, [&] {
+        auto tree = Tree{};
+        for (auto x : values) {
+            tree.insert(x);
+        }
+        bench::do_not_optimize(tree.size());
+    });
+    bench::report((std::string{name} + " " + order + " insert").c_str(), n, insert);
+
+    auto tree = Tree{};
+    for (auto x : values) {
+        tree.insert(x);
+    }
+    auto const find = bench::measure(n, [&] {
+        auto hits = std::size_t{0};
+        for (auto x : values) {
+            hits += tree.contains(x);
+        }
+        bench::do_not_optimize(hits);
+    });
+    bench::report((std::string{name} + " " + order + " find").c_str(), n, find);
+}
+
+template <typename Balance>
+using bst = forest::binary_search_tree<int, std::less<>, std::allocator<int>, forest::no_stats, Balance>;
+
+// The unbalanced tree takes quadratic time on sorted input, so it is only measured on the smallest one
+int main()
+{
+    for (auto n : {1'000UL, 100'000UL, 1'000'000UL}) {
+        auto const sorted = [n] {
+            auto values = std::vector<int>(n);
+            std::iota(values.begin(), values.end(), 0);
+            return values;
+        }();
+        auto const shuffled = bench::shuffled(n);
+        for (auto const & [order, values] : {std::pair{"sorted", &sorted}, std::pair{"random", &shuffled}}) {
+            inserts<forest::avl_tree<int>>("avl_tree", order, *values);
+            inserts<bst<forest::scapegoat<>>>("scapegoat 2/3", order, *values);
+            inserts<bst<forest::scapegoat<3, 4>>>("scapegoat 3/4", order, *values);
+            if (n <= 1'000 or values == &shuffled) {
+                inserts<bst<forest::unbalanced>>("unbalanced", order, *values);
+            }
+        }
+    }
+}
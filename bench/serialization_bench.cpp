@@ -0,0 +1,50 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : serialization_bench
+ * @created     : lunedì ott 19, 2026 02:31:18 CEST
+ * @license     : MIT
+ */
+
+#include <sstream>
+#include <string>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/serialization.hpp"
+
+namespace
+{
+template <typename T, typename Make>
+void reload(char const * name, std::size_t size, Make && make)
+{
+    auto tree = forest::avl_tree<T>{};
+    for (auto x : bench::shuffled(size)) {
+        tree.insert(make(x));
+    }
+    auto stream = std::stringstream{};
+    forest::save(tree, stream);
+    auto const bytes = stream.str();
+
+    auto const emplaced = bench::measure(size, [&] {
+        auto copy = forest::avl_tree<T>{};
+        for (auto const & x : tree) {
+            copy.emplace(x);
+        }
+        bench::do_not_optimize(copy.size());
+    });
+    auto const loaded = bench::measure(size, [&] {
+        auto in = std::istringstream{bytes};
+        bench::do_not_optimize(forest::load<forest::avl_tree<T>>(in).size());
+    });
+    bench::report((std::string{name} + ", emplace one by one").c_str(), size, emplaced);
+    bench::report((std::string{name} + ", load").c_str(), size, loaded);
+}
+} // namespace
+
+int main()
+{
+    for (auto size : {1'000u, 100'000u, 1'000'000u}) {
+        reload<int>("int", size, [](int x) { return x; });
+        reload<std::string>("std::string", size, [](int x) { return std::to_string(x); });
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : sharded_bench
+ * @created     : domenica ott 18, 2026 23:52:06 CEST
+ * @license     : MIT
+ */
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/sharded_tree.hpp"
+
+namespace
+{
+constexpr auto per_writer = 20'000;
+
+// An avl_tree behind a single mutex, as done before sharded_tree
+struct locked_avl_tree
+{
+    forest::avl_tree<int> tree;
+    std::mutex mutex;
+
+    void insert(int x) { auto const lock = std::unique_lock{mutex}; tree.insert(x); }
+};
+
+// `writers` threads insert values from disjoint key ranges; returns the time per insertion, over all the writers
+template <typename Tree>
+double run(Tree & tree, int writers)
+{
+    auto threads = std::vector<std::thread>{};
+    auto const start = std::chrono::steady_clock::now();
+    for (auto w = 0; w < writers; ++w) {
+        threads.emplace_back([&tree, w] {
+            for (auto x : bench::shuffled(per_writer, static_cast<unsigned>(w))) {
+                tree.insert(w * per_writer + x);
+            }
+        });
+    }
+    for (auto & t : threads) {
+        t.join();
+    }
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return static_cast<double>(ns) / static_cast<double>(writers * per_writer);
+}
+
+template <typename Tree, typename Make>
+void inserts(char const * name, Make && make)
+{
+    for (auto writers : {1, 2, 4, 8, 16, 32, 48}) {
+        auto tree = make(writers);
+        auto const label = std::string{name} + " inserts, writers: " + std::to_string(writers);
+        bench::report(label.c_str(), static_cast<std::size_t>(writers * per_writer), run(*tree, writers));
+    }
+}
+} // namespace
+
+int main()
+{
+    inserts<locked_avl_tree>("avl_tree + mutex", [](int) { return std::make_unique<locked_avl_tree>(); });
+    inserts<forest::sharded_tree<int>>("sharded_tree, rebalanced", [](int writers) {
+        return std::make_unique<forest::sharded_tree<int>>(static_cast<std::size_t>(writers));
+    });
+    inserts<forest::sharded_tree<int>>("sharded_tree, split by writer", [](int writers) {
+        auto splits = std::vector<int>{};
+        for (auto w = 1; w < writers; ++w) {
+            splits.push_back(w * per_writer);
+        }
+        return std::make_unique<forest::sharded_tree<int>>(std::move(splits));
+    });
+}
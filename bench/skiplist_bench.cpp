@@ -0,0 +1,108 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : skiplist_bench
+ * @created     : lunedì ott 19, 2026 01:21:44 CEST
+ * @license     : MIT
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/concurrent_skiplist.hpp"
+
+namespace
+{
+constexpr auto size = 100'000;
+constexpr auto duration = std::chrono::milliseconds{200};
+
+// An avl_tree behind a single mutex, for readers and writers alike
+struct locked_avl_tree
+{
+    forest::avl_tree<int> tree;
+    std::mutex mutex;
+
+    bool contains(int x) { auto const lock = std::unique_lock{mutex}; return tree.contains(x); }
+    void insert(int x) { auto const lock = std::unique_lock{mutex}; tree.insert(x); }
+    void erase(int x)
+    {
+        auto const lock = std::unique_lock{mutex};
+        if (auto const it = tree.find(x); it != tree.end()) {
+            tree.erase(it);
+        }
+    }
+};
+
+struct skiplist
+{
+    forest::concurrent_skiplist<int> list;
+
+    bool contains(int x) const { return list.contains(x); }
+    void insert(int x) { list.insert(x); }
+    void erase(int x) { list.extract(x); }
+};
+
+// `threads` threads run a mix of 25% insertions, 25% erasures and 50% lookups on random values; returns the time
+// per operation, over all the threads
+template <typename Tree>
+double run(Tree & tree, int threads)
+{
+    auto stop = std::atomic<bool>{false};
+    auto operations = std::atomic<std::size_t>{0};
+    auto workers = std::vector<std::thread>{};
+    for (auto t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            auto rng = std::mt19937{static_cast<unsigned>(t)};
+            auto found = std::size_t{0};
+            auto count = std::size_t{0};
+            for (; not stop.load(std::memory_order_relaxed); ++count) {
+                auto const r = rng();
+                auto const x = static_cast<int>((r >> 2) % (2 * size));
+                switch (r % 4) {
+                    case 0: tree.insert(x); break;
+                    case 1: tree.erase(x); break;
+                    default: found += tree.contains(x) ? 1 : 0;
+                }
+            }
+            bench::do_not_optimize(found);
+            operations += count;
+        });
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto & w : workers) {
+        w.join();
+    }
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return static_cast<double>(ns) / static_cast<double>(operations.load());
+}
+
+template <typename Tree>
+void mixed(char const * name)
+{
+    for (auto threads : {1, 2, 4, 8, 16, 32, 64}) {
+        auto tree = std::make_unique<Tree>();
+        for (auto x : bench::shuffled(size)) {
+            tree->insert(x * 2);
+        }
+        auto const label = std::string{name} + " mixed, threads: " + std::to_string(threads);
+        bench::report(label.c_str(), size, run(*tree, threads));
+    }
+}
+} // namespace
+
+int main()
+{
+    mixed<locked_avl_tree>("avl_tree + mutex");
+    mixed<skiplist>("concurrent_skiplist");
+}
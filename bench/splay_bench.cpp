@@ -0,0 +1,68 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : splay_bench
+ * @created     : lunedì ott 19, 2026 10:31:09 CEST
+ * @license     : MIT
+ */
+
+#include <cmath>
+#include <string>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/splay_tree.hpp"
+
+// `count` keys drawn from a Zipf distribution of exponent `s` over the ranks of `keys`; each draw is repeated
+// `burst` times in a row, for temporal locality
+std::vector<int> zipf_queries(std::vector<int> const & keys, double s, std::size_t count, std::size_t burst)
+{
+    auto cdf = std::vector<double>(keys.size());
+    auto sum = 0.0;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+        cdf[i] = sum;
+    }
+    auto rng = std::mt19937{7};
+    auto uniform = std::uniform_real_distribution<double>{0.0, sum};
+    auto queries = std::vector<int>{};
+    queries.reserve(count);
+    while (queries.size() < count) {
+        auto const rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+        auto const key = keys[static_cast<std::size_t>(std::min<std::ptrdiff_t>(rank, keys.size() - 1))];
+        for (std::size_t i = 0; i < burst and queries.size() < count; ++i) {
+            queries.push_back(key);
+        }
+    }
+    return queries;
+}
+
+template <typename Tree>
+void lookups(char const * name, std::vector<int> const & keys, std::vector<int> const & queries,
+             char const * workload)
+{
+    auto tree = Tree(keys.begin(), keys.end());
+    auto const time = bench::measure(queries.size(), [&] {
+        auto hits = std::size_t{0};
+        for (auto x : queries) {
+            hits += tree.find(x) != tree.end();
+        }
+        bench::do_not_optimize(hits);
+    });
+    bench::report((std::string{name} + " find, " + workload).c_str(), keys.size(), time);
+}
+
+int main()
+{
+    using semi_splay_tree = forest::splay_tree<int, std::less<>, std::allocator<int>, forest::no_stats,
+                                               forest::semi_splay>;
+    for (auto n : {1'000UL, 100'000UL, 1'000'000UL}) {
+        auto const keys = bench::shuffled(n);
+        for (auto [s, burst, workload] : {std::tuple{0.0, 1UL, "uniform"}, std::tuple{0.99, 1UL, "zipf 0.99"},
+                                          std::tuple{1.2, 1UL, "zipf 1.2"}, std::tuple{1.2, 8UL, "zipf 1.2 x8"}}) {
+            auto const queries = zipf_queries(keys, s, 1'000'000, burst);
+            lookups<forest::avl_tree<int>>("avl_tree", keys, queries, workload);
+            lookups<forest::splay_tree<int>>("splay_tree", keys, queries, workload);
+            lookups<semi_splay_tree>("splay_tree (semi)", keys, queries, workload);
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : treap_bench
+ * @created     : lunedì ott 19, 2026 08:54:02 CEST
+ * @license     : MIT
+ */
+
+#include <string>
+
+#include "bench.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/treap.hpp"
+
+template <typename Tree>
+void updates(char const * name, std::size_t n)
+{
+    auto const values = bench::shuffled(n);
+    auto const insert = bench::measure(n, [&] {
+        auto tree = Tree{};
+        for (auto x : values) {
+            tree.insert(x);
+        }
+        bench::do_not_optimize(tree.size());
+    });
+    bench::report((std::string{name} + " insert").c_str(), n, insert);
+
+    auto tree = Tree(values.begin(), values.end());
+    auto const find = bench::measure(n, [&] {
+        auto hits = std::size_t{0};
+        for (auto x : values) {
+            hits += tree.contains(x);
+        }
+        bench::do_not_optimize(hits);
+    });
+    bench::report((std::string{name} + " find").c_str(), n, find);
+
+    auto const erase = bench::measure(n, [&] {
+        auto copy = tree;
+        for (auto x : values) {
+            copy.erase(copy.find(x));
+        }
+        bench::do_not_optimize(copy.size());
+    }, 3);
+    bench::report((std::string{name} + " copy + erase").c_str(), n, erase);
+}
+
+// Cuts the treap at a random key and joins the two parts back. The links are cut and joined in O(log n), but
+// `split` also walks the smaller part to count it, which dominates at random keys
+void split_join(std::size_t n)
+{
+    auto const values = bench::shuffled(n);
+    auto tree = forest::treap<int>(values.begin(), values.end());
+    auto const rounds = std::size_t{1000};
+    auto const time = bench::measure(rounds, [&] {
+        for (std::size_t i = 0; i < rounds; ++i) {
+            auto upper = tree.split(values[i % n]);
+            tree.join(std::move(upper));
+        }
+        bench::do_not_optimize(tree.size());
+    });
+    bench::report("treap split + join", n, time);
+}
+
+int main()
+{
+    for (auto n : {1'000UL, 100'000UL, 1'000'000UL}) {
+        updates<forest::avl_tree<int>>("avl_tree", n);
+        updates<forest::treap<int>>("treap", n);
+        split_join(n);
+    }
+}
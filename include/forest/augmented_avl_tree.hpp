@@ -0,0 +1,650 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : augmented_avl_tree
+ * @created     : domenica ott 18, 2026 15:40:18 CEST
+ * @license     : MIT
+ * */
+
+#ifndef AUGMENTED_AVL_TREE_HPP
+#define AUGMENTED_AVL_TREE_HPP
+
+#include <algorithm>        //std::equal, std::lexicographical_compare
+#include <initializer_list>
+#include <limits>           //std::numeric_limits
+#include <memory>
+#include <utility>          //std::pair
+
+#include "node_handle.hpp"
+#include "detail/utils.hpp"
+#include "detail/augmented_node.hpp"
+#include "detail/bst_iterator.hpp"
+#include "detail/tree_algorithms.hpp"
+
+#include "meta/is_aggregate_monoid.hpp"
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+/// Monoids
+template <class T>
+struct sum_monoid
+{
+    using result_type = T;
+    constexpr inline result_type identity() const { return result_type{}; }
+    constexpr inline result_type const & lift(T const & v) const noexcept { return v; }
+    constexpr inline result_type operator()(result_type const & a, result_type const & b) const { return a + b; }
+}; // struct sum_monoid
+
+template <class T>
+struct min_monoid
+{
+    using result_type = T;
+    constexpr inline result_type identity() const { return std::numeric_limits<T>::max(); }
+    constexpr inline result_type const & lift(T const & v) const noexcept { return v; }
+    constexpr inline result_type operator()(result_type const & a, result_type const & b) const
+    { return b < a ? b : a; }
+}; // struct min_monoid
+
+template <class T>
+struct max_monoid
+{
+    using result_type = T;
+    constexpr inline result_type identity() const { return std::numeric_limits<T>::lowest(); }
+    constexpr inline result_type const & lift(T const & v) const noexcept { return v; }
+    constexpr inline result_type operator()(result_type const & a, result_type const & b) const
+    { return a < b ? b : a; }
+}; // struct max_monoid
+
+// An avl_tree whose nodes also store the aggregate, under `Monoid`, of the values in their subtree. The aggregates
+// are kept up to date along the insertion and erasure paths and by the rotations, so that the aggregate of any
+// range of keys costs O(log n)
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>, class Monoid = sum_monoid<T>>
+class augmented_avl_tree
+{
+    static_assert(meta::is_aggregate_monoid<Monoid, T>, "Monoid must be an aggregate monoid over T");
+
+public:
+    using aggregate_type         = typename Monoid::result_type;
+    using monoid_type            = Monoid;
+
+protected:
+    using node                  = detail::augmented_node<T, std::int_fast8_t, aggregate_type>;
+    using alloc_traits          = std::allocator_traits<Alloc>;
+    using node_allocator        = typename alloc_traits::template rebind_alloc<node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator>;
+    using node_pointer          = node *;
+    using node_const_pointer    = node const *;
+    using height_type           = std::int_fast8_t;
+
+public:
+    using key_type               = T;
+    using value_type             = T;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using allocator_type         = Alloc;
+    using reference              = value_type &;
+    using const_reference        = value_type const &;
+    using pointer                = typename alloc_traits::pointer;
+    using const_pointer          = typename alloc_traits::const_pointer;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = detail::_bst_iterator<value_type, node>;
+    using const_iterator         = detail::_bst_const_iterator<value_type, node>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using node_type              = forest::node_handle<value_type, height_type, allocator_type, node>;
+
+protected:
+    node _end; // _end.root = root; _end.left = back; _end.right = front
+    size_type _size = 0;
+    [[no_unique_address]] node_allocator _node_alloc;
+    [[no_unique_address]] key_compare _cmp;
+    [[no_unique_address]] monoid_type _monoid;
+
+public:
+    constexpr inline
+    augmented_avl_tree() noexcept(noexcept(std::is_nothrow_default_constructible<node_allocator>::value))
+    { _set_end(); }
+    constexpr inline explicit augmented_avl_tree(allocator_type const & a) noexcept : _node_alloc{a} { _set_end(); }
+    constexpr inline explicit augmented_avl_tree(monoid_type const & m, allocator_type const & a = allocator_type{})
+        : _node_alloc{a}, _monoid{m} { _set_end(); }
+
+    constexpr augmented_avl_tree(augmented_avl_tree const & other);
+    constexpr augmented_avl_tree(augmented_avl_tree && other) noexcept;
+
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr explicit augmented_avl_tree(Iterator f, Iterator l, allocator_type const & a = allocator_type{});
+
+    constexpr augmented_avl_tree(std::initializer_list<value_type> il, allocator_type const & a = allocator_type{})
+        : augmented_avl_tree(il.begin(), il.end(), a) { }
+
+    inline ~augmented_avl_tree() noexcept { clear(); }
+
+    constexpr augmented_avl_tree & operator=(augmented_avl_tree const & other);
+    constexpr augmented_avl_tree & operator=(augmented_avl_tree && other) noexcept;
+    constexpr inline
+    augmented_avl_tree & operator=(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); return *this; }
+
+    constexpr inline
+    void assign(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); }
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr void assign(Iterator f, Iterator l);
+
+    constexpr inline
+    allocator_type get_allocator() const noexcept { return allocator_type(_node_alloc); }
+    constexpr inline
+    monoid_type monoid() const { return _monoid; }
+
+    /// Capacity
+    constexpr inline size_type size() const noexcept { return _size; }
+    [[nodiscard]] constexpr inline bool empty() const noexcept { return _size == 0; }
+    constexpr inline
+    size_type max_size() const noexcept
+    {
+        return std::min<size_type>(
+            node_allocator_traits::max_size(_node_alloc), std::numeric_limits<difference_type>::max()
+        );
+    }
+
+    /// Iterators
+    constexpr inline iterator begin() noexcept { return iterator{_end.right}; }
+    constexpr inline const_iterator begin() const noexcept { return const_iterator{_end.right}; }
+    constexpr inline iterator end() noexcept { return iterator{std::addressof(_end)}; }
+    constexpr inline const_iterator end() const noexcept { return const_iterator{std::addressof(_end)}; }
+    constexpr inline const_iterator cbegin() const noexcept { return begin(); }
+    constexpr inline const_iterator cend() const noexcept { return end(); }
+
+    constexpr inline reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator crend() const noexcept { return const_reverse_iterator{begin()}; }
+
+    /// Access
+    constexpr inline const_reference front() const { return _end.right->value(); }
+    constexpr inline const_reference back() const { return _end.left->value(); }
+
+    /// Aggregates
+    // The aggregate of the whole tree, in O(1)
+    constexpr inline aggregate_type aggregate() const { return empty() ? _monoid.identity() : _end.root->aggregate; }
+    // The aggregate of the values in [lower_bound(lo), upper_bound(hi)), in O(log n)
+    constexpr inline aggregate_type aggregate(value_type const & lo, value_type const & hi) const
+    { return _aggregate(lo, hi); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline aggregate_type aggregate(U const & lo, U const & hi) const
+    { return _aggregate(lo, hi); }
+
+    /// Modifiers
+    constexpr void clear() noexcept;
+    constexpr inline iterator insert(value_type const & value) { return iterator{_insert(_construct_node(value))}; }
+    constexpr inline iterator insert(value_type && value) { return iterator{_insert(_construct_node(std::move(value)))}; }
+    template <typename ...Args>
+    constexpr inline reference emplace(Args&&... args)
+    { return _insert(_construct_node(std::forward<Args>(args)...))->value(); }
+    constexpr iterator insert(node_type && n);
+    constexpr node_type extract(const_iterator it);
+    constexpr node_type extract(value_type const & value);
+
+    constexpr iterator erase(const_iterator it);
+    constexpr iterator erase(const_iterator f, const_iterator l);
+    constexpr size_type erase(value_type const & value);
+
+    /// Lookup
+    constexpr auto count(value_type const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr auto count(U const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    constexpr inline bool contains(value_type const & x) const { return find(x) != end(); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline bool contains(U const & x) const { return find(x) != end(); }
+
+    constexpr inline iterator find(value_type const & x) { return iterator{_find(x)}; }
+    constexpr inline const_iterator find(value_type const & x) const { return const_iterator{_find(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline iterator find(U const & x) { return iterator{_find(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator find(U const & x) const { return const_iterator{_find(x)}; }
+
+    constexpr inline iterator lower_bound(value_type const & x) { return iterator{_lower_bound(x)}; }
+    constexpr inline const_iterator lower_bound(value_type const & x) const { return const_iterator{_lower_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline iterator lower_bound(U const & x) { return iterator{_lower_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator lower_bound(U const & x) const { return const_iterator{_lower_bound(x)}; }
+
+    constexpr inline iterator upper_bound(value_type const & x) { return iterator{_upper_bound(x)}; }
+    constexpr inline const_iterator upper_bound(value_type const & x) const { return const_iterator{_upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline iterator upper_bound(U const & x) { return iterator{_upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator upper_bound(U const & x) const { return const_iterator{_upper_bound(x)}; }
+
+    constexpr inline auto equal_range(value_type const & x) -> std::pair<iterator, iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    constexpr inline auto equal_range(value_type const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) -> std::pair<iterator, iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+
+    constexpr void swap(augmented_avl_tree & other) noexcept;
+
+    friend constexpr bool operator==(augmented_avl_tree const & lhs, augmented_avl_tree const & rhs) noexcept
+    { return lhs.size() == rhs.size() and std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend()); }
+    friend constexpr bool operator!=(augmented_avl_tree const & lhs, augmented_avl_tree const & rhs) noexcept
+    { return not (lhs == rhs); }
+    friend constexpr bool operator< (augmented_avl_tree const & lhs, augmented_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less{}); }
+    friend constexpr bool operator<=(augmented_avl_tree const & lhs, augmented_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less_equal{}); }
+    friend constexpr bool operator> (augmented_avl_tree const & lhs, augmented_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater{}); }
+    friend constexpr bool operator>=(augmented_avl_tree const & lhs, augmented_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater_equal{}); }
+
+protected:
+    constexpr inline
+    void _set_end() noexcept { _end.root = _end.left = _end.right = std::addressof(_end); }
+    constexpr inline
+    node_pointer _root() const noexcept { return empty() ? nullptr : _end.root; }
+
+    // Recomputes the aggregate of `n` from the ones of its children
+    constexpr inline
+    void _update(node_pointer n) const
+    {
+        auto acc = static_cast<aggregate_type>(_monoid.lift(n->value()));
+        if (n->left != nullptr) {
+            acc = _monoid(n->left->aggregate, acc);
+        }
+        if (n->right != nullptr) {
+            acc = _monoid(acc, n->right->aggregate);
+        }
+        n->aggregate = std::move(acc);
+    }
+    constexpr inline
+    auto _updater() const noexcept { return [this](node_pointer n) { _update(n); }; }
+
+    template <typename ...Args>
+    constexpr node_pointer _construct_node(Args &&... args);
+    constexpr void _destroy_node(node_pointer n) noexcept;
+
+    constexpr node_pointer _insert(node_pointer n);
+    constexpr node_pointer _unlink(node_pointer n) noexcept;
+
+    template <typename U> constexpr node_pointer _find(U const & x) const;
+    template <typename U> constexpr node_pointer _lower_bound(U const & x) const;
+    template <typename U> constexpr node_pointer _upper_bound(U const & x) const;
+    template <typename U> constexpr aggregate_type _aggregate(U const & lo, U const & hi) const;
+}; // class augmented_avl_tree
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr augmented_avl_tree<T, Compare, Alloc, Monoid>::augmented_avl_tree(augmented_avl_tree const & other)
+    : _node_alloc{node_allocator_traits::select_on_container_copy_construction(other._node_alloc)},
+      _cmp{other._cmp}, _monoid{other._monoid}
+{
+    _set_end();
+    assign(other.begin(), other.end());
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr augmented_avl_tree<T, Compare, Alloc, Monoid>::augmented_avl_tree(augmented_avl_tree && other) noexcept
+    : _node_alloc{std::move(other._node_alloc)}, _cmp{std::move(other._cmp)}, _monoid{other._monoid}
+{
+    _set_end();
+    swap(other);
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+constexpr augmented_avl_tree<T, Compare, Alloc, Monoid>::augmented_avl_tree(Iterator f, Iterator l,
+                                                                            allocator_type const & a)
+    : _node_alloc{a}
+{
+    _set_end();
+    assign(std::move(f), std::move(l));
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::operator=(augmented_avl_tree const & other)
+    -> augmented_avl_tree &
+{
+    if (this != std::addressof(other)) {
+        if constexpr (node_allocator_traits::propagate_on_container_copy_assignment::value) {
+            clear();
+            _node_alloc = other._node_alloc;
+        }
+        _cmp = other._cmp;
+        _monoid = other._monoid;
+        assign(other.begin(), other.end());
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::operator=(augmented_avl_tree && other) noexcept
+    -> augmented_avl_tree &
+{
+    if (this != std::addressof(other)) {
+        clear();
+        if constexpr (node_allocator_traits::propagate_on_container_move_assignment::value) {
+            _node_alloc = std::move(other._node_alloc);
+        }
+        //NB: if _node_alloc != other._node_alloc, behavior is undefined
+        _cmp = std::move(other._cmp);
+        swap(other);
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+constexpr void augmented_avl_tree<T, Compare, Alloc, Monoid>::assign(Iterator f, Iterator l)
+{
+    clear();
+    while (f != l) {
+        emplace(*f++);
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr void augmented_avl_tree<T, Compare, Alloc, Monoid>::clear() noexcept
+{
+    // post-order walk: every node is freed after its children
+    auto it = _root();
+    while (it != nullptr and it != std::addressof(_end)) {
+        if (it->left != nullptr) {
+            it = it->left;
+        } else if (it->right != nullptr) {
+            it = it->right;
+        } else {
+            auto const root = it->root;
+            if (root->left == it) {
+                root->left = nullptr;
+            } else {
+                root->right = nullptr;
+            }
+            _destroy_node(it);
+            it = root;
+        }
+    }
+    _set_end();
+    _size = 0;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr void augmented_avl_tree<T, Compare, Alloc, Monoid>::swap(augmented_avl_tree & other) noexcept
+{
+    using std::swap;
+    if constexpr (node_allocator_traits::propagate_on_container_swap::value) {
+        swap(_node_alloc, other._node_alloc);
+    }
+    swap(_cmp, other._cmp);
+    swap(_monoid, other._monoid);
+    swap(_size, other._size);
+    swap(_end.root, other._end.root);
+    swap(_end.left, other._end.left);
+    swap(_end.right, other._end.right);
+
+    // the root points to the sentinel, which must be the one of its new tree
+    for (auto * tree : {this, std::addressof(other)}) {
+        if (tree->_size == 0) {
+            tree->_set_end();
+        } else {
+            tree->_end.root->root = std::addressof(tree->_end);
+        }
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+template <typename ...Args>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::_construct_node(Args &&... args)
+    -> node_pointer
+{
+    auto hold = std::unique_ptr<node, detail::_node_deallocator<node, node_allocator>>(
+        node_allocator_traits::allocate(_node_alloc, 1), detail::_node_deallocator<node, node_allocator>(_node_alloc)
+    );
+    node_allocator_traits::construct(_node_alloc, hold.get());
+    ++hold.get_deleter().constructed;
+    node_allocator_traits::construct(_node_alloc, std::addressof(hold->value()), std::forward<Args>(args)...);
+    ++hold.get_deleter().constructed;
+    return hold.release();
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr void augmented_avl_tree<T, Compare, Alloc, Monoid>::_destroy_node(node_pointer n) noexcept
+{
+    node_allocator_traits::destroy(_node_alloc, std::addressof(n->value()));
+    node_allocator_traits::destroy(_node_alloc, n);
+    node_allocator_traits::deallocate(_node_alloc, n, 1);
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::_insert(node_pointer n)
+    -> node_pointer
+{
+    auto root = std::addressof(_end);
+    auto left = false;
+    for (auto it = _root(); it != nullptr; it = left ? it->left : it->right) {
+        root = it;
+        left = _cmp(n->value(), it->value());
+    }
+    detail::_link_leaf(root, left, n, std::addressof(_end));
+    _update(n);
+    ++_size;
+    detail::_avl_balance_from(root, std::addressof(_end), _updater());
+    return n;
+}
+
+// Unlinks `n` from the tree, fixing the aggregates of its ancestors. Returns the node following it
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::_unlink(node_pointer n) noexcept
+    -> node_pointer
+{
+    auto const next = detail::_bst_next(n);
+    if (_size == 1) {
+        n->root = n->left = n->right = nullptr;
+        _set_end();
+        _size = 0;
+        return next;
+    }
+
+    if (_end.right == n) {
+        _end.right = next;
+    }
+    if (_end.left == n) {
+        _end.left = detail::_bst_prev(n);
+    }
+    auto const changed = detail::_unlink(n, std::addressof(_end));
+    --_size;
+    detail::_avl_balance_from(changed, std::addressof(_end), _updater());
+    return next;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::insert(node_type && n)
+    -> iterator
+{
+    auto const ptr = n._storage;
+    n._storage = nullptr;
+    n._consume();
+    return iterator{_insert(ptr)};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::extract(const_iterator it)
+    -> node_type
+{
+    auto const n = const_cast<node_pointer>(it._current);
+    _unlink(n);
+    return node_type{n, get_allocator()};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::extract(value_type const & value)
+    -> node_type
+{
+    if (auto const it = find(value); it != end()) {
+        return extract(it);
+    }
+    return {};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::erase(const_iterator it)
+    -> iterator
+{
+    auto const n = const_cast<node_pointer>(it._current);
+    auto const next = _unlink(n);
+    _destroy_node(n);
+    return iterator{next};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::erase(const_iterator f, const_iterator l)
+    -> iterator
+{
+    if (f == begin() and l == end()) {
+        clear();
+        return end();
+    }
+    while (f != l) {
+        f = erase(f);
+    }
+    return iterator{const_cast<node_pointer>(l._current)};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::erase(value_type const & value)
+    -> size_type
+{
+    auto const [f, l] = equal_range(value);
+    auto const old_size = size();
+    erase(f, l);
+    return old_size - size();
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+template <typename U>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::_find(U const & x) const
+    -> node_pointer
+{
+    auto const found = _lower_bound(x);
+    if (found != std::addressof(_end) and not _cmp(x, found->value())) {
+        return found;
+    }
+    return const_cast<node_pointer>(std::addressof(_end));
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+template <typename U>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::_lower_bound(U const & x) const
+    -> node_pointer
+{
+    auto result = const_cast<node_pointer>(std::addressof(_end));
+    for (auto ptr = _root(); ptr != nullptr; ) {
+        if (_cmp(ptr->value(), x)) {
+            ptr = ptr->right;
+        } else {
+            result = ptr;
+            ptr = ptr->left;
+        }
+    }
+    return result;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+template <typename U>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::_upper_bound(U const & x) const
+    -> node_pointer
+{
+    auto result = const_cast<node_pointer>(std::addressof(_end));
+    for (auto ptr = _root(); ptr != nullptr; ) {
+        if (_cmp(x, ptr->value())) {
+            result = ptr;
+            ptr = ptr->left;
+        } else {
+            ptr = ptr->right;
+        }
+    }
+    return result;
+}
+
+// Descends to the highest node in [lo, hi]: the range is made of a suffix of its left subtree, the node itself and
+// a prefix of its right subtree. Along each of the two paths the subtrees which are entirely in range are taken
+// as a whole, using their stored aggregate
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+template <typename U>
+constexpr auto augmented_avl_tree<T, Compare, Alloc, Monoid>::_aggregate(U const & lo, U const & hi) const
+    -> aggregate_type
+{
+    auto split = _root();
+    while (split != nullptr) {
+        if (_cmp(split->value(), lo)) {
+            split = split->right;
+        } else if (_cmp(hi, split->value())) {
+            split = split->left;
+        } else {
+            break;
+        }
+    }
+    if (split == nullptr) {
+        return _monoid.identity();
+    }
+
+    auto left = static_cast<aggregate_type>(_monoid.identity());
+    for (auto ptr = split->left; ptr != nullptr; ) {
+        if (_cmp(ptr->value(), lo)) {
+            ptr = ptr->right;
+        } else {
+            auto acc = static_cast<aggregate_type>(_monoid.lift(ptr->value()));
+            if (ptr->right != nullptr) {
+                acc = _monoid(acc, ptr->right->aggregate);
+            }
+            left = _monoid(acc, left);
+            ptr = ptr->left;
+        }
+    }
+
+    auto right = static_cast<aggregate_type>(_monoid.identity());
+    for (auto ptr = split->right; ptr != nullptr; ) {
+        if (_cmp(hi, ptr->value())) {
+            ptr = ptr->left;
+        } else {
+            if (ptr->left != nullptr) {
+                right = _monoid(right, ptr->left->aggregate);
+            }
+            right = _monoid(right, _monoid.lift(ptr->value()));
+            ptr = ptr->right;
+        }
+    }
+
+    return _monoid(_monoid(left, _monoid.lift(split->value())), right);
+}
+
+template <typename T, typename Compare, typename Alloc, typename Monoid>
+constexpr inline
+void swap(augmented_avl_tree<T, Compare, Alloc, Monoid> & lhs, augmented_avl_tree<T, Compare, Alloc, Monoid> & rhs)
+    noexcept
+{ lhs.swap(rhs); }
+
+template <typename T, typename Compare, typename Alloc, typename Monoid, typename Pred>
+constexpr
+auto erase_if(augmented_avl_tree<T, Compare, Alloc, Monoid> & tree, Pred pred)
+    -> typename augmented_avl_tree<T, Compare, Alloc, Monoid>::size_type
+{
+    auto const old_size = tree.size();
+    for (auto it = tree.begin(); it != tree.end();) {
+        it = pred(*it) ? tree.erase(it) : std::next(it);
+    }
+    return old_size - tree.size();
+}
+
+} // namespace forest
+
+#endif /* AUGMENTED_AVL_TREE_HPP */
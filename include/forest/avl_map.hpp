@@ -0,0 +1,429 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : avl_map
+ * @created     : domenica ott 18, 2026 18:12:56 CEST
+ * @license     : MIT
+ * */
+
+#ifndef AVL_MAP_HPP
+#define AVL_MAP_HPP
+
+#include <stdexcept> //std::out_of_range
+#include <tuple>     //std::forward_as_tuple
+#include <utility>   //std::pair, std::piecewise_construct
+
+#include "avl_tree.hpp"
+#include "detail/map_iterator.hpp"
+
+namespace forest
+{
+
+namespace detail
+{
+// Compares the pairs of a map by key; a key compares with the key of a pair
+template <class Value, class Compare>
+struct _map_compare
+{
+    using is_transparent = void;
+
+    [[no_unique_address]] Compare _cmp;
+
+    constexpr inline bool operator()(Value const & a, Value const & b) const { return _cmp(a.first, b.first); }
+    template <typename K>
+    constexpr inline bool operator()(Value const & a, K const & b) const { return _cmp(a.first, b); }
+    template <typename K>
+    constexpr inline bool operator()(K const & a, Value const & b) const { return _cmp(a, b.first); }
+}; // struct _map_compare
+
+// What avl_map and avl_multimap share: an avl_tree of `std::pair<Key const, Mapped>`, ordered by key, whose
+// iterators give access to the mapped values, which can be modified in place
+template <class Key, class Mapped, class Compare, class Alloc>
+class _avl_map_base : protected avl_tree<std::pair<Key const, Mapped>, _map_compare<std::pair<Key const, Mapped>, Compare>, Alloc>
+{
+protected:
+    using base         = avl_tree<std::pair<Key const, Mapped>, _map_compare<std::pair<Key const, Mapped>, Compare>, Alloc>;
+    using node_pointer = typename base::node_pointer;
+    using _hold_ptr    = typename base::_hold_ptr;
+
+public:
+    using key_type               = Key;
+    using mapped_type            = Mapped;
+    using value_type             = std::pair<Key const, Mapped>;
+    using key_compare            = Compare;
+    using allocator_type         = typename base::allocator_type;
+    using reference              = value_type &;
+    using const_reference        = value_type const &;
+    using pointer                = typename base::pointer;
+    using const_pointer          = typename base::const_pointer;
+    using size_type              = typename base::size_type;
+    using difference_type        = typename base::difference_type;
+    using const_iterator         = typename base::const_iterator;
+    using iterator               = _map_iterator<value_type, typename base::iterator, const_iterator>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using node_type              = typename base::node_type;
+
+protected:
+    using base::_end;
+    using base::_node_alloc;
+
+public:
+    constexpr inline _avl_map_base() = default;
+    constexpr inline explicit _avl_map_base(allocator_type const & a) : base{a} {}
+
+    constexpr inline
+    allocator_type get_allocator() const noexcept { return base::get_allocator(); }
+    constexpr inline
+    key_compare key_comp() const { return base::_cmp._cmp; }
+
+    /// Capacity
+    using base::size;
+    using base::empty;
+    using base::max_size;
+    using base::capacity;
+    using base::reserve;
+    using base::shrink_to_fit;
+
+    /// Iterators
+    constexpr inline iterator begin() noexcept { return iterator{base::begin()}; }
+    constexpr inline const_iterator begin() const noexcept { return base::begin(); }
+    constexpr inline iterator end() noexcept { return iterator{base::end()}; }
+    constexpr inline const_iterator end() const noexcept { return base::end(); }
+    constexpr inline const_iterator cbegin() const noexcept { return begin(); }
+    constexpr inline const_iterator cend() const noexcept { return end(); }
+
+    constexpr inline reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator crend() const noexcept { return const_reverse_iterator{begin()}; }
+
+    /// Access
+    constexpr inline reference front() { return *begin(); }
+    constexpr inline const_reference front() const { return *begin(); }
+    constexpr inline reference back() { return *std::prev(end()); }
+    constexpr inline const_reference back() const { return *std::prev(end()); }
+
+    /// Modifiers
+    using base::clear;
+    constexpr inline iterator erase(const_iterator it) { return iterator{base::erase(_mutable(it))}; }
+    constexpr inline iterator erase(iterator it) { return iterator{base::erase(it._it)}; }
+    constexpr inline iterator erase(const_iterator f, const_iterator l)
+    { return iterator{base::erase(_mutable(f), _mutable(l))}; }
+    constexpr inline size_type erase(key_type const & k) { return _erase_key(k); }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline size_type erase(K const & k) { return _erase_key(k); }
+    constexpr inline node_type extract(const_iterator it) { return base::extract(_mutable(it)); }
+    constexpr inline node_type extract(key_type const & k)
+    { auto const it = find(k); return it == end() ? node_type{} : extract(it); }
+
+    /// Lookup
+    constexpr inline auto count(key_type const & k) const -> difference_type { return base::count(k); }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto count(K const & k) const -> difference_type { return base::count(k); }
+    constexpr inline bool contains(key_type const & k) const { return base::contains(k); }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline bool contains(K const & k) const { return base::contains(k); }
+
+    constexpr inline iterator find(key_type const & k) { return iterator{base::find(k)}; }
+    constexpr inline const_iterator find(key_type const & k) const { return base::find(k); }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline iterator find(K const & k) { return iterator{base::find(k)}; }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator find(K const & k) const { return base::find(k); }
+
+    constexpr inline iterator lower_bound(key_type const & k) { return iterator{base::lower_bound(k)}; }
+    constexpr inline const_iterator lower_bound(key_type const & k) const { return base::lower_bound(k); }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline iterator lower_bound(K const & k) { return iterator{base::lower_bound(k)}; }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator lower_bound(K const & k) const { return base::lower_bound(k); }
+
+    constexpr inline iterator upper_bound(key_type const & k) { return iterator{base::upper_bound(k)}; }
+    constexpr inline const_iterator upper_bound(key_type const & k) const { return base::upper_bound(k); }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline iterator upper_bound(K const & k) { return iterator{base::upper_bound(k)}; }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator upper_bound(K const & k) const { return base::upper_bound(k); }
+
+    constexpr inline auto equal_range(key_type const & k) -> std::pair<iterator, iterator>
+    { return {lower_bound(k), upper_bound(k)}; }
+    constexpr inline auto equal_range(key_type const & k) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(k), upper_bound(k)}; }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(K const & k) -> std::pair<iterator, iterator>
+    { return {lower_bound(k), upper_bound(k)}; }
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(K const & k) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(k), upper_bound(k)}; }
+
+    friend constexpr bool operator==(_avl_map_base const & lhs, _avl_map_base const & rhs) noexcept
+    { return lhs.size() == rhs.size() and std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend()); }
+    friend constexpr bool operator!=(_avl_map_base const & lhs, _avl_map_base const & rhs) noexcept
+    { return not (lhs == rhs); }
+
+protected:
+    static constexpr inline
+    typename base::iterator _mutable(const_iterator it) noexcept
+    { return typename base::iterator{const_cast<node_pointer>(it._current)}; }
+    static constexpr inline
+    iterator _iterator_to(node_pointer n) noexcept { return iterator{typename base::iterator{n}}; }
+    static constexpr inline
+    iterator _wrap(typename base::iterator it) noexcept { return iterator{it}; }
+
+    template <typename K>
+    constexpr size_type _erase_key(K const & k)
+    {
+        auto const [f, l] = base::equal_range(k);
+        auto const old_size = size();
+        base::erase(f, l);
+        return old_size - size();
+    }
+
+    // Links a new node after the ones with an equivalent key
+    constexpr node_pointer _link_multi(_hold_ptr && hold)
+    {
+        auto root = std::addressof(_end);
+        auto left = false;
+        for (auto it = empty() ? nullptr : _end.root; it != nullptr; it = left ? it->left : it->right) {
+            root = it;
+            left = base::_cmp(hold->value(), it->value());
+        }
+        return base::_link(root, left, std::move(hold));
+    }
+
+    template <typename ...Args>
+    constexpr inline _hold_ptr _construct(Args &&... args)
+    { return base::_construct_node(_node_alloc, std::forward<Args>(args)...); }
+
+    friend struct _serialization_access;
+}; // class _avl_map_base
+} // namespace detail
+
+// An ordered associative container from unique keys to mapped values, which can be modified in place through
+// the iterators, `operator[]`, `try_emplace` and `insert_or_assign`
+template <class Key, class Mapped, class Compare = std::less<>, class Alloc = std::allocator<std::pair<Key const, Mapped>>>
+class avl_map : public detail::_avl_map_base<Key, Mapped, Compare, Alloc>
+{
+protected:
+    using base = detail::_avl_map_base<Key, Mapped, Compare, Alloc>;
+
+public:
+    using typename base::key_type;
+    using typename base::mapped_type;
+    using typename base::value_type;
+    using typename base::allocator_type;
+    using typename base::iterator;
+    using typename base::const_iterator;
+    using typename base::size_type;
+    using typename base::node_type;
+
+    constexpr inline avl_map() = default;
+    constexpr inline explicit avl_map(allocator_type const & a) : base{a} {}
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr avl_map(Iterator f, Iterator l, allocator_type const & a = allocator_type{}) : base{a} { insert(f, l); }
+    constexpr avl_map(std::initializer_list<value_type> il, allocator_type const & a = allocator_type{})
+        : avl_map(il.begin(), il.end(), a) {}
+
+    constexpr inline
+    avl_map & operator=(std::initializer_list<value_type> il) { base::_recycle(); insert(il.begin(), il.end()); return *this; }
+
+    /// Access
+    constexpr inline mapped_type & operator[](key_type const & k) { return try_emplace(k).first->second; }
+    constexpr inline mapped_type & operator[](key_type && k) { return try_emplace(std::move(k)).first->second; }
+    constexpr mapped_type & at(key_type const & k);
+    constexpr mapped_type const & at(key_type const & k) const;
+
+    /// Modifiers
+    constexpr inline auto insert(value_type const & value) -> std::pair<iterator, bool> { return _insert(value); }
+    constexpr inline auto insert(value_type && value) -> std::pair<iterator, bool> { return _insert(std::move(value)); }
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr void insert(Iterator f, Iterator l) { for (; f != l; ++f) { insert(*f); } }
+    constexpr auto insert(node_type && n) -> std::pair<iterator, bool>;
+    template <typename ...Args>
+    constexpr inline auto emplace(Args &&... args) -> std::pair<iterator, bool>
+    { return _insert(value_type(std::forward<Args>(args)...)); }
+
+    // Emplaces `Mapped(args...)` if there is no `k` yet; otherwise, `args` are left untouched
+    template <typename ...Args>
+    constexpr inline auto try_emplace(key_type const & k, Args &&... args) -> std::pair<iterator, bool>
+    { return _try_emplace(k, std::forward<Args>(args)...); }
+    template <typename ...Args>
+    constexpr inline auto try_emplace(key_type && k, Args &&... args) -> std::pair<iterator, bool>
+    { return _try_emplace(std::move(k), std::forward<Args>(args)...); }
+
+    // Assigns `obj` to the value mapped to `k`, emplacing it if missing
+    template <typename M>
+    constexpr inline auto insert_or_assign(key_type const & k, M && obj) -> std::pair<iterator, bool>
+    { return _insert_or_assign(k, std::forward<M>(obj)); }
+    template <typename M>
+    constexpr inline auto insert_or_assign(key_type && k, M && obj) -> std::pair<iterator, bool>
+    { return _insert_or_assign(std::move(k), std::forward<M>(obj)); }
+
+    constexpr inline void swap(avl_map & other) noexcept { base::base::swap(other); }
+
+protected:
+    template <typename V>
+    constexpr auto _insert(V && value) -> std::pair<iterator, bool>;
+    template <typename K, typename ...Args>
+    constexpr auto _try_emplace(K && k, Args &&... args) -> std::pair<iterator, bool>;
+    template <typename K, typename M>
+    constexpr auto _insert_or_assign(K && k, M && obj) -> std::pair<iterator, bool>;
+}; // class avl_map
+
+// An ordered associative container from keys to mapped values, allowing equivalent keys
+template <class Key, class Mapped, class Compare = std::less<>, class Alloc = std::allocator<std::pair<Key const, Mapped>>>
+class avl_multimap : public detail::_avl_map_base<Key, Mapped, Compare, Alloc>
+{
+protected:
+    using base = detail::_avl_map_base<Key, Mapped, Compare, Alloc>;
+
+public:
+    using typename base::key_type;
+    using typename base::mapped_type;
+    using typename base::value_type;
+    using typename base::allocator_type;
+    using typename base::iterator;
+    using typename base::const_iterator;
+    using typename base::size_type;
+    using typename base::node_type;
+
+    constexpr inline avl_multimap() = default;
+    constexpr inline explicit avl_multimap(allocator_type const & a) : base{a} {}
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr avl_multimap(Iterator f, Iterator l, allocator_type const & a = allocator_type{}) : base{a} { insert(f, l); }
+    constexpr avl_multimap(std::initializer_list<value_type> il, allocator_type const & a = allocator_type{})
+        : avl_multimap(il.begin(), il.end(), a) {}
+
+    constexpr inline
+    avl_multimap & operator=(std::initializer_list<value_type> il)
+    { base::_recycle(); insert(il.begin(), il.end()); return *this; }
+
+    /// Modifiers
+    constexpr inline iterator insert(value_type const & value) { return emplace(value); }
+    constexpr inline iterator insert(value_type && value) { return emplace(std::move(value)); }
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr void insert(Iterator f, Iterator l) { for (; f != l; ++f) { insert(*f); } }
+    constexpr inline iterator insert(node_type && n) { return base::_wrap(base::base::insert(std::move(n))); }
+    template <typename ...Args>
+    constexpr inline iterator emplace(Args &&... args)
+    { return base::_iterator_to(base::_link_multi(base::_construct(std::forward<Args>(args)...))); }
+
+    constexpr inline void swap(avl_multimap & other) noexcept { base::base::swap(other); }
+}; // class avl_multimap
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc>
+constexpr auto avl_map<Key, Mapped, Compare, Alloc>::at(key_type const & k)
+    -> mapped_type &
+{
+    if (auto const [found, root, left] = base::_find_slot(k); found != nullptr) {
+        return found->value().second;
+    }
+    throw std::out_of_range{"forest::avl_map::at: key not found"};
+}
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc>
+constexpr auto avl_map<Key, Mapped, Compare, Alloc>::at(key_type const & k) const
+    -> mapped_type const &
+{
+    if (auto const [found, root, left] = base::_find_slot(k); found != nullptr) {
+        return found->value().second;
+    }
+    throw std::out_of_range{"forest::avl_map::at: key not found"};
+}
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc>
+template <typename V>
+constexpr auto avl_map<Key, Mapped, Compare, Alloc>::_insert(V && value)
+    -> std::pair<iterator, bool>
+{
+    auto const [found, root, left] = base::_find_slot(value.first);
+    if (found != nullptr) {
+        return {base::_iterator_to(found), false};
+    }
+    auto const n = base::_link(root, left, base::_construct(std::forward<V>(value)));
+    return {base::_iterator_to(n), true};
+}
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc>
+constexpr auto avl_map<Key, Mapped, Compare, Alloc>::insert(node_type && n)
+    -> std::pair<iterator, bool>
+{
+    if (n.empty()) {
+        return {base::end(), false};
+    }
+    auto const [found, root, left] = base::_find_slot(n.value().first);
+    if (found != nullptr) {
+        return {base::_iterator_to(found), false};
+    }
+    return {base::_wrap(base::base::insert(std::move(n))), true};
+}
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc>
+template <typename K, typename ...Args>
+constexpr auto avl_map<Key, Mapped, Compare, Alloc>::_try_emplace(K && k, Args &&... args)
+    -> std::pair<iterator, bool>
+{
+    auto const [found, root, left] = base::_find_slot(k);
+    if (found != nullptr) {
+        return {base::_iterator_to(found), false};
+    }
+    auto hold = base::_construct(
+        std::piecewise_construct, std::forward_as_tuple(std::forward<K>(k)),
+        std::forward_as_tuple(std::forward<Args>(args)...)
+    );
+    return {base::_iterator_to(base::_link(root, left, std::move(hold))), true};
+}
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc>
+template <typename K, typename M>
+constexpr auto avl_map<Key, Mapped, Compare, Alloc>::_insert_or_assign(K && k, M && obj)
+    -> std::pair<iterator, bool>
+{
+    auto const [found, root, left] = base::_find_slot(k);
+    if (found != nullptr) {
+        found->value().second = std::forward<M>(obj);
+        return {base::_iterator_to(found), false};
+    }
+    auto hold = base::_construct(std::forward<K>(k), std::forward<M>(obj));
+    return {base::_iterator_to(base::_link(root, left, std::move(hold))), true};
+}
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc>
+constexpr inline
+void swap(avl_map<Key, Mapped, Compare, Alloc> & lhs, avl_map<Key, Mapped, Compare, Alloc> & rhs) noexcept
+{ lhs.swap(rhs); }
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc>
+constexpr inline
+void swap(avl_multimap<Key, Mapped, Compare, Alloc> & lhs, avl_multimap<Key, Mapped, Compare, Alloc> & rhs) noexcept
+{ lhs.swap(rhs); }
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc, typename Pred>
+constexpr
+auto erase_if(avl_map<Key, Mapped, Compare, Alloc> & map, Pred pred)
+    -> typename avl_map<Key, Mapped, Compare, Alloc>::size_type
+{
+    auto const old_size = map.size();
+    for (auto it = map.begin(); it != map.end();) {
+        it = pred(*it) ? map.erase(it) : std::next(it);
+    }
+    return old_size - map.size();
+}
+
+template <typename Key, typename Mapped, typename Compare, typename Alloc, typename Pred>
+constexpr
+auto erase_if(avl_multimap<Key, Mapped, Compare, Alloc> & map, Pred pred)
+    -> typename avl_multimap<Key, Mapped, Compare, Alloc>::size_type
+{
+    auto const old_size = map.size();
+    for (auto it = map.begin(); it != map.end();) {
+        it = pred(*it) ? map.erase(it) : std::next(it);
+    }
+    return old_size - map.size();
+}
+
+} // namespace forest
+
+#endif /* AVL_MAP_HPP */
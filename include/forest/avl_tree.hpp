@@ -13,11 +13,11 @@
 namespace forest
 {
 
-template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>>
-class avl_tree : protected binary_search_tree<T, Compare, Alloc>
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>, class Stats = no_stats>
+class avl_tree : protected binary_search_tree<T, Compare, Alloc, Stats>
 {
 protected:
-    using base                  = binary_search_tree<T, Compare, Alloc>;
+    using base                  = binary_search_tree<T, Compare, Alloc, Stats>;
     using node                  = base::node_impl_type;
     using node_allocator        = base::node_allocator;
     using node_allocator_traits = base::node_allocator_traits;
@@ -93,6 +93,14 @@ public:
     constexpr inline
     size_type max_size() const noexcept { return base::max_size(); }
 
+    using base::capacity;
+    using base::reserve;
+    using base::shrink_to_fit;
+
+    /// Statistics, collected by the `Stats` policy
+    using base::stats;
+    using base::reset_stats;
+
     /// Iterators
     constexpr inline iterator begin() noexcept { return iterator{base::_first()}; }
     constexpr inline const_iterator begin() const noexcept { return const_iterator{base::_first()}; }
@@ -118,6 +126,11 @@ public:
     constexpr inline void clear() noexcept { base::clear(); }
     constexpr inline node_type extract(iterator it);
     constexpr inline node_type extract(value_type const & value);
+    constexpr inline iterator erase(iterator it);
+    constexpr inline iterator erase(iterator f, iterator l);
+    constexpr inline size_type erase(value_type const & value);
+    template <typename F>
+    constexpr iterator modify(iterator it, F && f);
     constexpr inline iterator insert(value_type const & value);
     constexpr inline iterator insert(value_type && value);
     constexpr inline iterator insert(node_type && n);
@@ -128,11 +141,16 @@ public:
 
     template <typename ...Args>
     constexpr reference emplace(Args&&... args);
+    template <typename ...Args>
+    constexpr auto emplace_unique(Args &&... args) -> std::pair<iterator, bool>;
+    template <typename K, typename ...Args>
+        requires std::is_same_v<K, value_type> or meta::is_transparent_compare<Compare>
+    constexpr auto try_emplace_unique(K const & key, Args &&... args) -> std::pair<iterator, bool>;
 
     template <typename Cmp2>
-    constexpr void merge(avl_tree<value_type, Cmp2, allocator_type> & source);
+    constexpr void merge(avl_tree<value_type, Cmp2, allocator_type, Stats> & source);
     template <typename Cmp2>
-    constexpr void merge(avl_tree<value_type, Cmp2, allocator_type> && source);
+    constexpr void merge(avl_tree<value_type, Cmp2, allocator_type, Stats> && source);
 
     /// Lookup
     constexpr inline auto count(value_type const & x) const -> difference_type;
@@ -168,12 +186,27 @@ public:
     template <typename U> requires meta::is_transparent_compare<Compare>
     constexpr inline auto upper_bound(U const & x) const -> const_iterator;
 
-private:
+protected:
+    using base::_find_slot;
+    using base::_discard;
     constexpr void _balance_from(node_pointer ptr);
+    constexpr node_pointer _link(node_pointer root, bool left, _hold_ptr && hold);
+    constexpr void _link(node_pointer root, bool left, node_pointer n);
+
+private:
 
+    constexpr inline auto _stats_update() const noexcept { return detail::_stats_update<Stats>{base::_stats}; }
     constexpr void _right_rotation(node_pointer const v) noexcept;
     constexpr void _left_rotation(node_pointer const v) noexcept;
 
+    constexpr static node_pointer _rotate_right(node_pointer const v) noexcept;
+    constexpr static node_pointer _rotate_left(node_pointer const v) noexcept;
+    constexpr static node_pointer _join_right(node_pointer left, node_pointer middle, node_pointer right) noexcept;
+    constexpr static node_pointer _join_left(node_pointer left, node_pointer middle, node_pointer right) noexcept;
+    constexpr static node_pointer _join(node_pointer left, node_pointer middle, node_pointer right) noexcept;
+
+    friend struct detail::_serialization_access;
+
 public:
 
     constexpr inline void swap(avl_tree & other)
@@ -194,8 +227,8 @@ public:
     { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater_equal{}); }
 }; // class avl_tree
 
-template <typename T, typename Compare, typename Alloc>
-constexpr avl_tree<T, Compare, Alloc>::avl_tree(avl_tree const & other)
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr avl_tree<T, Compare, Alloc, Stats>::avl_tree(avl_tree const & other)
     : base{
         std::allocator_traits<node_allocator>::select_on_container_copy_construction(other._node_alloc)
     }
@@ -203,61 +236,66 @@ constexpr avl_tree<T, Compare, Alloc>::avl_tree(avl_tree const & other)
     assign(other.begin(), other.end());
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr avl_tree<T, Compare, Alloc>::avl_tree(avl_tree const & other, allocator_type const & a)
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr avl_tree<T, Compare, Alloc, Stats>::avl_tree(avl_tree const & other, allocator_type const & a)
     : base{a}
 {
     assign(other.begin(), other.end());
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-avl_tree<T, Compare, Alloc>::avl_tree(avl_tree && other) : base{std::move(other._node_alloc)}
+avl_tree<T, Compare, Alloc, Stats>::avl_tree(avl_tree && other) : base{other._node_alloc}
 {
-    assign(std::move_iterator(other.begin()), std::move_iterator(other.end()));
-    other._size = 0;
+    base::_steal(other);
+    _cmp = std::move(other._cmp);
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-avl_tree<T, Compare, Alloc>::avl_tree(avl_tree && other, allocator_type const & alloc)
+avl_tree<T, Compare, Alloc, Stats>::avl_tree(avl_tree && other, allocator_type const & alloc)
     : base{alloc}
 {
-    assign(std::move_iterator(other.begin()), std::move_iterator(other.end()));
-    other._size = 0;
+    if (_node_alloc == other._node_alloc) {
+        base::_steal(other);
+    } else {
+        assign(std::move_iterator(other.begin()), std::move_iterator(other.end()));
+        other.clear();
+    }
+    _cmp = std::move(other._cmp);
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-avl_tree<T, Compare, Alloc>::avl_tree(std::initializer_list<value_type> il)
+avl_tree<T, Compare, Alloc, Stats>::avl_tree(std::initializer_list<value_type> il)
     : avl_tree(il.begin(), il.end()) { }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-avl_tree<T, Compare, Alloc>::avl_tree(std::initializer_list<value_type> il, allocator_type const & a)
+avl_tree<T, Compare, Alloc, Stats>::avl_tree(std::initializer_list<value_type> il, allocator_type const & a)
     : avl_tree(il.begin(), il.end(), a) { }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename Iterator>
     requires detail::is_input_iterator_v<Iterator>
 constexpr
-avl_tree<T, Compare, Alloc>::avl_tree(Iterator f, Iterator l)
+avl_tree<T, Compare, Alloc, Stats>::avl_tree(Iterator f, Iterator l)
 {
     assign(std::move(f), std::move(l));
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename Iterator>
     requires detail::is_input_iterator_v<Iterator>
 constexpr
-avl_tree<T, Compare, Alloc>::avl_tree(Iterator f, Iterator l, allocator_type const & a) : base{a}
+avl_tree<T, Compare, Alloc, Stats>::avl_tree(Iterator f, Iterator l, allocator_type const & a) : base{a}
 {
     assign(std::move(f), std::move(l));
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr
-avl_tree<T, Compare, Alloc> & avl_tree<T, Compare, Alloc>::operator=(avl_tree const & other)
+avl_tree<T, Compare, Alloc, Stats> & avl_tree<T, Compare, Alloc, Stats>::operator=(avl_tree const & other)
 {
     if (std::addressof(_end) == std::addressof(other._end)) {
         return *this;
@@ -265,7 +303,8 @@ avl_tree<T, Compare, Alloc> & avl_tree<T, Compare, Alloc>::operator=(avl_tree co
     if constexpr (std::allocator_traits<node_allocator>::propagate_on_container_copy_assignment::value) {
         if (_node_alloc != other._node_alloc) {
             clear();
-            _node_alloc = other.alloc;
+            base::shrink_to_fit();
+            _node_alloc = other._node_alloc;
         }
     }
     assign(other.begin(), other.end());
@@ -273,9 +312,9 @@ avl_tree<T, Compare, Alloc> & avl_tree<T, Compare, Alloc>::operator=(avl_tree co
     return *this;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr
-avl_tree<T, Compare, Alloc> & avl_tree<T, Compare, Alloc>::operator=(avl_tree && other)
+avl_tree<T, Compare, Alloc, Stats> & avl_tree<T, Compare, Alloc, Stats>::operator=(avl_tree && other)
 {
     if (std::addressof(_end) == std::addressof(other._end)) {
         return *this;
@@ -283,43 +322,39 @@ avl_tree<T, Compare, Alloc> & avl_tree<T, Compare, Alloc>::operator=(avl_tree &&
 
     if constexpr (std::allocator_traits<node_allocator>::propagate_on_container_move_assignment::value) {
         clear();
+        base::shrink_to_fit();
         _node_alloc = std::move(other._node_alloc);
-        _end = std::move(other._end);
-        _end.root->root = std::addressof(_end);
-        _size = std::move(other._size);
+        base::_steal(other);
     } else {
         if (_node_alloc != other._node_alloc) {
             auto const mbegin = std::move_iterator(other.begin());
             auto const mend = std::move_iterator(other.end());
             assign(mbegin, mend);
+            other.clear();
         } else {
             clear();
-            _end = std::move(other._end);
-            _end.root->root = std::addressof(_end);
-            _size = std::move(other._size);
+            base::_steal(other);
         }
     }
     _cmp = std::move(other._cmp);
-    other._size = 0;
-    other._set_end();
 
     return *this;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <class Iterator> requires detail::is_input_iterator_v<Iterator>
 constexpr inline
-void avl_tree<T, Compare, Alloc>::assign(Iterator f, Iterator l)
+void avl_tree<T, Compare, Alloc, Stats>::assign(Iterator f, Iterator l)
 {
-    clear();
+    base::_recycle();
     while (f != l) {
         emplace(*f++);
     }
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-auto avl_tree<T, Compare, Alloc>::extract(iterator it)
+auto avl_tree<T, Compare, Alloc, Stats>::extract(iterator it)
     -> node_type
 {
     auto replaced = base::_extract(it);
@@ -327,9 +362,9 @@ auto avl_tree<T, Compare, Alloc>::extract(iterator it)
     return node_type{it._current, _node_alloc};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-auto avl_tree<T, Compare, Alloc>::extract(value_type const & value)
+auto avl_tree<T, Compare, Alloc, Stats>::extract(value_type const & value)
     -> node_type
 {
     if (auto it = find(value); it != end()) {
@@ -338,9 +373,68 @@ auto avl_tree<T, Compare, Alloc>::extract(value_type const & value)
     return {};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto avl_tree<T, Compare, Alloc, Stats>::erase(iterator it)
+    -> iterator
+{
+    auto const next = std::next(it);
+    auto replaced = base::_extract(it);
+    if (replaced != nullptr) { _balance_from(replaced); }
+    base::_destroy_node(it._current);
+    return next;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto avl_tree<T, Compare, Alloc, Stats>::erase(iterator f, iterator l)
+    -> iterator
+{
+    return base::_erase(f, l, _join);
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto avl_tree<T, Compare, Alloc, Stats>::erase(value_type const & value)
+    -> size_type
+{
+    auto const [f, l] = equal_range(value);
+    auto const old_size = size();
+    erase(f, l);
+    return old_size - size();
+}
+
+// Applies `f` to the element at `it`. If the new value is out of order, the node is unlinked and linked back
+// where it belongs, searching from its old neighbour instead of from the root; no node is allocated nor freed.
+// If `f` throws, the element is erased
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename F>
 constexpr
-auto avl_tree<T, Compare, Alloc>::insert(value_type const & value)
+auto avl_tree<T, Compare, Alloc, Stats>::modify(iterator it, F && f)
+    -> iterator
+{
+    auto const n = it._current;
+    try {
+        std::invoke(std::forward<F>(f), n->value());
+    } catch (...) {
+        erase(it);
+        throw;
+    }
+    auto const from = base::_misplaced_from(n);
+    if (from == nullptr) {
+        return it;
+    }
+    if (auto const replaced = base::_extract(it); replaced != nullptr) {
+        _balance_from(replaced);
+    }
+    auto const [root, left] = detail::_finger_slot(from, n->value(), base::_comparator(), std::addressof(_end));
+    _link(root, left, n);
+    return it;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr
+auto avl_tree<T, Compare, Alloc, Stats>::insert(value_type const & value)
     -> iterator
 {
     auto _hold = base::_construct_node(_node_alloc, value);
@@ -350,9 +444,9 @@ auto avl_tree<T, Compare, Alloc>::insert(value_type const & value)
     return iterator{_new_node};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr
-auto avl_tree<T, Compare, Alloc>::insert(value_type && value)
+auto avl_tree<T, Compare, Alloc, Stats>::insert(value_type && value)
     -> iterator
 {
     auto _hold = base::_construct_node(_node_alloc, std::move(value));
@@ -362,9 +456,9 @@ auto avl_tree<T, Compare, Alloc>::insert(value_type && value)
     return iterator{_new_node};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-auto avl_tree<T, Compare, Alloc>::insert(node_type && n)
+auto avl_tree<T, Compare, Alloc, Stats>::insert(node_type && n)
     -> iterator
 {
     auto hold = _hold_ptr(n._storage, _node_deallocator(_node_alloc));
@@ -377,9 +471,9 @@ auto avl_tree<T, Compare, Alloc>::insert(node_type && n)
     return iterator{_new_node};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-auto avl_tree<T, Compare, Alloc>::insert(const_iterator it, node_type && n)
+auto avl_tree<T, Compare, Alloc, Stats>::insert(const_iterator it, node_type && n)
     -> iterator
 {
     auto hold = _hold_ptr(n._storage, _node_deallocator(_node_alloc));
@@ -392,55 +486,80 @@ auto avl_tree<T, Compare, Alloc>::insert(const_iterator it, node_type && n)
     return iterator{_new_node};
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr
-auto avl_tree<T, Compare, Alloc>::insert_unique(value_type const & value)
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto avl_tree<T, Compare, Alloc, Stats>::insert_unique(value_type const & value)
     -> iterator
 {
-    auto found = lower_bound(value);
-    if (found != end()) {
-        return found;
-    }
-    auto _hold = base::_construct_node(_node_alloc, value);
-    auto _new_node = base::_emplace(found, std::move(_hold));
-    _balance_from(_new_node);
+    return try_emplace_unique(value).first;
+}
 
-    return iterator{_new_node};
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto avl_tree<T, Compare, Alloc, Stats>::insert_unique(value_type && value)
+    -> iterator
+{
+    return try_emplace_unique(value, std::move(value)).first;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr
-auto avl_tree<T, Compare, Alloc>::insert_unique(value_type && value)
+auto avl_tree<T, Compare, Alloc, Stats>::insert_unique(node_type && n)
     -> iterator
 {
-    auto found = lower_bound(value);
-    if (found != end()) {
-        return found;
+    auto const [found, root, left] = _find_slot(n.value());
+    if (found != nullptr) {
+        return iterator{found};
     }
-    auto _hold = base::_construct_node(_node_alloc, std::move(value));
-    auto _new_node = base::_emplace(found, std::move(_hold));
-    _balance_from(_new_node);
 
-    return iterator{_new_node};
+    auto hold = _hold_ptr(n._storage, _node_deallocator(_node_alloc));
+    hold.get_deleter().constructed = 2;
+    n._storage = nullptr;
+    n._consume();
+    return iterator{_link(root, left, std::move(hold))};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename ...Args>
 constexpr
-auto avl_tree<T, Compare, Alloc>::insert_unique(node_type && n)
-    -> iterator
+auto avl_tree<T, Compare, Alloc, Stats>::emplace_unique(Args &&... args)
+    -> std::pair<iterator, bool>
 {
-    auto found = lower_bound(n.value());
-    if (found != end()) {
-        return found;
+    if constexpr ((sizeof...(Args) == 1) and (std::is_same_v<std::remove_cvref_t<Args>, value_type> and ...)) {
+        return try_emplace_unique(args..., std::forward<Args>(args)...);
+    } else {
+        auto hold = base::_construct_node(_node_alloc, std::forward<Args>(args)...);
+        auto const [found, root, left] = _find_slot(hold->value());
+        if (found != nullptr) {
+            _discard(std::move(hold));
+            return {iterator{found}, false};
+        }
+        return {iterator{_link(root, left, std::move(hold))}, true};
     }
+}
 
-    return insert(found, std::move(n));
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename K, typename ...Args>
+    requires std::is_same_v<K, T> or meta::is_transparent_compare<Compare>
+constexpr
+auto avl_tree<T, Compare, Alloc, Stats>::try_emplace_unique(K const & key, Args &&... args)
+    -> std::pair<iterator, bool>
+{
+    auto const [found, root, left] = _find_slot(key);
+    if (found != nullptr) {
+        return {iterator{found}, false};
+    }
+    if constexpr (sizeof...(Args) == 0) {
+        return {iterator{_link(root, left, base::_construct_node(_node_alloc, key))}, true};
+    } else {
+        return {iterator{_link(root, left, base::_construct_node(_node_alloc, std::forward<Args>(args)...))}, true};
+    }
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename ...Args>
 constexpr
-auto avl_tree<T, Compare, Alloc>::emplace(Args&&... args)
+auto avl_tree<T, Compare, Alloc, Stats>::emplace(Args&&... args)
     -> reference
 {
     auto & alloc = _node_alloc;
@@ -451,10 +570,10 @@ auto avl_tree<T, Compare, Alloc>::emplace(Args&&... args)
     return _new_node->value();
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename Cmp2>
 constexpr
-void avl_tree<T, Compare, Alloc>::merge(avl_tree<value_type, Cmp2, allocator_type> & source)
+void avl_tree<T, Compare, Alloc, Stats>::merge(avl_tree<value_type, Cmp2, allocator_type, Stats> & source)
 {
     auto it = source.begin();
     auto tmp = it++;
@@ -465,10 +584,10 @@ void avl_tree<T, Compare, Alloc>::merge(avl_tree<value_type, Cmp2, allocator_typ
     }
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename Cmp2>
 constexpr
-void avl_tree<T, Compare, Alloc>::merge(avl_tree<value_type, Cmp2, allocator_type> && source)
+void avl_tree<T, Compare, Alloc, Stats>::merge(avl_tree<value_type, Cmp2, allocator_type, Stats> && source)
 {
     auto it = source.begin();
     while (it != source.end()) {
@@ -477,225 +596,294 @@ void avl_tree<T, Compare, Alloc>::merge(avl_tree<value_type, Cmp2, allocator_typ
     }
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+void avl_tree<T, Compare, Alloc, Stats>::_right_rotation(node_pointer const v) noexcept
+{ detail::_avl_right_rotation(v, std::addressof(_end), _stats_update()); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+void avl_tree<T, Compare, Alloc, Stats>::_left_rotation(node_pointer const v) noexcept
+{ detail::_avl_left_rotation(v, std::addressof(_end), _stats_update()); }
+
+// Detached rotations: they do not update the link coming from `v->root`, and return the new root of the subtree
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr
-void avl_tree<T, Compare, Alloc>::_right_rotation(node_pointer const v) noexcept
+auto avl_tree<T, Compare, Alloc, Stats>::_rotate_right(node_pointer const v) noexcept
+    -> node_pointer
 {
-    auto const root = v->root;
-    auto const u  = v->left;
-    auto const ur = u->right;
-
-    if (root == std::addressof(_end)) {
-        _end.root = u;
+    auto const u = v->left;
+    v->left = u->right;
+    if (v->left != nullptr) {
+        v->left->root = v;
     }
-    else if (root->left == v) {
-        root->left = u;
-    } else {
-        root->right = u;
-    }
-    u->root = root;
-    v->root = u;
     u->right = v;
-
-    v->left = ur;
-    if (ur != nullptr) {
-        ur->root = v;
-    }
+    u->root = v->root;
+    v->root = u;
 
     v->height = _node_height(v);
+    u->height = _node_height(u);
+    return u;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr
-void avl_tree<T, Compare, Alloc>::_left_rotation(node_pointer const v) noexcept
+auto avl_tree<T, Compare, Alloc, Stats>::_rotate_left(node_pointer const v) noexcept
+    -> node_pointer
 {
-    auto const root = v->root;
     auto const u = v->right;
-    auto const ul = u->left;
-
-    if (root == std::addressof(_end)) {
-        _end.root = u;
+    v->right = u->left;
+    if (v->right != nullptr) {
+        v->right->root = v;
     }
-    else if (root->left == v) {
-        root->left = u;
-    } else {
-        root->right = u;
-    }
-    u->root = root;
-    v->root = u;
     u->left = v;
-
-    v->right = ul;
-    if (ul != nullptr) {
-        ul->root = v;
-    }
+    u->root = v->root;
+    v->root = u;
 
     v->height = _node_height(v);
+    u->height = _node_height(u);
+    return u;
 }
 
-
-template <typename T, typename Compare, typename Alloc>
+// Joins `left`, `middle` and `right` when `left` is the higher one, descending along its right spine
+// (see Blelloch, Ferizovic, Sun - "Just Join for Parallel Ordered Sets")
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr
-void avl_tree<T, Compare, Alloc>::_balance_from(node_pointer ptr)
+auto avl_tree<T, Compare, Alloc, Stats>::_join_right(node_pointer left, node_pointer middle, node_pointer right) noexcept
+    -> node_pointer
 {
-    constexpr auto balance_factor = [](node const * const root) noexcept -> std::ptrdiff_t {
-        constexpr auto height = [](node const * const n) {
-            return n ? n->height : -1;
-        };
-
-        if (root == nullptr) {
-            return 0;
+    using detail::_height_of;
+    auto const c = left->right;
+    auto sub = node_pointer{nullptr};
+    if (_height_of(c) <= _height_of(right) + 1) {
+        sub = base::_join(c, middle, right);
+        if (_height_of(sub) > _height_of(left->left) + 1) {
+            sub = _rotate_right(sub);
         }
+    } else {
+        sub = _join_right(c, middle, right);
+    }
+    left->right = sub;
+    sub->root = left;
+    left->height = _node_height(left);
+    if (_height_of(sub) > _height_of(left->left) + 1) {
+        return _rotate_left(left);
+    }
+    return left;
+}
 
-        return height(root->left) - height(root->right);
-    };
-
-    while (ptr->root != std::addressof(base::_end)) {
-        ptr = ptr->root;
-
-        if (auto const diff = balance_factor(ptr); diff >= 2) {
-            auto const left_diff = balance_factor(ptr->left);
-            if (left_diff > 0) {
-                _right_rotation(ptr);
-            } else if (left_diff < 0) {
-                _left_rotation(ptr->left);
-                _right_rotation(ptr);
-            }
-        } else if (diff <= -2) {
-            auto const right_diff = balance_factor(ptr->right);
-            if (right_diff < 0) {   
-                _left_rotation(ptr);
-            } else if (right_diff > 0) {
-                _right_rotation(ptr->right);
-                _left_rotation(ptr);
-            }
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr
+auto avl_tree<T, Compare, Alloc, Stats>::_join_left(node_pointer left, node_pointer middle, node_pointer right) noexcept
+    -> node_pointer
+{
+    using detail::_height_of;
+    auto const c = right->left;
+    auto sub = node_pointer{nullptr};
+    if (_height_of(c) <= _height_of(left) + 1) {
+        sub = base::_join(left, middle, c);
+        if (_height_of(sub) > _height_of(right->right) + 1) {
+            sub = _rotate_left(sub);
         }
+    } else {
+        sub = _join_left(left, middle, c);
+    }
+    right->left = sub;
+    sub->root = right;
+    right->height = _node_height(right);
+    if (_height_of(sub) > _height_of(right->right) + 1) {
+        return _rotate_right(right);
+    }
+    return right;
+}
+
+// Builds a balanced tree from two balanced trees and a node that sits between them, in O(|h(left) - h(right)|)
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr
+auto avl_tree<T, Compare, Alloc, Stats>::_join(node_pointer left, node_pointer middle, node_pointer right) noexcept
+    -> node_pointer
+{
+    using detail::_height_of;
+    if (_height_of(left) > _height_of(right) + 1) {
+        return _join_right(left, middle, right);
+    }
+    if (_height_of(right) > _height_of(left) + 1) {
+        return _join_left(left, middle, right);
     }
+    return base::_join(left, middle, right);
+}
+
+// Links the node held by `hold` as the `left` (or right) child of `root`, where a descent from the root ended,
+// and rebalances; `root` is `_end` if the tree is empty
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto avl_tree<T, Compare, Alloc, Stats>::_link(node_pointer root, bool left, _hold_ptr && hold)
+    -> node_pointer
+{
+    auto const n = hold.release();
+    _link(root, left, n);
+    return n;
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline bool avl_tree<T, Compare, Alloc>::contains(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+void avl_tree<T, Compare, Alloc, Stats>::_link(node_pointer root, bool left, node_pointer n)
+{
+    detail::_link_leaf(root, left, n, std::addressof(_end));
+    ++_size;
+    _balance_from(root);
+}
+
+// Restores heights and balance from `ptr` (included) up to the root
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+void avl_tree<T, Compare, Alloc, Stats>::_balance_from(node_pointer ptr)
+{ detail::_avl_balance_from(ptr, std::addressof(_end), _stats_update()); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline bool avl_tree<T, Compare, Alloc, Stats>::contains(value_type const & x) const
 { return base::contains(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr inline auto avl_tree<T, Compare, Alloc>::contains(U const & x) const
+constexpr inline auto avl_tree<T, Compare, Alloc, Stats>::contains(U const & x) const
     -> bool
 { return base::contains(x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto avl_tree<T, Compare, Alloc>::find(value_type const & x)
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto avl_tree<T, Compare, Alloc, Stats>::find(value_type const & x)
     -> iterator
 { return base::find(x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto avl_tree<T, Compare, Alloc>::find(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto avl_tree<T, Compare, Alloc, Stats>::find(value_type const & x) const
     -> const_iterator
 { return base::find(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto avl_tree<T, Compare, Alloc>::find(U const & x)
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::find(U const & x)
     -> iterator
 { return base::find(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto avl_tree<T, Compare, Alloc>::find(U const & x) const
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::find(U const & x) const
     -> const_iterator
 { return base::find(x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto avl_tree<T, Compare, Alloc>::lower_bound(value_type const & x)
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto avl_tree<T, Compare, Alloc, Stats>::lower_bound(value_type const & x)
     -> iterator
 { return base::lower_bound(x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto avl_tree<T, Compare, Alloc>::lower_bound(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto avl_tree<T, Compare, Alloc, Stats>::lower_bound(value_type const & x) const
     -> const_iterator
 { return base::lower_bound(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto avl_tree<T, Compare, Alloc>::lower_bound(U const & x)
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::lower_bound(U const & x)
     -> iterator
 { return base::lower_bound(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto avl_tree<T, Compare, Alloc>::lower_bound(U const & x) const
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::lower_bound(U const & x) const
     -> const_iterator
 { return base::lower_bound(x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto avl_tree<T, Compare, Alloc>::upper_bound(value_type const & x)
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto avl_tree<T, Compare, Alloc, Stats>::upper_bound(value_type const & x)
     -> iterator
 { return base::upper_bound(x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto avl_tree<T, Compare, Alloc>::upper_bound(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto avl_tree<T, Compare, Alloc, Stats>::upper_bound(value_type const & x) const
     -> const_iterator
 { return base::upper_bound(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto avl_tree<T, Compare, Alloc>::upper_bound(U const & x)
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::upper_bound(U const & x)
     -> iterator
 { return base::upper_bound(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto avl_tree<T, Compare, Alloc>::upper_bound(U const & x) const
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::upper_bound(U const & x) const
     -> const_iterator
 { return base::upper_bound(x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto avl_tree<T, Compare, Alloc>::equal_range(value_type const & x)
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto avl_tree<T, Compare, Alloc, Stats>::equal_range(value_type const & x)
     -> std::pair<iterator, iterator>
 { return base::equal_range(x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto avl_tree<T, Compare, Alloc>::equal_range(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto avl_tree<T, Compare, Alloc, Stats>::equal_range(value_type const & x) const
     -> std::pair<const_iterator, const_iterator>
 { return base::equal_range(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto avl_tree<T, Compare, Alloc>::equal_range(U const & x)
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::equal_range(U const & x)
     -> std::pair<iterator, iterator>
 { return base::equal_range(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto avl_tree<T, Compare, Alloc>::equal_range(U const & x) const
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::equal_range(U const & x) const
     -> std::pair<const_iterator, const_iterator>
 { return base::equal_range(x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto avl_tree<T, Compare, Alloc>::count(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::count(value_type const & x) const
     -> difference_type
 { return base::count(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto avl_tree<T, Compare, Alloc>::count(U const & x) const
+constexpr auto avl_tree<T, Compare, Alloc, Stats>::count(U const & x) const
     -> difference_type
 { return base::count(x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-void swap(avl_tree<T, Compare, Alloc> & lhs, avl_tree<T, Compare, Alloc> & rhs)
+void swap(avl_tree<T, Compare, Alloc, Stats> & lhs, avl_tree<T, Compare, Alloc, Stats> & rhs)
     noexcept(noexcept(lhs.swap(rhs)))
 { lhs.swap(rhs); }
 
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Pred>
+constexpr
+auto erase_if(avl_tree<T, Compare, Alloc, Stats> & tree, Pred pred)
+    -> typename avl_tree<T, Compare, Alloc, Stats>::size_type
+{
+    auto const old_size = tree.size();
+    auto it = tree.begin();
+    while (it != tree.end()) {
+        if (not pred(*it)) {
+            ++it;
+            continue;
+        }
+        auto last = std::next(it);
+        while (last != tree.end() and pred(*last)) {
+            ++last;
+        }
+        it = tree.erase(it, last);
+    }
+    return old_size - tree.size();
+}
+
 
 } // namespace forest
 
 namespace std
 {
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats>
 constexpr inline
-void std::swap(forest::avl_tree<T, Compare, Alloc> & lhs, forest::avl_tree<T, Compare, Alloc> & rhs)
+void std::swap(forest::avl_tree<T, Compare, Alloc, Stats> & lhs, forest::avl_tree<T, Compare, Alloc, Stats> & rhs)
     noexcept(noexcept(forest::swap(lhs, rhs)))
 { forest::swap(lhs, rhs); }
 } // namespace std
@@ -8,18 +8,67 @@
 #ifndef BINARY_SEARCH_TREE_HPP
 #define BINARY_SEARCH_TREE_HPP
 
+#include <algorithm>  //std::find_if, std::equal, std::lexicographical_compare, std::max
+#include <cstddef>    //std::size_t
+#include <functional> //std::invoke
+#include <limits>     //std::numeric_limits
+#include <tuple>      //std::tuple
+#include <type_traits>
+#include <utility>    //std::pair, std::exchange
+
 #include "detail/utils.hpp"
+#include "detail/tree_algorithms.hpp"
 #include "detail/tree_impl.hpp"
 #include "detail/bst_iterator.hpp"
 
 #include "meta/is_transparent_compare.hpp"
 
 #include "node_handle.hpp"
+#include "tree_stats.hpp"
 
 namespace forest
 {
 
-template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>>
+// The balancing policies of `binary_search_tree`. `unbalanced`, the default, leaves the shape of the tree to the
+// order of the insertions
+struct unbalanced
+{
+    static constexpr bool rebuilds = false;
+}; // struct unbalanced
+
+// Scapegoat balancing (see Galperin, Rivest - "Scapegoat Trees"), with `alpha` = Num / Den between 1/2 and 1.
+// When an insertion lands deeper than log_{1/alpha}(n), the lowest ancestor of the new node with a child holding
+// more than `alpha` of its subtree is rebuilt perfectly balanced; when the erasures leave less than `alpha` times
+// the most elements held since the last full rebuild, the whole tree is rebuilt. The nodes store nothing more,
+// the height stays within log_{1/alpha}(n) + 1 and the updates take O(log n) amortized time: a lower `alpha`
+// keeps the tree shallower, rebuilding more often
+template <unsigned Num = 2, unsigned Den = 3>
+struct scapegoat
+{
+    static_assert(Num < Den and Den < 2 * Num, "scapegoat: alpha = Num / Den must be between 1/2 and 1");
+    static constexpr bool rebuilds = true;
+
+    std::size_t max_size = 0;
+
+    // Whether a node `depth` links below the root is too deep for a tree of `size` elements
+    [[nodiscard]] static constexpr bool too_deep(std::size_t depth, std::size_t size) noexcept
+    {
+        auto bound = 1.0;
+        for (; depth > 0 and bound <= static_cast<double>(size); --depth) {
+            bound = bound * Den / Num;
+        }
+        return bound > static_cast<double>(size);
+    }
+    // Whether a subtree of `size` nodes with a child of `child_size` nodes has to be rebuilt
+    [[nodiscard]] static constexpr bool too_heavy(std::size_t child_size, std::size_t size) noexcept
+    { return child_size * Den > size * Num; }
+    // Whether a tree of `size` elements has shrunk enough to be rebuilt
+    [[nodiscard]] constexpr bool too_small(std::size_t size) const noexcept
+    { return size * Den < max_size * Num; }
+}; // struct scapegoat
+
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>, class Stats = no_stats,
+          class Balance = unbalanced>
 class binary_search_tree : private detail::_tree_impl<T, std::int_fast8_t, Alloc>
 {
 public:
@@ -57,6 +106,8 @@ protected:
     using base::_node_alloc;
     using base::_size;
     [[no_unique_address]] key_compare _cmp;
+    [[no_unique_address]] mutable Stats _stats;
+    [[no_unique_address]] Balance _balance;
 
 public:
 
@@ -91,7 +142,7 @@ public:
     void assign(Iterator f, Iterator l);
 
     constexpr inline
-    size_type get_allocator() const noexcept { return base::get_allocator(); }
+    allocator_type get_allocator() const noexcept { return base::get_allocator(); }
 
     /// Capacity
     constexpr inline
@@ -106,6 +157,16 @@ public:
         return std::min<size_type>(base::max_size(), std::numeric_limits<difference_type>::max());
     }
 
+    // The number of elements the tree can hold without allocating: its spare nodes are kept by `assign`, the
+    // assignments and `reserve`, and freed by `shrink_to_fit`
+    using base::capacity;
+    constexpr void reserve(size_type n);
+    using base::shrink_to_fit;
+
+    /// Statistics, collected by the `Stats` policy
+    constexpr inline Stats const & stats() const noexcept { return _stats; }
+    constexpr inline void reset_stats() noexcept { _stats.reset(); }
+
     /// Iterators
     constexpr inline iterator begin() noexcept { return iterator{_first()}; }
     constexpr inline const_iterator begin() const noexcept { return const_iterator{_first()}; }
@@ -131,6 +192,10 @@ protected:
     constexpr inline node_pointer & _root() noexcept { return _end.root; }
 
     using base::_set_end;
+    using base::_destroy_node;
+    using base::_destroy_subtree;
+    using base::_recycle;
+    constexpr inline void _steal(binary_search_tree & other) noexcept { base::_steal(other); }
 
     constexpr node_pointer _extract(iterator it);
 public:
@@ -140,31 +205,61 @@ public:
     constexpr inline const_reference back() const { return _last()->value(); }
 
     /// Modifiers
-    constexpr inline void clear() noexcept { base::clear(); }
+    constexpr inline void clear() noexcept { base::clear(); _balance = Balance{}; }
 
     constexpr inline node_type extract(iterator it);
     constexpr inline node_type extract(value_type const & value);
 
+    constexpr inline iterator erase(iterator it);
+    constexpr inline iterator erase(iterator f, iterator l);
+    constexpr inline size_type erase(value_type const & value);
+
+    // Applies `f` to the element at `it`, then moves its node where the new value belongs, if needed
+    template <typename F>
+    constexpr iterator modify(iterator it, F && f);
+
 protected:
+    constexpr node_pointer _misplaced_from(node_pointer n) const;
     constexpr node_pointer _emplace(const_iterator it, _hold_ptr && hold);
     constexpr node_pointer _emplace(_hold_ptr && hold);
+    // Descends looking for an element equivalent to `x`: returns its node, if any, and otherwise the node under
+    // which `x` should be linked, and on which side (`_end` if the tree is empty)
+    template <typename U>
+    constexpr auto _find_slot(U const & x) const -> std::tuple<node_pointer, node_pointer, bool>;
+    // Descends to the node under which `x` should be linked, after the elements equivalent to it, and on which side
+    constexpr auto _find_multi_slot(value_type const & x) const -> std::pair<node_pointer, bool>;
+    // Links the node held by `hold` as the `left` (or right) child of `root`, found by `_find_slot`
+    constexpr node_pointer _link(node_pointer root, bool left, _hold_ptr && hold) noexcept;
+    // Destroys the value held by `hold`, keeping its node as a spare
+    constexpr void _discard(_hold_ptr && hold) noexcept;
 
 public:
     constexpr inline iterator insert(value_type const & value);
     constexpr inline iterator insert(value_type && value);
     constexpr inline iterator insert(node_type && n);
     constexpr inline iterator insert(const_iterator hint, node_type && n);
+    // Insert the element unless an equivalent one is present, and return the position of either
     constexpr inline iterator insert_unique(value_type const & value);
     constexpr inline iterator insert_unique(value_type && value);
     constexpr inline iterator insert_unique(node_type && n);
 
     template <typename ...Args>
     constexpr reference emplace(Args&&... args);
+    // Like `std::set::emplace`: descends once, and returns the position of the new element, or of the equivalent
+    // one which prevented the insertion, and whether it happened. A single `value_type` argument is looked up
+    // before being copied or moved into a node; other arguments are constructed into a node first
+    template <typename ...Args>
+    constexpr auto emplace_unique(Args &&... args) -> std::pair<iterator, bool>;
+    // Looks up `key` and, on a miss only, constructs an element from `args` (or from `key`, if there are none),
+    // which must be equivalent to `key`
+    template <typename K, typename ...Args>
+        requires std::is_same_v<K, value_type> or meta::is_transparent_compare<Compare>
+    constexpr auto try_emplace_unique(K const & key, Args &&... args) -> std::pair<iterator, bool>;
 
     template <typename Cmp2>
-    constexpr void merge(binary_search_tree<value_type, Cmp2, allocator_type> & source);
+    constexpr void merge(binary_search_tree<value_type, Cmp2, allocator_type, Stats, Balance> & source);
     template <typename Cmp2>
-    constexpr void merge(binary_search_tree<value_type, Cmp2, allocator_type> && source);
+    constexpr void merge(binary_search_tree<value_type, Cmp2, allocator_type, Stats, Balance> && source);
 
     /// Lookup
 protected:
@@ -174,6 +269,9 @@ protected:
     constexpr auto _find_impl(U const & x) -> node_pointer;
     template <typename U> requires meta::is_transparent_compare<Compare>
     constexpr auto _find_impl(U const & x) const -> node_const_pointer;
+    template <typename Self>
+    static constexpr iterator _end_of(Self && self) noexcept
+    { return iterator{const_cast<node_pointer>(std::addressof(self._end))}; }
     template <typename Self, typename U>
     static constexpr auto _lower_bound_impl(Self && self, U const & x);
     template <typename Self, typename U>
@@ -219,7 +317,7 @@ public:
 
     constexpr inline void swap(binary_search_tree & other)
         noexcept(noexcept(std::allocator_traits<node_allocator>::is_always_equal::value))
-    { base::swap(other); }
+    { base::swap(other); std::swap(_balance, other._balance); }
 
     friend constexpr bool operator==(binary_search_tree const & lhs, binary_search_tree const & rhs) noexcept
     { return lhs.size() == rhs.size() and std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend()); }
@@ -239,28 +337,66 @@ protected:
     constexpr inline
     static auto is_left_child(node const * root, node const * child) -> bool;
 
+    constexpr void _replace_child(node_pointer root, node_pointer old, node_pointer child) noexcept;
+    constexpr node_pointer _unlink_join(node_pointer unlink) noexcept;
+
     constexpr
-    static node_pointer _unlink_join(node_pointer unlink) noexcept;
+    static node_pointer _join(node_pointer left, node_pointer middle, node_pointer right) noexcept;
+    template <typename Join>
+    constexpr auto _split(node_pointer pivot, Join && join) noexcept -> std::pair<node_pointer, node_pointer>;
+    template <typename Join>
+    constexpr iterator _erase(iterator f, iterator l, Join && join);
+
+    // Every call to the comparator goes through here, to be counted
+    template <typename L, typename R>
+    constexpr inline bool _compare(L const & lhs, R const & rhs) const
+    {
+        _stats.compared();
+        return _cmp(lhs, rhs);
+    }
+    constexpr inline auto _comparator() const noexcept
+    { return [this](auto const & lhs, auto const & rhs) { return _compare(lhs, rhs); }; }
+    constexpr inline auto _descent() const noexcept { return detail::_descent<Stats>{_stats}; }
 
+    // Takes a spare node if there is one, and allocates a new one otherwise
     template <typename ...Args>
     constexpr inline
-    static _hold_ptr _construct_node(node_allocator & alloc, Args &&... args)
+    _hold_ptr _construct_node(node_allocator & alloc, Args &&... args)
     {
-        auto ptr = node_allocator_traits::allocate(alloc, 1);
-        auto hold = _hold_ptr(ptr, _node_deallocator(alloc));
-        node_allocator_traits::construct(alloc, hold.get());
+        auto hold = _hold_ptr(base::_pop_spare(), _node_deallocator(alloc));
+        if (hold == nullptr) {
+            _stats.allocated();
+            hold.reset(node_allocator_traits::allocate(alloc, 1));
+            node_allocator_traits::construct(alloc, hold.get());
+        }
         ++hold.get_deleter().constructed;
         node_allocator_traits::construct(alloc, std::addressof(hold->value()), std::forward<Args>(args)...);
         ++hold.get_deleter().constructed;
         return hold;
     }
 
+    // Replaces the elements with `n` new ones, constructed in order from the results of `make()`, and linked in a
+    // perfectly balanced tree without comparing them
+    template <typename Make>
+    constexpr void _assign_sorted(size_type n, Make && make);
+    // Constructs `n` nodes from the results of `make()`, chained in order through their right links; returns the
+    // first and the last one
+    template <typename Make>
+    constexpr auto _sorted_chain(size_type n, Make && make) -> std::pair<node_pointer, node_pointer>;
+    constexpr static node_pointer _balanced_subtree(node_pointer & chain, size_type n) noexcept;
+
+    // Keep the tree balanced as the `Balance` policy asks, after `n` has been linked or elements have been removed
+    constexpr void _rebuild_after_insertion(node_pointer n) noexcept;
+    constexpr void _rebuild_after_erasure() noexcept;
+    // Relinks the `count` nodes of the subtree rooted at `n` in a perfectly balanced subtree
+    constexpr void _rebuild(node_pointer n, size_type count) noexcept;
 
+    friend struct detail::_serialization_access;
 
 }; // class binary_search_tree
 
-template <typename T, typename Compare, typename Alloc>
-constexpr binary_search_tree<T, Compare, Alloc>::binary_search_tree(binary_search_tree const & other)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr binary_search_tree<T, Compare, Alloc, Stats, Balance>::binary_search_tree(binary_search_tree const & other)
     : base{
         std::allocator_traits<node_allocator>::select_on_container_copy_construction(other._node_alloc)
     }
@@ -268,66 +404,73 @@ constexpr binary_search_tree<T, Compare, Alloc>::binary_search_tree(binary_searc
     assign(other.begin(), other.end());
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr binary_search_tree<T, Compare, Alloc>::binary_search_tree(
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr binary_search_tree<T, Compare, Alloc, Stats, Balance>::binary_search_tree(
     binary_search_tree const & other, allocator_type const & a
 ) : base{a}
 {
     assign(other.begin(), other.end());
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-binary_search_tree<T, Compare, Alloc>::binary_search_tree(binary_search_tree && other)
-    : base{std::move(other._node_alloc)}
+binary_search_tree<T, Compare, Alloc, Stats, Balance>::binary_search_tree(binary_search_tree && other)
+    : base{other._node_alloc}
 {
-    assign(std::move_iterator(other.begin()), std::move_iterator(other.end()));
-    other._size = 0;
+    _steal(other);
+    _cmp = std::move(other._cmp);
+    _balance = other._balance;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-binary_search_tree<T, Compare, Alloc>::binary_search_tree(
+binary_search_tree<T, Compare, Alloc, Stats, Balance>::binary_search_tree(
     binary_search_tree && other, allocator_type const & alloc
 ) : base{alloc}
 {
-    assign(std::move_iterator(other.begin()), std::move_iterator(other.end()));
-    other._size = 0;
+    if (_node_alloc == other._node_alloc) {
+        _steal(other);
+    } else {
+        assign(std::move_iterator(other.begin()), std::move_iterator(other.end()));
+        other.clear();
+    }
+    _cmp = std::move(other._cmp);
+    _balance = other._balance;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-binary_search_tree<T, Compare, Alloc>::binary_search_tree(std::initializer_list<value_type> il)
+binary_search_tree<T, Compare, Alloc, Stats, Balance>::binary_search_tree(std::initializer_list<value_type> il)
     : binary_search_tree(il.begin(), il.end()) { }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-binary_search_tree<T, Compare, Alloc>::binary_search_tree(
+binary_search_tree<T, Compare, Alloc, Stats, Balance>::binary_search_tree(
     std::initializer_list<value_type> il, allocator_type const & a
 ) : binary_search_tree(il.begin(), il.end(), a) { }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename Iterator>
     requires detail::is_input_iterator_v<Iterator>
 constexpr
-binary_search_tree<T, Compare, Alloc>::binary_search_tree(Iterator f, Iterator l)
+binary_search_tree<T, Compare, Alloc, Stats, Balance>::binary_search_tree(Iterator f, Iterator l)
 {
     assign(std::move(f), std::move(l));
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename Iterator>
     requires detail::is_input_iterator_v<Iterator>
 constexpr
-binary_search_tree<T, Compare, Alloc>::binary_search_tree(Iterator f, Iterator l, allocator_type const & a) : base{a}
+binary_search_tree<T, Compare, Alloc, Stats, Balance>::binary_search_tree(Iterator f, Iterator l, allocator_type const & a) : base{a}
 {
     assign(std::move(f), std::move(l));
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr
-auto binary_search_tree<T, Compare, Alloc>::operator=(binary_search_tree const & other)
-    -> binary_search_tree<T, Compare, Alloc> &
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::operator=(binary_search_tree const & other)
+    -> binary_search_tree<T, Compare, Alloc, Stats, Balance> &
 {
     if (std::addressof(_end) == std::addressof(other._end)) {
         return *this;
@@ -335,7 +478,8 @@ auto binary_search_tree<T, Compare, Alloc>::operator=(binary_search_tree const &
     if constexpr (std::allocator_traits<node_allocator>::propagate_on_container_copy_assignment::value) {
         if (_node_alloc != other._node_alloc) {
             clear();
-            _node_alloc = other.alloc;
+            shrink_to_fit();
+            _node_alloc = other._node_alloc;
         }
     }
     assign(other.begin(), other.end());
@@ -343,10 +487,10 @@ auto binary_search_tree<T, Compare, Alloc>::operator=(binary_search_tree const &
     return *this;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr
-auto binary_search_tree<T, Compare, Alloc>::operator=(binary_search_tree && other)
-    -> binary_search_tree<T, Compare, Alloc> &
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::operator=(binary_search_tree && other)
+    -> binary_search_tree<T, Compare, Alloc, Stats, Balance> &
 {
     if (std::addressof(_end) == std::addressof(other._end)) {
         return *this;
@@ -354,54 +498,64 @@ auto binary_search_tree<T, Compare, Alloc>::operator=(binary_search_tree && othe
 
     if constexpr (std::allocator_traits<node_allocator>::propagate_on_container_move_assignment::value) {
         clear();
+        shrink_to_fit();
         _node_alloc = std::move(other._node_alloc);
-        _end = std::move(other._end);
-        _end.root->root = std::addressof(_end);
-        _size = std::move(other._size);
+        _steal(other);
     } else {
         if (_node_alloc != other._node_alloc) {
             auto const mbegin = std::move_iterator(other.begin());
             auto const mend = std::move_iterator(other.end());
             assign(mbegin, mend);
+            other.clear();
         } else {
             clear();
-            _end = std::move(other._end);
-            _end.root->root = std::addressof(_end);
-            _size = std::move(other._size);
+            _steal(other);
         }
     }
     _cmp = std::move(other._cmp);
-    other._size = 0;
-    other._set_end();
+    _balance = other._balance;
 
     return *this;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <class Iterator> requires detail::is_input_iterator_v<Iterator>
 constexpr inline
-void binary_search_tree<T, Compare, Alloc>::assign(Iterator f, Iterator l)
+void binary_search_tree<T, Compare, Alloc, Stats, Balance>::assign(Iterator f, Iterator l)
 {
-    clear();
+    base::_recycle();
+    _balance = Balance{};
     while (f != l) {
         emplace(*f++);
     }
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr
+void binary_search_tree<T, Compare, Alloc, Stats, Balance>::reserve(size_type n)
+{
+    while (capacity() < n) {
+        _stats.allocated();
+        auto const ptr = node_allocator_traits::allocate(_node_alloc, 1);
+        node_allocator_traits::construct(_node_alloc, ptr);
+        base::_push_spare(ptr);
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename ...Args>
 constexpr inline
-auto binary_search_tree<T, Compare, Alloc>::emplace(Args&&... args)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::emplace(Args&&... args)
     -> reference
 {
     auto _new_node = _construct_node(_node_alloc, std::forward<Args>(args)...);
     return _emplace(std::move(_new_node))->value();
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename Cmp2>
 constexpr
-void binary_search_tree<T, Compare, Alloc>::merge(binary_search_tree<value_type, Cmp2, allocator_type> & source)
+void binary_search_tree<T, Compare, Alloc, Stats, Balance>::merge(binary_search_tree<value_type, Cmp2, allocator_type, Stats, Balance> & source)
 {
     auto it = source.begin();
     while (it != source.end()) {
@@ -410,10 +564,10 @@ void binary_search_tree<T, Compare, Alloc>::merge(binary_search_tree<value_type,
     }
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename Cmp2>
 constexpr
-void binary_search_tree<T, Compare, Alloc>::merge(binary_search_tree<value_type, Cmp2, allocator_type> && source)
+void binary_search_tree<T, Compare, Alloc, Stats, Balance>::merge(binary_search_tree<value_type, Cmp2, allocator_type, Stats, Balance> && source)
 {
     auto it = source.begin();
     while (it != source.end()) {
@@ -422,27 +576,27 @@ void binary_search_tree<T, Compare, Alloc>::merge(binary_search_tree<value_type,
     }
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr
-auto binary_search_tree<T, Compare, Alloc>::insert(value_type const & value)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::insert(value_type const & value)
     -> iterator
 {
     auto _new_node = _construct_node(_node_alloc, value);
     return iterator{_emplace(std::move(_new_node))};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr
-auto binary_search_tree<T, Compare, Alloc>::insert(value_type && value)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::insert(value_type && value)
     -> iterator
 {
     auto _new_node = _construct_node(_node_alloc, std::move(value));
     return iterator{_emplace(std::move(_new_node))};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-auto binary_search_tree<T, Compare, Alloc>::insert(node_type && n)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::insert(node_type && n)
     -> iterator
 {
     auto hold = _hold_ptr(n._storage, _node_deallocator(_node_alloc));
@@ -452,9 +606,9 @@ auto binary_search_tree<T, Compare, Alloc>::insert(node_type && n)
     return iterator{_emplace(std::move(hold))};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-auto binary_search_tree<T, Compare, Alloc>::insert(const_iterator it, node_type && n)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::insert(const_iterator it, node_type && n)
     -> iterator
 {
     auto hold = _hold_ptr(n._storage, _node_deallocator(_node_alloc));
@@ -464,60 +618,146 @@ auto binary_search_tree<T, Compare, Alloc>::insert(const_iterator it, node_type
     return iterator{_emplace(it, std::move(hold))};
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr
-auto binary_search_tree<T, Compare, Alloc>::insert_unique(value_type const & value)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::insert_unique(value_type const & value)
     -> iterator
 {
-    auto found = lower_bound(value);
-    if (found != end()) {
-        return found;
-    }
-
-    auto _new_node = _construct_node(_node_alloc, value);
-    return iterator{_emplace(found, std::move(_new_node))};
+    return try_emplace_unique(value).first;
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr
-auto binary_search_tree<T, Compare, Alloc>::insert_unique(value_type && value)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::insert_unique(value_type && value)
     -> iterator
 {
-    auto found = lower_bound(value);
-    if (found != end()) {
-        return found;
-    }
-
-    auto _new_node = _construct_node(_node_alloc, std::move(value));
-    return iterator{_emplace(found, std::move(_new_node))};
+    return try_emplace_unique(value, std::move(value)).first;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-auto binary_search_tree<T, Compare, Alloc>::insert_unique(node_type && n)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::insert_unique(node_type && n)
     -> iterator
 {
-    auto found = lower_bound(n.value());
-    if (found != end()) {
-        return found;
+    auto const [found, root, left] = _find_slot(n.value());
+    if (found != nullptr) {
+        return iterator{found};
     }
 
     auto hold = _hold_ptr(n._storage, _node_deallocator(_node_alloc));
     hold.get_deleter().constructed = 2;
     n._storage = nullptr;
     n._consume();
-    return iterator{_emplace(std::move(hold))};
+    return iterator{_link(root, left, std::move(hold))};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+template <typename ...Args>
+constexpr
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::emplace_unique(Args &&... args)
+    -> std::pair<iterator, bool>
+{
+    if constexpr ((sizeof...(Args) == 1) and (std::is_same_v<std::remove_cvref_t<Args>, value_type> and ...)) {
+        return try_emplace_unique(args..., std::forward<Args>(args)...);
+    } else {
+        auto hold = _construct_node(_node_alloc, std::forward<Args>(args)...);
+        auto const [found, root, left] = _find_slot(hold->value());
+        if (found != nullptr) {
+            _discard(std::move(hold));
+            return {iterator{found}, false};
+        }
+        return {iterator{_link(root, left, std::move(hold))}, true};
+    }
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+template <typename K, typename ...Args>
+    requires std::is_same_v<K, T> or meta::is_transparent_compare<Compare>
 constexpr
-auto binary_search_tree<T, Compare, Alloc>::_emplace(const_iterator hint, _hold_ptr && hold)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::try_emplace_unique(K const & key, Args &&... args)
+    -> std::pair<iterator, bool>
+{
+    auto const [found, root, left] = _find_slot(key);
+    if (found != nullptr) {
+        return {iterator{found}, false};
+    }
+    if constexpr (sizeof...(Args) == 0) {
+        return {iterator{_link(root, left, _construct_node(_node_alloc, key))}, true};
+    } else {
+        return {iterator{_link(root, left, _construct_node(_node_alloc, std::forward<Args>(args)...))}, true};
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+template <typename U>
+constexpr
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_find_slot(U const & x) const
+    -> std::tuple<node_pointer, node_pointer, bool>
+{
+    auto root = const_cast<node_pointer>(std::addressof(_end));
+    auto left = false;
+    auto descent = _descent();
+    for (auto it = empty() ? nullptr : _root(); it != nullptr; descent.step()) {
+        if (_compare(x, it->value())) {
+            left = true;
+        } else if (_compare(it->value(), x)) {
+            left = false;
+        } else {
+            return {it, root, left};
+        }
+        root = it;
+        it = left ? it->left : it->right;
+    }
+    return {nullptr, root, left};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_find_multi_slot(value_type const & x) const
+    -> std::pair<node_pointer, bool>
+{
+    auto root = const_cast<node_pointer>(std::addressof(_end));
+    auto left = false;
+    auto descent = _descent();
+    for (auto it = empty() ? nullptr : _root(); it != nullptr; descent.step()) {
+        left = _compare(x, it->value());
+        root = it;
+        it = left ? it->left : it->right;
+    }
+    return {root, left};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_link(node_pointer root, bool left, _hold_ptr && hold) noexcept
+    -> node_pointer
+{
+    auto const n = hold.release();
+    detail::_link_leaf(root, left, n, std::addressof(_end));
+    ++_size;
+    _rebuild_after_insertion(n);
+    return n;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline
+void binary_search_tree<T, Compare, Alloc, Stats, Balance>::_discard(_hold_ptr && hold) noexcept
+{
+    auto const n = hold.release();
+    node_allocator_traits::destroy(_node_alloc, std::addressof(n->value()));
+    base::_push_spare(n);
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_emplace(const_iterator hint, _hold_ptr && hold)
     -> node_pointer
 {
     if (empty()) {
         hold->root = std::addressof(_end);
         _end.left = _end.right = _end.root = hold.release();
         ++_size;
+        _rebuild_after_insertion(_end.root);
         return _end.root;
     }
 
@@ -531,19 +771,19 @@ auto binary_search_tree<T, Compare, Alloc>::_emplace(const_iterator hint, _hold_
         ptr = root;
     }
 
-    if (not _cmp(ptr->value(), hold->value())) {
-        while (ptr != _end.root and not _cmp(ptr->value(), hold->value())) {
+    if (not _compare(ptr->value(), hold->value())) {
+        while (ptr != _end.root and not _compare(ptr->value(), hold->value())) {
             ptr = ptr->root;
         }
     }  else {
-        while (ptr != _end.root and not _cmp(hold->value(), ptr->value())) {
+        while (ptr != _end.root and not _compare(hold->value(), ptr->value())) {
             ptr = ptr->root;
         }
     }
 
-    while (true) {
+    for (auto descent = _descent(); ; descent.step()) {
         ++ptr->height;
-        if (_cmp(hold->value(), ptr->value())) {
+        if (_compare(hold->value(), ptr->value())) {
             if (ptr->left == nullptr) {
                 hold->root = ptr;
                 ptr->left = hold.release();
@@ -553,6 +793,7 @@ auto binary_search_tree<T, Compare, Alloc>::_emplace(const_iterator hint, _hold_
                     _first() = ptr;
                 }
                 ++_size;
+                _rebuild_after_insertion(ptr);
                 return ptr;
             }
             ptr = ptr->left;
@@ -565,6 +806,7 @@ auto binary_search_tree<T, Compare, Alloc>::_emplace(const_iterator hint, _hold_
                     _last() = ptr;
                 }
                 ++_size;
+                _rebuild_after_insertion(ptr);
                 return ptr;
             }
             ptr = ptr->right;
@@ -573,24 +815,27 @@ auto binary_search_tree<T, Compare, Alloc>::_emplace(const_iterator hint, _hold_
     __builtin_unreachable();
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-auto binary_search_tree<T, Compare, Alloc>::_emplace(_hold_ptr && hold)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_emplace(_hold_ptr && hold)
     -> node_pointer
 {
     return _emplace(const_iterator{_end.root}, std::move(hold));
 }
 
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto binary_search_tree<T, Compare, Alloc>::_find_impl(value_type const & x)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_find_impl(value_type const & x)
     -> node_pointer
 {
-    auto it = _root();
-    while (it != nullptr) {
-        if (_cmp(it->value(), x)) {
+    if (empty()) {
+        return nullptr;
+    }
+    auto descent = _descent();
+    for (auto it = _root(); it != nullptr; descent.step()) {
+        if (_compare(it->value(), x)) {
             it = it->right;
-        } else if (_cmp(x, it->value())) {
+        } else if (_compare(x, it->value())) {
             it = it->left;
         } else {
             return it;
@@ -599,15 +844,18 @@ constexpr auto binary_search_tree<T, Compare, Alloc>::_find_impl(value_type cons
     return nullptr;
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto binary_search_tree<T, Compare, Alloc>::_find_impl(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_find_impl(value_type const & x) const
     -> node_const_pointer
 {
-    auto it = _root();
-    while (it != nullptr) {
-        if (_cmp(it->value(), x)) {
+    if (empty()) {
+        return nullptr;
+    }
+    auto descent = _descent();
+    for (auto it = _root(); it != nullptr; descent.step()) {
+        if (_compare(it->value(), x)) {
             it = it->right;
-        } else if (_cmp(x, it->value())) {
+        } else if (_compare(x, it->value())) {
             it = it->left;
         } else {
             return it;
@@ -616,17 +864,20 @@ constexpr auto binary_search_tree<T, Compare, Alloc>::_find_impl(value_type cons
     return nullptr;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U>
     requires meta::is_transparent_compare<Compare>
-constexpr auto binary_search_tree<T, Compare, Alloc>::_find_impl(U const & x)
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_find_impl(U const & x)
     -> node_pointer
 {
-    auto it = _root();
-    while (it != nullptr) {
-        if (_cmp(it->value(), x)) {
+    if (empty()) {
+        return nullptr;
+    }
+    auto descent = _descent();
+    for (auto it = _root(); it != nullptr; descent.step()) {
+        if (_compare(it->value(), x)) {
             it = it->right;
-        } else if (_cmp(x, it->value())) {
+        } else if (_compare(x, it->value())) {
             it = it->left;
         } else {
             return it;
@@ -635,17 +886,20 @@ constexpr auto binary_search_tree<T, Compare, Alloc>::_find_impl(U const & x)
     return nullptr;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U>
     requires meta::is_transparent_compare<Compare>
-constexpr auto binary_search_tree<T, Compare, Alloc>::_find_impl(U const & x) const
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_find_impl(U const & x) const
     -> node_const_pointer
 {
-    auto it = _root();
-    while (it != nullptr) {
-        if (_cmp(it->value(), x)) {
+    if (empty()) {
+        return nullptr;
+    }
+    auto descent = _descent();
+    for (auto it = _root(); it != nullptr; descent.step()) {
+        if (_compare(it->value(), x)) {
             it = it->right;
-        } else if (_cmp(x, it->value())) {
+        } else if (_compare(x, it->value())) {
             it = it->left;
         } else {
             return it;
@@ -656,190 +910,175 @@ constexpr auto binary_search_tree<T, Compare, Alloc>::_find_impl(U const & x) co
 
 
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline bool binary_search_tree<T, Compare, Alloc>::contains(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline bool binary_search_tree<T, Compare, Alloc, Stats, Balance>::contains(value_type const & x) const
 {
     return _find_impl(x) != nullptr;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr inline auto binary_search_tree<T, Compare, Alloc>::contains(U const & x) const
+constexpr inline auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::contains(U const & x) const
     -> bool
 {
     return _find_impl(x) != nullptr;
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto binary_search_tree<T, Compare, Alloc>::find(value_type const & x)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::find(value_type const & x)
     -> iterator
 {
     auto found = _find_impl(x);
     return found ? iterator{found} : end();
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto binary_search_tree<T, Compare, Alloc>::find(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::find(value_type const & x) const
     -> const_iterator
 {
     auto found = _find_impl(x);
     return found ? const_iterator{found} : end();
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto binary_search_tree<T, Compare, Alloc>::find(U const & x)
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::find(U const & x)
     -> iterator
 {
     auto found = _find_impl(x);
     return _find_impl(x) ? iterator{found} : end();
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto binary_search_tree<T, Compare, Alloc>::find(U const & x) const
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::find(U const & x) const
     -> const_iterator
 {
     auto found = _find_impl(x);
     return found ? iterator{found} : end();
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename Self, typename U>
-constexpr auto binary_search_tree<T, Compare, Alloc>::_lower_bound_impl(Self && self, U const & x)
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_lower_bound_impl(Self && self, U const & x)
 {
-    auto it = self._root();
-    auto last = it;
-    while (it != nullptr) {
-        if (self._cmp(it->value(), x)) {
-            last = it;
+    auto res = _end_of(self)._current;
+    auto descent = self._descent();
+    for (auto it = self.empty() ? nullptr : self._root(); it != nullptr; descent.step()) {
+        if (self._compare(it->value(), x)) {
             it = it->right;
-        } else if (self._cmp(x, it->value())) {
-            last = it;
-            it = it->left;
         } else {
-            auto current = iterator{it};
-            auto tmp = current;
-            auto const bg = self.begin();
-            while (current != bg and *--current == *tmp) { tmp = current; }
-            return tmp;
+            res = it;
+            it = it->left;
         }
     }
-    auto res = iterator{last};
-    if (self._cmp(*res, x)) {
-        ++res;
-    }
-    return res;
+    return iterator{res};
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto binary_search_tree<T, Compare, Alloc>::lower_bound(value_type const & x)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::lower_bound(value_type const & x)
     -> iterator
 { return _lower_bound_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto binary_search_tree<T, Compare, Alloc>::lower_bound(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::lower_bound(value_type const & x) const
     -> const_iterator
 { return _lower_bound_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U>
     requires meta::is_transparent_compare<Compare>
-constexpr inline auto binary_search_tree<T, Compare, Alloc>::lower_bound(U const & x)
+constexpr inline auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::lower_bound(U const & x)
     -> iterator
 { return _lower_bound_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U>
     requires meta::is_transparent_compare<Compare>
-constexpr inline auto binary_search_tree<T, Compare, Alloc>::lower_bound(U const & x) const
+constexpr inline auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::lower_bound(U const & x) const
     -> const_iterator
 { return _lower_bound_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename Self, typename U>
-constexpr auto binary_search_tree<T, Compare, Alloc>::_upper_bound_impl(Self && self, U const & x)
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_upper_bound_impl(Self && self, U const & x)
 {
-    auto it = self._root();
-    auto last = it;
-    while (it != nullptr) {
-        if (self._cmp(it->value(), x)) {
-            last = it;
-            it = it->right;
-        } else if (self._cmp(x, it->value())) {
-            last = it;
+    auto res = _end_of(self)._current;
+    auto descent = self._descent();
+    for (auto it = self.empty() ? nullptr : self._root(); it != nullptr; descent.step()) {
+        if (self._compare(x, it->value())) {
+            res = it;
             it = it->left;
         } else {
-            return std::find_if(iterator{it}, self.end(), [&x, &self](auto && v) { return self._cmp(x, v); });
+            it = it->right;
         }
     }
-    auto res = iterator{last};
-    return std::find_if(res, self.end(), [&x, &self](auto && v) { return self._cmp(x, v); });
+    return iterator{res};
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto binary_search_tree<T, Compare, Alloc>::upper_bound(value_type const & x)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::upper_bound(value_type const & x)
     -> iterator
 { return _upper_bound_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto binary_search_tree<T, Compare, Alloc>::upper_bound(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::upper_bound(value_type const & x) const
     -> const_iterator
 { return _upper_bound_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto binary_search_tree<T, Compare, Alloc>::upper_bound(U const & x)
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::upper_bound(U const & x)
     -> iterator
 { return _upper_bound_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto binary_search_tree<T, Compare, Alloc>::upper_bound(U const & x) const
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::upper_bound(U const & x) const
     -> const_iterator
 { return _upper_bound_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename Self, typename U>
-constexpr auto binary_search_tree<T, Compare, Alloc>::_equal_range_impl(Self && self, U const & x)
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_equal_range_impl(Self && self, U const & x)
 {
     auto const lower = _lower_bound_impl(self, x);
-    auto const upper = std::find_if(lower, self.end(), [&x, &self](auto && v) { return self._cmp(x, v); });
+    auto const upper = std::find_if(lower, _end_of(self), [&x, &self](auto && v) { return self._compare(x, v); });
 
     return std::pair{lower, upper};
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto binary_search_tree<T, Compare, Alloc>::equal_range(value_type const & x)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::equal_range(value_type const & x)
     -> std::pair<iterator, iterator>
 { return _equal_range_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto binary_search_tree<T, Compare, Alloc>::equal_range(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::equal_range(value_type const & x) const
     -> std::pair<const_iterator, const_iterator>
 { return _equal_range_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto binary_search_tree<T, Compare, Alloc>::equal_range(U const & x)
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::equal_range(U const & x)
     -> std::pair<iterator, iterator>
 { return _equal_range_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename U> requires meta::is_transparent_compare<Compare>
-constexpr auto binary_search_tree<T, Compare, Alloc>::equal_range(U const & x) const
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::equal_range(U const & x) const
     -> std::pair<const_iterator, const_iterator>
 { return _equal_range_impl(*this, x); }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto binary_search_tree<T, Compare, Alloc>::count(value_type const & x) const
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::count(value_type const & x) const
     -> difference_type
 {
     auto lower = lower_bound(x);
     auto const end = this->end();
     size_type count = 0;
-    auto const equal = [&cmp = _cmp, &x](auto && v) {
-        return not cmp(x, v) and not cmp(v, x);
+    auto const equal = [this, &x](auto && v) {
+        return not _compare(x, v) and not _compare(v, x);
     };
     while (lower != end and equal(*lower++)) {
         ++count;
@@ -848,16 +1087,16 @@ constexpr auto binary_search_tree<T, Compare, Alloc>::count(value_type const & x
     return count;
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 template <typename K> requires meta::is_transparent_compare<Compare>
-constexpr auto binary_search_tree<T, Compare, Alloc>::count(K const & x) const
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::count(K const & x) const
     -> difference_type
 {
     auto lower = lower_bound(x);
     auto const end = this->end();
     size_type count = 0;
-    auto const equal = [&cmp = _cmp, &x](auto && v) {
-        return not cmp(x, v) and not cmp(v, x);
+    auto const equal = [this, &x](auto && v) {
+        return not _compare(x, v) and not _compare(v, x);
     };
     while (lower != end and equal(*lower++)) {
         ++count;
@@ -866,113 +1105,254 @@ constexpr auto binary_search_tree<T, Compare, Alloc>::count(K const & x) const
     return count;
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr inline auto binary_search_tree<T, Compare, Alloc>::is_left_child(node const * root, node const * child)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::is_left_child(node const * root, node const * child)
     -> bool
 { return root->left == child; }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto binary_search_tree<T, Compare, Alloc>::_unlink_join(node_pointer unlink) noexcept
-    -> node_pointer
-{
-    auto const root  = unlink->root;
-    auto const left  = unlink->left;
-    auto const right = unlink->right;
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline
+void binary_search_tree<T, Compare, Alloc, Stats, Balance>::_replace_child(node_pointer root, node_pointer old, node_pointer child)
+    noexcept
+{ detail::_replace_child(root, old, child, std::addressof(_end)); }
 
-    bool const is_left = is_left_child(root, unlink);
-    bool const has_left   = left  != nullptr;
-    bool const has_right  = right != nullptr;
+// Unlinks `unlink` from the tree, leaving it with no links. Returns the deepest node whose subtree changed,
+// which is where a rebalancing should start from (it may be `_end`, if the root was removed)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_unlink_join(node_pointer unlink) noexcept
+    -> node_pointer
+{ return detail::_unlink(unlink, std::addressof(_end)); }
 
-    if (not has_left and not has_right) { // no children
-        (is_left ? root->left : root->right) = nullptr;
-        unlink->root = nullptr;
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_extract(iterator it)
+    -> node_pointer
+{
+    if (size() == 1) {
+        it._current->root = nullptr;
+        _set_end();
+        --_size;
         return nullptr;
     }
-    if (has_left != has_right) { // one child
-        auto son = has_left ? left : right;
-        (is_left ? root->left : root->right) = son;
-        son->root = root;
+    if (it._current == _first()) {
+        _first() = std::next(it)._current;
+    } else if (it._current == _last()) {
+        _last() = std::prev(it)._current;
+    }
+    auto const changed = _unlink_join(it._current);
+    --_size;
+    return changed != std::addressof(_end) ? changed : nullptr;
+}
 
-        unlink->left = unlink->right = unlink->root = nullptr;
-        return nullptr;
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_join(
+    node_pointer left, node_pointer middle, node_pointer right
+) noexcept -> node_pointer
+{
+    middle->left = left;
+    middle->right = right;
+    if (left != nullptr) {
+        left->root = middle;
     }
-    // two children
-    auto repl = std::prev(iterator{unlink})._current;
-    auto exchange = [](node * unlink, node * repl) noexcept
-    {
-        if (unlink == nullptr or repl == nullptr) {
-            std::terminate();
+    if (right != nullptr) {
+        right->root = middle;
+    }
+    middle->height = _node_height(middle);
+    return middle;
+}
+
+// Splits the tree around `pivot` climbing from it toward the root, using `join(left, middle, right)` to merge
+// back the pieces: returns the roots of the subtrees holding the elements before and after `pivot`.
+// The returned roots and `pivot` are left unlinked, and `_end` is not updated.
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+template <typename Join>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_split(node_pointer pivot, Join && join) noexcept
+    -> std::pair<node_pointer, node_pointer>
+{
+    auto left  = pivot->left;
+    auto right = pivot->right;
+    auto child = pivot;
+    auto root  = pivot->root;
+
+    while (root != std::addressof(_end)) {
+        auto const next = root->root;
+        if (root->right == child) {
+            left = join(root->left, root, left);
+        } else {
+            right = join(right, root, root->right);
         }
+        child = root;
+        root = next;
+    }
 
-        auto & u_from_root = is_left_child(unlink->root, unlink) ? unlink->root->left : unlink->root->right;
-        auto & r_from_root = is_left_child(repl->root, repl)     ? repl->root->left   : repl->root->right;
-        std::swap(u_from_root, repl);
-        std::swap(r_from_root, unlink);
-        std::swap(unlink->left->root,  repl->left->root);
-        std::swap(unlink->right->root, repl->right->root);
-
-        std::swap(unlink->root,   repl->root);
-        std::swap(unlink->left,   repl->left);
-        std::swap(unlink->right,  repl->right);
-        std::swap(unlink->height, repl->height);
-    };
+    for (auto sub : {left, right}) {
+        if (sub != nullptr) {
+            sub->root = nullptr;
+        }
+    }
+    pivot->left = pivot->right = pivot->root = nullptr;
+    pivot->height = 0;
+    return {left, right};
+}
 
-    exchange(unlink, repl);
-    unlink->left = unlink->right = unlink->root = nullptr;
-    unlink->height = 0;
+// Erases [f, l) splitting the tree twice and joining back what is left, so that the cost is proportional to
+// the height of the tree plus the number of erased elements
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+template <typename Join>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_erase(iterator f, iterator l, Join && join)
+    -> iterator
+{
+    if (f == l) {
+        return l;
+    }
+    if (f == begin() and l == end()) {
+        clear();
+        return end();
+    }
+
+    auto const first = f._current;
+    auto const last  = l._current;
+    auto const new_back = l == end() ? std::prev(f)._current : _last();
+    auto const new_front = f == begin() ? last : _first();
+
+    auto after = node_pointer{nullptr};
+    if (l != end()) {
+        auto const [before, rest] = _split(last, join);
+        after = rest;
+        _end.root = before;
+        before->root = std::addressof(_end);
+    }
+    auto const [kept, erased] = _split(first, join);
+    auto const count = _destroy_subtree(erased) + _destroy_subtree(first);
+
+    auto const root = l != end() ? join(kept, last, after) : kept;
+    _end.root = root;
+    root->root = std::addressof(_end);
+    _first() = new_front;
+    _last() = new_back;
+    _size -= count;
+
+    return l;
+}
 
-    return repl;
+// The nodes are first constructed in a chain through their right links, so that nothing but the chain has to
+// be freed if `make` throws, then consumed in order by `_balanced_subtree`
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+template <typename Make>
+constexpr void binary_search_tree<T, Compare, Alloc, Stats, Balance>::_assign_sorted(size_type n, Make && make)
+{
+    base::_recycle();
+    _balance = Balance{};
+    if (n == 0) {
+        return;
+    }
+    auto const [head, tail] = _sorted_chain(n, make);
+    auto chain = head;
+    auto const root = _balanced_subtree(chain, n);
+    _end.root = root;
+    root->root = std::addressof(_end);
+    _first() = head;
+    _last() = tail;
+    _size = n;
 }
 
-template <typename T, typename Compare, typename Alloc>
-constexpr auto binary_search_tree<T, Compare, Alloc>::_extract(iterator it)
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+template <typename Make>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_sorted_chain(size_type n, Make && make)
+    -> std::pair<node_pointer, node_pointer>
+{
+    auto head = node_pointer{nullptr};
+    auto tail = node_pointer{nullptr};
+    try {
+        for (size_type i = 0; i < n; ++i) {
+            auto const ptr = _construct_node(_node_alloc, make()).release();
+            (tail != nullptr ? tail->right : head) = ptr;
+            tail = ptr;
+        }
+    } catch (...) {
+        while (head != nullptr) {
+            _destroy_node(std::exchange(head, head->right));
+        }
+        throw;
+    }
+    return {head, tail};
+}
+
+// Links the next `n` nodes of `chain` in a subtree whose left and right halves differ by at most one node, so
+// that it is balanced as an avl_tree too; returns its root, and advances `chain` past it
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_balanced_subtree(node_pointer & chain, size_type n) noexcept
     -> node_pointer
 {
-    auto new_anchor = _end;
-    if (size() > 1) {
-        if (it._current == _first()) {
-            if (std::next(it) != end()) {
-                new_anchor.right = std::next(it)._current;
-            } else {
-                new_anchor.right = std::addressof(_end);
-            }
-        } else if (it._current == _last()) {
-            if (it != begin()) {
-                new_anchor.left = std::prev(it)._current;
-            } else {
-                new_anchor.left = std::addressof(_end);
+    if (n == 0) {
+        return nullptr;
+    }
+    auto const left = _balanced_subtree(chain, n / 2);
+    auto const middle = chain;
+    chain = chain->right;
+    auto const right = _balanced_subtree(chain, n - n / 2 - 1);
+    return _join(left, middle, right);
+}
+
+// Looks for the scapegoat only when `n` is too deep: climbing from it, the size of each ancestor is the size of
+// the child on the path plus the size of the other child, so that the nodes counted are at most as many as the
+// nodes of the subtree rebuilt
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr void binary_search_tree<T, Compare, Alloc, Stats, Balance>::_rebuild_after_insertion(node_pointer n) noexcept
+{
+    if constexpr (Balance::rebuilds) {
+        _balance.max_size = std::max(_balance.max_size, size());
+        if (not Balance::too_deep(detail::_depth_of(n), size())) {
+            return;
+        }
+        auto child_size = size_type{1};
+        for (auto root = n->root; root != std::addressof(_end); n = root, root = root->root) {
+            auto const sibling = root->left == n ? root->right : root->left;
+            auto const root_size = child_size + 1 + detail::_subtree_size(sibling);
+            if (Balance::too_heavy(child_size, root_size)) {
+                _rebuild(root, root_size);
+                return;
             }
+            child_size = root_size;
         }
-        if (it._current == _root()) {
-            if (it != begin()) {
-                new_anchor.root = std::prev(it)._current;
-            } else {
-                new_anchor.root = std::next(it)._current;
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr void binary_search_tree<T, Compare, Alloc, Stats, Balance>::_rebuild_after_erasure() noexcept
+{
+    if constexpr (Balance::rebuilds) {
+        if (_balance.too_small(size())) {
+            if (not empty()) {
+                _rebuild(_root(), size());
             }
+            _balance.max_size = size();
         }
-    } else {
-        new_anchor.left = new_anchor.right = new_anchor.root = std::addressof(_end);
     }
-    // it may not be a leaf, in that case I need to swap it with an adiacent leaf value
-    auto repl = _unlink_join(it._current);
+}
 
-    _end = new_anchor;
-    --_size;
-    return repl;
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr void binary_search_tree<T, Compare, Alloc, Stats, Balance>::_rebuild(node_pointer n, size_type count) noexcept
+{
+    _stats.rebalanced();
+    auto const root = n->root;
+    auto chain = detail::_flatten(n);
+    _replace_child(root, n, _balanced_subtree(chain, count));
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-auto binary_search_tree<T, Compare, Alloc>::extract(iterator it)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::extract(iterator it)
     -> node_type
 {
     _extract(std::move(it));
+    _rebuild_after_erasure();
     return node_type{it._current, _node_alloc};
 }
 
-template <typename T, typename Compare, typename Alloc>
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
 constexpr inline
-auto binary_search_tree<T, Compare, Alloc>::extract(value_type const & value)
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::extract(value_type const & value)
     -> node_type
 {
     if (auto it = find(value); it != end()) {
@@ -981,6 +1361,112 @@ auto binary_search_tree<T, Compare, Alloc>::extract(value_type const & value)
     return {};
 }
 
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::erase(iterator it)
+    -> iterator
+{
+    auto const next = std::next(it);
+    _extract(it);
+    _destroy_node(it._current);
+    _rebuild_after_erasure();
+    return next;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::erase(iterator f, iterator l)
+    -> iterator
+{
+    if constexpr (Balance::rebuilds) {
+        // Splitting and joining without balancing could leave nodes deeper than the policy allows
+        while (f != l) {
+            f = erase(f);
+        }
+        return l;
+    } else {
+        return _erase(f, l, _join);
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr inline
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::erase(value_type const & value)
+    -> size_type
+{
+    auto const [f, l] = equal_range(value);
+    auto const old_size = size();
+    erase(f, l);
+    return old_size - size();
+}
+
+// If `f` throws, the element is erased, since its value may be out of order
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+template <typename F>
+constexpr
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::modify(iterator it, F && f)
+    -> iterator
+{
+    auto const n = it._current;
+    try {
+        std::invoke(std::forward<F>(f), n->value());
+    } catch (...) {
+        erase(it);
+        throw;
+    }
+    auto const from = _misplaced_from(n);
+    if (from == nullptr) {
+        return it;
+    }
+    _extract(it);
+    auto const [root, left] = detail::_finger_slot(from, n->value(), _comparator(), std::addressof(_end));
+    detail::_link_leaf(root, left, n, std::addressof(_end));
+    ++_size;
+    _rebuild_after_insertion(n);
+    return it;
+}
+
+// The neighbour of `n` from which to search for the new position of `n`, or nullptr if `n` is still ordered
+// with respect to its neighbours
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance>
+constexpr
+auto binary_search_tree<T, Compare, Alloc, Stats, Balance>::_misplaced_from(node_pointer n) const
+    -> node_pointer
+{
+    if (n != _first()) {
+        if (auto const prev = detail::_bst_prev(n); _compare(n->value(), prev->value())) {
+            return prev;
+        }
+    }
+    if (n != _last()) {
+        if (auto const next = detail::_bst_next(n); _compare(next->value(), n->value())) {
+            return next;
+        }
+    }
+    return nullptr;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Balance, typename Pred>
+constexpr
+auto erase_if(binary_search_tree<T, Compare, Alloc, Stats, Balance> & tree, Pred pred)
+    -> typename binary_search_tree<T, Compare, Alloc, Stats, Balance>::size_type
+{
+    auto const old_size = tree.size();
+    auto it = tree.begin();
+    while (it != tree.end()) {
+        if (not pred(*it)) {
+            ++it;
+            continue;
+        }
+        auto last = std::next(it);
+        while (last != tree.end() and pred(*last)) {
+            ++last;
+        }
+        it = tree.erase(it, last);
+    }
+    return old_size - tree.size();
+}
+
 } // namespace forest
 
 #endif /* BINARY_SEARCH_TREE_HPP */
@@ -0,0 +1,731 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : compact_avl_tree
+ * @created     : lunedì ott 19, 2026 11:56:03 CEST
+ * @license     : MIT
+ * */
+
+#ifndef COMPACT_AVL_TREE_HPP
+#define COMPACT_AVL_TREE_HPP
+
+#include <algorithm>        //std::equal, std::lexicographical_compare
+#include <array>            //std::array
+#include <bit>              //std::bit_width
+#include <initializer_list>
+#include <iterator>         //std::next, std::distance
+#include <limits>           //std::numeric_limits
+#include <memory>
+#include <type_traits>      //std::conditional_t
+#include <utility>          //std::pair, std::exchange
+
+#include "detail/utils.hpp"
+#include "detail/compact_node.hpp"
+#include "detail/stack_iterator.hpp"
+#include "detail/tree_algorithms.hpp" //forest::detail::_subtree_height
+
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+// The node layouts of `compact_avl_tree`. `stored_height`, the default, keeps the height of each node in a byte
+// after the links, where a value of 4 bytes or less would leave padding anyway. `packed_balance` keeps only the
+// difference between the heights of the children, in the lowest bit of each link: the nodes are one word
+// smaller for larger values, at the price of masking the links while descending
+struct stored_height
+{
+    static constexpr bool packed = false;
+}; // struct stored_height
+
+struct packed_balance
+{
+    static constexpr bool packed = true;
+}; // struct packed_balance
+
+// An avl_tree whose nodes have no parent link, which saves a pointer per element: a node holding an `int` takes
+// 24 bytes instead of 40. Iterators keep the path from the root, as the ones of `persistent_avl_tree`; the
+// updates record the links they followed on the way down, and rebalance climbing back through them. Every
+// update invalidates all the iterators of the tree
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>, class Layout = stored_height>
+class compact_avl_tree
+{
+protected:
+    using node                  = std::conditional_t<
+        Layout::packed, detail::packed_node<T>, detail::compact_node<T, std::int_fast8_t>
+    >;
+    using alloc_traits          = std::allocator_traits<Alloc>;
+    using node_allocator        = typename alloc_traits::template rebind_alloc<node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator>;
+    using node_pointer          = node *;
+    using node_const_pointer    = node const *;
+    using link_type             = typename node::link_type;
+
+public:
+    using key_type               = T;
+    using value_type             = T;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using allocator_type         = Alloc;
+    using reference              = value_type const &;
+    using const_reference        = value_type const &;
+    using pointer                = typename alloc_traits::const_pointer;
+    using const_pointer          = typename alloc_traits::const_pointer;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = detail::_stack_iterator<value_type, node>;
+    using const_iterator         = iterator;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = reverse_iterator;
+
+protected:
+    // The links followed by an update, from `_root` down: as many as the levels an iterator can hold
+    using _slot_path = std::array<link_type *, iterator::_max_depth>;
+
+    link_type _root = nullptr;
+    size_type _size = 0;
+    [[no_unique_address]] node_allocator _node_alloc;
+    [[no_unique_address]] key_compare _cmp;
+
+public:
+    constexpr inline compact_avl_tree() = default;
+    constexpr inline explicit compact_avl_tree(allocator_type const & a) noexcept : _node_alloc{a} {}
+
+    constexpr compact_avl_tree(compact_avl_tree const & other);
+    constexpr inline compact_avl_tree(compact_avl_tree && other) noexcept
+        : _root{std::exchange(other._root, nullptr)}, _size{std::exchange(other._size, 0)},
+          _node_alloc{std::move(other._node_alloc)}, _cmp{std::move(other._cmp)} {}
+
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr explicit compact_avl_tree(Iterator f, Iterator l, allocator_type const & a = allocator_type{})
+        : _node_alloc{a}
+    { assign(std::move(f), std::move(l)); }
+
+    constexpr compact_avl_tree(std::initializer_list<value_type> il, allocator_type const & a = allocator_type{})
+        : compact_avl_tree(il.begin(), il.end(), a) { }
+
+    inline ~compact_avl_tree() noexcept { clear(); }
+
+    constexpr compact_avl_tree & operator=(compact_avl_tree const & other);
+    constexpr compact_avl_tree & operator=(compact_avl_tree && other) noexcept;
+    constexpr inline
+    compact_avl_tree & operator=(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); return *this; }
+
+    constexpr inline
+    void assign(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); }
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr void assign(Iterator f, Iterator l);
+
+    constexpr inline
+    allocator_type get_allocator() const noexcept { return allocator_type(_node_alloc); }
+
+    /// Capacity
+    constexpr inline size_type size() const noexcept { return _size; }
+    [[nodiscard]] constexpr inline bool empty() const noexcept { return _size == 0; }
+    constexpr inline
+    size_type max_size() const noexcept
+    {
+        return std::min<size_type>(
+            node_allocator_traits::max_size(_node_alloc), std::numeric_limits<difference_type>::max()
+        );
+    }
+
+    /// Iterators
+    constexpr inline
+    const_iterator begin() const noexcept { auto it = const_iterator{_root}; it._descend(_root, true); return it; }
+    constexpr inline const_iterator end() const noexcept { return const_iterator{_root}; }
+    constexpr inline const_iterator cbegin() const noexcept { return begin(); }
+    constexpr inline const_iterator cend() const noexcept { return end(); }
+    constexpr inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    constexpr inline const_reverse_iterator crend() const noexcept { return rend(); }
+
+    /// Access
+    constexpr inline const_reference front() const { return *begin(); }
+    constexpr inline const_reference back() const { return *std::prev(end()); }
+
+    /// Modifiers
+    constexpr void clear() noexcept;
+    constexpr inline iterator insert(value_type const & value) { return _insert(_construct_node(value)); }
+    constexpr inline iterator insert(value_type && value) { return _insert(_construct_node(std::move(value))); }
+    template <typename ...Args>
+    constexpr inline iterator emplace(Args&&... args) { return _insert(_construct_node(std::forward<Args>(args)...)); }
+
+    constexpr iterator erase(const_iterator it);
+    constexpr iterator erase(const_iterator f, const_iterator l);
+    constexpr size_type erase(value_type const & value);
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr size_type erase(U const & value);
+
+    /// Lookup
+    constexpr auto count(value_type const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr auto count(U const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    constexpr inline bool contains(value_type const & x) const { return _find(x) != nullptr; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline bool contains(U const & x) const { return _find(x) != nullptr; }
+
+    constexpr inline const_iterator find(value_type const & x) const { return _find_iterator(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator find(U const & x) const { return _find_iterator(x); }
+
+    constexpr inline const_iterator lower_bound(value_type const & x) const
+    { return _bound([&](auto const & v) { return not _cmp(v, x); }); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator lower_bound(U const & x) const
+    { return _bound([&](auto const & v) { return not _cmp(v, x); }); }
+
+    constexpr inline const_iterator upper_bound(value_type const & x) const
+    { return _bound([&](auto const & v) { return _cmp(x, v); }); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator upper_bound(U const & x) const
+    { return _bound([&](auto const & v) { return _cmp(x, v); }); }
+
+    constexpr inline auto equal_range(value_type const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+
+    constexpr inline
+    void swap(compact_avl_tree & other) noexcept
+    {
+        using std::swap;
+        swap(_root, other._root);
+        swap(_size, other._size);
+        swap(_cmp, other._cmp);
+        if constexpr (node_allocator_traits::propagate_on_container_swap::value) {
+            swap(_node_alloc, other._node_alloc);
+        }
+    }
+
+    friend constexpr bool operator==(compact_avl_tree const & lhs, compact_avl_tree const & rhs) noexcept
+    { return lhs.size() == rhs.size() and std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend()); }
+    friend constexpr bool operator!=(compact_avl_tree const & lhs, compact_avl_tree const & rhs) noexcept
+    { return not (lhs == rhs); }
+    friend constexpr bool operator< (compact_avl_tree const & lhs, compact_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less{}); }
+    friend constexpr bool operator<=(compact_avl_tree const & lhs, compact_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less_equal{}); }
+    friend constexpr bool operator> (compact_avl_tree const & lhs, compact_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater{}); }
+    friend constexpr bool operator>=(compact_avl_tree const & lhs, compact_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater_equal{}); }
+
+protected:
+    template <typename ...Args>
+    constexpr node_pointer _construct_node(Args &&... args);
+    constexpr void _destroy_node(node_pointer n) noexcept;
+    // Replaces the elements with copies of the `n` sorted ones starting at `f`, linked without comparing them
+    template <typename Iterator>
+    constexpr void _assign_sorted(Iterator f, size_type n);
+    static constexpr node_pointer _balanced_subtree(node_pointer & chain, size_type n) noexcept;
+
+    constexpr iterator _insert(node_pointer n);
+    // Unlinks the node at the end of the first `depth` links of `slots`, which may be overwritten
+    constexpr void _unlink(_slot_path & slots, std::size_t depth) noexcept;
+    constexpr iterator _iterator_to(node_const_pointer n) const;
+
+    // Rebalance after the subtree linked by `slots[depth]` grew, or shrank, by one level
+    static constexpr void _rebalance_inserted(_slot_path const & slots, std::size_t depth) noexcept;
+    static constexpr void _rebalance_erased(_slot_path const & slots, std::size_t depth) noexcept;
+
+    /// stored_height
+    static constexpr void _rebalance_path(_slot_path const & slots, std::size_t depth) noexcept;
+    static constexpr void _rebalance(link_type & slot) noexcept;
+    static constexpr void _right_rotation(link_type & slot) noexcept;
+    static constexpr void _left_rotation(link_type & slot) noexcept;
+
+    /// packed_balance
+    static constexpr bool _rotate_taller(link_type & slot, bool left) noexcept;
+
+    template <typename U> constexpr node_const_pointer _find(U const & x) const;
+    template <typename U> constexpr const_iterator _find_iterator(U const & x) const;
+    template <typename GoLeft> constexpr const_iterator _bound(GoLeft && go_left) const;
+}; // class compact_avl_tree
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr compact_avl_tree<T, Compare, Alloc, Layout>::compact_avl_tree(compact_avl_tree const & other)
+    : _node_alloc{node_allocator_traits::select_on_container_copy_construction(other._node_alloc)},
+      _cmp{other._cmp}
+{
+    _assign_sorted(other.begin(), other.size());
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::operator=(compact_avl_tree const & other)
+    -> compact_avl_tree &
+{
+    if (this != std::addressof(other)) {
+        clear();
+        if constexpr (node_allocator_traits::propagate_on_container_copy_assignment::value) {
+            _node_alloc = other._node_alloc;
+        }
+        _cmp = other._cmp;
+        _assign_sorted(other.begin(), other.size());
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::operator=(compact_avl_tree && other) noexcept
+    -> compact_avl_tree &
+{
+    if (this != std::addressof(other)) {
+        clear();
+        if constexpr (node_allocator_traits::propagate_on_container_move_assignment::value) {
+            _node_alloc = std::move(other._node_alloc);
+        }
+        //NB: if _node_alloc != other._node_alloc, behavior is undefined
+        _cmp = std::move(other._cmp);
+        _root = std::exchange(other._root, nullptr);
+        _size = std::exchange(other._size, 0);
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::assign(Iterator f, Iterator l)
+{
+    clear();
+    while (f != l) {
+        emplace(*f++);
+    }
+}
+
+// Frees the nodes without recursion nor memory: while the current node has a left child it is rotated right,
+// and once it has none it is freed, going on with its right child
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::clear() noexcept
+{
+    auto n = node_pointer{std::exchange(_root, nullptr)};
+    while (n != nullptr) {
+        if (auto const left = node_pointer{n->left}; left != nullptr) {
+            n->left = left->right;
+            left->right = n;
+            n = left;
+        } else {
+            _destroy_node(std::exchange(n, n->right));
+        }
+    }
+    _size = 0;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+template <typename ...Args>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::_construct_node(Args &&... args)
+    -> node_pointer
+{
+    auto hold = std::unique_ptr<node, detail::_node_deallocator<node, node_allocator>>(
+        node_allocator_traits::allocate(_node_alloc, 1), detail::_node_deallocator<node, node_allocator>(_node_alloc)
+    );
+    node_allocator_traits::construct(_node_alloc, hold.get());
+    ++hold.get_deleter().constructed;
+    node_allocator_traits::construct(_node_alloc, std::addressof(hold->value()), std::forward<Args>(args)...);
+    ++hold.get_deleter().constructed;
+    return hold.release();
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::_destroy_node(node_pointer n) noexcept
+{
+    node_allocator_traits::destroy(_node_alloc, std::addressof(n->value()));
+    node_allocator_traits::destroy(_node_alloc, n);
+    node_allocator_traits::deallocate(_node_alloc, n, 1);
+}
+
+// The copies are first chained through their right links, so that only the chain has to be freed if a copy
+// throws, then linked by `_balanced_subtree`. The tree must be empty
+template <typename T, typename Compare, typename Alloc, typename Layout>
+template <typename Iterator>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::_assign_sorted(Iterator f, size_type n)
+{
+    auto head = node_pointer{nullptr};
+    auto tail = node_pointer{nullptr};
+    try {
+        for (size_type i = 0; i < n; ++i, ++f) {
+            auto const ptr = _construct_node(*f);
+            if (tail != nullptr) {
+                tail->right = ptr;
+            } else {
+                head = ptr;
+            }
+            tail = ptr;
+        }
+    } catch (...) {
+        while (head != nullptr) {
+            _destroy_node(std::exchange(head, head->right));
+        }
+        throw;
+    }
+    _root = _balanced_subtree(head, n);
+    _size = n;
+}
+
+// Links the next `n` nodes of `chain` in a subtree whose halves differ by at most one node, and advances `chain`
+// past them
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::_balanced_subtree(
+    node_pointer & chain, size_type n
+) noexcept
+    -> node_pointer
+{
+    if (n == 0) {
+        return nullptr;
+    }
+    auto const left = _balanced_subtree(chain, n / 2);
+    auto const middle = chain;
+    chain = chain->right;
+    middle->left = left;
+    middle->right = _balanced_subtree(chain, n - n / 2 - 1);
+    if constexpr (Layout::packed) {
+        // A balanced subtree of `k` nodes has `std::bit_width(k)` levels
+        detail::_set_balance(middle, static_cast<int>(std::bit_width(n - n / 2 - 1) - std::bit_width(n / 2)));
+    } else {
+        middle->height = detail::_subtree_height(middle);
+    }
+    return middle;
+}
+
+// Equivalent elements go after the existing ones, as in `avl_tree`
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::_insert(node_pointer n)
+    -> iterator
+{
+    auto slots = _slot_path{};
+    auto depth = std::size_t{0};
+    for (auto slot = std::addressof(_root); ; ) {
+        slots[depth++] = slot;
+        if (*slot == nullptr) {
+            break;
+        }
+        slot = _cmp(n->value(), (*slot)->value()) ? std::addressof((*slot)->left) : std::addressof((*slot)->right);
+    }
+    *slots[depth - 1] = n;
+    ++_size;
+    _rebalance_inserted(slots, depth - 1);
+    // The node is the last among its equivalents: follow its path to build the iterator
+    auto it = iterator{_root};
+    for (auto ptr = node_const_pointer{_root}; ptr != n;
+         ptr = _cmp(n->value(), ptr->value()) ? ptr->left : ptr->right) {
+        it._push(ptr);
+    }
+    it._push(n);
+    return it;
+}
+
+// The path kept by `it` tells which link of each node leads to the next one, so the node is unlinked without
+// comparing elements
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::erase(const_iterator it)
+    -> iterator
+{
+    auto const n = const_cast<node_pointer>(it._current());
+    auto const next = std::next(it);
+    auto const following = next != end() ? next._current() : nullptr;
+
+    auto slots = _slot_path{};
+    slots[0] = std::addressof(_root);
+    for (std::size_t i = 1; i < it._depth; ++i) {
+        auto const parent = const_cast<node_pointer>(it._path[i - 1]);
+        slots[i] = std::addressof(parent->left == it._path[i] ? parent->left : parent->right);
+    }
+    _unlink(slots, it._depth);
+    _destroy_node(n);
+    --_size;
+    return following != nullptr ? _iterator_to(following) : end();
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::erase(const_iterator f, const_iterator l)
+    -> iterator
+{
+    // Each erasure invalidates `l`, so count the elements instead
+    for (auto n = std::distance(f, l); n > 0; --n) {
+        f = erase(f);
+    }
+    return f;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::erase(value_type const & value)
+    -> size_type
+{
+    auto const old_size = size();
+    for (auto it = lower_bound(value); it != end() and not _cmp(value, *it);) {
+        it = erase(it);
+    }
+    return old_size - size();
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::erase(U const & value)
+    -> size_type
+{
+    auto const old_size = size();
+    for (auto it = lower_bound(value); it != end() and not _cmp(value, *it);) {
+        it = erase(it);
+    }
+    return old_size - size();
+}
+
+// A node with two children is replaced by the first node of its right subtree: the path is extended down to
+// it, and the link to the right subtree moves to the replacement before rebalancing from where it was taken
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::_unlink(_slot_path & slots, std::size_t depth) noexcept
+{
+    auto const at = depth - 1;
+    auto const n = node_pointer{*slots[at]};
+    if (n->left == nullptr or n->right == nullptr) {
+        *slots[at] = n->left != nullptr ? n->left : n->right;
+        _rebalance_erased(slots, at);
+        return;
+    }
+    slots[depth++] = std::addressof(n->right);
+    for (; (*slots[depth - 1])->left != nullptr; ++depth) {
+        slots[depth] = std::addressof((*slots[depth - 1])->left);
+    }
+    auto const next = node_pointer{*slots[depth - 1]};
+    *slots[depth - 1] = next->right;
+    next->left = n->left;
+    next->right = n->right;
+    if constexpr (Layout::packed) {
+        detail::_set_balance(next, detail::_balance_of(n));
+    } else {
+        next->height = n->height;
+    }
+    *slots[at] = next;
+    slots[at + 1] = std::addressof(next->right);
+    _rebalance_erased(slots, depth - 1);
+}
+
+// Equivalent elements are visited in order from their lower bound, until `n`
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::_iterator_to(node_const_pointer n) const
+    -> iterator
+{
+    auto it = lower_bound(n->value());
+    while (it._current() != n) {
+        ++it;
+    }
+    return it;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::_rebalance_inserted(
+    _slot_path const & slots, std::size_t depth
+) noexcept
+{
+    if constexpr (not Layout::packed) {
+        _rebalance_path(slots, depth);
+    } else {
+        // The growth stops at the first node which becomes balanced, or which is rotated
+        while (depth-- > 0) {
+            auto const n = node_pointer{*slots[depth]};
+            auto const left = slots[depth + 1] == std::addressof(n->left);
+            auto const balance = detail::_balance_of(n) + (left ? -1 : 1);
+            if (balance == 0 or balance == -1 or balance == 1) {
+                detail::_set_balance(n, balance);
+                if (balance == 0) {
+                    return;
+                }
+            } else {
+                _rotate_taller(*slots[depth], left);
+                return;
+            }
+        }
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::_rebalance_erased(
+    _slot_path const & slots, std::size_t depth
+) noexcept
+{
+    if constexpr (not Layout::packed) {
+        _rebalance_path(slots, depth);
+    } else {
+        // The shrinking stops at the first node which becomes unbalanced, or which keeps its height once rotated
+        while (depth-- > 0) {
+            auto const n = node_pointer{*slots[depth]};
+            auto const left = slots[depth + 1] == std::addressof(n->left);
+            auto const balance = detail::_balance_of(n) + (left ? 1 : -1);
+            if (balance == 0 or balance == -1 or balance == 1) {
+                detail::_set_balance(n, balance);
+                if (balance != 0) {
+                    return;
+                }
+            } else if (_rotate_taller(*slots[depth], not left)) {
+                return;
+            }
+        }
+    }
+}
+
+// Rebalances the nodes linked by the first `depth` links of `slots`, from the deepest one, and stops at the
+// first subtree whose height did not change: the ones above it are as they were
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::_rebalance_path(
+    _slot_path const & slots, std::size_t depth
+) noexcept
+{
+    while (depth-- > 0) {
+        auto const height = (*slots[depth])->height;
+        _rebalance(*slots[depth]);
+        if ((*slots[depth])->height == height) {
+            return;
+        }
+    }
+}
+
+// Restores the height and the balance of the node linked by `slot`
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::_rebalance(link_type & slot) noexcept
+{
+    auto const factor = [](node_const_pointer n) {
+        return detail::_height_of(n->left) - detail::_height_of(n->right);
+    };
+    auto const s = slot;
+    s->height = detail::_subtree_height(s);
+    if (auto const diff = factor(s); diff >= 2) {
+        if (factor(s->left) < 0) {
+            _left_rotation(s->left);
+        }
+        _right_rotation(slot);
+    } else if (diff <= -2) {
+        if (factor(s->right) > 0) {
+            _right_rotation(s->right);
+        }
+        _left_rotation(slot);
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::_right_rotation(link_type & slot) noexcept
+{
+    auto const v = slot;
+    auto const u = v->left;
+    v->left = u->right;
+    u->right = v;
+    slot = u;
+    v->height = detail::_subtree_height(v);
+    u->height = detail::_subtree_height(u);
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr void compact_avl_tree<T, Compare, Alloc, Layout>::_left_rotation(link_type & slot) noexcept
+{
+    auto const v = slot;
+    auto const u = v->right;
+    v->right = u->left;
+    u->left = v;
+    slot = u;
+    v->height = detail::_subtree_height(v);
+    u->height = detail::_subtree_height(u);
+}
+
+// Rotates the node linked by `slot`, whose `left` (or right) subtree is two levels taller than the other one,
+// setting the balance of the nodes moved from the cases of the rotation rather than from their heights. Returns
+// whether the subtree is as tall as before the rotation, which happens only after an erasure, when the taller
+// child was balanced
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr bool compact_avl_tree<T, Compare, Alloc, Layout>::_rotate_taller(link_type & slot, bool left) noexcept
+{
+    auto const child = [](node_pointer n, bool left) -> link_type & { return left ? n->left : n->right; };
+    auto const taller = left ? -1 : 1;
+    auto const n = node_pointer{slot};
+    auto const u = node_pointer{child(n, left)};
+    auto const u_balance = detail::_balance_of(u);
+    if (u_balance != -taller) { // single rotation
+        child(n, left) = child(u, not left);
+        child(u, not left) = n;
+        slot = u;
+        detail::_set_balance(n, u_balance == 0 ? taller : 0);
+        detail::_set_balance(u, u_balance == 0 ? -taller : 0);
+        return u_balance == 0;
+    }
+    auto const w = node_pointer{child(u, not left)}; // double rotation
+    auto const w_balance = detail::_balance_of(w);
+    child(u, not left) = child(w, left);
+    child(n, left) = child(w, not left);
+    child(w, left) = u;
+    child(w, not left) = n;
+    slot = w;
+    detail::_set_balance(u, w_balance == -taller ? taller : 0);
+    detail::_set_balance(n, w_balance == taller ? -taller : 0);
+    detail::_set_balance(w, 0);
+    return false;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+template <typename U>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::_find(U const & x) const
+    -> node_const_pointer
+{
+    auto n = node_const_pointer{_root};
+    while (n != nullptr) {
+        if (_cmp(x, n->value())) {
+            n = n->left;
+        } else if (_cmp(n->value(), x)) {
+            n = n->right;
+        } else {
+            return n;
+        }
+    }
+    return nullptr;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+template <typename U>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::_find_iterator(U const & x) const
+    -> const_iterator
+{
+    auto it = lower_bound(x);
+    return it != end() and not _cmp(x, *it) ? it : end();
+}
+
+// The path to the first node for which `go_left` holds, that is the last one where the descent went left
+template <typename T, typename Compare, typename Alloc, typename Layout>
+template <typename GoLeft>
+constexpr auto compact_avl_tree<T, Compare, Alloc, Layout>::_bound(GoLeft && go_left) const
+    -> const_iterator
+{
+    auto it = const_iterator{_root};
+    auto depth = std::size_t{0};
+    for (auto n = node_const_pointer{_root}; n != nullptr;) {
+        it._push(n);
+        if (go_left(n->value())) {
+            depth = it._depth;
+            n = n->left;
+        } else {
+            n = n->right;
+        }
+    }
+    it._depth = depth;
+    return it;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Layout>
+constexpr inline
+void swap(compact_avl_tree<T, Compare, Alloc, Layout> & lhs, compact_avl_tree<T, Compare, Alloc, Layout> & rhs) noexcept
+{ lhs.swap(rhs); }
+
+template <typename T, typename Compare, typename Alloc, typename Layout, typename Pred>
+constexpr
+auto erase_if(compact_avl_tree<T, Compare, Alloc, Layout> & tree, Pred pred)
+    -> typename compact_avl_tree<T, Compare, Alloc, Layout>::size_type
+{
+    auto const old_size = tree.size();
+    for (auto it = tree.begin(); it != tree.end();) {
+        it = pred(*it) ? tree.erase(it) : std::next(it);
+    }
+    return old_size - tree.size();
+}
+
+} // namespace forest
+
+#endif /* COMPACT_AVL_TREE_HPP */
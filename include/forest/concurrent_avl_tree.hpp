@@ -0,0 +1,607 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : concurrent_avl_tree
+ * @created     : domenica ott 18, 2026 19:40:05 CEST
+ * @license     : MIT
+ * */
+
+#ifndef CONCURRENT_AVL_TREE_HPP
+#define CONCURRENT_AVL_TREE_HPP
+
+#include <algorithm>        //std::find_if
+#include <atomic>           //std::atomic
+#include <initializer_list>
+#include <memory>
+#include <mutex>            //std::mutex, std::lock_guard
+#include <optional>         //std::optional
+#include <utility>          //std::pair
+#include <vector>           //std::vector
+
+#include "detail/utils.hpp"
+#include "detail/concurrent_node.hpp"
+#include "detail/epoch.hpp"
+
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+// An avl_tree whose lookups run concurrently with the modifications, without taking any lock.
+// Each node has a version, bumped by the writer whenever it changes the links of the node: readers descend
+// hand-over-hand, checking that the version of the parent did not change after reading the child, and start
+// over from the root if it did. A node is locked whenever the range of values its subtree may hold shrinks
+// (e.g. when a rotation moves it down), so a reader which reached a node is never led astray by later changes.
+// Writers are serialized by a mutex that readers never touch, and lock only the nodes whose links they change.
+//
+// The lookups return copies of the values, since the elements may be erased concurrently. Erased nodes are not
+// freed right away, because a reader may still be visiting them: each lookup pins an epoch (see
+// `detail::_epoch_domain`), and the writers free a retired node once no pinned epoch is as old as the node.
+// They try every `reclaim_threshold` retired nodes; `reclaim()` tries right away
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>>
+class concurrent_avl_tree
+{
+protected:
+    using node                  = detail::concurrent_node<T, std::int_fast8_t>;
+    using alloc_traits          = std::allocator_traits<Alloc>;
+    using node_allocator        = typename alloc_traits::template rebind_alloc<node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator>;
+    using node_pointer          = node *;
+    using node_const_pointer    = node const *;
+    using version_type          = typename node::version_type;
+    using epoch_type            = detail::_epoch_domain::epoch_type;
+    using retired_node          = std::pair<node_pointer, epoch_type>;
+    using retired_list          = std::vector<retired_node, typename alloc_traits::template rebind_alloc<retired_node>>;
+
+public:
+    using key_type        = T;
+    using value_type      = T;
+    using key_compare     = Compare;
+    using value_compare   = Compare;
+    using allocator_type  = Alloc;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static constexpr size_type reclaim_threshold = 64;
+
+protected:
+    // _head.left is the root; _head is never erased nor rotated
+    node _head;
+    std::atomic<size_type> _size = 0;
+    mutable std::mutex _writer;
+    [[no_unique_address]] node_allocator _node_alloc;
+    [[no_unique_address]] key_compare _cmp;
+    retired_list _retired;       // in retirement order, so their epochs never decrease
+    detail::_epoch_domain _epochs;
+
+public:
+    inline concurrent_avl_tree() : _retired(allocator_type{}) {}
+    inline explicit concurrent_avl_tree(allocator_type const & a) : _node_alloc{a}, _retired(a) {}
+
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    explicit concurrent_avl_tree(Iterator f, Iterator l, allocator_type const & a = allocator_type{})
+        : concurrent_avl_tree(a)
+    { for (; f != l; ++f) { insert(*f); } }
+
+    concurrent_avl_tree(std::initializer_list<value_type> il, allocator_type const & a = allocator_type{})
+        : concurrent_avl_tree(il.begin(), il.end(), a) { }
+
+    concurrent_avl_tree(concurrent_avl_tree const &) = delete;
+    concurrent_avl_tree & operator=(concurrent_avl_tree const &) = delete;
+
+    inline ~concurrent_avl_tree() noexcept { _destroy_subtree(_root()); _free_retired(_retired.size()); }
+
+    inline allocator_type get_allocator() const noexcept { return allocator_type(_node_alloc); }
+
+    /// Capacity
+    inline size_type size() const noexcept { return _size.load(std::memory_order_relaxed); }
+    [[nodiscard]] inline bool empty() const noexcept { return size() == 0; }
+
+    /// Modifiers: they are serialized with each other
+    inline void insert(value_type const & value) { _insert(_construct_node(value), false); }
+    inline void insert(value_type && value) { _insert(_construct_node(std::move(value)), false); }
+    template <typename ...Args>
+    inline void emplace(Args &&... args) { _insert(_construct_node(std::forward<Args>(args)...), false); }
+    // Inserts `value` only if no equivalent element is in the tree; returns true if it did
+    inline bool insert_unique(value_type const & value) { return _insert(_construct_node(value), true); }
+    inline bool insert_unique(value_type && value) { return _insert(_construct_node(std::move(value)), true); }
+
+    // Erases every element equivalent to `x`, returning how many
+    inline size_type erase(value_type const & x) { return _erase(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline size_type erase(U const & x) { return _erase(x); }
+
+    // Detaches every element; the nodes are retired
+    void clear();
+    // Frees the retired nodes that no reader can reach anymore
+    void reclaim();
+
+    /// Lookup: lock-free, they can run concurrently with each other and with the modifiers
+    inline bool contains(value_type const & x) const
+    { auto const pin = _epochs.pin(); return _find(x) != nullptr; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline bool contains(U const & x) const
+    { auto const pin = _epochs.pin(); return _find(x) != nullptr; }
+
+    inline auto find(value_type const & x) const -> std::optional<value_type>
+    { auto const pin = _epochs.pin(); return _copy(_find(x)); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto find(U const & x) const -> std::optional<value_type>
+    { auto const pin = _epochs.pin(); return _copy(_find(x)); }
+
+    // The first element not less than `x`, if any
+    inline auto lower_bound(value_type const & x) const -> std::optional<value_type>
+    {
+        auto const pin = _epochs.pin();
+        return _copy(_bound(x, [this](auto const & v, auto const & y) { return not _cmp(v, y); }));
+    }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto lower_bound(U const & x) const -> std::optional<value_type>
+    {
+        auto const pin = _epochs.pin();
+        return _copy(_bound(x, [this](auto const & v, auto const & y) { return not _cmp(v, y); }));
+    }
+
+    // The first element greater than `x`, if any
+    inline auto upper_bound(value_type const & x) const -> std::optional<value_type>
+    {
+        auto const pin = _epochs.pin();
+        return _copy(_bound(x, [this](auto const & v, auto const & y) { return _cmp(y, v); }));
+    }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto upper_bound(U const & x) const -> std::optional<value_type>
+    {
+        auto const pin = _epochs.pin();
+        return _copy(_bound(x, [this](auto const & v, auto const & y) { return _cmp(y, v); }));
+    }
+
+    // Calls `f` on every element, in order, while holding the writer lock
+    template <typename F>
+    void for_each(F && f) const;
+
+protected:
+    template <typename ...Args>
+    node_pointer _construct_node(Args &&... args);
+    void _destroy_node(node_pointer n) noexcept;
+    void _destroy_subtree(node_pointer top) noexcept;
+    void _free_retired(size_type count) noexcept;
+    void _reclaim_locked() noexcept;
+    template <typename F> void _in_order(F && f) const;
+    static inline std::optional<value_type> _copy(node_const_pointer n)
+    { return n != nullptr ? std::optional<value_type>{n->value()} : std::nullopt; }
+
+    inline node_pointer _root() const noexcept { return _head.get_left(); }
+
+    bool _insert(node_pointer n, bool unique);
+    template <typename U> size_type _erase(U const & x);
+    void _unlink(node_pointer n);
+    void _replace_child(node_pointer root, node_pointer old, node_pointer child) noexcept;
+    template <typename U> node_pointer _find_locked(U const & x) const;
+
+    template <typename U> node_const_pointer _find(U const & x) const;
+    template <typename U, typename GoLeft> node_const_pointer _bound(U const & x, GoLeft && go_left) const;
+
+    void _balance_from(node_pointer ptr) noexcept;
+    void _right_rotation(node_pointer const v) noexcept;
+    void _left_rotation(node_pointer const v) noexcept;
+}; // class concurrent_avl_tree
+
+template <typename T, typename Compare, typename Alloc>
+template <typename ...Args>
+auto concurrent_avl_tree<T, Compare, Alloc>::_construct_node(Args &&... args)
+    -> node_pointer
+{
+    auto hold = std::unique_ptr<node, detail::_node_deallocator<node, node_allocator>>(
+        node_allocator_traits::allocate(_node_alloc, 1), detail::_node_deallocator<node, node_allocator>(_node_alloc)
+    );
+    node_allocator_traits::construct(_node_alloc, hold.get());
+    ++hold.get_deleter().constructed;
+    node_allocator_traits::construct(_node_alloc, std::addressof(hold->value()), std::forward<Args>(args)...);
+    ++hold.get_deleter().constructed;
+    return hold.release();
+}
+
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::_destroy_node(node_pointer n) noexcept
+{
+    node_allocator_traits::destroy(_node_alloc, std::addressof(n->value()));
+    node_allocator_traits::destroy(_node_alloc, n);
+    node_allocator_traits::deallocate(_node_alloc, n, 1);
+}
+
+// Frees every node in the subtree rooted at `top`, without recursion. No reader may be visiting them
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::_destroy_subtree(node_pointer top) noexcept
+{
+    if (top == nullptr) {
+        return;
+    }
+    auto const stop = top->root;
+    auto it = top;
+    while (it != stop) {
+        if (auto const l = it->get_left(); l != nullptr) {
+            it->set_left(nullptr);
+            it = l;
+        } else if (auto const r = it->get_right(); r != nullptr) {
+            it->set_right(nullptr);
+            it = r;
+        } else {
+            auto const del = it;
+            it = it->root;
+            _destroy_node(del);
+        }
+    }
+}
+
+// Calls `f` on every node, in order, climbing through the parent links: only the writer may call it
+template <typename T, typename Compare, typename Alloc>
+template <typename F>
+void concurrent_avl_tree<T, Compare, Alloc>::_in_order(F && f) const
+{
+    auto n = _root();
+    if (n == nullptr) {
+        return;
+    }
+    while (n->get_left() != nullptr) {
+        n = n->get_left();
+    }
+    auto const head = std::addressof(_head);
+    while (n != head) {
+        auto const current = n;
+        if (auto r = n->get_right(); r != nullptr) {
+            while (r->get_left() != nullptr) {
+                r = r->get_left();
+            }
+            n = r;
+        } else {
+            auto prev = n;
+            n = n->root;
+            while (n != head and n->get_right() == prev) {
+                prev = n;
+                n = n->root;
+            }
+        }
+        f(current);
+    }
+}
+
+// The detached nodes are unreachable afterwards, but readers may still be visiting them: they are retired
+// with their links untouched
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::clear()
+{
+    auto const guard = std::lock_guard{_writer};
+    if (_root() == nullptr) {
+        return;
+    }
+    _retired.reserve(_retired.size() + size());
+    auto const epoch = _epochs.current(); // only the writers advance the epoch
+    _in_order([this, epoch](node_pointer n) { _retired.emplace_back(n, epoch); });
+    _head.lock();
+    _head.set_left(nullptr);
+    _head.unlock();
+    _size.store(0, std::memory_order_relaxed);
+    _reclaim_locked();
+}
+
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::reclaim()
+{
+    auto const guard = std::lock_guard{_writer};
+    _reclaim_locked();
+}
+
+// Moves to a new epoch, and frees the nodes retired before the oldest pinned one. Only the writer may call it
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::_reclaim_locked() noexcept
+{
+    auto const oldest = _epochs.advance();
+    auto const it = std::find_if(_retired.begin(), _retired.end(), [oldest](retired_node const & r) {
+        return r.second >= oldest;
+    });
+    _free_retired(static_cast<size_type>(it - _retired.begin()));
+}
+
+// Frees the first `count` retired nodes
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::_free_retired(size_type count) noexcept
+{
+    auto const last = _retired.begin() + static_cast<difference_type>(count);
+    for (auto it = _retired.begin(); it != last; ++it) {
+        _destroy_node(it->first);
+    }
+    _retired.erase(_retired.begin(), last);
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename F>
+void concurrent_avl_tree<T, Compare, Alloc>::for_each(F && f) const
+{
+    auto const guard = std::lock_guard{_writer};
+    _in_order([&f](node_const_pointer n) { f(n->value()); });
+}
+
+/// Readers
+// Hand-over-hand optimistic descent: the child pointer is trusted only after the version of its parent is
+// validated, and so is the version of the child, which is then used to validate the next step
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+auto concurrent_avl_tree<T, Compare, Alloc>::_find(U const & x) const
+    -> node_const_pointer
+{
+restart:
+    node_const_pointer parent = std::addressof(_head);
+    auto pv = parent->stable_version();
+    auto go_left = true;
+    while (true) {
+        auto const n = parent->child(go_left);
+        if (not parent->validate(pv)) {
+            goto restart;
+        }
+        if (n == nullptr) {
+            return nullptr;
+        }
+        auto const nv = n->stable_version();
+        if (not parent->validate(pv)) {
+            goto restart;
+        }
+        if (_cmp(x, n->value())) {
+            go_left = true;
+        } else if (_cmp(n->value(), x)) {
+            go_left = false;
+        } else {
+            return n;
+        }
+        parent = n;
+        pv = nv;
+    }
+}
+
+// The last node where the descent for `x` went left, i.e. the first one for which `go_left(value, x)` holds.
+// Its version is checked again at the end, since it may have been erased while the descent went on
+template <typename T, typename Compare, typename Alloc>
+template <typename U, typename GoLeft>
+auto concurrent_avl_tree<T, Compare, Alloc>::_bound(U const & x, GoLeft && go_left) const
+    -> node_const_pointer
+{
+restart:
+    node_const_pointer parent = std::addressof(_head);
+    auto pv = parent->stable_version();
+    node_const_pointer candidate = nullptr;
+    auto cv = version_type{0};
+    auto left = true;
+    while (true) {
+        auto const n = parent->child(left);
+        if (not parent->validate(pv)) {
+            goto restart;
+        }
+        if (n == nullptr) {
+            if (candidate != nullptr and not candidate->validate(cv)) {
+                goto restart;
+            }
+            return candidate;
+        }
+        auto const nv = n->stable_version();
+        if (not parent->validate(pv)) {
+            goto restart;
+        }
+        left = go_left(n->value(), x);
+        if (left) {
+            candidate = n;
+            cv = nv;
+        }
+        parent = n;
+        pv = nv;
+    }
+}
+
+/// Writers
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+auto concurrent_avl_tree<T, Compare, Alloc>::_find_locked(U const & x) const
+    -> node_pointer
+{
+    auto n = _root();
+    while (n != nullptr) {
+        if (_cmp(x, n->value())) {
+            n = n->get_left();
+        } else if (_cmp(n->value(), x)) {
+            n = n->get_right();
+        } else {
+            return n;
+        }
+    }
+    return nullptr;
+}
+
+// Links `n` as a leaf, locking only its parent, then rebalances. If `unique` and an equivalent element is
+// found, `n` is destroyed
+template <typename T, typename Compare, typename Alloc>
+bool concurrent_avl_tree<T, Compare, Alloc>::_insert(node_pointer n, bool unique)
+{
+    auto guard = std::unique_lock{_writer};
+    auto root = std::addressof(_head);
+    auto left = true;
+    for (auto it = _root(); it != nullptr; it = left ? it->get_left() : it->get_right()) {
+        root = it;
+        left = _cmp(n->value(), it->value());
+        if (unique and not left and not _cmp(it->value(), n->value())) {
+            guard.unlock();
+            _destroy_node(n);
+            return false;
+        }
+    }
+    n->root = root;
+    root->lock();
+    left ? root->set_left(n) : root->set_right(n);
+    root->unlock();
+    _size.fetch_add(1, std::memory_order_relaxed);
+    _balance_from(root);
+    return true;
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+auto concurrent_avl_tree<T, Compare, Alloc>::_erase(U const & x)
+    -> size_type
+{
+    auto const guard = std::lock_guard{_writer};
+    auto count = size_type{0};
+    for (auto n = _find_locked(x); n != nullptr; n = _find_locked(x)) {
+        _retired.reserve(_retired.size() + 1); // a reader may still be visiting `n`: retire it
+        _unlink(n);
+        _retired.emplace_back(n, _epochs.current());
+        ++count;
+    }
+    if (_retired.size() >= reclaim_threshold) {
+        _reclaim_locked();
+    }
+    return count;
+}
+
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::_replace_child(node_pointer root, node_pointer old,
+                                                            node_pointer child) noexcept
+{
+    if (root->get_left() == old) {
+        root->set_left(child);
+    } else {
+        root->set_right(child);
+    }
+    if (child != nullptr) {
+        child->root = root;
+    }
+}
+
+// Unlinks `n` and rebalances. With two children, its predecessor takes its place: the nodes on the right spine
+// of its left subtree, down to the predecessor, are locked too, since their range of values shrinks
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::_unlink(node_pointer n)
+{
+    auto const root  = n->root;
+    auto const left  = n->get_left();
+    auto const right = n->get_right();
+    auto changed = root;
+
+    root->lock();
+    n->lock();
+    if (left == nullptr or right == nullptr) {
+        _replace_child(root, n, left != nullptr ? left : right);
+        n->unlock();
+        root->unlock();
+    } else {
+        auto repl = left;
+        repl->lock();
+        while (repl->get_right() != nullptr) {
+            repl = repl->get_right();
+            repl->lock();
+        }
+        if (repl == left) {
+            changed = repl;
+        } else {
+            changed = repl->root;
+            changed->set_right(repl->get_left());
+            if (repl->get_left() != nullptr) {
+                repl->get_left()->root = changed;
+            }
+            repl->set_left(left);
+            left->root = repl;
+        }
+        repl->set_right(right);
+        right->root = repl;
+        repl->height = n->height;
+        _replace_child(root, n, repl);
+
+        n->unlock();
+        root->unlock();
+        for (auto it = left; it != repl; it = it->get_right()) { // down to `changed`, whose right link changed
+            it->unlock();
+            if (it == changed) {
+                break;
+            }
+        }
+        repl->unlock();
+    }
+    _size.fetch_sub(1, std::memory_order_relaxed);
+    _balance_from(changed);
+}
+
+// Restores heights and balance from `ptr` (included) up to the root
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::_balance_from(node_pointer ptr) noexcept
+{
+    auto const factor = [](node_const_pointer n) {
+        return detail::_height_of(n->get_left()) - detail::_height_of(n->get_right());
+    };
+    for (auto const head = std::addressof(_head); ptr != head; ptr = ptr->root) {
+        ptr->height = detail::_node_height(ptr);
+        if (auto const diff = factor(ptr); diff >= 2) {
+            if (factor(ptr->get_left()) < 0) {
+                _left_rotation(ptr->get_left());
+            }
+            _right_rotation(ptr);
+        } else if (diff <= -2) {
+            if (factor(ptr->get_right()) > 0) {
+                _right_rotation(ptr->get_right());
+            }
+            _left_rotation(ptr);
+        }
+    }
+}
+
+// `v` moves down, so its range shrinks: it is locked together with its parent and its left child, whose
+// links change too
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::_right_rotation(node_pointer const v) noexcept
+{
+    auto const root = v->root;
+    auto const u  = v->get_left();
+    auto const ur = u->get_right();
+
+    root->lock();
+    v->lock();
+    u->lock();
+    _replace_child(root, v, u);
+    v->set_left(ur);
+    u->set_right(v);
+    u->unlock();
+    v->unlock();
+    root->unlock();
+
+    v->root = u;
+    if (ur != nullptr) {
+        ur->root = v;
+    }
+    v->height = detail::_node_height(v);
+    u->height = detail::_node_height(u);
+}
+
+template <typename T, typename Compare, typename Alloc>
+void concurrent_avl_tree<T, Compare, Alloc>::_left_rotation(node_pointer const v) noexcept
+{
+    auto const root = v->root;
+    auto const u  = v->get_right();
+    auto const ul = u->get_left();
+
+    root->lock();
+    v->lock();
+    u->lock();
+    _replace_child(root, v, u);
+    v->set_right(ul);
+    u->set_left(v);
+    u->unlock();
+    v->unlock();
+    root->unlock();
+
+    v->root = u;
+    if (ul != nullptr) {
+        ul->root = v;
+    }
+    v->height = detail::_node_height(v);
+    u->height = detail::_node_height(u);
+}
+
+} // namespace forest
+
+#endif /* CONCURRENT_AVL_TREE_HPP */
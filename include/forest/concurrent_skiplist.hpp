@@ -0,0 +1,537 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : concurrent_skiplist
+ * @created     : lunedì ott 19, 2026 00:34:52 CEST
+ * @license     : MIT
+ * */
+
+#ifndef CONCURRENT_SKIPLIST_HPP
+#define CONCURRENT_SKIPLIST_HPP
+
+#include <algorithm>        //std::min
+#include <array>            //std::array
+#include <atomic>           //std::atomic
+#include <bit>              //std::countr_one
+#include <functional>       //std::hash, std::less
+#include <initializer_list>
+#include <memory>
+#include <optional>         //std::optional
+#include <random>           //std::mt19937
+#include <thread>           //std::this_thread
+#include <utility>          //std::pair
+
+#include "detail/utils.hpp"
+#include "detail/epoch.hpp"
+#include "detail/skiplist_node.hpp"
+
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+// A multiset whose insertions, extractions and lookups are all lock-free: a skip list with Harris' marked links
+// (as in Herlihy and Shavit's lock-free skip list), whose nodes are freed by epoch based reclamation.
+// An element is inserted once it is linked in the lowest level, and extracted once its lowest link is marked;
+// marked nodes are unlinked from every level by the extracting thread, and by any traversal that meets them.
+// Equivalent elements are kept in the order of their addresses, so that every level agrees on their order.
+//
+// Like `concurrent_avl_tree`, the lookups return copies of the values and the tree has no iterators:
+// `for_each(f)` visits the elements in order, without seeing a consistent snapshot if modifications run
+// concurrently. The allocator must be thread safe
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>>
+class concurrent_skiplist
+{
+protected:
+    using node                  = detail::skiplist_node<T>;
+    using alloc_traits          = std::allocator_traits<Alloc>;
+    using node_allocator        = typename alloc_traits::template rebind_alloc<node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator>;
+    using node_pointer          = node *;
+    using node_const_pointer    = node const *;
+    using path                  = std::array<node_pointer, node::max_level>;
+
+public:
+    using key_type        = T;
+    using value_type      = T;
+    using key_compare     = Compare;
+    using value_compare   = Compare;
+    using allocator_type  = Alloc;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static constexpr size_type reclaim_threshold = 64;
+
+protected:
+    [[no_unique_address]] node_allocator _node_alloc;
+    [[no_unique_address]] key_compare _cmp;
+    node_pointer _head;                             // a tower of `node::max_level` links, without value
+    std::atomic<size_type> _size = 0;
+    std::atomic<node_pointer> _retired = nullptr;   // a stack, linked through `retired_next`
+    std::atomic<size_type> _retired_count = 0;
+    detail::_epoch_domain _epochs;
+
+public:
+    inline concurrent_skiplist() : concurrent_skiplist(allocator_type{}) {}
+    inline explicit concurrent_skiplist(allocator_type const & a) : _node_alloc{a}, _head{_allocate(node::max_level)} {}
+
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    explicit concurrent_skiplist(Iterator f, Iterator l, allocator_type const & a = allocator_type{})
+        : concurrent_skiplist(a)
+    { for (; f != l; ++f) { insert(*f); } }
+
+    concurrent_skiplist(std::initializer_list<value_type> il, allocator_type const & a = allocator_type{})
+        : concurrent_skiplist(il.begin(), il.end(), a) { }
+
+    concurrent_skiplist(concurrent_skiplist const &) = delete;
+    concurrent_skiplist & operator=(concurrent_skiplist const &) = delete;
+
+    ~concurrent_skiplist() noexcept;
+
+    inline allocator_type get_allocator() const noexcept { return allocator_type(_node_alloc); }
+
+    /// Capacity
+    inline size_type size() const noexcept { return _size.load(std::memory_order_relaxed); }
+    [[nodiscard]] inline bool empty() const noexcept { return size() == 0; }
+
+    /// Modifiers: lock-free
+    inline void insert(value_type const & value) { _insert(_construct_node(value), false); }
+    inline void insert(value_type && value) { _insert(_construct_node(std::move(value)), false); }
+    template <typename ...Args>
+    inline void emplace(Args &&... args) { _insert(_construct_node(std::forward<Args>(args)...), false); }
+    // Inserts `value` only if no equivalent element is in the list; returns true if it did
+    inline bool insert_unique(value_type const & value) { return _insert(_construct_node(value), true); }
+    inline bool insert_unique(value_type && value) { return _insert(_construct_node(std::move(value)), true); }
+
+    // Removes one element equivalent to `x`, returning a copy of it. If the copy throws, the element is erased
+    inline auto extract(value_type const & x) -> std::optional<value_type> { return _extract(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto extract(U const & x) -> std::optional<value_type> { return _extract(x); }
+
+    // Removes the elements equivalent to `x`, returning how many
+    size_type erase(value_type const & x);
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    size_type erase(U const & x);
+    // Removes every element found while walking the list
+    void clear();
+    // Frees the retired nodes that no thread can reach anymore; it also runs every `reclaim_threshold` retirements
+    void reclaim() noexcept;
+
+    /// Lookup: lock-free, they never write to the list
+    inline bool contains(value_type const & x) const
+    { auto const pin = _epochs.pin(); return _equivalent(_lower_bound(x), x) != nullptr; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline bool contains(U const & x) const
+    { auto const pin = _epochs.pin(); return _equivalent(_lower_bound(x), x) != nullptr; }
+
+    inline auto count(value_type const & x) const -> difference_type { return _count(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto count(U const & x) const -> difference_type { return _count(x); }
+
+    inline auto find(value_type const & x) const -> std::optional<value_type>
+    { auto const pin = _epochs.pin(); return _copy(_equivalent(_lower_bound(x), x)); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto find(U const & x) const -> std::optional<value_type>
+    { auto const pin = _epochs.pin(); return _copy(_equivalent(_lower_bound(x), x)); }
+
+    // The first element not less than `x`, if any
+    inline auto lower_bound(value_type const & x) const -> std::optional<value_type>
+    { auto const pin = _epochs.pin(); return _copy(_lower_bound(x)); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto lower_bound(U const & x) const -> std::optional<value_type>
+    { auto const pin = _epochs.pin(); return _copy(_lower_bound(x)); }
+
+    // The first element greater than `x`, if any
+    inline auto upper_bound(value_type const & x) const -> std::optional<value_type>
+    { auto const pin = _epochs.pin(); return _copy(_upper_bound(x)); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto upper_bound(U const & x) const -> std::optional<value_type>
+    { auto const pin = _epochs.pin(); return _copy(_upper_bound(x)); }
+
+    // `lower_bound(x)` and `upper_bound(x)`, within the same traversal
+    inline auto equal_range(value_type const & x) const -> std::pair<std::optional<value_type>, std::optional<value_type>>
+    { auto const pin = _epochs.pin(); return {_copy(_lower_bound(x)), _copy(_upper_bound(x))}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto equal_range(U const & x) const -> std::pair<std::optional<value_type>, std::optional<value_type>>
+    { auto const pin = _epochs.pin(); return {_copy(_lower_bound(x)), _copy(_upper_bound(x))}; }
+
+    // Calls `f` on every element found while walking the list, in order
+    template <typename F>
+    void for_each(F && f) const;
+
+protected:
+    node_pointer _allocate(std::size_t level);
+    void _deallocate(node_pointer n) noexcept;
+    template <typename ...Args>
+    node_pointer _construct_node(Args &&... args);
+    void _destroy_node(node_pointer n) noexcept;
+    static std::size_t _random_level() noexcept;
+
+    static inline std::optional<value_type> _copy(node_const_pointer n)
+    { return n != nullptr ? std::optional<value_type>{n->value()} : std::nullopt; }
+    template <typename U>
+    inline node_const_pointer _equivalent(node_const_pointer n, U const & x) const noexcept
+    { return n != nullptr and not _cmp(x, n->value()) ? n : nullptr; }
+    // The order of the list: by value, then by address
+    inline bool _before(node_const_pointer lhs, node_const_pointer rhs) const noexcept
+    {
+        return _cmp(lhs->value(), rhs->value())
+            or (not _cmp(rhs->value(), lhs->value()) and std::less<node_const_pointer>{}(lhs, rhs));
+    }
+
+    template <typename U> node_const_pointer _lower_bound(U const & x) const
+    { return _search([this, &x](node_const_pointer n) { return _cmp(n->value(), x); }); }
+    template <typename U> node_const_pointer _upper_bound(U const & x) const
+    { return _search([this, &x](node_const_pointer n) { return not _cmp(x, n->value()); }); }
+    template <typename GoRight> node_const_pointer _search(GoRight && go_right) const;
+    template <typename GoRight> void _find(GoRight && go_right, path & preds, path & succs);
+
+    bool _insert(node_pointer n, bool unique);
+    template <typename U> auto _extract(U const & x) -> std::optional<value_type>;
+    template <typename U> auto _count(U const & x) const -> difference_type;
+    static bool _take(node_pointer n) noexcept;
+    void _unlink(node_pointer n);
+    void _release(node_pointer n) noexcept;
+    void _retire(node_pointer n) noexcept;
+}; // class concurrent_skiplist
+
+template <typename T, typename Compare, typename Alloc>
+concurrent_skiplist<T, Compare, Alloc>::~concurrent_skiplist() noexcept
+{
+    for (auto n = _head->next(0); n != nullptr;) {
+        auto const next = n->next(0);
+        _destroy_node(n);
+        n = next;
+    }
+    for (auto n = _retired.load(std::memory_order_acquire); n != nullptr;) {
+        auto const next = n->retired_next;
+        _destroy_node(n);
+        n = next;
+    }
+    _deallocate(_head);
+}
+
+/// Nodes
+// The node and its tower share one allocation of `node::units(level)` nodes
+template <typename T, typename Compare, typename Alloc>
+auto concurrent_skiplist<T, Compare, Alloc>::_allocate(std::size_t level)
+    -> node_pointer
+{
+    auto const n = node_allocator_traits::allocate(_node_alloc, node::units(level));
+    node_allocator_traits::construct(_node_alloc, n);
+    n->level = level;
+    n->construct_tower();
+    return n;
+}
+
+template <typename T, typename Compare, typename Alloc>
+void concurrent_skiplist<T, Compare, Alloc>::_deallocate(node_pointer n) noexcept
+{
+    auto const units = node::units(n->level);
+    node_allocator_traits::destroy(_node_alloc, n);
+    node_allocator_traits::deallocate(_node_alloc, n, units);
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename ...Args>
+auto concurrent_skiplist<T, Compare, Alloc>::_construct_node(Args &&... args)
+    -> node_pointer
+{
+    auto const n = _allocate(_random_level());
+    try {
+        node_allocator_traits::construct(_node_alloc, std::addressof(n->value()), std::forward<Args>(args)...);
+    } catch (...) {
+        _deallocate(n);
+        throw;
+    }
+    return n;
+}
+
+template <typename T, typename Compare, typename Alloc>
+void concurrent_skiplist<T, Compare, Alloc>::_destroy_node(node_pointer n) noexcept
+{
+    node_allocator_traits::destroy(_node_alloc, std::addressof(n->value()));
+    _deallocate(n);
+}
+
+// A node reaches level `l` with probability 2^-l
+template <typename T, typename Compare, typename Alloc>
+std::size_t concurrent_skiplist<T, Compare, Alloc>::_random_level() noexcept
+{
+    thread_local auto rng = std::mt19937{static_cast<unsigned>(std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+    auto const ones = static_cast<std::size_t>(std::countr_one(static_cast<std::uint32_t>(rng())));
+    return std::min(ones + 1, node::max_level);
+}
+
+/// Traversals
+// Descends to the first node, at the lowest level, for which `go_right` is false, stepping over the marked nodes
+// without unlinking them
+template <typename T, typename Compare, typename Alloc>
+template <typename GoRight>
+auto concurrent_skiplist<T, Compare, Alloc>::_search(GoRight && go_right) const
+    -> node_const_pointer
+{
+    node_const_pointer pred = _head;
+    node_const_pointer curr = nullptr;
+    for (auto l = node::max_level; l-- > 0;) {
+        curr = pred->next(l);
+        while (curr != nullptr) {
+            auto const succ = curr->load(l);
+            if (not node::is_marked(succ)) {
+                if (not go_right(curr)) {
+                    break;
+                }
+                pred = curr;
+            }
+            curr = node::pointer_of(succ);
+        }
+    }
+    return curr;
+}
+
+// Fills, for each level, the last node for which `go_right` holds and the one after it. The marked nodes met on
+// the way are unlinked; if that fails, because the predecessor changed, the search starts over
+template <typename T, typename Compare, typename Alloc>
+template <typename GoRight>
+void concurrent_skiplist<T, Compare, Alloc>::_find(GoRight && go_right, path & preds, path & succs)
+{
+retry:
+    auto pred = _head;
+    for (auto l = node::max_level; l-- > 0;) {
+        auto curr = pred->next(l);
+        while (curr != nullptr) {
+            auto const succ = curr->load(l);
+            if (node::is_marked(succ)) {
+                auto expected = node::link_to(curr);
+                if (not pred->tower()[l].compare_exchange_strong(expected, node::link_to(node::pointer_of(succ)))) {
+                    goto retry;
+                }
+                curr = node::pointer_of(succ);
+            } else if (go_right(curr)) {
+                pred = curr;
+                curr = node::pointer_of(succ);
+            } else {
+                break;
+            }
+        }
+        preds[l] = pred;
+        succs[l] = curr;
+    }
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename F>
+void concurrent_skiplist<T, Compare, Alloc>::for_each(F && f) const
+{
+    auto const pin = _epochs.pin();
+    for (node_const_pointer n = _head->next(0); n != nullptr; n = n->next(0)) {
+        if (not n->is_erased()) {
+            f(n->value());
+        }
+    }
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+auto concurrent_skiplist<T, Compare, Alloc>::_count(U const & x) const
+    -> difference_type
+{
+    auto const pin = _epochs.pin();
+    auto res = difference_type{0};
+    for (auto n = _lower_bound(x); n != nullptr and not _cmp(x, n->value()); n = n->next(0)) {
+        res += n->is_erased() ? 0 : 1;
+    }
+    return res;
+}
+
+/// Modifiers
+// The node is inserted once the CAS on the lowest level succeeds; the upper levels are linked afterwards, until
+// the node is extracted. With `unique`, the position is searched among the values, to see an equivalent one
+template <typename T, typename Compare, typename Alloc>
+bool concurrent_skiplist<T, Compare, Alloc>::_insert(node_pointer n, bool unique)
+{
+    auto const pin = _epochs.pin();
+    auto const before = [this, n](node_const_pointer c) { return _before(c, n); };
+    auto preds = path{};
+    auto succs = path{};
+    for (;;) {
+        if (unique) {
+            _find([this, n](node_const_pointer c) { return _cmp(c->value(), n->value()); }, preds, succs);
+            if (_equivalent(succs[0], n->value()) != nullptr) {
+                _destroy_node(n);
+                return false;
+            }
+        } else {
+            _find(before, preds, succs);
+        }
+        for (std::size_t l = 0; l < n->level; ++l) {
+            n->tower()[l].store(node::link_to(succs[l]), std::memory_order_relaxed);
+        }
+        auto expected = node::link_to(succs[0]);
+        if (preds[0]->tower()[0].compare_exchange_strong(expected, node::link_to(n))) {
+            break;
+        }
+    }
+    _size.fetch_add(1, std::memory_order_relaxed);
+
+    // Nobody else changes the links of `n` above the lowest level, until it is linked there, but to mark them
+    for (std::size_t l = 1; l < n->level and not n->is_erased(); ++l) {
+        for (;;) {
+            auto link = n->load(l);
+            if (node::is_marked(link)) {
+                break;
+            }
+            if (node::pointer_of(link) != succs[l]
+                and not n->tower()[l].compare_exchange_strong(link, node::link_to(succs[l]))) {
+                break;
+            }
+            auto expected = node::link_to(succs[l]);
+            if (preds[l]->tower()[l].compare_exchange_strong(expected, node::link_to(n))) {
+                break;
+            }
+            _find(before, preds, succs);
+        }
+    }
+    // An extraction may have run its unlinking before the last levels were linked: the fence, paired with the one
+    // in `_unlink`, ensures that either this thread sees the node erased, or the extraction sees it linked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (n->is_erased()) {
+        _unlink(n);
+    }
+    _release(n);
+    return true;
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+auto concurrent_skiplist<T, Compare, Alloc>::_extract(U const & x)
+    -> std::optional<value_type>
+{
+    auto const pin = _epochs.pin();
+    auto preds = path{};
+    auto succs = path{};
+    for (;;) {
+        _find([this, &x](node_const_pointer c) { return _cmp(c->value(), x); }, preds, succs);
+        auto const n = succs[0];
+        if (_equivalent(n, x) == nullptr) {
+            return std::nullopt;
+        }
+        if (_take(n)) {
+            _size.fetch_sub(1, std::memory_order_relaxed);
+            _unlink(n);
+            // The node stays allocated while this thread is pinned
+            _release(n);
+            return std::optional<value_type>{n->value()};
+        }
+    }
+}
+
+template <typename T, typename Compare, typename Alloc>
+auto concurrent_skiplist<T, Compare, Alloc>::erase(value_type const & x)
+    -> size_type
+{
+    auto count = size_type{0};
+    for (; _extract(x).has_value(); ++count) {}
+    return count;
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U> requires meta::is_transparent_compare<Compare>
+auto concurrent_skiplist<T, Compare, Alloc>::erase(U const & x)
+    -> size_type
+{
+    auto count = size_type{0};
+    for (; _extract(x).has_value(); ++count) {}
+    return count;
+}
+
+template <typename T, typename Compare, typename Alloc>
+void concurrent_skiplist<T, Compare, Alloc>::clear()
+{
+    auto const pin = _epochs.pin();
+    for (auto n = _head->next(0); n != nullptr; n = n->next(0)) {
+        if (_take(n)) {
+            _size.fetch_sub(1, std::memory_order_relaxed);
+            _unlink(n);
+            _release(n);
+        }
+    }
+}
+
+// Marks the links of `n` from the top, so that no level is linked after the extraction; the thread marking the
+// lowest one extracts the node
+template <typename T, typename Compare, typename Alloc>
+bool concurrent_skiplist<T, Compare, Alloc>::_take(node_pointer n) noexcept
+{
+    for (auto l = n->level; l-- > 1;) {
+        n->mark(l);
+    }
+    return n->mark(0);
+}
+
+// Searches `n` itself at every level: `_find` unlinks it wherever it is found, since it is marked
+template <typename T, typename Compare, typename Alloc>
+void concurrent_skiplist<T, Compare, Alloc>::_unlink(node_pointer n)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto preds = path{};
+    auto succs = path{};
+    _find([this, n](node_const_pointer c) { return _before(c, n); }, preds, succs);
+}
+
+template <typename T, typename Compare, typename Alloc>
+void concurrent_skiplist<T, Compare, Alloc>::_release(node_pointer n) noexcept
+{
+    if (n->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        _retire(n);
+    }
+}
+
+// The node is unreachable: it is tagged with the current epoch and pushed on the retired stack
+template <typename T, typename Compare, typename Alloc>
+void concurrent_skiplist<T, Compare, Alloc>::_retire(node_pointer n) noexcept
+{
+    n->retired_epoch = _epochs.current();
+    auto top = _retired.load(std::memory_order_relaxed);
+    do {
+        n->retired_next = top;
+    } while (not _retired.compare_exchange_weak(top, n, std::memory_order_release, std::memory_order_relaxed));
+    if ((_retired_count.fetch_add(1, std::memory_order_relaxed) + 1) % reclaim_threshold == 0) {
+        reclaim();
+    }
+}
+
+// Takes the whole retired stack, frees what is older than every pinned epoch and pushes the rest back
+template <typename T, typename Compare, typename Alloc>
+void concurrent_skiplist<T, Compare, Alloc>::reclaim() noexcept
+{
+    auto n = _retired.exchange(nullptr, std::memory_order_acquire);
+    if (n == nullptr) {
+        return;
+    }
+    auto const oldest = _epochs.advance();
+    node_pointer kept = nullptr;
+    node_pointer last_kept = nullptr;
+    while (n != nullptr) {
+        auto const next = n->retired_next;
+        if (n->retired_epoch < oldest) {
+            _destroy_node(n);
+        } else {
+            n->retired_next = kept;
+            kept = n;
+            last_kept = last_kept != nullptr ? last_kept : n;
+        }
+        n = next;
+    }
+    if (kept != nullptr) {
+        auto top = _retired.load(std::memory_order_relaxed);
+        do {
+            last_kept->retired_next = top;
+        } while (not _retired.compare_exchange_weak(top, kept, std::memory_order_release, std::memory_order_relaxed));
+    }
+}
+
+} // namespace forest
+
+#endif /* CONCURRENT_SKIPLIST_HPP */
@@ -0,0 +1,47 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : augmented_node
+ * @created     : domenica ott 18, 2026 15:31:02 CEST
+ * @license     : MIT
+ * */
+
+#ifndef DETAIL_AUGMENTED_NODE_HPP
+#define DETAIL_AUGMENTED_NODE_HPP
+
+#include <memory> //std::addressof
+#include <new>    //std::launder
+
+namespace forest :: detail
+{
+
+// A `node` which also stores an aggregate of the values in its subtree
+template <class T, typename Int, typename Aggregate>
+struct augmented_node
+{
+    using value_type      = T;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using pointer         = value_type *;
+    using const_pointer   = value_type const *;
+    using height_type     = Int;
+    using aggregate_type  = Aggregate;
+    using node_ptr        = augmented_node *;
+
+    constexpr inline reference value() noexcept
+    { return *std::launder(reinterpret_cast<pointer>(std::addressof(_storage))); }
+    constexpr inline const_reference value() const noexcept
+    { return *std::launder(reinterpret_cast<const_pointer>(std::addressof(_storage))); }
+
+    height_type height = 0;
+    node_ptr root  = nullptr;
+    node_ptr left  = nullptr;
+    node_ptr right = nullptr;
+    aggregate_type aggregate{};
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+}; // struct augmented_node
+
+} // namespace forest :: detail
+
+#endif /* DETAIL_AUGMENTED_NODE_HPP */
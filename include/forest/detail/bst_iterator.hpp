@@ -11,28 +11,43 @@
 #include <cstdint> //std::int_fast8_t, std::ptrdiff_t
 
 #include "node.hpp" //forest::node
+#include "tree_algorithms.hpp" //forest::detail::_bst_next, forest::detail::_bst_prev, forest::detail::_depth_of
 
 namespace forest
 {
-template <class, class, class> class avl_tree;
-template <class, class, class> class binary_search_tree;
+template <class, class, class, class> class avl_tree;
+template <class, class, class, class> class wavl_tree;
+template <class, class, class, class> class treap;
+template <class, class, class, class, class> class splay_tree;
+template <class, class, class, class, class> class binary_search_tree;
+template <class, class, class, class> class augmented_avl_tree;
+template <class, class, class> class interval_tree;
 } // namespace forest
 
 namespace forest :: detail
 {
 
-template <typename T> struct _bst_iterator;
-template <typename T> struct _bst_const_iterator;
+template <class, class, class, class> class _avl_map_base;
 
-template <typename T>
+template <typename T, typename Node = node<T, std::int_fast8_t>> struct _bst_iterator;
+template <typename T, typename Node = node<T, std::int_fast8_t>> struct _bst_const_iterator;
+
+// Iterates over any `Node` with parent links; trees with a richer node than `forest::detail::node` reuse it
+template <typename T, typename Node>
 struct _bst_iterator
 {
 private:
-    template <class, class, class> friend class forest::binary_search_tree;
-    template <class, class, class> friend class forest::avl_tree;
-    template <class> friend class _bst_const_iterator;
-
-    using node_type         = node<T, std::int_fast8_t>;
+    template <class, class, class, class, class> friend class forest::binary_search_tree;
+    template <class, class, class, class> friend class forest::avl_tree;
+    template <class, class, class, class> friend class forest::wavl_tree;
+    template <class, class, class, class> friend class forest::treap;
+    template <class, class, class, class, class> friend class forest::splay_tree;
+    template <class, class, class, class> friend class forest::augmented_avl_tree;
+    template <class, class, class> friend class forest::interval_tree;
+    template <class, class, class, class> friend class _avl_map_base;
+    template <class, class> friend struct _bst_const_iterator;
+
+    using node_type         = Node;
     using node_pointer      = node_type *;
 public:
     using value_type        = T;
@@ -64,76 +79,11 @@ public:
         return std::pointer_traits<pointer>::pointer_to(_current->value());
     }
 
-    constexpr inline
-    _bst_iterator & _all_down_left() noexcept
-    {
-        if (_current->left == _current) {
-            return *this;
-        }
-        while (_current->left != nullptr) {
-            _current = _current->left;
-        }
-        return *this;
-    }
-
-    constexpr inline
-    _bst_iterator & _up_left() noexcept
-    {
-        auto prev = _current;
-        _current = _current->root;
-
-        if (_current->root == prev) {
-            return *this; //There's only one element: not doing this will start an infinite loop
-        }
-
-        //if the root is _end.left, it will stop at `_end`
-        while (prev == _current->right && _current->right != _current->root) {
-            prev = _current;
-            _current = _current->root;
-        }
-        return *this;
-    }
-
-    constexpr inline
-    _bst_iterator & _all_down_right() noexcept
-    {
-        if (_current->right == _current) {
-            return *this;
-        }
-        while (_current->right != nullptr) {
-            _current = _current->right;
-        }
-        return *this;
-    }
-
-    constexpr inline _bst_iterator & _up_right() noexcept
-    {
-        auto prev = _current;
-        _current = _current->root;
-
-        if (_current->root == prev) {
-            return *this;  //There's only one element; not doing this will start an infinite cycle
-        }
-
-        while (prev == _current->left) {
-            prev = _current;
-            _current = _current->root;
-        }
-        return *this;
-    }
-
     constexpr
     _bst_iterator & operator++() noexcept
     {
-        if (_current == nullptr) {
-            __builtin_unreachable();        // UREACHABLE - UB
-            return *this;
-        }
-        if (_current->right != nullptr) {
-            _current = _current->right;
-            return _all_down_left();
-        }
-        return _up_left();
+        _current = _bst_next(_current);
+        return *this;
     }
 
     constexpr inline
@@ -142,15 +92,8 @@ public:
     constexpr
     _bst_iterator & operator--() noexcept
     {
-        if (_current == nullptr) {
-            __builtin_unreachable();        // UREACHABLE - UB
-            return *this;
-        }
-        if (_current->left != nullptr) {
-            _current = _current->left;
-            return _all_down_right();
-        }
-        return _up_right();
+        _current = _bst_prev(_current);
+        return *this;
     }
 
     constexpr inline
@@ -167,19 +110,25 @@ public:
     { return !(lhs == rhs); }
 
     friend constexpr inline
-    auto depth(_bst_iterator<T> const & it) noexcept
-    { return _height(it._current); }
+    auto depth(_bst_iterator const & it) noexcept
+    { return _depth_of(it._current); }
 
 }; // struct _bst_iterator
 
-template <typename T>
+template <typename T, typename Node>
 struct _bst_const_iterator
 {
 private:
-    template <class, class, class> friend class forest::binary_search_tree;
-    template <class, class, class> friend class forest::avl_tree;
-
-    using node_type         = node<T, std::int_fast8_t>;
+    template <class, class, class, class, class> friend class forest::binary_search_tree;
+    template <class, class, class, class> friend class forest::avl_tree;
+    template <class, class, class, class> friend class forest::wavl_tree;
+    template <class, class, class, class> friend class forest::treap;
+    template <class, class, class, class, class> friend class forest::splay_tree;
+    template <class, class, class, class> friend class forest::augmented_avl_tree;
+    template <class, class, class> friend class forest::interval_tree;
+    template <class, class, class, class> friend class _avl_map_base;
+
+    using node_type         = Node;
     using node_pointer      = node_type const *;
 public:
     using value_type        = T;
@@ -202,7 +151,7 @@ public:
     _bst_const_iterator() noexcept = default;
 
     constexpr inline
-    _bst_const_iterator(_bst_iterator<T> const & it) : _current{it._current} { }
+    _bst_const_iterator(_bst_iterator<T, Node> const & it) : _current{it._current} { }
 
     constexpr inline
     reference operator*() const noexcept
@@ -214,76 +163,11 @@ public:
         return std::pointer_traits<pointer>::pointer_to(_current->value());
     }
 
-    constexpr inline
-    _bst_const_iterator & _all_down_left() noexcept
-    {
-        if (_current->left == _current) {
-            return *this;
-        }
-        while (_current->left != nullptr) {
-            _current = _current->left;
-        }
-        return *this;
-    }
-
-    constexpr inline
-    _bst_const_iterator & _up_left() noexcept
-    {
-        auto prev = _current;
-        _current = _current->root;
-
-        if (_current->root == prev) {
-            return *this; //There's only one element: not doing this will start an infinite loop
-        }
-
-        //if the root is _end.left, it will stop at `end`
-        while (prev == _current->right && _current->right != _current->root) {
-            prev = _current;
-            _current = _current->root;
-        }
-        return *this;
-    }
-
-    constexpr inline
-    _bst_const_iterator & _all_down_right() noexcept
-    {
-        if (_current->right == _current) {
-            return *this;
-        }
-        while (_current->right != nullptr) {
-            _current = _current->right;
-        }
-        return *this;
-    }
-
-    constexpr inline _bst_const_iterator & _up_right() noexcept
-    {
-        auto prev = _current;
-        _current = _current->root;
-
-        if (_current->root == prev) {
-            return *this;
-        }
-
-        while (prev == _current->left) {
-            prev = _current;
-            _current = _current->root;
-        }
-        return *this;
-    }
-
     constexpr
     _bst_const_iterator & operator++() noexcept
     {
-        if (_current == nullptr) {
-            __builtin_unreachable();        // UREACHABLE - UB
-            return *this;
-        }
-        if (_current->right != nullptr) {
-            _current = _current->right;
-            return _all_down_left();
-        }
-        return _up_left();
+        _current = _bst_next(_current);
+        return *this;
     }
 
     constexpr inline
@@ -292,15 +176,8 @@ public:
     constexpr
     _bst_const_iterator & operator--() noexcept
     {
-        if (_current == nullptr) {
-            __builtin_unreachable();        // UREACHABLE - UB
-            return *this;
-        }
-        if (_current->left != nullptr) {
-            _current = _current->left;
-            return _all_down_right();
-        }
-        return _up_right();
+        _current = _bst_prev(_current);
+        return *this;
     }
 
     constexpr inline
@@ -318,28 +195,31 @@ public:
 
     template <typename U>
     constexpr inline
-    bool operator==(_bst_iterator<U> const & rhs) const noexcept
+    bool operator==(_bst_iterator<U, Node> const & rhs) const noexcept
     { return _current == rhs._current; }
 
     template <typename U>
     constexpr inline
-    bool operator!=(_bst_iterator<U> const & rhs) const noexcept
+    bool operator!=(_bst_iterator<U, Node> const & rhs) const noexcept
     { return _current != rhs._current; }
 
+    friend constexpr inline
+    auto depth(_bst_const_iterator const & it) noexcept
+    { return _depth_of(it._current); }
 
     friend constexpr inline
-    auto depth(_bst_const_iterator<T> const & it) noexcept
-    { return _height(it._current); }
+    node_pointer _node_of(_bst_const_iterator const & it) noexcept
+    { return it._current; }
 }; // struct _bst_const_iterator
 
-template <typename T, typename U>
+template <typename T, typename U, typename Node>
 constexpr inline
-bool operator!=(_bst_iterator<U> const & lhs, _bst_const_iterator<T> const & rhs) noexcept
+bool operator!=(_bst_iterator<U, Node> const & lhs, _bst_const_iterator<T, Node> const & rhs) noexcept
 { return rhs != lhs; }
 
-template <typename T, typename U>
+template <typename T, typename U, typename Node>
 constexpr inline
-bool operator==(_bst_iterator<U> const & lhs, _bst_const_iterator<T> const & rhs) noexcept
+bool operator==(_bst_iterator<U, Node> const & lhs, _bst_const_iterator<T, Node> const & rhs) noexcept
 { return rhs == lhs; }
 
 } // namespace forest :: detail
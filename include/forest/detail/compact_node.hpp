@@ -0,0 +1,121 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : compact_node
+ * @created     : lunedì ott 19, 2026 11:48:27 CEST
+ * @license     : MIT
+ * */
+
+#ifndef DETAIL_COMPACT_NODE_HPP
+#define DETAIL_COMPACT_NODE_HPP
+
+#include <cstdint>     //std::uintptr_t
+#include <memory>      //std::addressof
+#include <new>         //std::launder
+#include <type_traits> //std::aligned_storage
+
+namespace forest :: detail
+{
+
+// A node with no parent link: the trees using it keep the path from the root while they walk or update. The
+// height comes after the links, so that it shares with a small value the padding before the end of the node
+template <class T, typename Int>
+struct compact_node
+{
+    using value_type      = T;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using pointer         = value_type *;
+    using const_pointer   = value_type const *;
+    using height_type     = Int;
+    using node_ptr        = compact_node *;
+    using link_type       = node_ptr;
+
+    constexpr inline reference value() noexcept
+    { return *std::launder(reinterpret_cast<pointer>(std::addressof(_storage))); }
+    constexpr inline const_reference value() const noexcept
+    { return *std::launder(reinterpret_cast<const_pointer>(std::addressof(_storage))); }
+
+    node_ptr left = nullptr;
+    node_ptr right = nullptr;
+    height_type height = 0;
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+}; // struct compact_node
+
+// A child link whose lowest bit, free since nodes are aligned to pointers, tells whether the subtree it leads to
+// is taller than its sibling. Assigning a node to it keeps the bit, which belongs to the node holding the link
+template <class Node>
+struct _balance_link
+{
+    std::uintptr_t _bits = 0;
+
+    constexpr inline _balance_link() noexcept = default;
+    constexpr inline _balance_link(Node * n) noexcept : _bits{reinterpret_cast<std::uintptr_t>(n)} {}
+    constexpr inline _balance_link(_balance_link const &) noexcept = default;
+
+    constexpr inline
+    _balance_link & operator=(Node * n) noexcept
+    {
+        _bits = reinterpret_cast<std::uintptr_t>(n) | (_bits & 1);
+        return *this;
+    }
+    constexpr inline
+    _balance_link & operator=(_balance_link const & other) noexcept { return *this = other.get(); }
+
+    constexpr inline
+    Node * get() const noexcept { return reinterpret_cast<Node *>(_bits & ~std::uintptr_t{1}); }
+    constexpr inline operator Node *() const noexcept { return get(); }
+    constexpr inline Node * operator->() const noexcept { return get(); }
+
+    constexpr inline
+    bool taller() const noexcept { return (_bits & 1) != 0; }
+    constexpr inline
+    void set_taller(bool taller) noexcept { _bits = (_bits & ~std::uintptr_t{1}) | std::uintptr_t{taller}; }
+
+    friend constexpr inline
+    bool operator==(_balance_link const & lhs, Node const * rhs) noexcept { return lhs.get() == rhs; }
+}; // struct _balance_link
+
+// A node with no parent link nor height: an avl tree needs only the difference between the heights of the
+// children, which the links keep in their lowest bits. Any value fits right after the two links
+template <class T>
+struct packed_node
+{
+    using value_type      = T;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using pointer         = value_type *;
+    using const_pointer   = value_type const *;
+    using node_ptr        = packed_node *;
+    using link_type       = _balance_link<packed_node>;
+
+    constexpr inline reference value() noexcept
+    { return *std::launder(reinterpret_cast<pointer>(std::addressof(_storage))); }
+    constexpr inline const_reference value() const noexcept
+    { return *std::launder(reinterpret_cast<const_pointer>(std::addressof(_storage))); }
+
+    link_type left;
+    link_type right;
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+}; // struct packed_node
+
+// The height of the right subtree of `n` minus the one of the left subtree: -1, 0 or 1
+template <class T>
+[[nodiscard]] constexpr inline int _balance_of(packed_node<T> const * const n) noexcept
+{
+    return static_cast<int>(n->right.taller()) - static_cast<int>(n->left.taller());
+}
+
+template <class T>
+constexpr inline void _set_balance(packed_node<T> * const n, int balance) noexcept
+{
+    n->left.set_taller(balance < 0);
+    n->right.set_taller(balance > 0);
+}
+
+} // namespace forest :: detail
+
+#endif /* DETAIL_COMPACT_NODE_HPP */
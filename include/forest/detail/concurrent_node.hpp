@@ -0,0 +1,104 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : concurrent_node
+ * @created     : domenica ott 18, 2026 19:22:14 CEST
+ * @license     : MIT
+ * */
+
+#ifndef DETAIL_CONCURRENT_NODE_HPP
+#define DETAIL_CONCURRENT_NODE_HPP
+
+#include <atomic>  //std::atomic, std::atomic_thread_fence
+#include <cstdint> //std::uint64_t
+#include <new>     //std::launder
+#include <memory>  //std::addressof
+#include <thread>  //std::this_thread::yield
+
+#include "node.hpp" //forest::detail::_height_of
+
+namespace forest :: detail
+{
+
+// A node whose child links can be read while a writer changes them. Each node carries a version, odd while a
+// writer is changing its links: readers read the version, then the links, then check that the version did not
+// change (a seqlock). `height` and `root` are only used by the writer, which is unique
+template <class T, typename Int>
+struct concurrent_node
+{
+    using value_type      = T;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using pointer         = value_type *;
+    using const_pointer   = value_type const *;
+    using height_type     = Int;
+    using node_ptr        = concurrent_node *;
+    using version_type    = std::uint64_t;
+
+    constexpr inline reference value() noexcept
+    { return *std::launder(reinterpret_cast<pointer>(std::addressof(_storage))); }
+    constexpr inline const_reference value() const noexcept
+    { return *std::launder(reinterpret_cast<const_pointer>(std::addressof(_storage))); }
+
+    /// Reader side
+    // Waits until no writer is changing the node, and returns its version
+    inline version_type stable_version() const noexcept
+    {
+        for (auto spins = 0;; ++spins) {
+            if (auto const v = version.load(std::memory_order_acquire); (v & 1) == 0) {
+                return v;
+            }
+            if (spins >= 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    // True if the links read since `stable_version` returned `v` are still valid
+    inline bool validate(version_type v) const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version.load(std::memory_order_relaxed) == v;
+    }
+    inline node_ptr child(bool go_left) const noexcept
+    { return (go_left ? left : right).load(std::memory_order_relaxed); }
+
+    /// Writer side: locking a locked node, or unlocking an unlocked one, does nothing
+    inline void lock() noexcept
+    {
+        if (auto const v = version.load(std::memory_order_relaxed); (v & 1) == 0) {
+            version.store(v + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+    }
+    inline void unlock() noexcept
+    {
+        if (auto const v = version.load(std::memory_order_relaxed); (v & 1) != 0) {
+            version.store(v + 1, std::memory_order_release);
+        }
+    }
+    inline node_ptr get_left() const noexcept { return left.load(std::memory_order_relaxed); }
+    inline node_ptr get_right() const noexcept { return right.load(std::memory_order_relaxed); }
+    inline void set_left(node_ptr n) noexcept { left.store(n, std::memory_order_relaxed); }
+    inline void set_right(node_ptr n) noexcept { right.store(n, std::memory_order_relaxed); }
+
+    std::atomic<version_type> version = 0;
+    std::atomic<node_ptr> left = nullptr;
+    std::atomic<node_ptr> right = nullptr;
+    node_ptr root = nullptr;
+    height_type height = 0;
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+}; // struct concurrent_node
+
+template <class T, typename Int>
+[[nodiscard]] inline auto _node_height(concurrent_node<T, Int> const * const v) noexcept
+    -> Int
+{
+    auto const l = _height_of(v->get_left());
+    auto const r = _height_of(v->get_right());
+    return static_cast<Int>((l > r ? l : r) + 1);
+}
+
+} // namespace forest :: detail
+
+#endif /* DETAIL_CONCURRENT_NODE_HPP */
@@ -0,0 +1,100 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : epoch
+ * @created     : domenica ott 18, 2026 22:41:37 CEST
+ * @license     : MIT
+ * */
+
+#ifndef DETAIL_EPOCH_HPP
+#define DETAIL_EPOCH_HPP
+
+#include <array>       //std::array
+#include <atomic>      //std::atomic, std::atomic_thread_fence
+#include <cstddef>     //std::size_t
+#include <cstdint>     //std::uint64_t
+#include <functional>  //std::hash
+#include <memory>      //std::addressof
+#include <thread>      //std::this_thread
+
+namespace forest :: detail
+{
+
+// Epoch based reclamation. Readers pin the current epoch for the duration of a traversal, in one of a fixed set
+// of slots; a writer tags each unlinked node with the epoch it was retired in, and frees it once every pinned
+// epoch is newer. A reader which pinned an epoch later than the tag loaded the root after the node was unlinked,
+// so it cannot reach it.
+// Pinning is a compare-and-swap on a slot chosen from the thread id, so readers never wait for writers; if all
+// the slots are taken, a reader yields until one is released
+class _epoch_domain
+{
+public:
+    using epoch_type = std::uint64_t;
+    static constexpr std::size_t max_pinned = 128;
+
+private:
+    struct alignas(64) _slot
+    {
+        std::atomic<epoch_type> epoch = 0; // 0 when free
+    };
+
+    mutable std::array<_slot, max_pinned> _slots{};
+    std::atomic<epoch_type> _global = 1;
+
+public:
+    // Keeps an epoch pinned while alive
+    class guard
+    {
+        friend class _epoch_domain;
+        std::atomic<epoch_type> * _epoch;
+        explicit guard(std::atomic<epoch_type> * e) noexcept : _epoch{e} {}
+
+    public:
+        guard(guard const &) = delete;
+        guard & operator=(guard const &) = delete;
+        inline ~guard() noexcept { _epoch->store(0, std::memory_order_release); }
+    };
+
+    inline _epoch_domain() noexcept = default;
+    _epoch_domain(_epoch_domain const &) = delete;
+    _epoch_domain & operator=(_epoch_domain const &) = delete;
+
+    // The tag of a node retired now. The load is sequentially consistent, so that it follows the (sequentially
+    // consistent) unlinking in the total order even when `advance` runs in another thread
+    inline epoch_type current() const noexcept { return _global.load(std::memory_order_seq_cst); }
+
+    // The announcement must be visible before the traversal reads any link: paired with the fence in `advance`,
+    // either the writer sees the pinned epoch, or the reader sees the unlinked tree
+    [[nodiscard]] inline guard pin() const noexcept
+    {
+        auto const start = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        for (;;) {
+            for (auto i = std::size_t{0}; i < max_pinned; ++i) {
+                auto & slot = _slots[(start + i) % max_pinned].epoch;
+                auto expected = epoch_type{0};
+                if (slot.compare_exchange_strong(expected, current(), std::memory_order_seq_cst)) {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    return guard{std::addressof(slot)};
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Moves to a new epoch, and returns the oldest one still pinned (or the new one): the nodes retired in
+    // an earlier epoch can be freed
+    inline epoch_type advance() noexcept
+    {
+        auto oldest = _global.fetch_add(1, std::memory_order_seq_cst) + 1;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (auto const & slot : _slots) {
+            if (auto const e = slot.epoch.load(std::memory_order_acquire); e != 0 and e < oldest) {
+                oldest = e;
+            }
+        }
+        return oldest;
+    }
+}; // class _epoch_domain
+
+} // namespace forest :: detail
+
+#endif /* DETAIL_EPOCH_HPP */
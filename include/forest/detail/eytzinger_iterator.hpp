@@ -0,0 +1,141 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : eytzinger_iterator
+ * @created     : lunedì ott 19, 2026 05:12:44 CEST
+ * @license     : MIT
+ * */
+
+#ifndef EYTZINGER_ITERATOR_HPP
+#define EYTZINGER_ITERATOR_HPP
+
+#include <bit>      //std::countr_one, std::countr_zero
+#include <cstddef>  //std::ptrdiff_t, std::size_t
+#include <iterator> //std::bidirectional_iterator_tag
+#include <memory>   //std::addressof
+
+namespace forest
+{
+template <class, std::size_t, class> class static_set;
+} // namespace forest
+
+namespace forest :: detail
+{
+
+// The Eytzinger layout stores a complete binary tree in an array, level by level: numbering the slots from 1, the
+// children of `k` are `2k` and `2k + 1`, and the parent of `k` is `k / 2`. Index 0 is past the end
+/// Traversal
+[[nodiscard]] constexpr inline
+std::size_t _eytzinger_first(std::size_t size) noexcept
+{
+    if (size == 0) {
+        return 0;
+    }
+    auto k = std::size_t{1};
+    for (; 2 * k <= size; k *= 2) {}
+    return k;
+}
+
+[[nodiscard]] constexpr inline
+std::size_t _eytzinger_last(std::size_t size) noexcept
+{
+    if (size == 0) {
+        return 0;
+    }
+    auto k = std::size_t{1};
+    for (; 2 * k + 1 <= size; k = 2 * k + 1) {}
+    return k;
+}
+
+[[nodiscard]] constexpr inline
+std::size_t _eytzinger_next(std::size_t k, std::size_t size) noexcept
+{
+    if (2 * k + 1 <= size) {
+        for (k = 2 * k + 1; 2 * k <= size; k *= 2) {}
+        return k;
+    }
+    // Climbs past the ancestors reached from the right, then once more
+    return k >> (std::countr_one(k) + 1);
+}
+
+[[nodiscard]] constexpr inline
+std::size_t _eytzinger_prev(std::size_t k, std::size_t size) noexcept
+{
+    if (k == 0) {
+        return _eytzinger_last(size);
+    }
+    if (2 * k <= size) {
+        for (k = 2 * k; 2 * k + 1 <= size; k = 2 * k + 1) {}
+        return k;
+    }
+    return k >> (std::countr_zero(k) + 1);
+}
+
+// Iterates in order over an array in Eytzinger layout; `_data` is the first slot, numbered 1
+template <typename T>
+struct _eytzinger_iterator
+{
+private:
+    template <class, std::size_t, class> friend class forest::static_set;
+
+public:
+    using value_type        = T;
+    using reference         = value_type const &;
+    using const_reference   = value_type const &;
+    using pointer           = value_type const *;
+    using const_pointer     = value_type const *;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+private:
+    pointer _data = nullptr;
+    std::size_t _size = 0;
+    std::size_t _index = 0;
+
+    explicit constexpr
+    _eytzinger_iterator(pointer data, std::size_t size, std::size_t index) noexcept
+        : _data{data}, _size{size}, _index{index} {}
+
+public:
+    constexpr inline
+    _eytzinger_iterator() noexcept = default;
+
+    constexpr inline
+    reference operator*() const noexcept
+    { return _data[_index - 1]; }
+
+    constexpr inline
+    pointer operator->() const noexcept
+    { return std::addressof(_data[_index - 1]); }
+
+    constexpr inline
+    _eytzinger_iterator & operator++() noexcept
+    {
+        _index = _eytzinger_next(_index, _size);
+        return *this;
+    }
+
+    constexpr inline
+    _eytzinger_iterator operator++(int) noexcept { auto res = *this; ++(*this); return res; }
+
+    constexpr inline
+    _eytzinger_iterator & operator--() noexcept
+    {
+        _index = _eytzinger_prev(_index, _size);
+        return *this;
+    }
+
+    constexpr inline
+    _eytzinger_iterator operator--(int) noexcept { auto res = *this; --(*this); return res; }
+
+    friend constexpr inline
+    bool operator==(_eytzinger_iterator const & lhs, _eytzinger_iterator const & rhs) noexcept
+    { return lhs._index == rhs._index; }
+
+    friend constexpr inline
+    bool operator!=(_eytzinger_iterator const & lhs, _eytzinger_iterator const & rhs) noexcept
+    { return !(lhs == rhs); }
+}; // struct _eytzinger_iterator
+
+} // namespace forest :: detail
+
+#endif /* EYTZINGER_ITERATOR_HPP */
@@ -0,0 +1,151 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : intrusive_iterator
+ * @created     : domenica ott 18, 2026 14:02:37 CEST
+ * @license     : MIT
+ * */
+
+#ifndef INTRUSIVE_ITERATOR_HPP
+#define INTRUSIVE_ITERATOR_HPP
+
+#include <cstddef>  //std::ptrdiff_t
+#include <iterator> //std::bidirectional_iterator_tag
+
+#include "tree_algorithms.hpp" //forest::detail::_bst_next, forest::detail::_bst_prev
+
+namespace forest
+{
+struct avl_hook;
+template <class, class, class> class intrusive_avl_tree;
+} // namespace forest
+
+namespace forest :: detail
+{
+
+template <typename T, typename Hook> struct _intrusive_iterator;
+template <typename T, typename Hook> struct _intrusive_const_iterator;
+
+// Iterates over the hooks of the tree; `Hook` converts them back to the values which contain them
+template <typename T, typename Hook>
+struct _intrusive_iterator
+{
+private:
+    template <class, class, class> friend class forest::intrusive_avl_tree;
+    template <class, class> friend struct _intrusive_const_iterator;
+
+    using hook_pointer      = avl_hook *;
+public:
+    using value_type        = T;
+    using reference         = value_type &;
+    using const_reference   = value_type const &;
+    using pointer           = value_type *;
+    using const_pointer     = value_type const *;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+private:
+    hook_pointer _current = nullptr;
+
+    explicit constexpr
+    _intrusive_iterator(hook_pointer ptr) noexcept
+        : _current{ptr} {}
+
+public:
+    constexpr inline
+    _intrusive_iterator() noexcept = default;
+
+    constexpr inline
+    reference operator*() const noexcept
+    { return *Hook::to_value(_current); }
+
+    constexpr inline
+    pointer operator->() const noexcept
+    { return Hook::to_value(_current); }
+
+    constexpr inline
+    _intrusive_iterator & operator++() noexcept
+    { _current = _bst_next(_current); return *this; }
+
+    constexpr inline
+    _intrusive_iterator operator++(int) noexcept { auto res = *this; ++(*this); return res; }
+
+    constexpr inline
+    _intrusive_iterator & operator--() noexcept
+    { _current = _bst_prev(_current); return *this; }
+
+    constexpr inline
+    _intrusive_iterator operator--(int) noexcept { auto res = *this; --(*this); return res; }
+
+    friend constexpr inline
+    bool operator==(_intrusive_iterator const & lhs, _intrusive_iterator const & rhs) noexcept
+    { return lhs._current == rhs._current; }
+
+    friend constexpr inline
+    bool operator!=(_intrusive_iterator const & lhs, _intrusive_iterator const & rhs) noexcept
+    { return !(lhs == rhs); }
+}; // struct _intrusive_iterator
+
+template <typename T, typename Hook>
+struct _intrusive_const_iterator
+{
+private:
+    template <class, class, class> friend class forest::intrusive_avl_tree;
+
+    using hook_pointer      = avl_hook const *;
+public:
+    using value_type        = T;
+    using reference         = value_type const &;
+    using const_reference   = value_type const &;
+    using pointer           = value_type const *;
+    using const_pointer     = value_type const *;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+private:
+    hook_pointer _current = nullptr;
+
+    explicit constexpr
+    _intrusive_const_iterator(hook_pointer ptr) noexcept
+        : _current{ptr} {}
+
+public:
+    constexpr inline
+    _intrusive_const_iterator() noexcept = default;
+
+    constexpr inline
+    _intrusive_const_iterator(_intrusive_iterator<T, Hook> const & it) noexcept : _current{it._current} { }
+
+    constexpr inline
+    reference operator*() const noexcept
+    { return *Hook::to_value(_current); }
+
+    constexpr inline
+    pointer operator->() const noexcept
+    { return Hook::to_value(_current); }
+
+    constexpr inline
+    _intrusive_const_iterator & operator++() noexcept
+    { _current = _bst_next(_current); return *this; }
+
+    constexpr inline
+    _intrusive_const_iterator operator++(int) noexcept { auto res = *this; ++(*this); return res; }
+
+    constexpr inline
+    _intrusive_const_iterator & operator--() noexcept
+    { _current = _bst_prev(_current); return *this; }
+
+    constexpr inline
+    _intrusive_const_iterator operator--(int) noexcept { auto res = *this; --(*this); return res; }
+
+    friend constexpr inline
+    bool operator==(_intrusive_const_iterator const & lhs, _intrusive_const_iterator const & rhs) noexcept
+    { return lhs._current == rhs._current; }
+
+    friend constexpr inline
+    bool operator!=(_intrusive_const_iterator const & lhs, _intrusive_const_iterator const & rhs) noexcept
+    { return !(lhs == rhs); }
+}; // struct _intrusive_const_iterator
+
+} // namespace forest :: detail
+
+#endif /* INTRUSIVE_ITERATOR_HPP */
@@ -0,0 +1,77 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : map_iterator
+ * @created     : domenica ott 18, 2026 18:04:31 CEST
+ * @license     : MIT
+ * */
+
+#ifndef MAP_ITERATOR_HPP
+#define MAP_ITERATOR_HPP
+
+#include <cstddef>  //std::ptrdiff_t
+#include <iterator> //std::bidirectional_iterator_tag
+
+namespace forest :: detail
+{
+
+template <class, class, class, class> class _avl_map_base;
+
+// Iterates over the `std::pair<Key const, Mapped>` of a map, giving access to the mapped values: the key cannot
+// change, so the order of the tree is not affected
+template <typename Value, typename Iterator, typename ConstIterator>
+struct _map_iterator
+{
+private:
+    template <class, class, class, class> friend class _avl_map_base;
+
+    Iterator _it;
+
+    explicit constexpr
+    _map_iterator(Iterator it) noexcept
+        : _it{it} {}
+
+public:
+    using value_type        = Value;
+    using reference         = value_type &;
+    using const_reference   = value_type const &;
+    using pointer           = value_type *;
+    using const_pointer     = value_type const *;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    constexpr inline
+    _map_iterator() noexcept = default;
+
+    constexpr inline
+    operator ConstIterator() const noexcept { return ConstIterator{_it}; }
+
+    constexpr inline
+    reference operator*() const noexcept { return const_cast<reference>(*_it); }
+
+    constexpr inline
+    pointer operator->() const noexcept { return std::addressof(**this); }
+
+    constexpr inline
+    _map_iterator & operator++() noexcept { ++_it; return *this; }
+
+    constexpr inline
+    _map_iterator operator++(int) noexcept { auto res = *this; ++(*this); return res; }
+
+    constexpr inline
+    _map_iterator & operator--() noexcept { --_it; return *this; }
+
+    constexpr inline
+    _map_iterator operator--(int) noexcept { auto res = *this; --(*this); return res; }
+
+    friend constexpr inline
+    bool operator==(_map_iterator const & lhs, _map_iterator const & rhs) noexcept
+    { return lhs._it == rhs._it; }
+
+    friend constexpr inline
+    bool operator!=(_map_iterator const & lhs, _map_iterator const & rhs) noexcept
+    { return !(lhs == rhs); }
+}; // struct _map_iterator
+
+} // namespace forest :: detail
+
+#endif /* MAP_ITERATOR_HPP */
@@ -61,6 +61,12 @@ template <class T, typename Int>
     ) + 1;
 }
 
+template <class Node>
+[[nodiscard]] constexpr inline auto _height_of(Node const * const n) noexcept
+{
+    return n != nullptr ? n->height : -1;
+}
+
 } // namespace forest :: detail
 
 #endif /* DETAIL_NODE_HPP */
@@ -0,0 +1,53 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : persistent_node
+ * @created     : domenica ott 18, 2026 21:24:40 CEST
+ * @license     : MIT
+ * */
+
+#ifndef DETAIL_PERSISTENT_NODE_HPP
+#define DETAIL_PERSISTENT_NODE_HPP
+
+#include <atomic>  //std::atomic
+#include <cstddef> //std::size_t
+#include <new>     //std::launder
+#include <memory>  //std::addressof
+
+#include "node.hpp" //forest::detail::_height_of
+
+namespace forest :: detail
+{
+
+// A node shared by several versions of a tree: it has no parent link, and it counts the links pointing to it
+// (from parents or from the roots of the trees). A node referenced once is owned by the only tree which can reach
+// it, and can be changed in place; the others are immutable, and are copied before changing them
+template <class T, typename Int>
+struct persistent_node
+{
+    using value_type      = T;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using pointer         = value_type *;
+    using const_pointer   = value_type const *;
+    using height_type     = Int;
+    using node_ptr        = persistent_node *;
+
+    constexpr inline reference value() noexcept
+    { return *std::launder(reinterpret_cast<pointer>(std::addressof(_storage))); }
+    constexpr inline const_reference value() const noexcept
+    { return *std::launder(reinterpret_cast<const_pointer>(std::addressof(_storage))); }
+
+    inline bool is_shared() const noexcept { return refs.load(std::memory_order_acquire) != 1; }
+
+    std::atomic<std::size_t> refs = 1;
+    node_ptr left = nullptr;
+    node_ptr right = nullptr;
+    height_type height = 0;
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+}; // struct persistent_node
+
+} // namespace forest :: detail
+
+#endif /* DETAIL_PERSISTENT_NODE_HPP */
@@ -0,0 +1,102 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : sharded_iterator
+ * @created     : domenica ott 18, 2026 23:12:48 CEST
+ * @license     : MIT
+ * */
+
+#ifndef SHARDED_ITERATOR_HPP
+#define SHARDED_ITERATOR_HPP
+
+#include <cstddef>  //std::ptrdiff_t, std::size_t
+#include <iterator> //std::bidirectional_iterator_tag
+#include <memory>   //std::addressof
+
+namespace forest
+{
+template <class, class, class, template <class, class, class> class> class sharded_tree;
+} // namespace forest
+
+namespace forest :: detail
+{
+
+// Iterates over the elements of all the shards of a `sharded_tree`. The shards hold disjoint, ordered key
+// ranges, so the merged order is the concatenation of the shards: the iterator moves to the next (or previous)
+// non empty shard when it runs off one. The past-the-end iterator is the end of the last shard
+template <typename T, typename Shards>
+struct _sharded_iterator
+{
+private:
+    template <class, class, class, template <class, class, class> class> friend class forest::sharded_tree;
+
+    using tree_iterator = typename Shards::value_type::tree_type::const_iterator;
+
+    Shards const * _shards = nullptr;
+    std::size_t _index = 0;
+    tree_iterator _it;
+
+    constexpr
+    _sharded_iterator(Shards const & shards, std::size_t index, tree_iterator it) noexcept
+        : _shards{std::addressof(shards)}, _index{index}, _it{it} { _skip_empty(); }
+
+    constexpr inline auto const & _tree() const noexcept { return (*_shards)[_index].tree; }
+
+    constexpr inline
+    void _skip_empty() noexcept
+    {
+        while (_it == _tree().end() and _index + 1 < _shards->size()) {
+            ++_index;
+            _it = _tree().begin();
+        }
+    }
+
+public:
+    using value_type        = T;
+    using reference         = value_type const &;
+    using const_reference   = value_type const &;
+    using pointer           = value_type const *;
+    using const_pointer     = value_type const *;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    constexpr inline
+    _sharded_iterator() noexcept = default;
+
+    constexpr inline
+    reference operator*() const noexcept { return *_it; }
+
+    constexpr inline
+    pointer operator->() const noexcept { return std::addressof(*_it); }
+
+    constexpr inline
+    _sharded_iterator & operator++() noexcept { ++_it; _skip_empty(); return *this; }
+
+    constexpr inline
+    _sharded_iterator operator++(int) noexcept { auto res = *this; ++(*this); return res; }
+
+    constexpr inline
+    _sharded_iterator & operator--() noexcept
+    {
+        while (_it == _tree().begin() and _index > 0) {
+            --_index;
+            _it = _tree().end();
+        }
+        --_it;
+        return *this;
+    }
+
+    constexpr inline
+    _sharded_iterator operator--(int) noexcept { auto res = *this; --(*this); return res; }
+
+    friend constexpr inline
+    bool operator==(_sharded_iterator const & lhs, _sharded_iterator const & rhs) noexcept
+    { return lhs._index == rhs._index and lhs._it == rhs._it; }
+
+    friend constexpr inline
+    bool operator!=(_sharded_iterator const & lhs, _sharded_iterator const & rhs) noexcept
+    { return !(lhs == rhs); }
+}; // struct _sharded_iterator
+
+} // namespace forest :: detail
+
+#endif /* SHARDED_ITERATOR_HPP */
@@ -0,0 +1,82 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : skiplist_node
+ * @created     : lunedì ott 19, 2026 00:21:09 CEST
+ * @license     : MIT
+ * */
+
+#ifndef DETAIL_SKIPLIST_NODE_HPP
+#define DETAIL_SKIPLIST_NODE_HPP
+
+#include <atomic>  //std::atomic
+#include <cstddef> //std::size_t, std::byte
+#include <cstdint> //std::uintptr_t, std::uint64_t
+#include <new>     //std::launder, placement new
+#include <memory>  //std::addressof
+
+namespace forest :: detail
+{
+
+// A node of a lock-free skip list. Its tower of `level` links is stored right after it, in the same allocation;
+// the lowest bit of a link marks the node as being removed from that level, so that no insertion can link a node
+// after it (Harris' marked pointers). A node is logically erased once its lowest link is marked.
+// `owners` counts the inserting thread, until it stops linking the upper levels, and the membership of the node
+// in the list, which ends with its extraction: the last one to leave retires the node
+template <class T>
+struct skiplist_node
+{
+    using value_type      = T;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using pointer         = value_type *;
+    using const_pointer   = value_type const *;
+    using node_ptr        = skiplist_node *;
+    using link            = std::atomic<std::uintptr_t>;
+
+    static constexpr std::size_t max_level = 32;
+
+    constexpr inline reference value() noexcept
+    { return *std::launder(reinterpret_cast<pointer>(std::addressof(_storage))); }
+    constexpr inline const_reference value() const noexcept
+    { return *std::launder(reinterpret_cast<const_pointer>(std::addressof(_storage))); }
+
+    // How many nodes worth of memory hold a node with a tower of `level` links
+    static constexpr inline
+    std::size_t units(std::size_t level) noexcept
+    { return 1 + (level * sizeof(link) + sizeof(skiplist_node) - 1) / sizeof(skiplist_node); }
+
+    // Starts the lifetime of the `level` null links following the node
+    inline void construct_tower() noexcept
+    {
+        auto const raw = reinterpret_cast<std::byte *>(this + 1);
+        for (std::size_t l = 0; l < level; ++l) {
+            ::new (static_cast<void *>(raw + l * sizeof(link))) link{0};
+        }
+    }
+    inline link * tower() noexcept { return std::launder(reinterpret_cast<link *>(this + 1)); }
+    inline link const * tower() const noexcept { return std::launder(reinterpret_cast<link const *>(this + 1)); }
+
+    static inline bool is_marked(std::uintptr_t l) noexcept { return (l & 1) != 0; }
+    static inline node_ptr pointer_of(std::uintptr_t l) noexcept
+    { return reinterpret_cast<node_ptr>(l & ~std::uintptr_t{1}); }
+    static inline std::uintptr_t link_to(node_ptr n) noexcept { return reinterpret_cast<std::uintptr_t>(n); }
+
+    inline std::uintptr_t load(std::size_t l) const noexcept { return tower()[l].load(std::memory_order_acquire); }
+    inline node_ptr next(std::size_t l) const noexcept { return pointer_of(load(l)); }
+    inline bool is_erased() const noexcept { return is_marked(load(0)); }
+    // Marks the link at level `l`; true if it was not marked before
+    inline bool mark(std::size_t l) noexcept
+    { return not is_marked(tower()[l].fetch_or(1, std::memory_order_acq_rel)); }
+
+    std::size_t level = 0;
+    std::atomic<int> owners = 2;
+    node_ptr retired_next = nullptr;
+    std::uint64_t retired_epoch = 0;
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+}; // struct skiplist_node
+
+} // namespace forest :: detail
+
+#endif /* DETAIL_SKIPLIST_NODE_HPP */
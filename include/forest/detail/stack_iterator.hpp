@@ -0,0 +1,137 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : stack_iterator
+ * @created     : domenica ott 18, 2026 21:31:02 CEST
+ * @license     : MIT
+ * */
+
+#ifndef STACK_ITERATOR_HPP
+#define STACK_ITERATOR_HPP
+
+#include <array>    //std::array
+#include <cstddef>  //std::ptrdiff_t, std::size_t
+#include <iterator> //std::bidirectional_iterator_tag
+#include <memory>   //std::addressof
+
+namespace forest
+{
+template <class, class, class> class persistent_avl_tree;
+template <class, class, class, class> class compact_avl_tree;
+} // namespace forest
+
+namespace forest :: detail
+{
+
+// Iterates over a tree whose nodes have no parent link, keeping the path from the root to the current node.
+// An avl tree of height 64 holds more than 10^13 elements, so the path has a fixed capacity.
+// The past-the-end iterator has an empty path; it keeps the root, to be decremented
+template <typename T, typename Node>
+struct _stack_iterator
+{
+private:
+    template <class, class, class> friend class forest::persistent_avl_tree;
+    template <class, class, class, class> friend class forest::compact_avl_tree;
+
+    using node_pointer = Node const *;
+    static constexpr std::size_t _max_depth = 64;
+
+public:
+    using value_type        = T;
+    using reference         = value_type const &;
+    using const_reference   = value_type const &;
+    using pointer           = value_type const *;
+    using const_pointer     = value_type const *;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+private:
+    node_pointer _root = nullptr;
+    std::size_t _depth = 0;
+    std::array<node_pointer, _max_depth> _path{};
+
+    explicit constexpr
+    _stack_iterator(node_pointer root) noexcept
+        : _root{root} {}
+
+    constexpr inline node_pointer _current() const noexcept { return _path[_depth - 1]; }
+    constexpr inline void _push(node_pointer n) noexcept { _path[_depth++] = n; }
+
+    // Goes down to the first (or last, if not `left`) node of the subtree of `n`
+    constexpr inline
+    void _descend(node_pointer n, bool left) noexcept
+    {
+        for (; n != nullptr; n = left ? n->left : n->right) {
+            _push(n);
+        }
+    }
+    // Climbs to the first ancestor reached from its left (or right, if not `left`) subtree
+    constexpr inline
+    void _climb(bool left) noexcept
+    {
+        auto n = _path[--_depth];
+        while (_depth > 0 and (left ? _current()->left : _current()->right) != n) {
+            n = _path[--_depth];
+        }
+    }
+
+public:
+    constexpr inline
+    _stack_iterator() noexcept = default;
+
+    constexpr inline
+    reference operator*() const noexcept
+    { return _current()->value(); }
+
+    constexpr inline
+    pointer operator->() const noexcept
+    { return std::addressof(_current()->value()); }
+
+    constexpr inline
+    _stack_iterator & operator++() noexcept
+    {
+        if (auto const right = _current()->right; right != nullptr) {
+            _push(right);
+            _descend(right->left, true);
+        } else {
+            _climb(true);
+        }
+        return *this;
+    }
+
+    constexpr inline
+    _stack_iterator operator++(int) noexcept { auto res = *this; ++(*this); return res; }
+
+    constexpr inline
+    _stack_iterator & operator--() noexcept
+    {
+        if (_depth == 0) {
+            _descend(_root, false);
+        } else if (auto const left = _current()->left; left != nullptr) {
+            _push(left);
+            _descend(left->right, false);
+        } else {
+            _climb(false);
+        }
+        return *this;
+    }
+
+    constexpr inline
+    _stack_iterator operator--(int) noexcept { auto res = *this; --(*this); return res; }
+
+    friend constexpr inline
+    bool operator==(_stack_iterator const & lhs, _stack_iterator const & rhs) noexcept
+    {
+        if (lhs._depth == 0 or rhs._depth == 0) {
+            return lhs._depth == rhs._depth;
+        }
+        return lhs._current() == rhs._current();
+    }
+
+    friend constexpr inline
+    bool operator!=(_stack_iterator const & lhs, _stack_iterator const & rhs) noexcept
+    { return !(lhs == rhs); }
+}; // struct _stack_iterator
+
+} // namespace forest :: detail
+
+#endif /* STACK_ITERATOR_HPP */
@@ -0,0 +1,152 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : threaded_iterator
+ * @created     : domenica ott 18, 2026 10:40:05 CEST
+ * @license     : MIT
+ * */
+
+#ifndef THREADED_ITERATOR_HPP
+#define THREADED_ITERATOR_HPP
+
+#include <cstddef>  //std::ptrdiff_t
+#include <cstdint>  //std::int_fast8_t
+#include <iterator> //std::bidirectional_iterator_tag
+
+#include "threaded_node.hpp"
+
+namespace forest
+{
+template <class, class, class> class threaded_avl_tree;
+} // namespace forest
+
+namespace forest :: detail
+{
+
+template <typename T> struct _threaded_iterator;
+template <typename T> struct _threaded_const_iterator;
+
+template <typename T>
+struct _threaded_iterator
+{
+private:
+    template <class, class, class> friend class forest::threaded_avl_tree;
+    template <class> friend struct _threaded_const_iterator;
+
+    using node_type         = threaded_node<T, std::int_fast8_t>;
+    using node_pointer      = node_type *;
+public:
+    using value_type        = T;
+    using reference         = value_type const &;
+    using const_reference   = value_type const &;
+    using pointer           = value_type const *;
+    using const_pointer     = value_type const *;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+private:
+    node_pointer _current = nullptr;
+
+    explicit constexpr
+    _threaded_iterator(node_pointer ptr) noexcept
+        : _current{ptr} {}
+
+public:
+    constexpr inline
+    _threaded_iterator() noexcept = default;
+
+    constexpr inline
+    reference operator*() const noexcept
+    { return _current->value(); }
+
+    constexpr inline
+    pointer operator->() const noexcept
+    { return std::addressof(_current->value()); }
+
+    constexpr inline
+    _threaded_iterator & operator++() noexcept
+    { _current = _threaded_next(_current); return *this; }
+
+    constexpr inline
+    _threaded_iterator operator++(int) noexcept { auto res = *this; ++(*this); return res; }
+
+    constexpr inline
+    _threaded_iterator & operator--() noexcept
+    { _current = _threaded_prev(_current); return *this; }
+
+    constexpr inline
+    _threaded_iterator operator--(int) noexcept { auto res = *this; --(*this); return res; }
+
+    friend constexpr inline
+    bool operator==(_threaded_iterator const & lhs, _threaded_iterator const & rhs) noexcept
+    { return lhs._current == rhs._current; }
+
+    friend constexpr inline
+    bool operator!=(_threaded_iterator const & lhs, _threaded_iterator const & rhs) noexcept
+    { return !(lhs == rhs); }
+}; // struct _threaded_iterator
+
+template <typename T>
+struct _threaded_const_iterator
+{
+private:
+    template <class, class, class> friend class forest::threaded_avl_tree;
+
+    using node_type         = threaded_node<T, std::int_fast8_t>;
+    using node_pointer      = node_type const *;
+public:
+    using value_type        = T;
+    using reference         = value_type const &;
+    using const_reference   = value_type const &;
+    using pointer           = value_type const *;
+    using const_pointer     = value_type const *;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+private:
+    node_pointer _current = nullptr;
+
+    explicit constexpr
+    _threaded_const_iterator(node_pointer ptr) noexcept
+        : _current{ptr} {}
+
+public:
+    constexpr inline
+    _threaded_const_iterator() noexcept = default;
+
+    constexpr inline
+    _threaded_const_iterator(_threaded_iterator<T> const & it) noexcept : _current{it._current} { }
+
+    constexpr inline
+    reference operator*() const noexcept
+    { return _current->value(); }
+
+    constexpr inline
+    pointer operator->() const noexcept
+    { return std::addressof(_current->value()); }
+
+    constexpr inline
+    _threaded_const_iterator & operator++() noexcept
+    { _current = _threaded_next(_current); return *this; }
+
+    constexpr inline
+    _threaded_const_iterator operator++(int) noexcept { auto res = *this; ++(*this); return res; }
+
+    constexpr inline
+    _threaded_const_iterator & operator--() noexcept
+    { _current = _threaded_prev(_current); return *this; }
+
+    constexpr inline
+    _threaded_const_iterator operator--(int) noexcept { auto res = *this; --(*this); return res; }
+
+    friend constexpr inline
+    bool operator==(_threaded_const_iterator const & lhs, _threaded_const_iterator const & rhs) noexcept
+    { return lhs._current == rhs._current; }
+
+    friend constexpr inline
+    bool operator!=(_threaded_const_iterator const & lhs, _threaded_const_iterator const & rhs) noexcept
+    { return !(lhs == rhs); }
+}; // struct _threaded_const_iterator
+
+} // namespace forest :: detail
+
+#endif /* THREADED_ITERATOR_HPP */
@@ -0,0 +1,114 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : threaded_node
+ * @created     : domenica ott 18, 2026 10:12:31 CEST
+ * @license     : MIT
+ * */
+
+#ifndef DETAIL_THREADED_NODE_HPP
+#define DETAIL_THREADED_NODE_HPP
+
+#include <algorithm> //std::max
+#include <cstdint>   //std::uintptr_t
+#include <new>       //std::launder
+#include <memory>    //std::addressof
+
+namespace forest :: detail
+{
+
+// A child link which, when the child is missing, stores a thread to the in-order predecessor (for `left`)
+// or successor (for `right`), tagged in the lowest bit of the pointer
+template <class Node>
+struct _thread_link
+{
+    std::uintptr_t _bits = 0;
+
+    constexpr inline
+    Node * get() const noexcept { return reinterpret_cast<Node *>(_bits & ~std::uintptr_t{1}); }
+    constexpr inline
+    bool is_thread() const noexcept { return (_bits & 1) != 0; }
+    constexpr inline
+    bool is_child() const noexcept { return (_bits & 1) == 0; }
+    constexpr inline
+    Node * child() const noexcept { return is_child() ? get() : nullptr; }
+
+    constexpr inline
+    void set_child(Node * n) noexcept { _bits = reinterpret_cast<std::uintptr_t>(n); }
+    constexpr inline
+    void set_thread(Node * n) noexcept { _bits = reinterpret_cast<std::uintptr_t>(n) | 1; }
+}; // struct _thread_link
+
+template <class T, typename Int>
+struct threaded_node
+{
+    using value_type      = T;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using pointer         = value_type *;
+    using const_pointer   = value_type const *;
+    using height_type     = Int;
+    using node_ptr        = threaded_node *;
+    using link_type       = _thread_link<threaded_node>;
+
+    constexpr inline reference value() noexcept
+    { return *std::launder(reinterpret_cast<pointer>(std::addressof(_storage))); }
+    constexpr inline const_reference value() const noexcept
+    { return *std::launder(reinterpret_cast<const_pointer>(std::addressof(_storage))); }
+
+    height_type height = 0;
+    node_ptr root = nullptr;
+    link_type left;
+    link_type right;
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+}; // struct threaded_node
+
+template <class T, typename Int>
+[[nodiscard]] constexpr inline auto _node_height(threaded_node<T, Int> const * const v) noexcept
+    -> Int
+{
+    return std::max(
+        v->left.is_child()  ? v->left.get()->height  : -1,
+        v->right.is_child() ? v->right.get()->height : -1
+    ) + 1;
+}
+
+template <class T, typename Int>
+[[nodiscard]] constexpr inline auto _height_of(threaded_node<T, Int> const * const n) noexcept
+{
+    return n != nullptr ? n->height : -1;
+}
+
+// In-order successor and predecessor: a single hop through a thread, or a descent along one spine
+template <class Node>
+constexpr inline
+Node * _threaded_next(Node * n) noexcept
+{
+    if (n->right.is_thread()) {
+        return n->right.get();
+    }
+    n = n->right.get();
+    while (n->left.is_child()) {
+        n = n->left.get();
+    }
+    return n;
+}
+
+template <class Node>
+constexpr inline
+Node * _threaded_prev(Node * n) noexcept
+{
+    if (n->left.is_thread()) {
+        return n->left.get();
+    }
+    n = n->left.get();
+    while (n->right.is_child()) {
+        n = n->right.get();
+    }
+    return n;
+}
+
+} // namespace forest :: detail
+
+#endif /* DETAIL_THREADED_NODE_HPP */
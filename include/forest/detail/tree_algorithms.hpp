@@ -0,0 +1,694 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : tree_algorithms
+ * @created     : domenica ott 18, 2026 13:31:52 CEST
+ * @license     : MIT
+ * */
+
+#ifndef TREE_ALGORITHMS_HPP
+#define TREE_ALGORITHMS_HPP
+
+#include <algorithm>   //std::max
+#include <cstddef>     //std::ptrdiff_t, std::size_t
+#include <cstdint>     //std::uint64_t, std::uintptr_t
+#include <type_traits> //std::is_nothrow_invocable_v
+#include <utility>     //std::pair, std::exchange
+
+#include "node.hpp"  //forest::detail::_height_of
+
+// Algorithms shared by every tree with parent links. They work on any `Node` exposing the `root`, `left`,
+// `right` and `height` members, and on the sentinel layout of `_tree_impl`: `end->root` is the root of the tree,
+// `end->left` the last element and `end->right` the first one; the root of the tree has `end` as `root`.
+
+namespace forest :: detail
+{
+
+template <class Node>
+[[nodiscard]] constexpr inline auto _subtree_height(Node const * const v) noexcept
+{
+    return static_cast<decltype(v->height)>(std::max<int>(_height_of(v->left), _height_of(v->right)) + 1);
+}
+
+/// Traversal
+template <class Node>
+constexpr Node * _bst_next(Node * n) noexcept
+{
+    if (n->right != nullptr) {
+        n = n->right;
+        if (n->left == n) { //`n` is the sentinel of an empty tree
+            return n;
+        }
+        while (n->left != nullptr) {
+            n = n->left;
+        }
+        return n;
+    }
+
+    auto prev = n;
+    n = n->root;
+    if (n->root == prev) {
+        return n; //There's only one element: not doing this will start an infinite loop
+    }
+    //if the root is _end.left, it will stop at `_end`
+    while (prev == n->right && n->right != n->root) {
+        prev = n;
+        n = n->root;
+    }
+    return n;
+}
+
+template <class Node>
+constexpr Node * _bst_prev(Node * n) noexcept
+{
+    if (n->left != nullptr) {
+        n = n->left;
+        if (n->right == n) {
+            return n;
+        }
+        while (n->right != nullptr) {
+            n = n->right;
+        }
+        return n;
+    }
+
+    auto prev = n;
+    n = n->root;
+    if (n->root == prev) {
+        return n;  //There's only one element; not doing this will start an infinite cycle
+    }
+    while (prev == n->left) {
+        prev = n;
+        n = n->root;
+    }
+    return n;
+}
+
+// The number of links between `n` and the root of its tree. The root is the only node whose parent links back
+// to it, through the `root` of the sentinel
+template <class Node>
+[[nodiscard]] constexpr inline std::size_t _depth_of(Node const * n) noexcept
+{
+    auto depth = std::size_t{0};
+    for (; n->root->root != n; n = n->root) {
+        ++depth;
+    }
+    return depth;
+}
+
+// Calls `visit` with the depth of each node of the tree, in order: walks the parent links rather than recursing,
+// so that it needs no memory whatever the shape of the tree
+template <class Node, class Visit>
+constexpr void _for_each_depth(Node const * end, Visit && visit)
+{
+    auto n = end->root;
+    if (n == end) {
+        return;
+    }
+    auto depth = std::size_t{0};
+    for (; n->left != nullptr; n = n->left) {
+        ++depth;
+    }
+    while (true) {
+        visit(depth);
+        if (n->right != nullptr) {
+            for (n = n->right, ++depth; n->left != nullptr; n = n->left) {
+                ++depth;
+            }
+            continue;
+        }
+        auto parent = n->root;
+        for (; parent != end and parent->right == n; parent = parent->root) {
+            n = parent;
+            --depth;
+        }
+        if (parent == end) {
+            return;
+        }
+        n = parent;
+        --depth;
+    }
+}
+
+/// Linking
+template <class Node>
+constexpr inline
+void _replace_child(Node * root, Node * old, Node * child, Node * end) noexcept
+{
+    if (root == end) {
+        end->root = child;
+    } else if (root->left == old) {
+        root->left = child;
+    } else {
+        root->right = child;
+    }
+    if (child != nullptr) {
+        child->root = root;
+    }
+}
+
+// Links the detached node `n` as the `left` (or right) child of `root`, which must be missing, and updates
+// the first and last element of the tree; `root` is `end` if the tree is empty
+template <class Node>
+constexpr
+void _link_leaf(Node * root, bool left, Node * n, Node * end) noexcept
+{
+    n->left = n->right = nullptr;
+    n->height = 0;
+    n->root = root;
+    if (root == end) {
+        end->root = end->left = end->right = n;
+    } else if (left) {
+        root->left = n;
+        if (end->right == root) {
+            end->right = n;
+        }
+    } else {
+        root->right = n;
+        if (end->left == root) {
+            end->left = n;
+        }
+    }
+}
+
+// The missing child of a leaf where `value` can be linked, searching from `from`, a node close to its position:
+// climbs until the subtree of the current node is bounded by `value` on both sides, then descends from there.
+// The cost is proportional to the distance in the tree between `from` and the slot, rather than to the height.
+// As in a descent from the root, equivalent elements are left before `value`
+template <class Node, class Value, class Compare>
+constexpr
+auto _finger_slot(Node * from, Value const & value, Compare const & cmp, Node * end)
+    -> std::pair<Node *, bool>
+{
+    auto const after = not cmp(value, from->value());
+    auto top = from;
+    for (auto root = top->root; root != end; top = root, root = root->root) {
+        if (after and root->left == top and cmp(value, root->value())) {
+            break;
+        }
+        if (not after and root->right == top and not cmp(value, root->value())) {
+            break;
+        }
+    }
+    while (true) {
+        auto const left = cmp(value, top->value());
+        auto const next = left ? top->left : top->right;
+        if (next == nullptr) {
+            return {top, left};
+        }
+        top = next;
+    }
+}
+
+// Unlinks `unlink` from the tree, leaving it with no links. Returns the deepest node whose subtree changed,
+// which is where a rebalancing should start from (it may be `end`, if the root was removed).
+// The first and last element of the tree are not updated
+template <class Node>
+constexpr
+Node * _unlink(Node * unlink, Node * end) noexcept
+{
+    auto const root  = unlink->root;
+    auto const left  = unlink->left;
+    auto const right = unlink->right;
+    auto changed = root;
+
+    if (left == nullptr or right == nullptr) { // at most one child
+        _replace_child(root, unlink, left != nullptr ? left : right, end);
+    } else { // two children: the predecessor takes the place of `unlink`
+        auto const repl = _bst_prev(unlink);
+        if (repl == left) {
+            changed = repl;
+        } else {
+            changed = repl->root;
+            changed->right = repl->left;
+            if (repl->left != nullptr) {
+                repl->left->root = changed;
+            }
+            repl->left = left;
+            left->root = repl;
+        }
+        repl->right = right;
+        right->root = repl;
+        repl->height = unlink->height;
+        _replace_child(root, unlink, repl, end);
+    }
+
+    unlink->left = unlink->right = unlink->root = nullptr;
+    unlink->height = 0;
+    return changed;
+}
+
+/// AVL balancing
+// The balancing algorithms take an `update` callback, invoked on each node whose subtree changed (children first),
+// right after its height: trees storing per-subtree data use it to recompute them
+struct _no_update
+{
+    template <class Node>
+    constexpr inline void operator()(Node *) const noexcept {}
+}; // struct _no_update
+
+// An `update` may also expose `rotated()` and `rebalanced()`, called on each rotation and on each node visited
+// while rebalancing
+template <class Update>
+constexpr inline void _notify_rotated(Update & update) noexcept
+{
+    if constexpr (requires { update.rotated(); }) {
+        update.rotated();
+    }
+}
+
+template <class Update>
+constexpr inline void _notify_rebalanced(Update & update) noexcept
+{
+    if constexpr (requires { update.rebalanced(); }) {
+        update.rebalanced();
+    }
+}
+
+// Rotations which only relink the nodes: `v` goes down, and its left (or right) child `u` takes its place
+template <class Node>
+constexpr inline
+Node * _relink_right_rotation(Node * const v, Node * const end) noexcept
+{
+    auto const root = v->root;
+    auto const u  = v->left;
+    auto const ur = u->right;
+
+    if (root == end) {
+        end->root = u;
+    }
+    else if (root->left == v) {
+        root->left = u;
+    } else {
+        root->right = u;
+    }
+    u->root = root;
+    v->root = u;
+    u->right = v;
+
+    v->left = ur;
+    if (ur != nullptr) {
+        ur->root = v;
+    }
+    return u;
+}
+
+template <class Node>
+constexpr inline
+Node * _relink_left_rotation(Node * const v, Node * const end) noexcept
+{
+    auto const root = v->root;
+    auto const u = v->right;
+    auto const ul = u->left;
+
+    if (root == end) {
+        end->root = u;
+    }
+    else if (root->left == v) {
+        root->left = u;
+    } else {
+        root->right = u;
+    }
+    u->root = root;
+    v->root = u;
+    u->left = v;
+
+    v->right = ul;
+    if (ul != nullptr) {
+        ul->root = v;
+    }
+    return u;
+}
+
+template <class Node, class Update = _no_update>
+constexpr
+void _avl_right_rotation(Node * const v, Node * const end, Update && update = {})
+    noexcept(std::is_nothrow_invocable_v<Update &, Node *>)
+{
+    auto const u = _relink_right_rotation(v, end);
+    v->height = _subtree_height(v);
+    update(v);
+    u->height = _subtree_height(u);
+    update(u);
+    _notify_rotated(update);
+}
+
+template <class Node, class Update = _no_update>
+constexpr
+void _avl_left_rotation(Node * const v, Node * const end, Update && update = {})
+    noexcept(std::is_nothrow_invocable_v<Update &, Node *>)
+{
+    auto const u = _relink_left_rotation(v, end);
+    v->height = _subtree_height(v);
+    update(v);
+    u->height = _subtree_height(u);
+    update(u);
+    _notify_rotated(update);
+}
+
+template <class Node>
+[[nodiscard]] constexpr inline
+std::ptrdiff_t _balance_factor(Node const * const n) noexcept
+{
+    return _height_of(n->left) - _height_of(n->right);
+}
+
+// Restores heights and balance from `ptr` (included) up to the root
+template <class Node, class Update = _no_update>
+constexpr
+void _avl_balance_from(Node * ptr, Node * const end, Update && update = {})
+    noexcept(std::is_nothrow_invocable_v<Update &, Node *>)
+{
+    for (; ptr != end; ptr = ptr->root) {
+        ptr->height = _subtree_height(ptr);
+        update(ptr);
+        _notify_rebalanced(update);
+
+        if (auto const diff = _balance_factor(ptr); diff >= 2) {
+            if (_balance_factor(ptr->left) < 0) {
+                _avl_left_rotation(ptr->left, end, update);
+            }
+            _avl_right_rotation(ptr, end, update);
+        } else if (diff <= -2) {
+            if (_balance_factor(ptr->right) > 0) {
+                _avl_right_rotation(ptr->right, end, update);
+            }
+            _avl_left_rotation(ptr, end, update);
+        }
+    }
+}
+
+/// WAVL balancing
+// Weak AVL trees (see Haeupler, Sen, Tarjan - "Rank-Balanced Trees") store a rank in `height`, a missing node
+// having rank -1. The rank difference between a node and each of its children is 1 or 2, and leaves have rank 0,
+// so that without erasures a weak AVL tree is an AVL tree with rank as height. Both fixups stop as soon as the
+// rule holds again, after at most two rotations: `update` is told about rotations and rebalancing steps only,
+// as the nodes above the stopping point are not visited
+template <class Node>
+[[nodiscard]] constexpr inline
+int _rank_difference(Node const * const parent, Node const * const child) noexcept
+{
+    return parent->height - _height_of(child);
+}
+
+template <class Node, class Update>
+constexpr inline
+void _wavl_rotation(Node * const v, bool right, Node * const end, Update & update) noexcept
+{
+    right ? _relink_right_rotation(v, end) : _relink_left_rotation(v, end);
+    _notify_rotated(update);
+}
+
+// Restores the rank rule after the leaf `x`, of rank 0, was linked: while `x` is a 0-child, its parent is
+// promoted if the sibling of `x` is a 1-child, and the parent is rotated down otherwise
+template <class Node, class Update = _no_update>
+constexpr
+void _wavl_insert_fixup(Node * x, Node * const end, Update && update = {}) noexcept
+{
+    for (auto p = x->root; p != end and p->height == x->height; x = p, p = p->root) {
+        _notify_rebalanced(update);
+        auto const left = p->left == x;
+        if (_rank_difference(p, left ? p->right : p->left) == 1) {
+            ++p->height;
+            continue;
+        }
+        auto const inner = left ? x->right : x->left;
+        if (_rank_difference(x, inner) == 2) {
+            _wavl_rotation(p, left, end, update);
+            --p->height;
+        } else {
+            _wavl_rotation(x, not left, end, update);
+            _wavl_rotation(p, left, end, update);
+            ++inner->height;
+            --x->height;
+            --p->height;
+        }
+        return;
+    }
+}
+
+// Restores the rank rule after a node was unlinked below `p`, as returned by `_unlink`: a leaf left with rank 1
+// is demoted, then while a child of `p` is a 3-child, `p` (and possibly the sibling) is demoted, unless the
+// sibling has a 1-child on the far side, or on the near side only, which are rotated up
+template <class Node, class Update = _no_update>
+constexpr
+void _wavl_erase_fixup(Node * p, Node * const end, Update && update = {}) noexcept
+{
+    if (p == end) {
+        return;
+    }
+    if (p->left == nullptr and p->right == nullptr and p->height != 0) {
+        _notify_rebalanced(update);
+        p->height = 0;
+        p = p->root;
+    }
+    for (; p != end; p = p->root) {
+        _notify_rebalanced(update);
+        auto const left = _rank_difference(p, p->left) == 3;
+        if (not left and _rank_difference(p, p->right) != 3) {
+            return;
+        }
+        auto const y = left ? p->right : p->left;
+        if (_rank_difference(p, y) == 2) {
+            --p->height;
+            continue;
+        }
+        auto const outer = left ? y->right : y->left;
+        auto const inner = left ? y->left : y->right;
+        if (_rank_difference(y, outer) == 2 and _rank_difference(y, inner) == 2) {
+            --p->height;
+            --y->height;
+            continue;
+        }
+        if (_rank_difference(y, outer) == 1) {
+            _wavl_rotation(p, not left, end, update);
+            ++y->height;
+            --p->height;
+            if (p->left == nullptr and p->right == nullptr) {
+                --p->height;
+            }
+        } else {
+            _wavl_rotation(y, left, end, update);
+            _wavl_rotation(p, not left, end, update);
+            inner->height += 2;
+            --y->height;
+            p->height -= 2;
+        }
+        return;
+    }
+}
+
+/// Treap balancing
+// A treap keeps its nodes in heap order of a priority, besides the search order. The priority of a node is a hash
+// of its address (the finalizer of splitmix64), so that it takes no space and the node keeps it wherever it is
+// linked, even in another tree. The shape of the tree is then that of a random binary search tree
+template <class Node>
+[[nodiscard]] inline
+std::uint64_t _treap_priority(Node const * const n) noexcept
+{
+    auto x = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(n));
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9u;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebu;
+    return x ^ (x >> 31);
+}
+
+// Rotates the leaf `n`, just linked, up while its priority is higher than the one of its parent: the expected
+// number of rotations is less than two
+template <class Node, class Update = _no_update>
+constexpr
+void _treap_sift_up(Node * const n, Node * const end, Update && update = {}) noexcept
+{
+    for (auto p = n->root; p != end and _treap_priority(p) < _treap_priority(n); p = n->root) {
+        p->left == n ? _relink_right_rotation(p, end) : _relink_left_rotation(p, end);
+        _notify_rotated(update);
+    }
+}
+
+// Rotates `n` down, below its child of higher priority, until it has at most one child and can be unlinked
+// without breaking the heap order
+template <class Node, class Update = _no_update>
+constexpr
+void _treap_sift_down(Node * const n, Node * const end, Update && update = {}) noexcept
+{
+    while (n->left != nullptr and n->right != nullptr) {
+        _treap_priority(n->left) > _treap_priority(n->right) ? _relink_right_rotation(n, end)
+                                                               : _relink_left_rotation(n, end);
+        _notify_rotated(update);
+    }
+}
+
+// Splits the subtree of `root` in the nodes for which `goes_right` is false and the ones for which it is true,
+// which must follow them in order; returns the roots of the two treaps, whose `root` link is left to the caller.
+// It takes a single descent, relinking the nodes met along it
+template <class Node, class Pred>
+constexpr
+auto _treap_split(Node * root, Pred && goes_right) -> std::pair<Node *, Node *>
+{
+    Node * roots[2] = {nullptr, nullptr};
+    Node ** slots[2] = {&roots[0], &roots[1]};
+    Node * parents[2] = {nullptr, nullptr};
+    while (root != nullptr) {
+        auto const side = goes_right(root) ? 1 : 0;
+        *slots[side] = root;
+        root->root = parents[side];
+        parents[side] = root;
+        slots[side] = side == 1 ? &root->left : &root->right;
+        root = *slots[side];
+    }
+    *slots[0] = *slots[1] = nullptr;
+    return {roots[0], roots[1]};
+}
+
+// Joins the treaps rooted in `left` and `right`, whose nodes all follow the ones of `left`, merging the right
+// spine of the former with the left spine of the latter; returns the new root, whose `root` link is left to the
+// caller
+template <class Node>
+constexpr
+Node * _treap_join(Node * left, Node * right) noexcept
+{
+    auto root = static_cast<Node *>(nullptr);
+    auto slot = &root;
+    auto parent = static_cast<Node *>(nullptr);
+    while (left != nullptr and right != nullptr) {
+        auto & top = _treap_priority(left) > _treap_priority(right) ? left : right;
+        *slot = top;
+        top->root = parent;
+        parent = top;
+        if (&top == &left) {
+            slot = &top->right;
+            left = left->right;
+        } else {
+            slot = &top->left;
+            right = right->left;
+        }
+    }
+    *slot = left != nullptr ? left : right;
+    if (*slot != nullptr) {
+        (*slot)->root = parent;
+    }
+    return root;
+}
+
+// Links the nodes of `chain`, given in order through their right links, in a treap, without comparing them: each
+// node pops the nodes of lower priority off the right spine, and takes them as its left subtree. It takes O(n)
+// steps overall; returns the root, whose `root` link is left to the caller
+template <class Node>
+constexpr
+Node * _treap_build(Node * chain) noexcept
+{
+    auto root = static_cast<Node *>(nullptr);
+    auto spine = static_cast<Node *>(nullptr);
+    while (chain != nullptr) {
+        auto const n = chain;
+        chain = chain->right;
+        auto below = static_cast<Node *>(nullptr);
+        auto top = spine;
+        for (; top != nullptr and _treap_priority(top) < _treap_priority(n); top = top->root) {
+            below = top;
+        }
+        n->left = below;
+        n->right = nullptr;
+        n->height = 0;
+        if (below != nullptr) {
+            below->root = n;
+        }
+        n->root = top;
+        (top != nullptr ? top->right : root) = n;
+        spine = n;
+    }
+    return root;
+}
+
+/// Splaying
+// Splaying (see Sleator, Tarjan - "Self-Adjusting Binary Search Trees") moves a node to the root with pairs of
+// rotations, which roughly halve the depth of the nodes along its path, so that the nodes accessed often stay
+// close to the root. Semi-splaying rotates only once in the zig-zig case, and goes on from the parent of the
+// node: the node climbs only part of the way, and about half as many links are written, with the same amortized
+// bounds
+template <class Node>
+constexpr inline
+void _rotate_up(Node * const x, Node * const end) noexcept
+{
+    x->root->left == x ? _relink_right_rotation(x->root, end) : _relink_left_rotation(x->root, end);
+}
+
+template <class Node, class Update = _no_update>
+constexpr
+void _splay(Node * x, Node * const end, bool semi, Update && update = {}) noexcept
+{
+    while (x->root != end) {
+        _notify_rebalanced(update);
+        auto const p = x->root;
+        auto const g = p->root;
+        if (g == end) { // zig
+            _rotate_up(x, end);
+            _notify_rotated(update);
+            return;
+        }
+        if ((g->left == p) == (p->left == x)) { // zig-zig
+            _rotate_up(p, end);
+            _notify_rotated(update);
+            if (semi) {
+                x = p;
+                continue;
+            }
+            _rotate_up(x, end);
+        } else { // zig-zag
+            _rotate_up(x, end);
+            _notify_rotated(update);
+            _rotate_up(x, end);
+        }
+        _notify_rotated(update);
+    }
+}
+
+/// Scapegoat rebuilding
+// A scapegoat tree (see Galperin, Rivest - "Scapegoat Trees") stores nothing in its nodes: it finds the
+// subtrees to rebuild by counting their nodes, and rebuilds them by chaining their nodes in order and linking
+// the chain back in a balanced shape, both in time proportional to their size
+template <class Node>
+[[nodiscard]] constexpr std::size_t _subtree_size(Node const * n) noexcept
+{
+    if (n == nullptr) {
+        return 0;
+    }
+    auto first = n;
+    for (; first->left != nullptr; first = first->left) {}
+    auto last = n;
+    for (; last->right != nullptr; last = last->right) {}
+    auto size = std::size_t{1};
+    for (; first != last; first = _bst_next(first)) {
+        ++size;
+    }
+    return size;
+}
+
+// Chains the nodes of the subtree rooted at `n` in order through their right links, and returns the first one.
+// The subtree is walked backwards, so that each right link is rewritten after the walk has left it behind
+template <class Node>
+constexpr Node * _flatten(Node * n) noexcept
+{
+    auto const stop = n->root;
+    for (; n->right != nullptr; n = n->right) {}
+    auto chain = static_cast<Node *>(nullptr);
+    while (n != nullptr) {
+        auto prev = n->left;
+        if (prev != nullptr) {
+            for (; prev->right != nullptr; prev = prev->right) {}
+        } else {
+            auto child = n;
+            for (prev = n->root; prev != stop and prev->left == child; prev = prev->root) {
+                child = prev;
+            }
+            if (prev == stop) {
+                prev = nullptr;
+            }
+        }
+        n->right = std::exchange(chain, n);
+        n = prev;
+    }
+    return chain;
+}
+
+} // namespace forest :: detail
+
+#endif /* TREE_ALGORITHMS_HPP */
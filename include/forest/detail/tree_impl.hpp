@@ -9,6 +9,7 @@
 #define TREE_IMPL_HPP
 
 #include <memory>
+#include <utility> //std::exchange
 
 #include "node.hpp"
 
@@ -41,6 +42,9 @@ protected:
     node_impl_type _end; // _end->root = root; _end->left = front; _end->right = back
     size_type _size;
     [[no_unique_address]] node_allocator _node_alloc;
+    // Allocated nodes holding no value, linked through `right`: new elements take them before allocating
+    node_pointer _spare = nullptr;
+    size_type _spare_count = 0;
 
     constexpr _tree_impl()
         noexcept(noexcept(std::is_nothrow_default_constructible<node_allocator>::value));
@@ -51,14 +55,30 @@ protected:
     inline ~_tree_impl() noexcept;
 
     constexpr void clear() noexcept;
+    constexpr void _destroy_node(node_pointer del) noexcept;
+    constexpr size_type _destroy_subtree(node_pointer top) noexcept;
+    template <typename Dispose>
+    constexpr size_type _dispose_subtree(node_pointer top, Dispose && dispose) noexcept;
     constexpr bool empty() const noexcept { return _size == 0; }
 
+    /// Spare nodes
+    constexpr inline size_type capacity() const noexcept { return _size + _spare_count; }
+    constexpr void shrink_to_fit() noexcept;
+    // Empties the tree like `clear`, but keeps its nodes as spares
+    constexpr void _recycle() noexcept;
+    constexpr void _push_spare(node_pointer n) noexcept;
+    // Takes a spare node, with its links reset, or returns null if there is none
+    constexpr node_pointer _pop_spare() noexcept;
+
     constexpr inline
     allocator_type get_allocator() const noexcept { return allocator_type(_node_alloc); }
 
     constexpr void swap(_tree_impl & other)
         noexcept(noexcept(std::allocator_traits<allocator_type>::is_always_equal::value));
 
+    // Takes the nodes of `other`, leaving it empty; `*this` must be empty, with an allocator equal to `other`'s
+    constexpr void _steal(_tree_impl & other) noexcept;
+
 protected:
     constexpr inline
     void _set_end() noexcept { _end.root = _end.left = _end.right = std::addressof(_end); }
@@ -92,36 +112,124 @@ _tree_impl<T, Int, Alloc>::_tree_impl(node_allocator && a)
 
 template <typename T, typename Int, typename Alloc>
 _tree_impl<T, Int, Alloc>::~_tree_impl() noexcept
-{ clear(); }
+{
+    clear();
+    shrink_to_fit();
+}
 
 template <typename T, typename Int, typename Alloc>
 constexpr
 void _tree_impl<T, Int, Alloc>::clear() noexcept
 {
     if (!empty()) {
-        auto it = _end.root;
-
-        while (it != std::addressof(_end)) {
-            while (it->left != nullptr) {
-                it = it->left;
-                it->root->left = nullptr;
-            }
-            if (it->right != nullptr) {
-                it = it->right;
-                it->root->right = nullptr;
-                continue;
-            }
-            auto del = it;
-            it = it->root;
-            node_allocator_traits::destroy(_node_alloc, std::addressof(del->value()));
-            node_allocator_traits::destroy(_node_alloc, del);
-            node_allocator_traits::deallocate(_node_alloc, del, 1);
-        }
+        _destroy_subtree(_end.root);
         _set_end(); /* _end.left = _end.right = _end.root = std::addressof(_end); */
         _size = 0;
     }
 }
 
+template <typename T, typename Int, typename Alloc>
+constexpr inline
+void _tree_impl<T, Int, Alloc>::_destroy_node(node_pointer del) noexcept
+{
+    node_allocator_traits::destroy(_node_alloc, std::addressof(del->value()));
+    node_allocator_traits::destroy(_node_alloc, del);
+    node_allocator_traits::deallocate(_node_alloc, del, 1);
+}
+
+// Frees every node in the subtree rooted at `top`, without recursion; returns how many were freed.
+// Does not touch `_size` nor the link from `top->root` to `top`.
+template <typename T, typename Int, typename Alloc>
+constexpr inline
+auto _tree_impl<T, Int, Alloc>::_destroy_subtree(node_pointer top) noexcept
+    -> size_type
+{
+    return _dispose_subtree(top, [this](node_pointer del) { _destroy_node(del); });
+}
+
+// Hands every node in the subtree rooted at `top` to `dispose`, children first, without recursion; returns how
+// many there were. The links to the children are cut before, so `dispose` may reuse them
+template <typename T, typename Int, typename Alloc>
+template <typename Dispose>
+constexpr
+auto _tree_impl<T, Int, Alloc>::_dispose_subtree(node_pointer top, Dispose && dispose) noexcept
+    -> size_type
+{
+    if (top == nullptr) {
+        return 0;
+    }
+    auto const stop = top->root;
+    auto it = top;
+    size_type count = 0;
+
+    while (it != stop) {
+        while (it->left != nullptr) {
+            it = it->left;
+            it->root->left = nullptr;
+        }
+        if (it->right != nullptr) {
+            it = it->right;
+            it->root->right = nullptr;
+            continue;
+        }
+        auto del = it;
+        it = it->root;
+        dispose(del);
+        ++count;
+    }
+    return count;
+}
+
+template <typename T, typename Int, typename Alloc>
+constexpr
+void _tree_impl<T, Int, Alloc>::shrink_to_fit() noexcept
+{
+    while (_spare != nullptr) {
+        auto const del = std::exchange(_spare, _spare->right);
+        node_allocator_traits::destroy(_node_alloc, del);
+        node_allocator_traits::deallocate(_node_alloc, del, 1);
+    }
+    _spare_count = 0;
+}
+
+template <typename T, typename Int, typename Alloc>
+constexpr
+void _tree_impl<T, Int, Alloc>::_recycle() noexcept
+{
+    if (!empty()) {
+        _dispose_subtree(_end.root, [this](node_pointer n) {
+            node_allocator_traits::destroy(_node_alloc, std::addressof(n->value()));
+            _push_spare(n);
+        });
+        _set_end();
+        _size = 0;
+    }
+}
+
+template <typename T, typename Int, typename Alloc>
+constexpr inline
+void _tree_impl<T, Int, Alloc>::_push_spare(node_pointer n) noexcept
+{
+    n->right = _spare;
+    _spare = n;
+    ++_spare_count;
+}
+
+template <typename T, typename Int, typename Alloc>
+constexpr inline
+auto _tree_impl<T, Int, Alloc>::_pop_spare() noexcept
+    -> node_pointer
+{
+    if (_spare == nullptr) {
+        return nullptr;
+    }
+    auto const n = std::exchange(_spare, _spare->right);
+    --_spare_count;
+    n->height = 0;
+    n->root = n->left = n->right = nullptr;
+    return n;
+}
+
 template <typename T, typename Int, typename Alloc>
 constexpr
 void _tree_impl<T, Int, Alloc>::swap(_tree_impl & other)
@@ -139,6 +247,8 @@ void _tree_impl<T, Int, Alloc>::swap(_tree_impl & other)
     //NB: if _node_alloc != other._node_alloc, behavior is undefined
     swap(_size, other._size);
     swap(_end, other._end);
+    swap(_spare, other._spare);
+    swap(_spare_count, other._spare_count);
     if (_size == 0) {
         _end.root = _end.left = _end.right = std::addressof(_end);
     } else {
@@ -151,6 +261,20 @@ void _tree_impl<T, Int, Alloc>::swap(_tree_impl & other)
     }
 }
 
+template <typename T, typename Int, typename Alloc>
+constexpr
+void _tree_impl<T, Int, Alloc>::_steal(_tree_impl & other) noexcept
+{
+    if (other.empty()) {
+        return;
+    }
+    _end = other._end;
+    _end.root->root = std::addressof(_end);
+    _size = other._size;
+    other._set_end();
+    other._size = 0;
+}
+
 } // namespace forest :: detail
 
 #endif /* TREE_IMPL_HPP */
@@ -9,12 +9,17 @@
 #define UTILS_HPP
 
 #include <iterator>
+#include <type_traits> //std::void_t
 
 namespace forest :: detail
 {
 
+// False for types without `iterator_traits`, so that it can constrain overloads taking any other argument
+template <class Iterator, class = void>
+struct is_input_iterator : std::false_type {};
+
 template <class Iterator>
-struct is_input_iterator
+struct is_input_iterator<Iterator, std::void_t<typename std::iterator_traits<Iterator>::iterator_category>>
 {
 private:
     using traits = std::iterator_traits<Iterator>;
@@ -26,6 +31,9 @@ public:
 template <typename Iterator>
 constexpr inline auto is_input_iterator_v = is_input_iterator<Iterator>::value;
 
+// Befriended by the trees that `load` can build directly from a sorted stream, see serialization.hpp
+struct _serialization_access;
+
 template <typename Node, typename Alloc>
 struct _node_deallocator
 {
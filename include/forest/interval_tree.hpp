@@ -0,0 +1,310 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : interval_tree
+ * @created     : domenica ott 18, 2026 16:58:23 CEST
+ * @license     : MIT
+ * */
+
+#ifndef INTERVAL_TREE_HPP
+#define INTERVAL_TREE_HPP
+
+#include <iterator>    //std::forward_iterator_tag
+#include <limits>      //std::numeric_limits
+#include <tuple>       //std::get, std::tuple_element_t
+#include <type_traits> //std::remove_cvref_t
+
+#include "augmented_avl_tree.hpp"
+
+namespace forest
+{
+
+// How to read the bounds of an `Interval`; by default, `get<0>` and `get<1>` (e.g. `std::pair<T, T>`).
+// Specialize it for other types. Intervals are closed: [lower, upper]
+template <class Interval>
+struct interval_traits
+{
+    using bound_type = std::remove_cvref_t<std::tuple_element_t<0, Interval>>;
+    static constexpr inline bound_type const & lower(Interval const & i) noexcept { using std::get; return get<0>(i); }
+    static constexpr inline bound_type const & upper(Interval const & i) noexcept { using std::get; return get<1>(i); }
+}; // struct interval_traits
+
+namespace detail
+{
+// Orders the intervals by lower bound, then by upper bound; a bound compares with the lower bound
+template <class Interval, class Compare>
+struct _interval_compare
+{
+    using is_transparent = void;
+    using traits         = interval_traits<Interval>;
+    using bound_type     = typename traits::bound_type;
+
+    [[no_unique_address]] Compare _cmp;
+
+    constexpr inline bool operator()(Interval const & a, Interval const & b) const
+    {
+        if (_cmp(traits::lower(a), traits::lower(b))) { return true; }
+        if (_cmp(traits::lower(b), traits::lower(a))) { return false; }
+        return _cmp(traits::upper(a), traits::upper(b));
+    }
+    constexpr inline bool operator()(Interval const & a, bound_type const & b) const { return _cmp(traits::lower(a), b); }
+    constexpr inline bool operator()(bound_type const & a, Interval const & b) const { return _cmp(a, traits::lower(b)); }
+}; // struct _interval_compare
+
+// The greatest upper bound of a subtree
+template <class Interval, class Compare>
+struct _interval_max_upper
+{
+    using traits      = interval_traits<Interval>;
+    using result_type = typename traits::bound_type;
+
+    [[no_unique_address]] Compare _cmp;
+
+    constexpr inline result_type identity() const
+    {
+        if constexpr (std::numeric_limits<result_type>::is_specialized) {
+            return std::numeric_limits<result_type>::lowest();
+        } else {
+            return result_type{};
+        }
+    }
+    constexpr inline result_type const & lift(Interval const & i) const noexcept { return traits::upper(i); }
+    constexpr inline result_type operator()(result_type const & a, result_type const & b) const
+    { return _cmp(a, b) ? b : a; }
+}; // struct _interval_max_upper
+} // namespace detail
+
+// An augmented_avl_tree of closed intervals, ordered by lower bound, whose nodes store the greatest upper bound
+// in their subtree. The subtrees which cannot contain an interval overlapping the query are skipped, so the
+// overlapping intervals are enumerated in order, visiting O(log n) nodes for each of them
+template <class Interval, class Compare = std::less<>, class Alloc = std::allocator<Interval>>
+class interval_tree : protected augmented_avl_tree<
+    Interval, detail::_interval_compare<Interval, Compare>, Alloc, detail::_interval_max_upper<Interval, Compare>
+>
+{
+protected:
+    using base = augmented_avl_tree<
+        Interval, detail::_interval_compare<Interval, Compare>, Alloc, detail::_interval_max_upper<Interval, Compare>
+    >;
+    using traits             = interval_traits<Interval>;
+    using node               = typename base::node;
+    using node_pointer       = typename base::node_pointer;
+    using node_const_pointer = typename base::node_const_pointer;
+
+public:
+    using bound_type             = typename traits::bound_type;
+    using bound_compare          = Compare;
+    using key_type               = typename base::key_type;
+    using value_type             = typename base::value_type;
+    using key_compare            = typename base::key_compare;
+    using value_compare          = typename base::value_compare;
+    using allocator_type         = typename base::allocator_type;
+    using reference              = typename base::reference;
+    using const_reference        = typename base::const_reference;
+    using pointer                = typename base::pointer;
+    using const_pointer          = typename base::const_pointer;
+    using size_type              = typename base::size_type;
+    using difference_type        = typename base::difference_type;
+    using iterator               = typename base::iterator;
+    using const_iterator         = typename base::const_iterator;
+    using reverse_iterator       = typename base::reverse_iterator;
+    using const_reverse_iterator = typename base::const_reverse_iterator;
+    using node_type              = typename base::node_type;
+
+    // The intervals overlapping a query, lazily found in order
+    class overlap_iterator
+    {
+        friend class interval_tree;
+
+        interval_tree const * _tree = nullptr;
+        node_const_pointer _current = nullptr;
+        bound_type _lo{};
+        bound_type _hi{};
+
+        constexpr inline
+        overlap_iterator(interval_tree const * tree, node_const_pointer n, bound_type lo, bound_type hi)
+            : _tree{tree}, _current{n}, _lo{std::move(lo)}, _hi{std::move(hi)} {}
+
+    public:
+        using value_type        = Interval;
+        using reference         = value_type const &;
+        using pointer           = value_type const *;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        constexpr inline overlap_iterator() noexcept = default;
+
+        constexpr inline reference operator*() const noexcept { return _current->value(); }
+        constexpr inline pointer operator->() const noexcept { return std::addressof(_current->value()); }
+
+        constexpr inline
+        overlap_iterator & operator++() { _current = _tree->_next_overlap(_current, _lo, _hi); return *this; }
+        constexpr inline
+        overlap_iterator operator++(int) { auto res = *this; ++(*this); return res; }
+
+        // The position of the interval in the tree
+        constexpr inline
+        const_iterator base() const noexcept { return _current ? const_iterator{_current} : _tree->end(); }
+
+        friend constexpr inline
+        bool operator==(overlap_iterator const & lhs, overlap_iterator const & rhs) noexcept
+        { return lhs._current == rhs._current; }
+        friend constexpr inline
+        bool operator!=(overlap_iterator const & lhs, overlap_iterator const & rhs) noexcept
+        { return !(lhs == rhs); }
+    }; // class overlap_iterator
+
+    struct overlap_range
+    {
+        overlap_iterator _begin;
+        constexpr inline overlap_iterator begin() const noexcept { return _begin; }
+        constexpr inline overlap_iterator end() const noexcept { return {}; }
+        [[nodiscard]] constexpr inline bool empty() const noexcept { return _begin == end(); }
+    }; // struct overlap_range
+
+    constexpr inline interval_tree() = default;
+    constexpr inline explicit interval_tree(allocator_type const & a) noexcept : base(a) {}
+
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr explicit interval_tree(Iterator f, Iterator l, allocator_type const & a = allocator_type{})
+        : base(std::move(f), std::move(l), a) {}
+    constexpr interval_tree(std::initializer_list<value_type> il, allocator_type const & a = allocator_type{})
+        : base(il, a) {}
+
+    constexpr inline
+    interval_tree & operator=(std::initializer_list<value_type> il) { base::assign(il); return *this; }
+    using base::assign;
+    using base::get_allocator;
+
+    /// Capacity
+    using base::size;
+    using base::empty;
+    using base::max_size;
+
+    /// Iterators
+    using base::begin;
+    using base::end;
+    using base::cbegin;
+    using base::cend;
+    using base::rbegin;
+    using base::rend;
+    using base::crbegin;
+    using base::crend;
+
+    /// Access
+    using base::front;
+    using base::back;
+    // The greatest upper bound among the intervals, in O(1)
+    constexpr inline bound_type max_upper() const { return base::aggregate(); }
+
+    /// Modifiers
+    using base::clear;
+    using base::insert;
+    using base::emplace;
+    using base::extract;
+    using base::erase;
+
+    /// Lookup
+    using base::count;
+    using base::contains;
+    using base::find;
+    using base::lower_bound;
+    using base::upper_bound;
+    using base::equal_range;
+
+    // The intervals containing `point`
+    constexpr inline overlap_range overlapping(bound_type const & point) const { return overlapping(point, point); }
+    // The intervals overlapping [lo, hi]
+    constexpr inline
+    overlap_range overlapping(bound_type const & lo, bound_type const & hi) const
+    { return {overlap_iterator{this, _first_overlap(base::_root(), lo, hi), lo, hi}}; }
+
+    constexpr inline void swap(interval_tree & other) noexcept { base::swap(other); }
+
+    friend constexpr bool operator==(interval_tree const & lhs, interval_tree const & rhs) noexcept
+    { return static_cast<base const &>(lhs) == static_cast<base const &>(rhs); }
+    friend constexpr bool operator!=(interval_tree const & lhs, interval_tree const & rhs) noexcept
+    { return not (lhs == rhs); }
+
+protected:
+    using base::_cmp;
+
+    constexpr inline bool _before(bound_type const & a, bound_type const & b) const { return _cmp._cmp(a, b); }
+    constexpr inline bool _ends_before(node_const_pointer n, bound_type const & lo) const
+    { return _before(n->aggregate, lo); }
+
+    constexpr node_const_pointer _first_overlap(node_const_pointer n, bound_type const & lo, bound_type const & hi) const;
+    constexpr node_const_pointer _next_overlap(node_const_pointer n, bound_type const & lo, bound_type const & hi) const;
+}; // class interval_tree
+
+// The first interval overlapping [lo, hi] in the subtree of `n`, or nullptr.
+// If the left subtree reaches `lo`, it contains the answer, if any: otherwise its interval with the greatest upper
+// bound starts after `hi`, and so do `n` and the right subtree
+template <typename Interval, typename Compare, typename Alloc>
+constexpr auto interval_tree<Interval, Compare, Alloc>::_first_overlap(node_const_pointer n, bound_type const & lo,
+                                                                       bound_type const & hi) const
+    -> node_const_pointer
+{
+    while (n != nullptr and not _ends_before(n, lo)) {
+        if (n->left != nullptr and not _ends_before(n->left, lo)) {
+            n = n->left;
+            continue;
+        }
+        if (_before(hi, traits::lower(n->value()))) {
+            return nullptr;
+        }
+        if (not _before(traits::upper(n->value()), lo)) {
+            return n;
+        }
+        n = n->right;
+    }
+    return nullptr;
+}
+
+// The first interval overlapping [lo, hi] after `n`, or nullptr: it is either in the right subtree, or it is an
+// ancestor reached from its left subtree, or it is in the right subtree of such an ancestor
+template <typename Interval, typename Compare, typename Alloc>
+constexpr auto interval_tree<Interval, Compare, Alloc>::_next_overlap(node_const_pointer n, bound_type const & lo,
+                                                                      bound_type const & hi) const
+    -> node_const_pointer
+{
+    if (auto const found = _first_overlap(n->right, lo, hi); found != nullptr) {
+        return found;
+    }
+    auto const end = std::addressof(this->_end);
+    for (auto root = n->root; root != end; n = root, root = root->root) {
+        if (root->left != n) {
+            continue;
+        }
+        if (_before(hi, traits::lower(root->value()))) {
+            return nullptr; // all the following intervals start after `hi`
+        }
+        if (not _before(traits::upper(root->value()), lo)) {
+            return root;
+        }
+        if (auto const found = _first_overlap(root->right, lo, hi); found != nullptr) {
+            return found;
+        }
+    }
+    return nullptr;
+}
+
+template <typename Interval, typename Compare, typename Alloc>
+constexpr inline
+void swap(interval_tree<Interval, Compare, Alloc> & lhs, interval_tree<Interval, Compare, Alloc> & rhs) noexcept
+{ lhs.swap(rhs); }
+
+template <typename Interval, typename Compare, typename Alloc, typename Pred>
+constexpr
+auto erase_if(interval_tree<Interval, Compare, Alloc> & tree, Pred pred)
+    -> typename interval_tree<Interval, Compare, Alloc>::size_type
+{
+    auto const old_size = tree.size();
+    for (auto it = tree.begin(); it != tree.end();) {
+        it = pred(*it) ? tree.erase(it) : std::next(it);
+    }
+    return old_size - tree.size();
+}
+
+} // namespace forest
+
+#endif /* INTERVAL_TREE_HPP */
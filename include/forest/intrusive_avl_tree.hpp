@@ -0,0 +1,463 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : intrusive_avl_tree
+ * @created     : domenica ott 18, 2026 14:20:11 CEST
+ * @license     : MIT
+ * */
+
+#ifndef INTRUSIVE_AVL_TREE_HPP
+#define INTRUSIVE_AVL_TREE_HPP
+
+#include <algorithm>  //std::equal, std::lexicographical_compare
+#include <cstddef>    //std::size_t, std::ptrdiff_t
+#include <cstdint>    //std::int_fast8_t
+#include <functional> //std::less
+#include <limits>     //std::numeric_limits
+#include <memory>     //std::addressof
+#include <utility>    //std::pair
+
+#include "detail/tree_algorithms.hpp"
+#include "detail/intrusive_iterator.hpp"
+
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+// The links an element needs to be part of an intrusive_avl_tree. Copying an element does not copy its links:
+// the copy is not part of any tree
+struct avl_hook
+{
+    avl_hook * root  = nullptr;
+    avl_hook * left  = nullptr;
+    avl_hook * right = nullptr;
+    std::int_fast8_t height = 0;
+
+    constexpr inline avl_hook() noexcept = default;
+    constexpr inline avl_hook(avl_hook const &) noexcept {}
+    constexpr inline avl_hook & operator=(avl_hook const &) noexcept { return *this; }
+
+    // An element is linked while it is part of a tree
+    [[nodiscard]] constexpr inline
+    bool is_linked() const noexcept { return root != nullptr; }
+}; // struct avl_hook
+
+// Finds the hook of a `T` which inherits from `avl_hook`
+template <class T>
+struct base_hook
+{
+    static constexpr inline avl_hook * to_hook(T & v) noexcept
+    { return static_cast<avl_hook *>(std::addressof(v)); }
+    static constexpr inline T * to_value(avl_hook * h) noexcept
+    { return static_cast<T *>(h); }
+    static constexpr inline T const * to_value(avl_hook const * h) noexcept
+    { return static_cast<T const *>(h); }
+}; // struct base_hook
+
+// Finds the hook of a `T` which stores it in the member `Member`
+template <class T, avl_hook T::* Member>
+struct member_hook
+{
+    static constexpr inline avl_hook * to_hook(T & v) noexcept
+    { return std::addressof(v.*Member); }
+    static inline T * to_value(avl_hook * h) noexcept
+    { return reinterpret_cast<T *>(reinterpret_cast<char *>(h) - _offset()); }
+    static inline T const * to_value(avl_hook const * h) noexcept
+    { return reinterpret_cast<T const *>(reinterpret_cast<char const *>(h) - _offset()); }
+
+private:
+    static inline std::ptrdiff_t _offset() noexcept
+    {
+        alignas(T) static char const _probe[sizeof(T)] = {};
+        auto const obj = reinterpret_cast<T const *>(_probe);
+        return reinterpret_cast<char const *>(std::addressof(obj->*Member)) - _probe;
+    }
+}; // struct member_hook
+
+// An avl_tree which does not own its elements: they carry their own links (an `avl_hook`, located by `Hook`),
+// so inserting and erasing never allocate. The elements must outlive the tree, or be erased before dying,
+// and must not change their key while linked.
+template <class T, class Hook = base_hook<T>, class Compare = std::less<>>
+class intrusive_avl_tree
+{
+protected:
+    using hook_pointer       = avl_hook *;
+    using hook_const_pointer = avl_hook const *;
+    using key_compare        = Compare;
+    using value_compare      = Compare;
+
+public:
+    using key_type               = T;
+    using value_type             = T;
+    using reference              = value_type &;
+    using const_reference        = value_type const &;
+    using pointer                = value_type *;
+    using const_pointer          = value_type const *;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = detail::_intrusive_iterator<T, Hook>;
+    using const_iterator         = detail::_intrusive_const_iterator<T, Hook>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+protected:
+    avl_hook _end;
+    size_type _size = 0;
+    [[no_unique_address]] key_compare _cmp;
+
+public:
+    constexpr inline
+    intrusive_avl_tree() noexcept { _set_end(); }
+    constexpr inline explicit
+    intrusive_avl_tree(Compare const & cmp) noexcept : _cmp{cmp} { _set_end(); }
+
+    // The elements can be part of a single tree at a time
+    intrusive_avl_tree(intrusive_avl_tree const &) = delete;
+    intrusive_avl_tree & operator=(intrusive_avl_tree const &) = delete;
+
+    constexpr intrusive_avl_tree(intrusive_avl_tree && other) noexcept;
+    constexpr intrusive_avl_tree & operator=(intrusive_avl_tree && other) noexcept;
+
+    // Unlinks every element
+    constexpr inline ~intrusive_avl_tree() { clear(); }
+
+    /// Capacity
+    constexpr inline
+    size_type size() const noexcept { return _size; }
+    [[nodiscard]] constexpr inline
+    bool empty() const noexcept { return _size == 0; }
+    constexpr inline
+    size_type max_size() const noexcept { return std::numeric_limits<difference_type>::max(); }
+
+    /// Iterators
+    constexpr inline iterator begin() noexcept { return iterator{_end.right}; }
+    constexpr inline const_iterator begin() const noexcept { return const_iterator{_end.right}; }
+    constexpr inline iterator end() noexcept { return iterator{std::addressof(_end)}; }
+    constexpr inline const_iterator end() const noexcept { return const_iterator{std::addressof(_end)}; }
+    constexpr inline const_iterator cbegin() const noexcept { return begin(); }
+    constexpr inline const_iterator cend() const noexcept { return end(); }
+
+    constexpr inline reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator rcbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rcend() const noexcept { return const_reverse_iterator{begin()}; }
+
+    // The iterator to an element of the tree, in O(1)
+    constexpr inline iterator iterator_to(reference value) noexcept { return iterator{Hook::to_hook(value)}; }
+    constexpr inline const_iterator iterator_to(const_reference value) const noexcept
+    { return const_iterator{Hook::to_hook(const_cast<reference>(value))}; }
+
+    /// Access
+    constexpr inline reference front() { return *Hook::to_value(_end.right); }
+    constexpr inline const_reference front() const { return *Hook::to_value(_end.right); }
+    constexpr inline reference back() { return *Hook::to_value(_end.left); }
+    constexpr inline const_reference back() const { return *Hook::to_value(_end.left); }
+
+    /// Modifiers
+    constexpr inline void clear() noexcept { clear_and_dispose([](pointer) noexcept {}); }
+    // Unlinks every element, then calls `dispose` on it (e.g. to free its memory)
+    template <typename Disposer>
+    constexpr void clear_and_dispose(Disposer dispose);
+    constexpr iterator insert(reference value) noexcept;
+    constexpr auto insert_unique(reference value) noexcept -> std::pair<iterator, bool>;
+    constexpr iterator erase(const_iterator it) noexcept;
+    constexpr iterator erase(const_iterator f, const_iterator l) noexcept;
+    constexpr size_type erase(value_type const & x) noexcept;
+    template <typename Disposer>
+    constexpr iterator erase_and_dispose(const_iterator it, Disposer dispose);
+
+    /// Lookup
+    constexpr inline auto count(value_type const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto count(U const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    constexpr inline bool contains(value_type const & x) const { return _find(x) != nullptr; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto contains(U const & x) const -> bool { return _find(x) != nullptr; }
+
+    constexpr inline auto find(value_type const & x) -> iterator
+    { auto const found = _find(x); return found ? iterator{found} : end(); }
+    constexpr inline auto find(value_type const & x) const -> const_iterator
+    { auto const found = _find(x); return found ? const_iterator{found} : end(); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto find(U const & x) -> iterator
+    { auto const found = _find(x); return found ? iterator{found} : end(); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto find(U const & x) const -> const_iterator
+    { auto const found = _find(x); return found ? const_iterator{found} : end(); }
+
+    constexpr inline auto lower_bound(value_type const & x) -> iterator { return iterator{_lower_bound(x)}; }
+    constexpr inline auto lower_bound(value_type const & x) const -> const_iterator
+    { return const_iterator{_lower_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto lower_bound(U const & x) -> iterator { return iterator{_lower_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto lower_bound(U const & x) const -> const_iterator { return const_iterator{_lower_bound(x)}; }
+
+    constexpr inline auto upper_bound(value_type const & x) -> iterator { return iterator{_upper_bound(x)}; }
+    constexpr inline auto upper_bound(value_type const & x) const -> const_iterator
+    { return const_iterator{_upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto upper_bound(U const & x) -> iterator { return iterator{_upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto upper_bound(U const & x) const -> const_iterator { return const_iterator{_upper_bound(x)}; }
+
+    constexpr inline auto equal_range(value_type const & x) -> std::pair<iterator, iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    constexpr inline auto equal_range(value_type const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) -> std::pair<iterator, iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+
+    constexpr void swap(intrusive_avl_tree & other) noexcept;
+
+    friend constexpr bool operator==(intrusive_avl_tree const & lhs, intrusive_avl_tree const & rhs) noexcept
+    { return lhs.size() == rhs.size() and std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend()); }
+    friend constexpr bool operator!=(intrusive_avl_tree const & lhs, intrusive_avl_tree const & rhs) noexcept
+    { return not (lhs == rhs); }
+    friend constexpr bool operator< (intrusive_avl_tree const & lhs, intrusive_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less{}); }
+    friend constexpr bool operator<=(intrusive_avl_tree const & lhs, intrusive_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less_equal{}); }
+    friend constexpr bool operator> (intrusive_avl_tree const & lhs, intrusive_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater{}); }
+    friend constexpr bool operator>=(intrusive_avl_tree const & lhs, intrusive_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater_equal{}); }
+
+protected:
+    constexpr inline
+    void _set_end() noexcept { _end.root = _end.left = _end.right = std::addressof(_end); }
+    // After `_end` changed address, makes the root point to it again
+    constexpr inline
+    void _adopt_root() noexcept { if (_size == 0) { _set_end(); } else { _end.root->root = std::addressof(_end); } }
+
+    static constexpr inline const_reference _value(hook_const_pointer h) noexcept { return *Hook::to_value(h); }
+    constexpr inline hook_pointer _root() const noexcept { return _size == 0 ? nullptr : _end.root; }
+
+    template <typename U> constexpr hook_pointer _find(U const & x) const;
+    template <typename U> constexpr hook_pointer _lower_bound(U const & x) const;
+    template <typename U> constexpr hook_pointer _upper_bound(U const & x) const;
+}; // class intrusive_avl_tree
+
+template <typename T, typename Hook, typename Compare>
+constexpr intrusive_avl_tree<T, Hook, Compare>::intrusive_avl_tree(intrusive_avl_tree && other) noexcept
+    : _cmp{std::move(other._cmp)}
+{
+    _set_end();
+    swap(other);
+}
+
+template <typename T, typename Hook, typename Compare>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::operator=(intrusive_avl_tree && other) noexcept
+    -> intrusive_avl_tree &
+{
+    if (this != std::addressof(other)) {
+        clear();
+        _cmp = std::move(other._cmp);
+        swap(other);
+    }
+    return *this;
+}
+
+template <typename T, typename Hook, typename Compare>
+constexpr void intrusive_avl_tree<T, Hook, Compare>::swap(intrusive_avl_tree & other) noexcept
+{
+    using std::swap;
+    swap(_cmp, other._cmp);
+    swap(_size, other._size);
+    swap(_end.root, other._end.root);
+    swap(_end.left, other._end.left);
+    swap(_end.right, other._end.right);
+    _adopt_root();
+    other._adopt_root();
+}
+
+template <typename T, typename Hook, typename Compare>
+template <typename Disposer>
+constexpr void intrusive_avl_tree<T, Hook, Compare>::clear_and_dispose(Disposer dispose)
+{
+    // post-order walk: every element is unlinked after its children, so it can be disposed immediately
+    auto it = _root();
+    while (it != nullptr and it != std::addressof(_end)) {
+        if (it->left != nullptr) {
+            it = it->left;
+        } else if (it->right != nullptr) {
+            it = it->right;
+        } else {
+            auto const root = it->root;
+            if (root->left == it) {
+                root->left = nullptr;
+            } else if (root != std::addressof(_end)) {
+                root->right = nullptr;
+            }
+            it->root = nullptr;
+            it->height = 0;
+            dispose(Hook::to_value(it));
+            it = root;
+        }
+    }
+    _set_end();
+    _size = 0;
+}
+
+template <typename T, typename Hook, typename Compare>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::insert(reference value) noexcept
+    -> iterator
+{
+    auto const n = Hook::to_hook(value);
+    auto root = std::addressof(_end);
+    auto left = false;
+    for (auto it = _root(); it != nullptr; it = left ? it->left : it->right) {
+        root = it;
+        left = _cmp(value, _value(it));
+    }
+    detail::_link_leaf(root, left, n, std::addressof(_end));
+    ++_size;
+    detail::_avl_balance_from(root, std::addressof(_end));
+    return iterator{n};
+}
+
+template <typename T, typename Hook, typename Compare>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::insert_unique(reference value) noexcept
+    -> std::pair<iterator, bool>
+{
+    auto const n = Hook::to_hook(value);
+    auto root = std::addressof(_end);
+    auto left = false;
+    for (auto it = _root(); it != nullptr; it = left ? it->left : it->right) {
+        root = it;
+        left = _cmp(value, _value(it));
+        if (not left and not _cmp(_value(it), value)) {
+            return {iterator{it}, false};
+        }
+    }
+    detail::_link_leaf(root, left, n, std::addressof(_end));
+    ++_size;
+    detail::_avl_balance_from(root, std::addressof(_end));
+    return {iterator{n}, true};
+}
+
+template <typename T, typename Hook, typename Compare>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::erase(const_iterator it) noexcept
+    -> iterator
+{
+    auto const n = const_cast<hook_pointer>(it._current);
+    if (_size == 1) {
+        n->root = n->left = n->right = nullptr;
+        n->height = 0;
+        _set_end();
+        _size = 0;
+        return end();
+    }
+
+    auto const next = detail::_bst_next(n);
+    if (_end.right == n) {
+        _end.right = next;
+    }
+    if (_end.left == n) {
+        _end.left = detail::_bst_prev(n);
+    }
+    auto const changed = detail::_unlink(n, std::addressof(_end));
+    --_size;
+    detail::_avl_balance_from(changed, std::addressof(_end));
+    return iterator{next};
+}
+
+template <typename T, typename Hook, typename Compare>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::erase(const_iterator f, const_iterator l) noexcept
+    -> iterator
+{
+    while (f != l) {
+        f = erase(f);
+    }
+    return iterator{const_cast<hook_pointer>(l._current)};
+}
+
+template <typename T, typename Hook, typename Compare>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::erase(value_type const & x) noexcept
+    -> size_type
+{
+    auto const old_size = _size;
+    auto const [f, l] = equal_range(x);
+    erase(f, l);
+    return old_size - _size;
+}
+
+template <typename T, typename Hook, typename Compare>
+template <typename Disposer>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::erase_and_dispose(const_iterator it, Disposer dispose)
+    -> iterator
+{
+    auto const value = Hook::to_value(const_cast<hook_pointer>(it._current));
+    auto const next = erase(it);
+    dispose(value);
+    return next;
+}
+
+template <typename T, typename Hook, typename Compare>
+template <typename U>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::_find(U const & x) const
+    -> hook_pointer
+{
+    auto it = _root();
+    while (it != nullptr) {
+        if (_cmp(_value(it), x)) {
+            it = it->right;
+        } else if (_cmp(x, _value(it))) {
+            it = it->left;
+        } else {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+template <typename T, typename Hook, typename Compare>
+template <typename U>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::_lower_bound(U const & x) const
+    -> hook_pointer
+{
+    auto res = const_cast<hook_pointer>(std::addressof(_end));
+    for (auto it = _root(); it != nullptr; ) {
+        if (_cmp(_value(it), x)) {
+            it = it->right;
+        } else {
+            res = it;
+            it = it->left;
+        }
+    }
+    return res;
+}
+
+template <typename T, typename Hook, typename Compare>
+template <typename U>
+constexpr auto intrusive_avl_tree<T, Hook, Compare>::_upper_bound(U const & x) const
+    -> hook_pointer
+{
+    auto res = const_cast<hook_pointer>(std::addressof(_end));
+    for (auto it = _root(); it != nullptr; ) {
+        if (_cmp(x, _value(it))) {
+            res = it;
+            it = it->left;
+        } else {
+            it = it->right;
+        }
+    }
+    return res;
+}
+
+template <typename T, typename Hook, typename Compare>
+constexpr inline void swap(intrusive_avl_tree<T, Hook, Compare> & lhs, intrusive_avl_tree<T, Hook, Compare> & rhs)
+    noexcept
+{ lhs.swap(rhs); }
+
+} // namespace forest
+
+#endif /* INTRUSIVE_AVL_TREE_HPP */
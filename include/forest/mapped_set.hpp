@@ -0,0 +1,271 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : mapped_set
+ * @created     : lunedì ott 19, 2026 02:52:40 CEST
+ * @license     : MIT
+ * */
+
+#ifndef MAPPED_SET_HPP
+#define MAPPED_SET_HPP
+
+#include <algorithm>    //std::lower_bound, std::upper_bound, std::equal_range
+#include <cerrno>       //errno
+#include <cstdint>      //std::uint32_t, std::uint64_t
+#include <cstring>      //std::memcpy
+#include <filesystem>   //std::filesystem::path
+#include <functional>   //std::less
+#include <iterator>     //std::reverse_iterator
+#include <ostream>
+#include <system_error> //std::system_error
+#include <type_traits>
+#include <utility>      //std::exchange, std::pair
+
+#include <fcntl.h>      //open
+#include <sys/mman.h>   //mmap, munmap
+#include <sys/stat.h>   //fstat
+#include <unistd.h>     //close
+
+#include "serialization.hpp"
+
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+namespace detail
+{
+// The header of a mapped file, followed by the elements in order, as an array starting at `offset`
+struct _mapped_header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t element_size;
+    std::uint32_t element_alignment;
+    std::uint32_t reserved;
+    std::uint64_t count;
+    std::uint64_t offset;
+}; // struct _mapped_header
+
+constexpr inline char _mapped_magic[8] = {'F', 'R', 'S', 'T', 'M', 'A', 'P', '\0'};
+constexpr inline std::uint32_t _mapped_version = 1;
+
+// The elements start on a cache line, or further if they need it
+template <class T>
+constexpr inline std::uint64_t _mapped_offset = (sizeof(_mapped_header) + std::max<std::size_t>(64, alignof(T)) - 1)
+                                                / std::max<std::size_t>(64, alignof(T))
+                                                * std::max<std::size_t>(64, alignof(T));
+} // namespace detail
+
+// Writes the elements of `tree`, in order, in the format read by `mapped_set`: a header and a plain array, which
+// holds no pointer and can be mapped anywhere. Like `save`, it reports failures through the state of `os`, which
+// should be opened in binary mode
+template <class Tree>
+void save_mapped(Tree const & tree, std::ostream & os)
+{
+    using value_type = typename Tree::value_type;
+    static_assert(std::is_trivially_copyable_v<value_type>, "save_mapped: the elements must be trivially copyable");
+
+    auto header = detail::_mapped_header{};
+    std::copy(std::begin(detail::_mapped_magic), std::end(detail::_mapped_magic), header.magic);
+    header.version = detail::_mapped_version;
+    header.element_size = sizeof(value_type);
+    header.element_alignment = alignof(value_type);
+    header.count = tree.size();
+    header.offset = detail::_mapped_offset<value_type>;
+    os.write(reinterpret_cast<char const *>(std::addressof(header)), sizeof(header));
+    for (auto pad = sizeof(header); pad < header.offset; ++pad) {
+        os.put('\0');
+    }
+    detail::_save_raw_elements(tree, os);
+}
+
+// A read-only set over a file written by `save_mapped`, mapped in memory: opening it reads nothing but the
+// header, and the lookups binary search the array of elements in place, paging in only what they touch.
+// Its iterators are pointers into the mapping; it is movable, not copyable, and unmaps the file when destroyed.
+// The lookups may run concurrently
+template <class T, class Compare = std::less<>>
+class mapped_set
+{
+    static_assert(std::is_trivially_copyable_v<T>, "mapped_set: the elements must be trivially copyable");
+
+public:
+    using key_type               = T;
+    using value_type             = T;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = value_type const &;
+    using const_reference        = value_type const &;
+    using pointer                = value_type const *;
+    using const_pointer          = value_type const *;
+    using iterator               = value_type const *;
+    using const_iterator         = value_type const *;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+protected:
+    void * _mapping = nullptr;
+    std::size_t _length = 0;
+    pointer _first = nullptr;
+    size_type _size = 0;
+    [[no_unique_address]] key_compare _cmp;
+
+public:
+    // Maps the file at `path`; throws `std::system_error` if it cannot be opened or mapped, and `archive_error` if
+    // it does not hold elements of type `T`
+    explicit mapped_set(std::filesystem::path const & path, key_compare const & cmp = key_compare{});
+
+    inline mapped_set(mapped_set && other) noexcept
+        : _mapping{std::exchange(other._mapping, nullptr)}, _length{std::exchange(other._length, 0)}
+        , _first{std::exchange(other._first, nullptr)}, _size{std::exchange(other._size, 0)}, _cmp{other._cmp} {}
+    inline mapped_set & operator=(mapped_set && other) noexcept
+    {
+        auto tmp = mapped_set{std::move(other)};
+        swap(tmp);
+        return *this;
+    }
+    mapped_set(mapped_set const &) = delete;
+    mapped_set & operator=(mapped_set const &) = delete;
+
+    inline ~mapped_set() noexcept { _unmap(); }
+
+    inline key_compare key_comp() const { return _cmp; }
+
+    /// Capacity
+    inline size_type size() const noexcept { return _size; }
+    [[nodiscard]] inline bool empty() const noexcept { return _size == 0; }
+
+    /// Iterators
+    inline const_iterator begin() const noexcept { return _first; }
+    inline const_iterator end() const noexcept { return _first + _size; }
+    inline const_iterator cbegin() const noexcept { return begin(); }
+    inline const_iterator cend() const noexcept { return end(); }
+    inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+    inline const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    inline const_reverse_iterator crend() const noexcept { return rend(); }
+
+    /// Access
+    inline const_reference front() const { return *begin(); }
+    inline const_reference back() const { return *(end() - 1); }
+    inline const_pointer data() const noexcept { return _first; }
+
+    /// Lookup
+    inline auto lower_bound(value_type const & x) const -> const_iterator
+    { return std::lower_bound(begin(), end(), x, _cmp); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto lower_bound(U const & x) const -> const_iterator
+    { return std::lower_bound(begin(), end(), x, _cmp); }
+    inline auto upper_bound(value_type const & x) const -> const_iterator
+    { return std::upper_bound(begin(), end(), x, _cmp); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto upper_bound(U const & x) const -> const_iterator
+    { return std::upper_bound(begin(), end(), x, _cmp); }
+    inline auto equal_range(value_type const & x) const -> std::pair<const_iterator, const_iterator>
+    { return std::equal_range(begin(), end(), x, _cmp); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto equal_range(U const & x) const -> std::pair<const_iterator, const_iterator>
+    { return std::equal_range(begin(), end(), x, _cmp); }
+
+    inline auto find(value_type const & x) const -> const_iterator { return _find(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto find(U const & x) const -> const_iterator { return _find(x); }
+    inline bool contains(value_type const & x) const { return _find(x) != end(); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline bool contains(U const & x) const { return _find(x) != end(); }
+    inline auto count(value_type const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return l - f; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto count(U const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return l - f; }
+
+    inline void swap(mapped_set & other) noexcept
+    {
+        using std::swap;
+        swap(_mapping, other._mapping);
+        swap(_length, other._length);
+        swap(_first, other._first);
+        swap(_size, other._size);
+        swap(_cmp, other._cmp);
+    }
+
+protected:
+    template <typename U>
+    inline const_iterator _find(U const & x) const
+    {
+        auto const it = lower_bound(x);
+        return it != end() and not _cmp(x, *it) ? it : end();
+    }
+    void _unmap() noexcept;
+}; // class mapped_set
+
+template <typename T, typename Compare>
+mapped_set<T, Compare>::mapped_set(std::filesystem::path const & path, key_compare const & cmp)
+    : _cmp{cmp}
+{
+    auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::system_error{errno, std::generic_category(), "mapped_set: cannot open " + path.string()};
+    }
+    struct ::stat st;
+    if (::fstat(fd, &st) == -1) {
+        auto const error = errno;
+        ::close(fd);
+        throw std::system_error{error, std::generic_category(), "mapped_set: cannot stat " + path.string()};
+    }
+    _length = static_cast<std::size_t>(st.st_size);
+    if (_length < sizeof(detail::_mapped_header)) {
+        ::close(fd);
+        throw archive_error{"mapped_set: " + path.string() + " is too short"};
+    }
+    auto const mapping = ::mmap(nullptr, _length, PROT_READ, MAP_SHARED, fd, 0);
+    auto const error = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::system_error{error, std::generic_category(), "mapped_set: cannot map " + path.string()};
+    }
+    _mapping = mapping;
+
+    auto header = detail::_mapped_header{};
+    std::memcpy(std::addressof(header), _mapping, sizeof(header));
+    auto const fail = [this, &path](char const * what) {
+        _unmap();
+        throw archive_error{"mapped_set: " + path.string() + ": " + what};
+    };
+    if (not std::equal(std::begin(header.magic), std::end(header.magic), detail::_mapped_magic)) {
+        fail("not a mapped tree");
+    }
+    if (header.version != detail::_mapped_version) {
+        fail("unsupported format version");
+    }
+    if (header.element_size != sizeof(T) or header.element_alignment != alignof(T)) {
+        fail("the file holds elements of another type");
+    }
+    if (header.offset % alignof(T) != 0 or header.offset > _length
+        or header.count > (_length - header.offset) / sizeof(T)) {
+        fail("the file is truncated");
+    }
+    _first = std::launder(reinterpret_cast<pointer>(static_cast<char const *>(_mapping) + header.offset));
+    _size = static_cast<size_type>(header.count);
+}
+
+template <typename T, typename Compare>
+void mapped_set<T, Compare>::_unmap() noexcept
+{
+    if (_mapping != nullptr) {
+        ::munmap(_mapping, _length);
+        _mapping = nullptr;
+        _length = 0;
+        _first = nullptr;
+        _size = 0;
+    }
+}
+
+template <typename T, typename Compare>
+inline void swap(mapped_set<T, Compare> & lhs, mapped_set<T, Compare> & rhs) noexcept
+{ lhs.swap(rhs); }
+
+} // namespace forest
+
+#endif /* MAPPED_SET_HPP */
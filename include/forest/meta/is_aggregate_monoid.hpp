@@ -0,0 +1,26 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : is_aggregate_monoid
+ * @created     : domenica ott 18, 2026 15:24:40 CEST
+ * @license     : MIT
+ * */
+
+#ifndef IS_AGGREGATE_MONOID_HPP
+#define IS_AGGREGATE_MONOID_HPP
+
+#include <concepts> //std::convertible_to, std::default_initializable
+
+namespace forest :: meta
+{
+// A monoid over the values of type `T`: `identity()` is its neutral element, `lift(v)` turns a value into an
+// aggregate and `operator()` combines two aggregates (it must be associative, but not necessarily commutative)
+template <typename Monoid, typename T>
+concept is_aggregate_monoid = requires (Monoid const m, T const & v, typename Monoid::result_type const & a) {
+    requires std::default_initializable<typename Monoid::result_type>;
+    { m.identity() } -> std::convertible_to<typename Monoid::result_type>;
+    { m.lift(v) }    -> std::convertible_to<typename Monoid::result_type>;
+    { m(a, a) }      -> std::convertible_to<typename Monoid::result_type>;
+};
+} // namespace forest :: meta
+
+#endif /* IS_AGGREGATE_MONOID_HPP */
@@ -6,10 +6,11 @@
  * */
 
 #ifndef NODE_HANDLE_HPP
-#define NODE_HPP
+#define NODE_HANDLE_HPP
 
 #include <memory>
 #include <optional>
+#include <utility> //std::exchange
 
 #include "detail/node.hpp"
 #include "detail/utils.hpp"
@@ -19,19 +20,24 @@
 namespace forest
 {
 
-template <typename T, typename Int, typename Alloc>
+// `Node` is the node type of the tree which extracted it: trees storing more than `detail::node` use their own
+template <typename T, typename Int, typename Alloc, typename Node = detail::node<T, Int>>
 class CONSUMABLE node_handle
 {
 public:
-    template <typename, typename, typename> friend class binary_search_tree;
-    template <typename, typename, typename> friend class avl_tree;
+    template <typename, typename, typename, typename, typename> friend class binary_search_tree;
+    template <typename, typename, typename, typename> friend class avl_tree;
+    template <typename, typename, typename, typename> friend class wavl_tree;
+    template <typename, typename, typename, typename> friend class treap;
+    template <typename, typename, typename, typename, typename> friend class splay_tree;
+    template <typename, typename, typename, typename> friend class augmented_avl_tree;
     using value_type      = T;
     using reference       = value_type &;
     using const_reference = value_type const &;
     using pointer         = value_type const *;
     using const_pointer   = value_type const *;
 
-    using node = detail::node<T, Int>;
+    using node = Node;
     using node_ptr = node *;
 
     using allocator_type        = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
@@ -45,22 +51,15 @@ private:
 
 public:
     RETURN_TYPESTATE(consumed)   constexpr inline node_handle() noexcept = default;
-    RETURN_TYPESTATE(unconsumed) constexpr inline node_handle(node_handle &&) noexcept = default;
+    RETURN_TYPESTATE(unconsumed) constexpr inline node_handle(node_handle && other) noexcept :
+        _storage{std::exchange(other._storage, nullptr)}, _alloc{std::move(other._alloc)} { }
     SET_TYPESTATE(unconsumed)    constexpr inline node_handle & operator=(node_handle && other);
     node_handle(node_handle const &) = delete;
     node_handle & operator=(node_handle const &) = delete;
     RETURN_TYPESTATE(unconsumed) constexpr inline node_handle(node * ptr, allocator_type alloc) :
         _storage{ptr}, _alloc{alloc} { }
 
-    inline ~node_handle() noexcept
-    {
-        if (_storage) {
-            auto node_alloc = node_allocator{*_alloc};
-            allocator_traits::destroy(*_alloc, std::addressof(_storage->value()));
-            node_allocator_traits::destroy(node_alloc, _storage);
-            node_allocator_traits::deallocate(node_alloc, _storage, 1);
-        }
-    }
+    inline ~node_handle() noexcept { _destroy(); }
 
     [[nodiscard]] constexpr inline bool empty() const noexcept { return !_storage; }
     explicit
@@ -77,26 +76,39 @@ public:
         ));
 private:
     SET_TYPESTATE(unconsumed) constexpr inline void _consume() { }
+    constexpr inline
+    void _destroy() noexcept
+    {
+        if (_storage) {
+            auto node_alloc = node_allocator{*_alloc};
+            allocator_traits::destroy(*_alloc, std::addressof(_storage->value()));
+            node_allocator_traits::destroy(node_alloc, _storage);
+            node_allocator_traits::deallocate(node_alloc, _storage, 1);
+        }
+    }
 }; // class node_handle
 
-template <typename T, typename Int, typename Alloc>
-constexpr auto node_handle<T, Int, Alloc>::operator=(node_handle && other)
+template <typename T, typename Int, typename Alloc, typename Node>
+constexpr auto node_handle<T, Int, Alloc, Node>::operator=(node_handle && other)
     -> node_handle &
 {
-    _storage = std::move(other.storage);
-    auto transfer_allocator = other.empty();
-    if constexpr (allocator_traits::propagate_on_container_move_assignment) {
+    if (this == std::addressof(other)) {
+        return *this;
+    }
+    _destroy();
+    _storage = std::exchange(other._storage, nullptr);
+    auto transfer_allocator = not _alloc.has_value();
+    if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
         transfer_allocator = true;
     }
     if (transfer_allocator) {
-        _alloc = std::move(other.alloc);
+        _alloc = std::move(other._alloc);
     }
-    other.consume();
     return *this;
 }
 
-template <typename T, typename Int, typename Alloc>
-constexpr void node_handle<T, Int, Alloc>::swap(node_handle & other)
+template <typename T, typename Int, typename Alloc, typename Node>
+constexpr void node_handle<T, Int, Alloc, Node>::swap(node_handle & other)
         noexcept(noexcept(
                 allocator_traits::propagate_on_container_swap::value ||
                 allocator_traits::is_always_equal::value
@@ -106,7 +118,7 @@ constexpr void node_handle<T, Int, Alloc>::swap(node_handle & other)
     swap(_storage, other._storage);
 
     auto swap_allocator = empty() || other.empty();
-    if constexpr (allocator_traits::propagate_on_container_swap) {
+    if constexpr (allocator_traits::propagate_on_container_swap::value) {
         swap_allocator = true;
     }
     if (swap_allocator) {
@@ -114,9 +126,9 @@ constexpr void node_handle<T, Int, Alloc>::swap(node_handle & other)
     }
 }
 
-template <typename T, typename Int, typename Alloc>
+template <typename T, typename Int, typename Alloc, typename Node>
 constexpr inline
-void swap(node_handle<T, Int, Alloc> & f, node_handle<T, Int, Alloc> & s) noexcept(noexcept(f.swap(s)))
+void swap(node_handle<T, Int, Alloc, Node> & f, node_handle<T, Int, Alloc, Node> & s) noexcept(noexcept(f.swap(s)))
 {
     f.swap(s);
 }
@@ -125,5 +137,5 @@ void swap(node_handle<T, Int, Alloc> & f, node_handle<T, Int, Alloc> & s) noexce
 
 #include "detail/pop_consumable.hpp"
 
-#endif /* NODE_HPP */
+#endif /* NODE_HANDLE_HPP */
 
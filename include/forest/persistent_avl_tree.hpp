@@ -0,0 +1,565 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : persistent_avl_tree
+ * @created     : domenica ott 18, 2026 21:46:19 CEST
+ * @license     : MIT
+ * */
+
+#ifndef PERSISTENT_AVL_TREE_HPP
+#define PERSISTENT_AVL_TREE_HPP
+
+#include <algorithm>        //std::equal, std::lexicographical_compare
+#include <initializer_list>
+#include <limits>           //std::numeric_limits
+#include <memory>
+#include <utility>          //std::pair, std::exchange
+
+#include "detail/utils.hpp"
+#include "detail/persistent_node.hpp"
+#include "detail/stack_iterator.hpp"
+#include "detail/tree_algorithms.hpp" //forest::detail::_subtree_height
+
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+// An avl_tree whose versions share their nodes. Copying the tree (or calling `snapshot()`) is O(1): the copy
+// references the same root. An update copies only the nodes on the path it changes, O(log n) of them, and
+// rebalances the copies; the nodes referenced by a single tree are changed in place, so a tree with no
+// snapshot around allocates only the inserted nodes. Nodes are reference counted, and freed with the last
+// version using them.
+// A version never changes once another one shares its nodes, so different trees can be read and updated from
+// different threads without locks; as for `std::shared_ptr`, a single tree object is not thread safe.
+// Updates invalidate the iterators of the updated tree only. The values must be copy constructible
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>>
+class persistent_avl_tree
+{
+protected:
+    using node                  = detail::persistent_node<T, std::int_fast8_t>;
+    using alloc_traits          = std::allocator_traits<Alloc>;
+    using node_allocator        = typename alloc_traits::template rebind_alloc<node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator>;
+    using node_pointer          = node *;
+    using node_const_pointer    = node const *;
+
+public:
+    using key_type               = T;
+    using value_type             = T;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using allocator_type         = Alloc;
+    using reference              = value_type const &;
+    using const_reference        = value_type const &;
+    using pointer                = typename alloc_traits::const_pointer;
+    using const_pointer          = typename alloc_traits::const_pointer;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = detail::_stack_iterator<value_type, node>;
+    using const_iterator         = iterator;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = reverse_iterator;
+
+protected:
+    node_pointer _root = nullptr;
+    size_type _size = 0;
+    [[no_unique_address]] node_allocator _node_alloc;
+    [[no_unique_address]] key_compare _cmp;
+
+public:
+    constexpr inline persistent_avl_tree() = default;
+    constexpr inline explicit persistent_avl_tree(allocator_type const & a) noexcept : _node_alloc{a} {}
+
+    // O(1): the copy shares the nodes of `other`
+    constexpr inline persistent_avl_tree(persistent_avl_tree const & other) noexcept
+        : _root{_acquire(other._root)}, _size{other._size}, _node_alloc{other._node_alloc}, _cmp{other._cmp} {}
+    constexpr inline persistent_avl_tree(persistent_avl_tree && other) noexcept
+        : _root{std::exchange(other._root, nullptr)}, _size{std::exchange(other._size, 0)},
+          _node_alloc{std::move(other._node_alloc)}, _cmp{std::move(other._cmp)} {}
+
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr explicit persistent_avl_tree(Iterator f, Iterator l, allocator_type const & a = allocator_type{})
+        : _node_alloc{a}
+    { assign(std::move(f), std::move(l)); }
+
+    constexpr persistent_avl_tree(std::initializer_list<value_type> il, allocator_type const & a = allocator_type{})
+        : persistent_avl_tree(il.begin(), il.end(), a) { }
+
+    inline ~persistent_avl_tree() noexcept { clear(); }
+
+    constexpr persistent_avl_tree & operator=(persistent_avl_tree const & other) noexcept;
+    constexpr persistent_avl_tree & operator=(persistent_avl_tree && other) noexcept;
+    constexpr inline
+    persistent_avl_tree & operator=(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); return *this; }
+
+    constexpr inline
+    void assign(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); }
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr void assign(Iterator f, Iterator l);
+
+    // A version of the tree that later updates of `*this` do not affect, in O(1)
+    constexpr inline persistent_avl_tree snapshot() const noexcept { return *this; }
+
+    constexpr inline
+    allocator_type get_allocator() const noexcept { return allocator_type(_node_alloc); }
+
+    /// Capacity
+    constexpr inline size_type size() const noexcept { return _size; }
+    [[nodiscard]] constexpr inline bool empty() const noexcept { return _size == 0; }
+    constexpr inline
+    size_type max_size() const noexcept
+    {
+        return std::min<size_type>(
+            node_allocator_traits::max_size(_node_alloc), std::numeric_limits<difference_type>::max()
+        );
+    }
+
+    /// Iterators
+    constexpr inline
+    const_iterator begin() const noexcept { auto it = const_iterator{_root}; it._descend(_root, true); return it; }
+    constexpr inline const_iterator end() const noexcept { return const_iterator{_root}; }
+    constexpr inline const_iterator cbegin() const noexcept { return begin(); }
+    constexpr inline const_iterator cend() const noexcept { return end(); }
+    constexpr inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    constexpr inline const_reverse_iterator crend() const noexcept { return rend(); }
+
+    /// Access
+    constexpr inline const_reference front() const { return *begin(); }
+    constexpr inline const_reference back() const { return *std::prev(end()); }
+
+    /// Modifiers
+    constexpr void clear() noexcept { _release(std::exchange(_root, nullptr)); _size = 0; }
+    constexpr inline iterator insert(value_type const & value) { return _insert(_construct_node(value)); }
+    constexpr inline iterator insert(value_type && value) { return _insert(_construct_node(std::move(value))); }
+    template <typename ...Args>
+    constexpr inline iterator emplace(Args&&... args) { return _insert(_construct_node(std::forward<Args>(args)...)); }
+
+    constexpr iterator erase(const_iterator it);
+    constexpr size_type erase(value_type const & value);
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr size_type erase(U const & value);
+
+    /// Lookup
+    constexpr auto count(value_type const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr auto count(U const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    constexpr inline bool contains(value_type const & x) const { return _find(x) != nullptr; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline bool contains(U const & x) const { return _find(x) != nullptr; }
+
+    constexpr inline const_iterator find(value_type const & x) const { return _find_iterator(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator find(U const & x) const { return _find_iterator(x); }
+
+    constexpr inline const_iterator lower_bound(value_type const & x) const
+    { return _bound([&](auto const & v) { return not _cmp(v, x); }); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator lower_bound(U const & x) const
+    { return _bound([&](auto const & v) { return not _cmp(v, x); }); }
+
+    constexpr inline const_iterator upper_bound(value_type const & x) const
+    { return _bound([&](auto const & v) { return _cmp(x, v); }); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator upper_bound(U const & x) const
+    { return _bound([&](auto const & v) { return _cmp(x, v); }); }
+
+    constexpr inline auto equal_range(value_type const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+
+    constexpr inline
+    void swap(persistent_avl_tree & other) noexcept
+    {
+        using std::swap;
+        swap(_root, other._root);
+        swap(_size, other._size);
+        swap(_cmp, other._cmp);
+        if constexpr (node_allocator_traits::propagate_on_container_swap::value) {
+            swap(_node_alloc, other._node_alloc);
+        }
+    }
+
+    friend constexpr bool operator==(persistent_avl_tree const & lhs, persistent_avl_tree const & rhs) noexcept
+    {
+        return lhs.size() == rhs.size()
+           and (lhs._root == rhs._root or std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend()));
+    }
+    friend constexpr bool operator!=(persistent_avl_tree const & lhs, persistent_avl_tree const & rhs) noexcept
+    { return not (lhs == rhs); }
+    friend constexpr bool operator< (persistent_avl_tree const & lhs, persistent_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less{}); }
+    friend constexpr bool operator<=(persistent_avl_tree const & lhs, persistent_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less_equal{}); }
+    friend constexpr bool operator> (persistent_avl_tree const & lhs, persistent_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater{}); }
+    friend constexpr bool operator>=(persistent_avl_tree const & lhs, persistent_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater_equal{}); }
+
+protected:
+    static constexpr inline
+    node_pointer _acquire(node_pointer n) noexcept
+    {
+        if (n != nullptr) {
+            n->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return n;
+    }
+    constexpr void _release(node_pointer n) noexcept;
+
+    template <typename ...Args>
+    constexpr node_pointer _construct_node(Args &&... args);
+    constexpr void _destroy_node(node_pointer n) noexcept;
+    constexpr node_pointer _unshare(node_pointer & slot);
+
+    constexpr iterator _insert(node_pointer n);
+    constexpr void _insert(node_pointer & slot, node_pointer n);
+    template <typename U>
+    constexpr void _erase(node_pointer & slot, U const & x);
+    constexpr node_pointer _take_front(node_pointer & slot);
+
+    constexpr void _rebalance(node_pointer & slot);
+    constexpr void _right_rotation(node_pointer & slot);
+    constexpr void _left_rotation(node_pointer & slot);
+
+    template <typename U> constexpr node_const_pointer _find(U const & x) const;
+    template <typename U> constexpr const_iterator _find_iterator(U const & x) const;
+    template <typename GoLeft> constexpr const_iterator _bound(GoLeft && go_left) const;
+}; // class persistent_avl_tree
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::operator=(persistent_avl_tree const & other) noexcept
+    -> persistent_avl_tree &
+{
+    auto const root = _acquire(other._root);
+    clear();
+    _root = root;
+    _size = other._size;
+    _cmp = other._cmp;
+    if constexpr (node_allocator_traits::propagate_on_container_copy_assignment::value) {
+        _node_alloc = other._node_alloc;
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::operator=(persistent_avl_tree && other) noexcept
+    -> persistent_avl_tree &
+{
+    if (this != std::addressof(other)) {
+        clear();
+        if constexpr (node_allocator_traits::propagate_on_container_move_assignment::value) {
+            _node_alloc = std::move(other._node_alloc);
+        }
+        //NB: if _node_alloc != other._node_alloc, behavior is undefined
+        _cmp = std::move(other._cmp);
+        _root = std::exchange(other._root, nullptr);
+        _size = std::exchange(other._size, 0);
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+constexpr void persistent_avl_tree<T, Compare, Alloc>::assign(Iterator f, Iterator l)
+{
+    clear();
+    while (f != l) {
+        emplace(*f++);
+    }
+}
+
+// Drops a link to `n`, freeing it if it was the last one, and then its children in turn. The recursion is as
+// deep as the tree
+template <typename T, typename Compare, typename Alloc>
+constexpr void persistent_avl_tree<T, Compare, Alloc>::_release(node_pointer n) noexcept
+{
+    while (n != nullptr and n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        _release(n->left);
+        auto const right = n->right;
+        _destroy_node(n);
+        n = right;
+    }
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename ...Args>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::_construct_node(Args &&... args)
+    -> node_pointer
+{
+    auto hold = std::unique_ptr<node, detail::_node_deallocator<node, node_allocator>>(
+        node_allocator_traits::allocate(_node_alloc, 1), detail::_node_deallocator<node, node_allocator>(_node_alloc)
+    );
+    node_allocator_traits::construct(_node_alloc, hold.get());
+    ++hold.get_deleter().constructed;
+    node_allocator_traits::construct(_node_alloc, std::addressof(hold->value()), std::forward<Args>(args)...);
+    ++hold.get_deleter().constructed;
+    return hold.release();
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void persistent_avl_tree<T, Compare, Alloc>::_destroy_node(node_pointer n) noexcept
+{
+    node_allocator_traits::destroy(_node_alloc, std::addressof(n->value()));
+    node_allocator_traits::destroy(_node_alloc, n);
+    node_allocator_traits::deallocate(_node_alloc, n, 1);
+}
+
+// Makes the node linked by `slot` owned by this tree only, copying it if another link points to it. The copy
+// links the same children, which become shared in turn. `slot` must belong to a node owned by this tree (or be
+// `_root`), so that no other tree can see the change
+template <typename T, typename Compare, typename Alloc>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::_unshare(node_pointer & slot)
+    -> node_pointer
+{
+    if (not slot->is_shared()) {
+        return slot;
+    }
+    auto const copy = _construct_node(std::as_const(slot->value()));
+    copy->left = _acquire(slot->left);
+    copy->right = _acquire(slot->right);
+    copy->height = slot->height;
+    _release(std::exchange(slot, copy));
+    return copy;
+}
+
+// Path copying insertion: equivalent elements go after the existing ones, as in `avl_tree`. If copying a node
+// throws, the copies done so far hold the same values, and `n` is freed
+template <typename T, typename Compare, typename Alloc>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::_insert(node_pointer n)
+    -> iterator
+{
+    try {
+        _insert(_root, n);
+    } catch (...) {
+        _destroy_node(n);
+        throw;
+    }
+    ++_size;
+    // The node is the last among its equivalents: follow its path to build the iterator
+    auto it = iterator{_root};
+    for (auto ptr = _root; ptr != n; ptr = _cmp(n->value(), ptr->value()) ? ptr->left : ptr->right) {
+        it._push(ptr);
+    }
+    it._push(n);
+    return it;
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void persistent_avl_tree<T, Compare, Alloc>::_insert(node_pointer & slot, node_pointer n)
+{
+    if (slot == nullptr) {
+        slot = n;
+        return;
+    }
+    auto const s = _unshare(slot);
+    _insert(_cmp(n->value(), s->value()) ? s->left : s->right, n);
+    _rebalance(slot);
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::erase(const_iterator it)
+    -> iterator
+{
+    // The equivalent elements are indistinguishable: erase the first one, and return an iterator to the one
+    // following the erased position
+    auto const target = *it;
+    auto const before = std::distance(lower_bound(target), it);
+    _erase(_root, target);
+    --_size;
+    return std::next(lower_bound(target), before);
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::erase(value_type const & value)
+    -> size_type
+{
+    auto count = size_type{0};
+    for (; contains(value); ++count, --_size) {
+        _erase(_root, value);
+    }
+    return count;
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::erase(U const & value)
+    -> size_type
+{
+    auto count = size_type{0};
+    for (; contains(value); ++count, --_size) {
+        _erase(_root, value);
+    }
+    return count;
+}
+
+// Erases the first element equivalent to `x`, which must be in the subtree. With two children, the node is
+// replaced by the first one of its right subtree
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+constexpr void persistent_avl_tree<T, Compare, Alloc>::_erase(node_pointer & slot, U const & x)
+{
+    // The left subtree holds an equivalent element iff its last one is not less than `x`
+    auto const equivalent_before = [this, &x](node_const_pointer n) {
+        for (; n != nullptr and n->right != nullptr; n = n->right) {}
+        return n != nullptr and not _cmp(n->value(), x);
+    };
+    auto const s = _unshare(slot);
+    if (_cmp(x, s->value())) {
+        _erase(s->left, x);
+    } else if (_cmp(s->value(), x)) {
+        _erase(s->right, x);
+    } else if (equivalent_before(s->left)) {
+        _erase(s->left, x);
+    } else {
+        if (s->left == nullptr or s->right == nullptr) {
+            slot = s->left != nullptr ? s->left : s->right;
+        } else {
+            auto const next = _take_front(s->right);
+            next->left = s->left;
+            next->right = s->right;
+            slot = next;
+        }
+        s->left = s->right = nullptr;
+        _release(s);
+    }
+    if (slot != nullptr) {
+        _rebalance(slot);
+    }
+}
+
+// Detaches the first node of the subtree, owned by this tree, and rebalances what is left
+template <typename T, typename Compare, typename Alloc>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::_take_front(node_pointer & slot)
+    -> node_pointer
+{
+    auto const s = _unshare(slot);
+    if (s->left == nullptr) {
+        slot = std::exchange(s->right, nullptr);
+        return s;
+    }
+    auto const front = _take_front(s->left);
+    _rebalance(slot);
+    return front;
+}
+
+// Restores the height and the balance of the node linked by `slot`, which must be owned by this tree
+template <typename T, typename Compare, typename Alloc>
+constexpr void persistent_avl_tree<T, Compare, Alloc>::_rebalance(node_pointer & slot)
+{
+    auto const factor = [](node_const_pointer n) {
+        return detail::_height_of(n->left) - detail::_height_of(n->right);
+    };
+    auto const s = slot;
+    s->height = detail::_subtree_height(s);
+    if (auto const diff = factor(s); diff >= 2) {
+        if (factor(s->left) < 0) {
+            _left_rotation(s->left);
+        }
+        _right_rotation(slot);
+    } else if (diff <= -2) {
+        if (factor(s->right) > 0) {
+            _right_rotation(s->right);
+        }
+        _left_rotation(slot);
+    }
+}
+
+// The links move between the rotated nodes, so the reference counts do not change; both nodes are made owned
+template <typename T, typename Compare, typename Alloc>
+constexpr void persistent_avl_tree<T, Compare, Alloc>::_right_rotation(node_pointer & slot)
+{
+    auto const v = _unshare(slot);
+    auto const u = _unshare(v->left);
+    v->left = u->right;
+    u->right = v;
+    slot = u;
+    v->height = detail::_subtree_height(v);
+    u->height = detail::_subtree_height(u);
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void persistent_avl_tree<T, Compare, Alloc>::_left_rotation(node_pointer & slot)
+{
+    auto const v = _unshare(slot);
+    auto const u = _unshare(v->right);
+    v->right = u->left;
+    u->left = v;
+    slot = u;
+    v->height = detail::_subtree_height(v);
+    u->height = detail::_subtree_height(u);
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::_find(U const & x) const
+    -> node_const_pointer
+{
+    auto n = node_const_pointer{_root};
+    while (n != nullptr) {
+        if (_cmp(x, n->value())) {
+            n = n->left;
+        } else if (_cmp(n->value(), x)) {
+            n = n->right;
+        } else {
+            return n;
+        }
+    }
+    return nullptr;
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::_find_iterator(U const & x) const
+    -> const_iterator
+{
+    auto it = lower_bound(x);
+    return it != end() and not _cmp(x, *it) ? it : end();
+}
+
+// The path to the first node for which `go_left` holds, that is the last one where the descent went left
+template <typename T, typename Compare, typename Alloc>
+template <typename GoLeft>
+constexpr auto persistent_avl_tree<T, Compare, Alloc>::_bound(GoLeft && go_left) const
+    -> const_iterator
+{
+    auto it = const_iterator{_root};
+    auto depth = std::size_t{0};
+    for (auto n = node_const_pointer{_root}; n != nullptr;) {
+        it._push(n);
+        if (go_left(n->value())) {
+            depth = it._depth;
+            n = n->left;
+        } else {
+            n = n->right;
+        }
+    }
+    it._depth = depth;
+    return it;
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr inline
+void swap(persistent_avl_tree<T, Compare, Alloc> & lhs, persistent_avl_tree<T, Compare, Alloc> & rhs) noexcept
+{ lhs.swap(rhs); }
+
+template <typename T, typename Compare, typename Alloc, typename Pred>
+constexpr
+auto erase_if(persistent_avl_tree<T, Compare, Alloc> & tree, Pred pred)
+    -> typename persistent_avl_tree<T, Compare, Alloc>::size_type
+{
+    auto const old_size = tree.size();
+    for (auto it = tree.begin(); it != tree.end();) {
+        it = pred(*it) ? tree.erase(it) : std::next(it);
+    }
+    return old_size - tree.size();
+}
+
+} // namespace forest
+
+#endif /* PERSISTENT_AVL_TREE_HPP */
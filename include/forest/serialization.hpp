@@ -0,0 +1,247 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : serialization
+ * @created     : lunedì ott 19, 2026 01:48:15 CEST
+ * @license     : MIT
+ * */
+
+#ifndef SERIALIZATION_HPP
+#define SERIALIZATION_HPP
+
+#include <algorithm>   //std::min
+#include <bit>         //std::bit_cast
+#include <cstdint>     //std::uint32_t, std::uint64_t
+#include <cstring>     //std::memcpy
+#include <istream>
+#include <memory>      //std::unique_ptr
+#include <new>         //std::launder
+#include <ostream>
+#include <stdexcept>   //std::runtime_error
+#include <string>      //std::basic_string
+#include <type_traits>
+#include <utility>     //std::pair
+
+#include "detail/utils.hpp"
+
+namespace forest
+{
+
+// Thrown by `load` when the stream does not hold elements of the requested type, or ends before them
+struct archive_error : std::runtime_error
+{
+    using std::runtime_error::runtime_error;
+};
+
+// How `save` and `load` write and read the elements which are not trivially copyable. A specialization provides
+// `static void save(std::ostream &, T const &)` and `static T load(std::istream &)`; the ones for
+// `std::basic_string` and `std::pair` are provided
+template <class T>
+struct serial_traits;
+
+namespace detail
+{
+// Trivially copyable values are written as their bytes, in the byte order of the machine
+template <class T>
+constexpr inline bool _is_raw_serializable = std::is_trivially_copyable_v<T>;
+
+template <class T>
+inline void _save_value(std::ostream & os, T const & value)
+{
+    if constexpr (_is_raw_serializable<T>) {
+        os.write(reinterpret_cast<char const *>(std::addressof(value)), sizeof(T));
+    } else {
+        serial_traits<T>::save(os, value);
+    }
+}
+
+template <class T>
+inline T _load_value(std::istream & is)
+{
+    if constexpr (_is_raw_serializable<T>) {
+        char bytes[sizeof(T)];
+        if (not is.read(bytes, sizeof(T))) {
+            throw archive_error{"forest::load: unexpected end of the stream"};
+        }
+        return std::bit_cast<T>(bytes);
+    } else {
+        return serial_traits<T>::load(is);
+    }
+}
+
+// The header: a magic number, the version of the format, the size of the elements if they are written as bytes
+// (0 otherwise) and their number
+constexpr inline char _archive_magic[4] = {'F', 'R', 'S', 'T'};
+constexpr inline std::uint32_t _archive_version = 1;
+
+template <class T>
+constexpr inline std::uint32_t _archive_element_size = _is_raw_serializable<T> ? sizeof(T) : 0;
+
+template <class T>
+inline void _save_header(std::ostream & os, std::uint64_t count)
+{
+    os.write(_archive_magic, sizeof(_archive_magic));
+    _save_value(os, _archive_version);
+    _save_value(os, _archive_element_size<T>);
+    _save_value(os, count);
+}
+
+template <class T>
+inline std::uint64_t _load_header(std::istream & is)
+{
+    char magic[sizeof(_archive_magic)];
+    if (not is.read(magic, sizeof(magic)) or not std::equal(std::begin(magic), std::end(magic), _archive_magic)) {
+        throw archive_error{"forest::load: the stream does not hold a tree"};
+    }
+    if (_load_value<std::uint32_t>(is) != _archive_version) {
+        throw archive_error{"forest::load: unsupported format version"};
+    }
+    if (_load_value<std::uint32_t>(is) != _archive_element_size<T>) {
+        throw archive_error{"forest::load: the stream holds elements of another type"};
+    }
+    return _load_value<std::uint64_t>(is);
+}
+
+// Trivially copyable elements go through a buffer of about 64 KiB, written and read with a single call
+template <class T>
+struct _raw_block
+{
+    using storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+    static_assert(sizeof(storage) == sizeof(T));
+
+    static constexpr std::size_t capacity = std::max<std::size_t>(1, (1 << 16) / sizeof(T));
+
+    std::unique_ptr<storage[]> data = std::make_unique<storage[]>(capacity);
+
+    inline char * bytes() noexcept { return reinterpret_cast<char *>(data.get()); }
+    inline T const & operator[](std::size_t i) const noexcept
+    { return *std::launder(reinterpret_cast<T const *>(std::addressof(data[i]))); }
+}; // struct _raw_block
+
+// Writes the elements of `tree` as their bytes, one block at a time
+template <class Tree>
+void _save_raw_elements(Tree const & tree, std::ostream & os)
+{
+    using value_type = typename Tree::value_type;
+    auto block = _raw_block<value_type>{};
+    auto filled = std::size_t{0};
+    for (auto const & value : tree) {
+        std::memcpy(std::addressof(block.data[filled]), std::addressof(value), sizeof(value_type));
+        if (++filled == block.capacity) {
+            os.write(block.bytes(), static_cast<std::streamsize>(filled * sizeof(value_type)));
+            filled = 0;
+        }
+    }
+    os.write(block.bytes(), static_cast<std::streamsize>(filled * sizeof(value_type)));
+}
+
+struct _serialization_access
+{
+    // Links the elements in order, without comparisons, when the tree allows it
+    template <class Tree, class Make>
+    static auto assign(Tree & tree, std::uint64_t count, Make & make, int)
+        -> decltype(tree._assign_sorted(count, make))
+    { return tree._assign_sorted(count, make); }
+
+    template <class Tree, class Make>
+    static void assign(Tree & tree, std::uint64_t count, Make & make, long)
+    {
+        tree.clear();
+        for (std::uint64_t i = 0; i < count; ++i) {
+            tree.insert(make());
+        }
+    }
+}; // struct _serialization_access
+} // namespace detail
+
+// Writes the size of `tree` and its elements in order to `os`. Failures are reported through the state of `os`
+template <class Tree>
+void save(Tree const & tree, std::ostream & os)
+{
+    using value_type = typename Tree::value_type;
+    detail::_save_header<value_type>(os, tree.size());
+    if constexpr (detail::_is_raw_serializable<value_type>) {
+        detail::_save_raw_elements(tree, os);
+    } else {
+        for (auto const & value : tree) {
+            detail::_save_value(os, value);
+        }
+    }
+}
+
+// Reads a tree written by `save`. `binary_search_tree`, `avl_tree`, `wavl_tree` and the maps link the elements
+// in a perfectly balanced tree as they are read, in O(n) and without comparing them, and `treap` links them in a
+// treap the same way; other trees insert them one by one. Throws `archive_error` if the stream holds something else or ends early
+template <class Tree>
+Tree load(std::istream & is, typename Tree::allocator_type const & a = typename Tree::allocator_type{})
+{
+    using value_type = typename Tree::value_type;
+    auto tree = Tree(a);
+    auto const count = detail::_load_header<value_type>(is);
+    if constexpr (detail::_is_raw_serializable<value_type>) {
+        auto block = detail::_raw_block<value_type>{};
+        auto remaining = count;
+        auto filled = std::size_t{0};
+        auto next = std::size_t{0};
+        auto make = [&]() -> value_type const & {
+            if (next == filled) {
+                filled = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, block.capacity));
+                if (not is.read(block.bytes(), static_cast<std::streamsize>(filled * sizeof(value_type)))) {
+                    throw archive_error{"forest::load: unexpected end of the stream"};
+                }
+                remaining -= filled;
+                next = 0;
+            }
+            return block[next++];
+        };
+        detail::_serialization_access::assign(tree, count, make, 0);
+    } else {
+        auto make = [&is] {
+            auto value = detail::_load_value<value_type>(is);
+            if (not is) {
+                throw archive_error{"forest::load: unexpected end of the stream"};
+            }
+            return value;
+        };
+        detail::_serialization_access::assign(tree, count, make, 0);
+    }
+    return tree;
+}
+
+template <class CharT, class Traits, class Alloc>
+struct serial_traits<std::basic_string<CharT, Traits, Alloc>>
+{
+    using string_type = std::basic_string<CharT, Traits, Alloc>;
+
+    static void save(std::ostream & os, string_type const & s)
+    {
+        detail::_save_value(os, static_cast<std::uint64_t>(s.size()));
+        os.write(reinterpret_cast<char const *>(s.data()), static_cast<std::streamsize>(s.size() * sizeof(CharT)));
+    }
+    static string_type load(std::istream & is)
+    {
+        auto s = string_type(static_cast<std::size_t>(detail::_load_value<std::uint64_t>(is)), CharT{});
+        is.read(reinterpret_cast<char *>(s.data()), static_cast<std::streamsize>(s.size() * sizeof(CharT)));
+        return s;
+    }
+}; // struct serial_traits<std::basic_string>
+
+// Also covers the `std::pair<Key const, Mapped>` of the maps
+template <class First, class Second>
+struct serial_traits<std::pair<First, Second>>
+{
+    static void save(std::ostream & os, std::pair<First, Second> const & p)
+    {
+        detail::_save_value(os, p.first);
+        detail::_save_value(os, p.second);
+    }
+    static std::pair<First, Second> load(std::istream & is)
+    {
+        auto first = detail::_load_value<std::remove_const_t<First>>(is);
+        auto second = detail::_load_value<std::remove_const_t<Second>>(is);
+        return {std::move(first), std::move(second)};
+    }
+}; // struct serial_traits<std::pair>
+
+} // namespace forest
+
+#endif /* SERIALIZATION_HPP */
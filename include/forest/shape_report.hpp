@@ -0,0 +1,64 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : shape_report
+ * @created     : lunedì ott 19, 2026 04:31:09 CEST
+ * @license     : MIT
+ * */
+
+#ifndef SHAPE_REPORT_HPP
+#define SHAPE_REPORT_HPP
+
+#include <bit>         //std::bit_width
+#include <cstddef>     //std::size_t
+#include <type_traits> //std::remove_cvref_t
+#include <vector>
+
+#include "detail/bst_iterator.hpp"
+
+namespace forest
+{
+
+// The shape of a tree, as measured by `shape_report`. Depths count the links from the root, which is at depth 0
+struct tree_shape
+{
+    std::size_t size = 0;                      // the number of nodes
+    std::size_t height = 0;                    // the number of levels, 0 if the tree is empty
+    std::size_t min_height = 0;                // the height of a perfectly balanced tree with as many nodes
+    std::vector<std::size_t> depth_histogram;  // `depth_histogram[d]` nodes are at depth `d`
+    double average_path_length = 0;            // the nodes a successful lookup visits, on average over the elements
+    std::size_t node_size = 0;                 // the bytes of a node, without the overhead of the allocator
+    std::size_t total_bytes = 0;               // the bytes of the nodes and of the tree object
+}; // struct tree_shape
+
+// Measures the shape of `tree`, which may be a `binary_search_tree`, an `avl_tree`, an `avl_map`, an
+// `avl_multimap`, an `augmented_avl_tree` or an `interval_tree`. It walks the tree once, in O(n) time and
+// without recursion; the histogram is the only memory it allocates, so it can be sampled periodically to spot
+// a tree degenerating under some pattern of insertions
+template <class Tree>
+tree_shape shape_report(Tree const & tree)
+{
+    using node_type = std::remove_cvref_t<decltype(*_node_of(tree.cend()))>;
+
+    auto shape = tree_shape{};
+    auto path_lengths = std::size_t{0};
+    detail::_for_each_depth(_node_of(tree.cend()), [&](std::size_t depth) {
+        if (depth >= shape.depth_histogram.size()) {
+            shape.depth_histogram.resize(depth + 1);
+        }
+        ++shape.depth_histogram[depth];
+        path_lengths += depth + 1;
+        ++shape.size;
+    });
+    shape.height = shape.depth_histogram.size();
+    shape.min_height = static_cast<std::size_t>(std::bit_width(shape.size));
+    if (shape.size != 0) {
+        shape.average_path_length = static_cast<double>(path_lengths) / static_cast<double>(shape.size);
+    }
+    shape.node_size = sizeof(node_type);
+    shape.total_bytes = shape.size * sizeof(node_type) + sizeof(Tree);
+    return shape;
+}
+
+} // namespace forest
+
+#endif /* SHAPE_REPORT_HPP */
@@ -0,0 +1,429 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : sharded_tree
+ * @created     : domenica ott 18, 2026 23:01:14 CEST
+ * @license     : MIT
+ * */
+
+#ifndef SHARDED_TREE_HPP
+#define SHARDED_TREE_HPP
+
+#include <algorithm>        //std::upper_bound, std::max
+#include <atomic>           //std::atomic
+#include <deque>            //std::deque
+#include <initializer_list>
+#include <iterator>         //std::distance
+#include <limits>           //std::numeric_limits
+#include <memory>
+#include <mutex>            //std::unique_lock, std::try_to_lock
+#include <optional>         //std::optional
+#include <shared_mutex>     //std::shared_mutex, std::shared_lock
+#include <vector>           //std::vector
+
+#include "avl_tree.hpp"
+#include "detail/utils.hpp"
+#include "detail/sharded_iterator.hpp"
+
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+// A multiset split by key range into a fixed number of shards, each one a `Tree` with its own lock, so that
+// writers working on different key ranges do not wait for each other. Shard `i` holds the elements `x` with
+// `split[i - 1] <= x < split[i]`: equivalent elements always share a shard.
+//
+// The split points are either given at construction or computed from a sample of the elements: `rebalance()`
+// walks the tree taking `samples_per_shard` evenly spaced elements per shard, picks their quantiles as the new
+// split points, and moves the elements which changed shard (through node handles, when `Tree` has them).
+// A writer which grows its shard past twice the size of the largest shard after the last rebalance (and past
+// `min_shard_size`) triggers a new one, waiting for the other operations to end.
+//
+// Every member function but the iterators can run concurrently. Lookups return `std::optional<T>` copies;
+// iterators visit all the shards in order, and must not be used while the tree is modified
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>,
+          template <class, class, class> class Tree = avl_tree>
+class sharded_tree
+{
+protected:
+    struct alignas(64) _shard
+    {
+        using tree_type = Tree<T, Compare, Alloc>;
+
+        mutable std::shared_mutex mutex;
+        std::atomic<std::size_t> size = 0; // readable without the lock
+        tree_type tree;
+
+        explicit _shard(Alloc const & a) : tree(a) {}
+    };
+    using shard_list = std::deque<_shard, typename std::allocator_traits<Alloc>::template rebind_alloc<_shard>>;
+    using split_list = std::vector<T, Alloc>;
+    using tree_type  = typename _shard::tree_type;
+
+public:
+    using key_type               = T;
+    using value_type             = T;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using allocator_type         = Alloc;
+    using reference              = value_type const &;
+    using const_reference        = value_type const &;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = detail::_sharded_iterator<value_type, shard_list>;
+    using const_iterator         = iterator;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = reverse_iterator;
+
+    static constexpr size_type default_shard_count = 16;
+    static constexpr size_type samples_per_shard = 32;
+    static constexpr size_type min_shard_size = 1024;
+
+protected:
+    // Shared by every operation, exclusive while the split points change
+    mutable std::shared_mutex _layout;
+    shard_list _shards;
+    split_list _splits;
+    std::atomic<size_type> _shard_limit = min_shard_size;
+    [[no_unique_address]] key_compare _cmp;
+
+public:
+    inline explicit sharded_tree(size_type shards = default_shard_count, allocator_type const & a = allocator_type{})
+        : _shards(a), _splits(a)
+    {
+        for (size_type i = 0; i < std::max<size_type>(shards, 1); ++i) {
+            _shards.emplace_back(a);
+        }
+    }
+    // `splits.size() + 1` shards, split at the given points, which must be sorted
+    inline explicit sharded_tree(split_list splits, allocator_type const & a = allocator_type{})
+        : sharded_tree(splits.size() + 1, a)
+    { _splits = std::move(splits); }
+
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    explicit sharded_tree(Iterator f, Iterator l, size_type shards = default_shard_count,
+                          allocator_type const & a = allocator_type{})
+        : sharded_tree(shards, a)
+    {
+        for (; f != l; ++f) {
+            _shards.front().tree.insert(*f);
+        }
+        _shards.front().size = _shards.front().tree.size();
+        rebalance();
+    }
+    sharded_tree(std::initializer_list<value_type> il, size_type shards = default_shard_count,
+                 allocator_type const & a = allocator_type{})
+        : sharded_tree(il.begin(), il.end(), shards, a) { }
+
+    sharded_tree(sharded_tree const &) = delete;
+    sharded_tree & operator=(sharded_tree const &) = delete;
+
+    inline allocator_type get_allocator() const noexcept { return _shards.front().tree.get_allocator(); }
+
+    /// Capacity
+    size_type size() const noexcept;
+    [[nodiscard]] inline bool empty() const noexcept { return size() == 0; }
+    inline size_type max_size() const noexcept { return std::numeric_limits<size_type>::max(); }
+    inline size_type shard_count() const noexcept { return _shards.size(); }
+    // The current split points
+    split_list split_points() const;
+
+    /// Iterators: no modification may run concurrently
+    inline const_iterator begin() const noexcept
+    { return const_iterator{_shards, 0, _shards.front().tree.begin()}; }
+    inline const_iterator end() const noexcept
+    { return const_iterator{_shards, _shards.size() - 1, _shards.back().tree.end()}; }
+    inline const_iterator cbegin() const noexcept { return begin(); }
+    inline const_iterator cend() const noexcept { return end(); }
+    inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+
+    /// Modifiers: they lock only the shard of the element
+    inline void insert(value_type const & value) { _insert(value, false); }
+    inline void insert(value_type && value) { _insert(std::move(value), false); }
+    template <typename ...Args>
+    inline void emplace(Args &&... args) { _insert(value_type(std::forward<Args>(args)...), false); }
+    // Inserts `value` only if no equivalent element is in the tree; returns true if it did
+    inline bool insert_unique(value_type const & value) { return _insert(value, true); }
+    inline bool insert_unique(value_type && value) { return _insert(std::move(value), true); }
+
+    // Erases every element equivalent to `x`, returning how many
+    size_type erase(value_type const & x);
+    void clear();
+    // Recomputes the split points from a sample of the elements, and moves the elements to their new shards.
+    // It waits for every other operation to end, and runs in O(n)
+    void rebalance();
+
+    /// Lookup: they lock the shards they visit, shared
+    inline bool contains(value_type const & x) const
+    { return _lookup(x, [&x](auto const & t) { return t.contains(x); }); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline bool contains(U const & x) const
+    { return _lookup(x, [&x](auto const & t) { return t.contains(x); }); }
+
+    inline auto count(value_type const & x) const -> difference_type
+    { return _lookup(x, [&x](auto const & t) { return static_cast<difference_type>(t.count(x)); }); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto count(U const & x) const -> difference_type
+    { return _lookup(x, [&x](auto const & t) { return static_cast<difference_type>(t.count(x)); }); }
+
+    inline auto find(value_type const & x) const -> std::optional<value_type> { return _find(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto find(U const & x) const -> std::optional<value_type> { return _find(x); }
+
+    // The first element not less than `x`, if any
+    inline auto lower_bound(value_type const & x) const -> std::optional<value_type>
+    { return _bound(x, [&x](auto const & t) { return t.lower_bound(x); }); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto lower_bound(U const & x) const -> std::optional<value_type>
+    { return _bound(x, [&x](auto const & t) { return t.lower_bound(x); }); }
+
+    // The first element greater than `x`, if any
+    inline auto upper_bound(value_type const & x) const -> std::optional<value_type>
+    { return _bound(x, [&x](auto const & t) { return t.upper_bound(x); }); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    inline auto upper_bound(U const & x) const -> std::optional<value_type>
+    { return _bound(x, [&x](auto const & t) { return t.upper_bound(x); }); }
+
+    // Calls `f` on every element, in order, holding the lock of one shard at a time
+    template <typename F>
+    void for_each(F && f) const;
+
+protected:
+    template <typename U>
+    inline size_type _shard_index(U const & x) const
+    { return static_cast<size_type>(std::upper_bound(_splits.begin(), _splits.end(), x, _cmp) - _splits.begin()); }
+
+    template <typename V> bool _insert(V && value, bool unique);
+    template <typename U, typename F> auto _lookup(U const & x, F && f) const;
+    template <typename U> auto _find(U const & x) const -> std::optional<value_type>;
+    template <typename U, typename F> auto _bound(U const & x, F && f) const -> std::optional<value_type>;
+
+    void _rebalance();
+    void _redistribute();
+}; // class sharded_tree
+
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+auto sharded_tree<T, Compare, Alloc, Tree>::size() const noexcept
+    -> size_type
+{
+    auto res = size_type{0};
+    for (auto const & shard : _shards) {
+        res += shard.size.load(std::memory_order_relaxed);
+    }
+    return res;
+}
+
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+auto sharded_tree<T, Compare, Alloc, Tree>::split_points() const
+    -> split_list
+{
+    auto const layout = std::shared_lock{_layout};
+    return _splits;
+}
+
+// The rebalance check runs after the locks are released, since it needs the layout lock exclusively. The
+// first writer to see the shard over the limit raises it, so that the others do not rebalance again
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+template <typename V>
+bool sharded_tree<T, Compare, Alloc, Tree>::_insert(V && value, bool unique)
+{
+    auto layout = std::shared_lock{_layout};
+    auto & shard = _shards[_shard_index(value)];
+    auto size = size_type{0};
+    {
+        auto const lock = std::unique_lock{shard.mutex};
+        if (unique and shard.tree.contains(value)) {
+            return false;
+        }
+        shard.tree.insert(std::forward<V>(value));
+        size = shard.tree.size();
+        shard.size.store(size, std::memory_order_relaxed);
+    }
+    layout.unlock();
+    auto limit = _shard_limit.load(std::memory_order_relaxed);
+    if (size > limit and _shard_limit.compare_exchange_strong(limit, max_size(), std::memory_order_relaxed)) {
+        auto const exclusive = std::unique_lock{_layout};
+        try {
+            _rebalance();
+        } catch (...) {
+            _shard_limit.store(limit, std::memory_order_relaxed);
+            throw;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+auto sharded_tree<T, Compare, Alloc, Tree>::erase(value_type const & x)
+    -> size_type
+{
+    auto const layout = std::shared_lock{_layout};
+    auto & shard = _shards[_shard_index(x)];
+    auto const lock = std::unique_lock{shard.mutex};
+    auto const count = shard.tree.erase(x);
+    shard.size.store(shard.tree.size(), std::memory_order_relaxed);
+    return count;
+}
+
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+void sharded_tree<T, Compare, Alloc, Tree>::clear()
+{
+    auto const layout = std::shared_lock{_layout};
+    for (auto & shard : _shards) {
+        auto const lock = std::unique_lock{shard.mutex};
+        shard.tree.clear();
+        shard.size.store(0, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+void sharded_tree<T, Compare, Alloc, Tree>::rebalance()
+{
+    auto const layout = std::unique_lock{_layout};
+    _rebalance();
+}
+
+// Equivalent elements are all in the shard of `x`
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+template <typename U, typename F>
+auto sharded_tree<T, Compare, Alloc, Tree>::_lookup(U const & x, F && f) const
+{
+    auto const layout = std::shared_lock{_layout};
+    auto const & shard = _shards[_shard_index(x)];
+    auto const lock = std::shared_lock{shard.mutex};
+    return f(shard.tree);
+}
+
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+template <typename U>
+auto sharded_tree<T, Compare, Alloc, Tree>::_find(U const & x) const
+    -> std::optional<value_type>
+{
+    return _lookup(x, [&x](auto const & t) {
+        auto const it = t.find(x);
+        return it != t.end() ? std::optional<value_type>{*it} : std::nullopt;
+    });
+}
+
+// Looks for the bound in the shard of `x`, then takes the first element of the following non empty shard
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+template <typename U, typename F>
+auto sharded_tree<T, Compare, Alloc, Tree>::_bound(U const & x, F && f) const
+    -> std::optional<value_type>
+{
+    auto const layout = std::shared_lock{_layout};
+    auto const first = _shard_index(x);
+    for (auto i = first; i < _shards.size(); ++i) {
+        auto const & shard = _shards[i];
+        auto const lock = std::shared_lock{shard.mutex};
+        if (auto const it = i == first ? f(shard.tree) : shard.tree.begin(); it != shard.tree.end()) {
+            return *it;
+        }
+    }
+    return std::nullopt;
+}
+
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+template <typename F>
+void sharded_tree<T, Compare, Alloc, Tree>::for_each(F && f) const
+{
+    auto const layout = std::shared_lock{_layout};
+    for (auto const & shard : _shards) {
+        auto const lock = std::shared_lock{shard.mutex};
+        for (auto const & x : shard.tree) {
+            f(x);
+        }
+    }
+}
+
+// Takes every `stride`-th element, so that each shard contributes in proportion to its size, and splits at
+// the quantiles of the sample. The caller holds the layout lock exclusively
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+void sharded_tree<T, Compare, Alloc, Tree>::_rebalance()
+{
+    auto const total = size();
+    auto const shards = _shards.size();
+    if (shards > 1 and total > 0) {
+        auto const stride = std::max<size_type>(total / (shards * samples_per_shard), 1);
+        auto sample = split_list(_splits.get_allocator());
+        sample.reserve(total / stride + 1);
+        auto i = size_type{0};
+        for (auto it = begin(); it != end(); ++it, ++i) {
+            if (i % stride == 0) {
+                sample.push_back(*it);
+            }
+        }
+        auto splits = split_list(_splits.get_allocator());
+        splits.reserve(shards - 1);
+        for (size_type k = 1; k < shards; ++k) {
+            splits.push_back(sample[k * sample.size() / shards]);
+        }
+        _splits = std::move(splits);
+        _redistribute();
+    }
+
+    auto largest = size_type{0};
+    for (auto const & shard : _shards) {
+        largest = std::max(largest, shard.tree.size());
+    }
+    _shard_limit.store(2 * std::max({largest, total / shards, min_shard_size}), std::memory_order_relaxed);
+}
+
+// Moves the elements out of the range of their shard: they are a prefix and a suffix of it. The moved
+// elements are collected first, so that no shard receives elements before giving away its own
+template <typename T, typename Compare, typename Alloc, template <class, class, class> class Tree>
+void sharded_tree<T, Compare, Alloc, Tree>::_redistribute()
+{
+    auto const shards = _shards.size();
+    auto const range = [this, shards](tree_type & tree, size_type i) {
+        return std::pair{
+            i == 0 ? tree.begin() : tree.lower_bound(_splits[i - 1]),
+            i == shards - 1 ? tree.end() : tree.lower_bound(_splits[i])
+        };
+    };
+
+    if constexpr (requires { typename tree_type::node_type; }) {
+        auto moved = size_type{0};
+        for (size_type i = 0; i < shards; ++i) {
+            auto & tree = _shards[i].tree;
+            auto const [f, l] = range(tree, i);
+            moved += static_cast<size_type>(std::distance(tree.begin(), f) + std::distance(l, tree.end()));
+        }
+        auto nodes = std::vector<typename tree_type::node_type>{};
+        nodes.reserve(moved);
+        for (size_type i = 0; i < shards; ++i) {
+            auto & tree = _shards[i].tree;
+            auto [f, l] = range(tree, i);
+            while (tree.begin() != f) {
+                nodes.push_back(tree.extract(tree.begin()));
+            }
+            while (l != tree.end()) {
+                nodes.push_back(tree.extract(l++));
+            }
+        }
+        for (auto & n : nodes) {
+            _shards[_shard_index(n.value())].tree.insert(std::move(n));
+        }
+    } else {
+        auto values = split_list(_splits.get_allocator());
+        for (size_type i = 0; i < shards; ++i) {
+            auto & tree = _shards[i].tree;
+            auto const [f, l] = range(tree, i);
+            values.insert(values.end(), tree.begin(), f);
+            values.insert(values.end(), l, tree.end());
+            tree.erase(l, tree.end());
+            tree.erase(tree.begin(), f);
+        }
+        for (auto & x : values) {
+            _shards[_shard_index(x)].tree.insert(std::move(x));
+        }
+    }
+    for (auto & shard : _shards) {
+        shard.size.store(shard.tree.size(), std::memory_order_relaxed);
+    }
+}
+
+} // namespace forest
+
+#endif /* SHARDED_TREE_HPP */
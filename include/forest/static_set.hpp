@@ -0,0 +1,172 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : static_set
+ * @created     : lunedì ott 19, 2026 05:08:31 CEST
+ * @license     : MIT
+ * */
+
+#ifndef STATIC_SET_HPP
+#define STATIC_SET_HPP
+
+#include <algorithm>   //std::sort
+#include <array>       //std::array
+#include <bit>         //std::countr_one
+#include <cstddef>     //std::size_t
+#include <functional>  //std::less
+#include <iterator>    //std::reverse_iterator
+#include <stdexcept>   //std::invalid_argument
+#include <type_traits>
+#include <utility>     //std::pair
+
+#include "detail/eytzinger_iterator.hpp"
+
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+// A set of `N` elements fixed at construction, which can happen at compile time: the elements are sorted and laid
+// out in a single array as a complete binary tree, level by level (the Eytzinger layout), so that it holds no
+// pointer and a `constexpr static_set` is a table in the read-only data of the program, with no initialization
+// at startup. A lookup descends the implicit tree, touching one slot per level.
+// The elements must be distinct, default constructible and copy assignable; a constructor given duplicates throws
+// `std::invalid_argument`, which makes a constant expression ill-formed
+template <class T, std::size_t N, class Compare = std::less<>>
+class static_set
+{
+public:
+    using key_type               = T;
+    using value_type             = T;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = value_type const &;
+    using const_reference        = value_type const &;
+    using pointer                = value_type const *;
+    using const_pointer          = value_type const *;
+    using iterator               = detail::_eytzinger_iterator<T>;
+    using const_iterator         = iterator;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+protected:
+    std::array<T, N> _data{};
+    [[no_unique_address]] key_compare _cmp;
+
+public:
+    // Takes the elements in any order
+    explicit constexpr static_set(std::array<T, N> values, key_compare const & cmp = key_compare{});
+
+    constexpr inline key_compare key_comp() const { return _cmp; }
+    constexpr inline value_compare value_comp() const { return _cmp; }
+
+    /// Capacity
+    constexpr inline size_type size() const noexcept { return N; }
+    constexpr inline size_type max_size() const noexcept { return N; }
+    [[nodiscard]] constexpr inline bool empty() const noexcept { return N == 0; }
+
+    /// Iterators
+    constexpr inline const_iterator begin() const noexcept { return _at(detail::_eytzinger_first(N)); }
+    constexpr inline const_iterator end() const noexcept { return _at(0); }
+    constexpr inline const_iterator cbegin() const noexcept { return begin(); }
+    constexpr inline const_iterator cend() const noexcept { return end(); }
+    constexpr inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    constexpr inline const_reverse_iterator crend() const noexcept { return rend(); }
+
+    /// Access
+    constexpr inline const_reference front() const { return *begin(); }
+    constexpr inline const_reference back() const { return *_at(detail::_eytzinger_last(N)); }
+
+    /// Lookup
+    constexpr inline auto lower_bound(value_type const & x) const -> const_iterator { return _lower_bound(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto lower_bound(U const & x) const -> const_iterator { return _lower_bound(x); }
+    constexpr inline auto upper_bound(value_type const & x) const -> const_iterator { return _upper_bound(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto upper_bound(U const & x) const -> const_iterator { return _upper_bound(x); }
+    constexpr inline auto equal_range(value_type const & x) const -> std::pair<const_iterator, const_iterator>
+    { return _equal_range(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) const -> std::pair<const_iterator, const_iterator>
+    { return _equal_range(x); }
+
+    constexpr inline auto find(value_type const & x) const -> const_iterator { return _find(x); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto find(U const & x) const -> const_iterator { return _find(x); }
+    constexpr inline bool contains(value_type const & x) const { return _find(x) != end(); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline bool contains(U const & x) const { return _find(x) != end(); }
+    constexpr inline auto count(value_type const & x) const -> size_type { return contains(x) ? 1 : 0; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto count(U const & x) const -> size_type { return contains(x) ? 1 : 0; }
+
+    friend constexpr inline
+    bool operator==(static_set const & lhs, static_set const & rhs)
+    { return lhs._data == rhs._data; }
+
+protected:
+    constexpr inline const_iterator _at(std::size_t k) const noexcept { return const_iterator{_data.data(), N, k}; }
+
+    // Descends from the root, going right while `right(element)`: the result is the first element for which
+    // it is false, as the ancestors left from the right are skipped on the way back
+    template <typename Right>
+    constexpr inline
+    std::size_t _descend(Right const & right) const
+    {
+        auto k = std::size_t{1};
+        while (k <= N) {
+            k = 2 * k + static_cast<std::size_t>(right(_data[k - 1]));
+        }
+        return k >> (std::countr_one(k) + 1);
+    }
+
+    template <typename U>
+    constexpr inline const_iterator _lower_bound(U const & x) const
+    { return _at(_descend([this, &x](T const & e) { return _cmp(e, x); })); }
+    template <typename U>
+    constexpr inline const_iterator _upper_bound(U const & x) const
+    { return _at(_descend([this, &x](T const & e) { return not _cmp(x, e); })); }
+    template <typename U>
+    constexpr inline std::pair<const_iterator, const_iterator> _equal_range(U const & x) const
+    {
+        auto const first = _find(x);
+        return {first, first == end() ? first : std::next(first)};
+    }
+    template <typename U>
+    constexpr inline const_iterator _find(U const & x) const
+    {
+        auto const it = _lower_bound(x);
+        return it != end() and not _cmp(x, *it) ? it : end();
+    }
+}; // class static_set
+
+template <typename T, std::size_t N, typename Compare>
+constexpr static_set<T, N, Compare>::static_set(std::array<T, N> values, key_compare const & cmp)
+    : _cmp{cmp}
+{
+    std::sort(values.begin(), values.end(), _cmp);
+    for (std::size_t i = 1; i < N; ++i) {
+        if (not _cmp(values[i - 1], values[i])) {
+            throw std::invalid_argument{"forest::static_set: the elements are not distinct"};
+        }
+    }
+    // The in-order visit of the slots meets the elements in order
+    auto k = detail::_eytzinger_first(N);
+    for (auto & value : values) {
+        _data[k - 1] = std::move(value);
+        k = detail::_eytzinger_next(k, N);
+    }
+}
+
+template <typename T, std::size_t N>
+static_set(std::array<T, N>) -> static_set<T, N>;
+
+template <typename T, std::size_t N, typename Compare>
+static_set(std::array<T, N>, Compare) -> static_set<T, N, Compare>;
+
+} // namespace forest
+
+#endif /* STATIC_SET_HPP */
@@ -0,0 +1,634 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : threaded_avl_tree
+ * @created     : domenica ott 18, 2026 11:02:47 CEST
+ * @license     : MIT
+ * */
+
+#ifndef THREADED_AVL_TREE_HPP
+#define THREADED_AVL_TREE_HPP
+
+#include <algorithm>        //std::equal, std::lexicographical_compare
+#include <initializer_list>
+#include <limits>           //std::numeric_limits
+#include <memory>
+#include <utility>          //std::pair
+
+#include "detail/utils.hpp"
+#include "detail/threaded_node.hpp"
+#include "detail/threaded_iterator.hpp"
+
+#include "meta/is_transparent_compare.hpp"
+
+namespace forest
+{
+
+// An avl_tree whose missing children are replaced by threads to the in-order predecessor and successor:
+// stepping an iterator is a single hop through a thread or a descent along a spine, never a climb toward
+// the root. The threads live in the low bit of the child pointers, so the node is as big as `avl_tree`'s one.
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>>
+class threaded_avl_tree
+{
+protected:
+    using node                  = detail::threaded_node<T, std::int_fast8_t>;
+    using alloc_traits          = std::allocator_traits<Alloc>;
+    using node_allocator        = typename alloc_traits::template rebind_alloc<node>;
+    using node_allocator_traits = std::allocator_traits<node_allocator>;
+    using node_pointer          = node *;
+    using node_const_pointer    = node const *;
+    using height_type           = std::int_fast8_t;
+
+public:
+    using key_type               = T;
+    using value_type             = T;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using allocator_type         = Alloc;
+    using reference              = value_type &;
+    using const_reference        = value_type const &;
+    using pointer                = typename alloc_traits::pointer;
+    using const_pointer          = typename alloc_traits::const_pointer;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = detail::_threaded_iterator<value_type>;
+    using const_iterator         = detail::_threaded_const_iterator<value_type>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+protected:
+    // _end.root = root; _end.left = thread to back; _end.right = thread to front
+    node _end;
+    size_type _size = 0;
+    [[no_unique_address]] node_allocator _node_alloc;
+    [[no_unique_address]] key_compare _cmp;
+
+public:
+    constexpr inline
+    threaded_avl_tree() noexcept(noexcept(std::is_nothrow_default_constructible<node_allocator>::value))
+    { _set_end(); }
+    constexpr inline explicit threaded_avl_tree(allocator_type const & a) noexcept : _node_alloc{a} { _set_end(); }
+
+    constexpr threaded_avl_tree(threaded_avl_tree const & other);
+    constexpr threaded_avl_tree(threaded_avl_tree && other) noexcept;
+
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr explicit threaded_avl_tree(Iterator f, Iterator l, allocator_type const & a = allocator_type{});
+
+    constexpr threaded_avl_tree(std::initializer_list<value_type> il, allocator_type const & a = allocator_type{})
+        : threaded_avl_tree(il.begin(), il.end(), a) { }
+
+    inline ~threaded_avl_tree() noexcept { clear(); }
+
+    constexpr threaded_avl_tree & operator=(threaded_avl_tree const & other);
+    constexpr threaded_avl_tree & operator=(threaded_avl_tree && other) noexcept;
+    constexpr inline
+    threaded_avl_tree & operator=(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); return *this; }
+
+    constexpr inline
+    void assign(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); }
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr void assign(Iterator f, Iterator l);
+
+    constexpr inline
+    allocator_type get_allocator() const noexcept { return allocator_type(_node_alloc); }
+
+    /// Capacity
+    constexpr inline size_type size() const noexcept { return _size; }
+    [[nodiscard]] constexpr inline bool empty() const noexcept { return _size == 0; }
+    constexpr inline
+    size_type max_size() const noexcept
+    {
+        return std::min<size_type>(
+            node_allocator_traits::max_size(_node_alloc), std::numeric_limits<difference_type>::max()
+        );
+    }
+
+    /// Iterators
+    constexpr inline iterator begin() noexcept { return iterator{_end.right.get()}; }
+    constexpr inline const_iterator begin() const noexcept { return const_iterator{_end.right.get()}; }
+    constexpr inline iterator end() noexcept { return iterator{std::addressof(_end)}; }
+    constexpr inline const_iterator end() const noexcept { return const_iterator{std::addressof(_end)}; }
+    constexpr inline const_iterator cbegin() const noexcept { return begin(); }
+    constexpr inline const_iterator cend() const noexcept { return end(); }
+
+    constexpr inline reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator crend() const noexcept { return const_reverse_iterator{begin()}; }
+
+    /// Access
+    constexpr inline const_reference front() const { return _end.right.get()->value(); }
+    constexpr inline const_reference back() const { return _end.left.get()->value(); }
+
+    /// Modifiers
+    constexpr void clear() noexcept;
+    constexpr inline iterator insert(value_type const & value) { return iterator{_insert(_construct_node(value))}; }
+    constexpr inline iterator insert(value_type && value) { return iterator{_insert(_construct_node(std::move(value)))}; }
+    template <typename ...Args>
+    constexpr inline reference emplace(Args&&... args)
+    { return _insert(_construct_node(std::forward<Args>(args)...))->value(); }
+
+    constexpr iterator erase(iterator it);
+    constexpr iterator erase(iterator f, iterator l);
+    constexpr size_type erase(value_type const & value);
+
+    /// Lookup
+    constexpr auto count(value_type const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr auto count(U const & x) const -> difference_type
+    { auto const [f, l] = equal_range(x); return std::distance(f, l); }
+    constexpr inline bool contains(value_type const & x) const { return find(x) != end(); }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline bool contains(U const & x) const { return find(x) != end(); }
+
+    constexpr inline iterator find(value_type const & x) { return iterator{_find(x)}; }
+    constexpr inline const_iterator find(value_type const & x) const { return const_iterator{_find(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline iterator find(U const & x) { return iterator{_find(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator find(U const & x) const { return const_iterator{_find(x)}; }
+
+    constexpr inline iterator lower_bound(value_type const & x) { return iterator{_lower_bound(x)}; }
+    constexpr inline const_iterator lower_bound(value_type const & x) const { return const_iterator{_lower_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline iterator lower_bound(U const & x) { return iterator{_lower_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator lower_bound(U const & x) const { return const_iterator{_lower_bound(x)}; }
+
+    constexpr inline iterator upper_bound(value_type const & x) { return iterator{_upper_bound(x)}; }
+    constexpr inline const_iterator upper_bound(value_type const & x) const { return const_iterator{_upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline iterator upper_bound(U const & x) { return iterator{_upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline const_iterator upper_bound(U const & x) const { return const_iterator{_upper_bound(x)}; }
+
+    constexpr inline auto equal_range(value_type const & x) -> std::pair<iterator, iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    constexpr inline auto equal_range(value_type const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) -> std::pair<iterator, iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) const -> std::pair<const_iterator, const_iterator>
+    { return {lower_bound(x), upper_bound(x)}; }
+
+    constexpr void swap(threaded_avl_tree & other) noexcept;
+
+    friend constexpr bool operator==(threaded_avl_tree const & lhs, threaded_avl_tree const & rhs) noexcept
+    { return lhs.size() == rhs.size() and std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend()); }
+    friend constexpr bool operator!=(threaded_avl_tree const & lhs, threaded_avl_tree const & rhs) noexcept
+    { return not (lhs == rhs); }
+    friend constexpr bool operator< (threaded_avl_tree const & lhs, threaded_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less{}); }
+    friend constexpr bool operator<=(threaded_avl_tree const & lhs, threaded_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less_equal{}); }
+    friend constexpr bool operator> (threaded_avl_tree const & lhs, threaded_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater{}); }
+    friend constexpr bool operator>=(threaded_avl_tree const & lhs, threaded_avl_tree const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater_equal{}); }
+
+protected:
+    constexpr inline
+    void _set_end() noexcept
+    {
+        _end.root = nullptr;
+        _end.left.set_thread(std::addressof(_end));
+        _end.right.set_thread(std::addressof(_end));
+    }
+
+    template <typename ...Args>
+    constexpr node_pointer _construct_node(Args &&... args);
+    constexpr void _destroy_node(node_pointer n) noexcept;
+
+    constexpr node_pointer _insert(node_pointer n) noexcept;
+    constexpr void _unlink(node_pointer n) noexcept;
+    constexpr void _replace_child(node_pointer root, node_pointer old, node_pointer child) noexcept;
+
+    template <typename U> constexpr node_pointer _find(U const & x) const;
+    template <typename U> constexpr node_pointer _lower_bound(U const & x) const;
+    template <typename U> constexpr node_pointer _upper_bound(U const & x) const;
+
+    constexpr void _balance_from(node_pointer ptr) noexcept;
+    constexpr void _right_rotation(node_pointer const v) noexcept;
+    constexpr void _left_rotation(node_pointer const v) noexcept;
+}; // class threaded_avl_tree
+
+template <typename T, typename Compare, typename Alloc>
+constexpr threaded_avl_tree<T, Compare, Alloc>::threaded_avl_tree(threaded_avl_tree const & other)
+    : _node_alloc{node_allocator_traits::select_on_container_copy_construction(other._node_alloc)},
+      _cmp{other._cmp}
+{
+    _set_end();
+    assign(other.begin(), other.end());
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr threaded_avl_tree<T, Compare, Alloc>::threaded_avl_tree(threaded_avl_tree && other) noexcept
+    : _node_alloc{std::move(other._node_alloc)}, _cmp{std::move(other._cmp)}
+{
+    _set_end();
+    swap(other);
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+constexpr threaded_avl_tree<T, Compare, Alloc>::threaded_avl_tree(Iterator f, Iterator l, allocator_type const & a)
+    : _node_alloc{a}
+{
+    _set_end();
+    assign(std::move(f), std::move(l));
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::operator=(threaded_avl_tree const & other)
+    -> threaded_avl_tree &
+{
+    if (this != std::addressof(other)) {
+        if constexpr (node_allocator_traits::propagate_on_container_copy_assignment::value) {
+            clear();
+            _node_alloc = other._node_alloc;
+        }
+        _cmp = other._cmp;
+        assign(other.begin(), other.end());
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::operator=(threaded_avl_tree && other) noexcept
+    -> threaded_avl_tree &
+{
+    if (this != std::addressof(other)) {
+        clear();
+        if constexpr (node_allocator_traits::propagate_on_container_move_assignment::value) {
+            _node_alloc = std::move(other._node_alloc);
+        }
+        //NB: if _node_alloc != other._node_alloc, behavior is undefined
+        _cmp = std::move(other._cmp);
+        swap(other);
+    }
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+constexpr void threaded_avl_tree<T, Compare, Alloc>::assign(Iterator f, Iterator l)
+{
+    clear();
+    while (f != l) {
+        emplace(*f++);
+    }
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void threaded_avl_tree<T, Compare, Alloc>::clear() noexcept
+{
+    // the threads make the in-order walk stackless, so nodes can be freed while walking
+    auto it = _end.right.get();
+    while (it != std::addressof(_end)) {
+        auto const next = detail::_threaded_next(it);
+        _destroy_node(it);
+        it = next;
+    }
+    _set_end();
+    _size = 0;
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void threaded_avl_tree<T, Compare, Alloc>::swap(threaded_avl_tree & other) noexcept
+{
+    using std::swap;
+    if constexpr (node_allocator_traits::propagate_on_container_swap::value) {
+        swap(_node_alloc, other._node_alloc);
+    }
+    swap(_cmp, other._cmp);
+    swap(_size, other._size);
+    swap(_end, other._end);
+
+    // the nodes pointing to a sentinel must be moved to the other one
+    for (auto * tree : {this, std::addressof(other)}) {
+        auto & end = tree->_end;
+        if (tree->_size == 0) {
+            tree->_set_end();
+            continue;
+        }
+        end.root->root = std::addressof(end);
+        end.right.get()->left.set_thread(std::addressof(end));
+        end.left.get()->right.set_thread(std::addressof(end));
+    }
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename ...Args>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::_construct_node(Args &&... args)
+    -> node_pointer
+{
+    auto hold = std::unique_ptr<node, detail::_node_deallocator<node, node_allocator>>(
+        node_allocator_traits::allocate(_node_alloc, 1), detail::_node_deallocator<node, node_allocator>(_node_alloc)
+    );
+    node_allocator_traits::construct(_node_alloc, hold.get());
+    ++hold.get_deleter().constructed;
+    node_allocator_traits::construct(_node_alloc, std::addressof(hold->value()), std::forward<Args>(args)...);
+    ++hold.get_deleter().constructed;
+    return hold.release();
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void threaded_avl_tree<T, Compare, Alloc>::_destroy_node(node_pointer n) noexcept
+{
+    node_allocator_traits::destroy(_node_alloc, std::addressof(n->value()));
+    node_allocator_traits::destroy(_node_alloc, n);
+    node_allocator_traits::deallocate(_node_alloc, n, 1);
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::_insert(node_pointer n) noexcept
+    -> node_pointer
+{
+    auto const end = std::addressof(_end);
+    ++_size;
+    if (_end.root == nullptr) {
+        n->root = end;
+        n->left.set_thread(end);
+        n->right.set_thread(end);
+        _end.root = n;
+        _end.left.set_thread(n);
+        _end.right.set_thread(n);
+        return n;
+    }
+
+    auto ptr = _end.root;
+    while (true) {
+        if (_cmp(n->value(), ptr->value())) {
+            if (ptr->left.is_thread()) {
+                n->left = ptr->left;
+                n->right.set_thread(ptr);
+                ptr->left.set_child(n);
+                if (n->left.get() == end) {
+                    _end.right.set_thread(n);
+                }
+                break;
+            }
+            ptr = ptr->left.get();
+        } else {
+            if (ptr->right.is_thread()) {
+                n->right = ptr->right;
+                n->left.set_thread(ptr);
+                ptr->right.set_child(n);
+                if (n->right.get() == end) {
+                    _end.left.set_thread(n);
+                }
+                break;
+            }
+            ptr = ptr->right.get();
+        }
+    }
+    n->root = ptr;
+    n->height = 0;
+    _balance_from(ptr);
+    return n;
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void threaded_avl_tree<T, Compare, Alloc>::_replace_child(node_pointer root, node_pointer old, node_pointer child)
+    noexcept
+{
+    if (root == std::addressof(_end)) {
+        _end.root = child;
+    } else if (root->left.is_child() and root->left.get() == old) {
+        root->left.set_child(child);
+    } else {
+        root->right.set_child(child);
+    }
+    child->root = root;
+}
+
+// Unlinks `n` from the tree, rerouting the threads that pointed to it, and rebalances
+template <typename T, typename Compare, typename Alloc>
+constexpr void threaded_avl_tree<T, Compare, Alloc>::_unlink(node_pointer n) noexcept
+{
+    auto const end = std::addressof(_end);
+    auto const root = n->root;
+    auto changed = root;
+
+    if (n == _end.right.get()) {
+        _end.right.set_thread(detail::_threaded_next(n));
+    }
+    if (n == _end.left.get()) {
+        _end.left.set_thread(detail::_threaded_prev(n));
+    }
+
+    if (n->left.is_thread() and n->right.is_thread()) {
+        if (root == end) {
+            _end.root = nullptr;
+        } else if (root->left.is_child() and root->left.get() == n) {
+            root->left = n->left;
+        } else {
+            root->right = n->right;
+        }
+    } else if (n->right.is_thread()) {
+        auto const pred = detail::_threaded_prev(n);
+        pred->right = n->right;
+        _replace_child(root, n, n->left.get());
+    } else if (n->left.is_thread()) {
+        auto const succ = detail::_threaded_next(n);
+        succ->left = n->left;
+        _replace_child(root, n, n->right.get());
+    } else {
+        // the predecessor takes the place of `n`
+        auto const repl = detail::_threaded_prev(n);
+        auto const succ = detail::_threaded_next(n);
+        succ->left.set_thread(repl);
+        if (repl == n->left.get()) {
+            changed = repl;
+        } else {
+            changed = repl->root;
+            if (repl->left.is_child()) {
+                changed->right = repl->left;
+                repl->left.get()->root = changed;
+            } else {
+                changed->right.set_thread(repl);
+            }
+            repl->left = n->left;
+            repl->left.get()->root = repl;
+        }
+        repl->right = n->right;
+        repl->right.get()->root = repl;
+        repl->height = n->height;
+        _replace_child(root, n, repl);
+    }
+
+    --_size;
+    if (changed != end) {
+        _balance_from(changed);
+    }
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::erase(iterator it)
+    -> iterator
+{
+    auto const next = std::next(it);
+    _unlink(it._current);
+    _destroy_node(it._current);
+    return next;
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::erase(iterator f, iterator l)
+    -> iterator
+{
+    if (f == begin() and l == end()) {
+        clear();
+        return end();
+    }
+    while (f != l) {
+        f = erase(f);
+    }
+    return l;
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::erase(value_type const & value)
+    -> size_type
+{
+    auto const [f, l] = equal_range(value);
+    auto const old_size = size();
+    erase(f, l);
+    return old_size - size();
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::_find(U const & x) const
+    -> node_pointer
+{
+    auto const found = _lower_bound(x);
+    if (found != std::addressof(_end) and not _cmp(x, found->value())) {
+        return found;
+    }
+    return const_cast<node_pointer>(std::addressof(_end));
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::_lower_bound(U const & x) const
+    -> node_pointer
+{
+    auto result = const_cast<node_pointer>(std::addressof(_end));
+    auto ptr = _end.root;
+    while (ptr != nullptr) {
+        if (_cmp(ptr->value(), x)) {
+            ptr = ptr->right.child();
+        } else {
+            result = ptr;
+            ptr = ptr->left.child();
+        }
+    }
+    return result;
+}
+
+template <typename T, typename Compare, typename Alloc>
+template <typename U>
+constexpr auto threaded_avl_tree<T, Compare, Alloc>::_upper_bound(U const & x) const
+    -> node_pointer
+{
+    auto result = const_cast<node_pointer>(std::addressof(_end));
+    auto ptr = _end.root;
+    while (ptr != nullptr) {
+        if (_cmp(x, ptr->value())) {
+            result = ptr;
+            ptr = ptr->left.child();
+        } else {
+            ptr = ptr->right.child();
+        }
+    }
+    return result;
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void threaded_avl_tree<T, Compare, Alloc>::_right_rotation(node_pointer const v) noexcept
+{
+    auto const u = v->left.get();
+
+    if (u->right.is_thread()) { // the thread pointed to `v`, which now has no left child
+        v->left.set_thread(u);
+    } else {
+        v->left = u->right;
+        v->left.get()->root = v;
+    }
+    _replace_child(v->root, v, u);
+    u->right.set_child(v);
+    v->root = u;
+
+    v->height = _node_height(v);
+    u->height = _node_height(u);
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void threaded_avl_tree<T, Compare, Alloc>::_left_rotation(node_pointer const v) noexcept
+{
+    auto const u = v->right.get();
+
+    if (u->left.is_thread()) {
+        v->right.set_thread(u);
+    } else {
+        v->right = u->left;
+        v->right.get()->root = v;
+    }
+    _replace_child(v->root, v, u);
+    u->left.set_child(v);
+    v->root = u;
+
+    v->height = _node_height(v);
+    u->height = _node_height(u);
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr void threaded_avl_tree<T, Compare, Alloc>::_balance_from(node_pointer ptr) noexcept
+{
+    constexpr auto balance_factor = [](node const * const n) noexcept -> std::ptrdiff_t {
+        return detail::_height_of(n->left.child()) - detail::_height_of(n->right.child());
+    };
+
+    for (; ptr != std::addressof(_end); ptr = ptr->root) {
+        ptr->height = _node_height(ptr);
+
+        if (auto const diff = balance_factor(ptr); diff >= 2) {
+            if (balance_factor(ptr->left.get()) < 0) {
+                _left_rotation(ptr->left.get());
+            }
+            _right_rotation(ptr);
+        } else if (diff <= -2) {
+            if (balance_factor(ptr->right.get()) > 0) {
+                _right_rotation(ptr->right.get());
+            }
+            _left_rotation(ptr);
+        }
+    }
+}
+
+template <typename T, typename Compare, typename Alloc>
+constexpr inline
+void swap(threaded_avl_tree<T, Compare, Alloc> & lhs, threaded_avl_tree<T, Compare, Alloc> & rhs) noexcept
+{ lhs.swap(rhs); }
+
+template <typename T, typename Compare, typename Alloc, typename Pred>
+constexpr
+auto erase_if(threaded_avl_tree<T, Compare, Alloc> & tree, Pred pred)
+    -> typename threaded_avl_tree<T, Compare, Alloc>::size_type
+{
+    auto const old_size = tree.size();
+    for (auto it = tree.begin(); it != tree.end();) {
+        it = pred(*it) ? tree.erase(it) : std::next(it);
+    }
+    return old_size - tree.size();
+}
+
+} // namespace forest
+
+#endif /* THREADED_AVL_TREE_HPP */
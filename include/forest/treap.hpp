@@ -0,0 +1,892 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : treap
+ * @created     : lunedì ott 19, 2026 07:48:21 CEST
+ * @license     : MIT
+ * */
+
+#ifndef TREAP_HPP
+#define TREAP_HPP
+
+#include <stdexcept> //std::invalid_argument
+
+#include "binary_search_tree.hpp"
+
+namespace forest
+{
+
+// A randomized binary search tree (see Seidel, Aragon - "Randomized Search Trees"): the nodes are in heap order
+// of a priority, a hash of their address, so that they need nothing besides the links of `binary_search_tree`.
+// Lookups and iterators are the ones of `binary_search_tree`; the expected height is about 3 log2(n), and
+// insertions and erasures take less than two rotations on average. `split` and `join` cut and concatenate treaps
+// in expected O(log n) links
+template <class T, class Compare = std::less<>, class Alloc = std::allocator<T>, class Stats = no_stats>
+class treap : protected binary_search_tree<T, Compare, Alloc, Stats>
+{
+protected:
+    using base                  = binary_search_tree<T, Compare, Alloc, Stats>;
+    using node                  = base::node_impl_type;
+    using node_allocator        = base::node_allocator;
+    using node_allocator_traits = base::node_allocator_traits;
+    using node_pointer          = base::node_pointer;
+    using node_const_pointer    = base::node_const_pointer;
+    using key_compare           = Compare;
+    using value_compare         = Compare;
+    using height_type           = std::int_fast8_t;
+
+public:
+    using key_type               = T;
+    using value_type             = T;
+    using allocator_type         = Alloc;
+    using reference              = value_type &;
+    using const_reference        = value_type const &;
+    using pointer                = base::pointer;
+    using const_pointer          = base::const_pointer;
+    using size_type              = base::size_type;
+    using difference_type        = base::difference_type;
+    using iterator               = base::iterator;
+    using const_iterator         = base::const_iterator;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using node_type              = base::node_type;
+
+protected:
+    using _node_deallocator     = base::_node_deallocator;
+    using _hold_ptr             = base::_hold_ptr;
+
+    using base::_end;
+    using base::_node_alloc;
+    using base::_size;
+    [[no_unique_address]] key_compare _cmp;
+
+public:
+    constexpr inline
+    treap() noexcept(noexcept(std::is_nothrow_default_constructible<node_allocator>::value)) = default;
+    constexpr inline explicit treap(allocator_type const & a) noexcept : base{a} {}
+
+    constexpr treap(treap const & other);
+    constexpr treap(treap const & other, allocator_type const & a);
+
+    constexpr treap(treap && other);
+    constexpr treap(treap && other, allocator_type const & a);
+
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr explicit treap(Iterator f, Iterator l);
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr explicit treap(Iterator f, Iterator l, allocator_type const & a);
+
+    constexpr treap(std::initializer_list<value_type> il);
+    constexpr treap(std::initializer_list<value_type> il, allocator_type const & a);
+
+    constexpr treap & operator=(treap const & other);
+    constexpr treap & operator=(treap && other);
+    constexpr inline
+    treap & operator=(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); return *this; }
+
+    constexpr inline
+    void assign(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); }
+    template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+    constexpr inline
+    void assign(Iterator f, Iterator l);
+
+    constexpr inline
+    allocator_type get_allocator() const noexcept { return base::get_allocator(); }
+
+    /// Capacity
+    constexpr inline
+    size_type size() const noexcept { return base::_size; }
+    [[nodiscard]] constexpr inline
+    bool empty() const noexcept { return base::empty(); }
+    constexpr inline
+    size_type max_size() const noexcept { return base::max_size(); }
+
+    using base::capacity;
+    using base::reserve;
+    using base::shrink_to_fit;
+
+    /// Statistics, collected by the `Stats` policy
+    using base::stats;
+    using base::reset_stats;
+
+    /// Iterators
+    constexpr inline iterator begin() noexcept { return iterator{base::_first()}; }
+    constexpr inline const_iterator begin() const noexcept { return const_iterator{base::_first()}; }
+    constexpr inline iterator end() noexcept { return iterator{std::addressof(_end)}; }
+    constexpr inline const_iterator end() const noexcept { return const_iterator{std::addressof(_end)}; }
+    constexpr inline const_iterator cbegin() const noexcept { return begin(); }
+    constexpr inline const_iterator cend() const noexcept { return end(); }
+
+    constexpr inline reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+    constexpr inline const_reverse_iterator rcbegin() const noexcept { return const_reverse_iterator{end()}; }
+    constexpr inline const_reverse_iterator rcend() const noexcept { return const_reverse_iterator{begin()}; }
+
+    /// Access
+    constexpr inline reference front() { return base::_first()->value(); }
+    constexpr inline const_reference front() const { return base::_first()->value(); }
+    constexpr inline reference back() { return base::_last()->value(); }
+    constexpr inline const_reference back() const { return base::_last()->value(); }
+
+    /// Modifiers
+    constexpr inline void clear() noexcept { base::clear(); }
+    constexpr inline node_type extract(iterator it);
+    constexpr inline node_type extract(value_type const & value);
+    constexpr inline iterator erase(iterator it);
+    constexpr inline iterator erase(iterator f, iterator l);
+    constexpr inline size_type erase(value_type const & value);
+    template <typename F>
+    constexpr iterator modify(iterator it, F && f);
+    constexpr inline iterator insert(value_type const & value);
+    constexpr inline iterator insert(value_type && value);
+    constexpr inline iterator insert(node_type && n);
+    constexpr inline iterator insert(const_iterator hint, node_type && n);
+    constexpr inline iterator insert_unique(value_type const & value);
+    constexpr inline iterator insert_unique(value_type && value);
+    constexpr inline iterator insert_unique(node_type && n);
+
+    template <typename ...Args>
+    constexpr reference emplace(Args&&... args);
+    template <typename ...Args>
+    constexpr auto emplace_unique(Args &&... args) -> std::pair<iterator, bool>;
+    template <typename K, typename ...Args>
+        requires std::is_same_v<K, value_type> or meta::is_transparent_compare<Compare>
+    constexpr auto try_emplace_unique(K const & key, Args &&... args) -> std::pair<iterator, bool>;
+
+    template <typename Cmp2>
+    constexpr void merge(treap<value_type, Cmp2, allocator_type, Stats> & source);
+    template <typename Cmp2>
+    constexpr void merge(treap<value_type, Cmp2, allocator_type, Stats> && source);
+
+    // Moves the elements not less than `key` to a new treap, which is returned: the links are cut along a single
+    // descent, while the sizes are found walking the smaller part from `lower_bound(key)`
+    constexpr treap split(value_type const & key);
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr treap split(U const & key);
+    // Appends the elements of `other`, which must not be less than the ones of this treap (throws
+    // `std::invalid_argument` otherwise), and leaves it empty. If the allocators differ, they are copied
+    constexpr void join(treap && other);
+
+    /// Lookup
+    constexpr inline auto count(value_type const & x) const -> difference_type;
+    template <typename K> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto count(K const & x) const -> difference_type;
+    constexpr inline bool contains(value_type const & x) const;
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto contains(U const & x) const -> bool;
+    constexpr inline auto find(value_type const & x) -> iterator;
+    constexpr inline auto find(value_type const & x) const -> const_iterator;
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto find(U const & x) -> iterator;
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto find(U const & x) const -> const_iterator;
+    constexpr inline auto equal_range(value_type const & x) -> std::pair<iterator, iterator>;
+    constexpr inline auto equal_range(value_type const & x) const -> std::pair<const_iterator, const_iterator>;
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) -> std::pair<iterator, iterator>;
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto equal_range(U const & x) const -> std::pair<const_iterator, const_iterator>;
+
+    constexpr inline auto lower_bound(value_type const & x) -> iterator;
+    constexpr inline auto lower_bound(value_type const & x) const -> const_iterator;
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto lower_bound(U const & x) -> iterator;
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto lower_bound(U const & x) const -> const_iterator;
+
+    constexpr inline auto upper_bound(value_type const & x) -> iterator;
+    constexpr inline auto upper_bound(value_type const & x) const -> const_iterator;
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto upper_bound(U const & x) -> iterator;
+    template <typename U> requires meta::is_transparent_compare<Compare>
+    constexpr inline auto upper_bound(U const & x) const -> const_iterator;
+
+protected:
+    using base::_find_slot;
+    using base::_find_multi_slot;
+    using base::_discard;
+    constexpr void _unlink(iterator it) noexcept;
+    template <typename U>
+    constexpr treap _split(U const & key);
+    template <typename Make>
+    constexpr void _assign_sorted(size_type n, Make && make);
+    constexpr node_pointer _link(node_pointer root, bool left, _hold_ptr && hold) noexcept;
+    constexpr void _link(node_pointer root, bool left, node_pointer n) noexcept;
+
+private:
+    constexpr inline auto _stats_update() const noexcept { return detail::_stats_update<Stats>{base::_stats}; }
+
+    friend struct detail::_serialization_access;
+
+public:
+
+    constexpr inline void swap(treap & other)
+        noexcept(noexcept(std::allocator_traits<node_allocator>::is_always_equal::value))
+    { base::swap(other); }
+
+    friend constexpr bool operator==(treap const & lhs, treap const & rhs) noexcept
+    { return lhs.size() == rhs.size() and std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend()); }
+    friend constexpr bool operator!=(treap const & lhs, treap const & rhs) noexcept
+    { return not (lhs == rhs); }
+    friend constexpr bool operator< (treap const & lhs, treap const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less{}); }
+    friend constexpr bool operator<=(treap const & lhs, treap const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less_equal{}); }
+    friend constexpr bool operator> (treap const & lhs, treap const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater{}); }
+    friend constexpr bool operator>=(treap const & lhs, treap const & rhs) noexcept
+    { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater_equal{}); }
+}; // class treap
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr treap<T, Compare, Alloc, Stats>::treap(treap const & other)
+    : base{
+        std::allocator_traits<node_allocator>::select_on_container_copy_construction(other._node_alloc)
+    }
+{
+    assign(other.begin(), other.end());
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr treap<T, Compare, Alloc, Stats>::treap(treap const & other, allocator_type const & a)
+    : base{a}
+{
+    assign(other.begin(), other.end());
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+treap<T, Compare, Alloc, Stats>::treap(treap && other) : base{other._node_alloc}
+{
+    base::_steal(other);
+    _cmp = std::move(other._cmp);
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+treap<T, Compare, Alloc, Stats>::treap(treap && other, allocator_type const & alloc)
+    : base{alloc}
+{
+    if (_node_alloc == other._node_alloc) {
+        base::_steal(other);
+    } else {
+        assign(std::move_iterator(other.begin()), std::move_iterator(other.end()));
+        other.clear();
+    }
+    _cmp = std::move(other._cmp);
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+treap<T, Compare, Alloc, Stats>::treap(std::initializer_list<value_type> il)
+    : treap(il.begin(), il.end()) { }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+treap<T, Compare, Alloc, Stats>::treap(std::initializer_list<value_type> il, allocator_type const & a)
+    : treap(il.begin(), il.end(), a) { }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename Iterator>
+    requires detail::is_input_iterator_v<Iterator>
+constexpr
+treap<T, Compare, Alloc, Stats>::treap(Iterator f, Iterator l)
+{
+    assign(std::move(f), std::move(l));
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename Iterator>
+    requires detail::is_input_iterator_v<Iterator>
+constexpr
+treap<T, Compare, Alloc, Stats>::treap(Iterator f, Iterator l, allocator_type const & a) : base{a}
+{
+    assign(std::move(f), std::move(l));
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr
+treap<T, Compare, Alloc, Stats> & treap<T, Compare, Alloc, Stats>::operator=(treap const & other)
+{
+    if (std::addressof(_end) == std::addressof(other._end)) {
+        return *this;
+    }
+    if constexpr (std::allocator_traits<node_allocator>::propagate_on_container_copy_assignment::value) {
+        if (_node_alloc != other._node_alloc) {
+            clear();
+            base::shrink_to_fit();
+            _node_alloc = other._node_alloc;
+        }
+    }
+    assign(other.begin(), other.end());
+    _cmp = other._cmp;
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr
+treap<T, Compare, Alloc, Stats> & treap<T, Compare, Alloc, Stats>::operator=(treap && other)
+{
+    if (std::addressof(_end) == std::addressof(other._end)) {
+        return *this;
+    }
+
+    if constexpr (std::allocator_traits<node_allocator>::propagate_on_container_move_assignment::value) {
+        clear();
+        base::shrink_to_fit();
+        _node_alloc = std::move(other._node_alloc);
+        base::_steal(other);
+    } else {
+        if (_node_alloc != other._node_alloc) {
+            auto const mbegin = std::move_iterator(other.begin());
+            auto const mend = std::move_iterator(other.end());
+            assign(mbegin, mend);
+            other.clear();
+        } else {
+            clear();
+            base::_steal(other);
+        }
+    }
+    _cmp = std::move(other._cmp);
+
+    return *this;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <class Iterator> requires detail::is_input_iterator_v<Iterator>
+constexpr inline
+void treap<T, Compare, Alloc, Stats>::assign(Iterator f, Iterator l)
+{
+    base::_recycle();
+    while (f != l) {
+        emplace(*f++);
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::extract(iterator it)
+    -> node_type
+{
+    _unlink(it);
+    return node_type{it._current, _node_alloc};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::extract(value_type const & value)
+    -> node_type
+{
+    if (auto it = find(value); it != end()) {
+        return extract(std::move(it));
+    }
+    return {};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::erase(iterator it)
+    -> iterator
+{
+    auto const next = std::next(it);
+    _unlink(it);
+    base::_destroy_node(it._current);
+    return next;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::erase(iterator f, iterator l)
+    -> iterator
+{
+    while (f != l) {
+        f = erase(f);
+    }
+    return l;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::erase(value_type const & value)
+    -> size_type
+{
+    auto const [f, l] = equal_range(value);
+    auto const old_size = size();
+    erase(f, l);
+    return old_size - size();
+}
+
+// Applies `f` to the element at `it`. If the new value is out of order, the node is unlinked and linked back
+// where it belongs, searching from its old neighbour instead of from the root; no node is allocated nor freed.
+// If `f` throws, the element is erased
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename F>
+constexpr
+auto treap<T, Compare, Alloc, Stats>::modify(iterator it, F && f)
+    -> iterator
+{
+    auto const n = it._current;
+    try {
+        std::invoke(std::forward<F>(f), n->value());
+    } catch (...) {
+        erase(it);
+        throw;
+    }
+    auto const from = base::_misplaced_from(n);
+    if (from == nullptr) {
+        return it;
+    }
+    _unlink(it);
+    auto const [root, left] = detail::_finger_slot(from, n->value(), base::_comparator(), std::addressof(_end));
+    _link(root, left, n);
+    return it;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr
+auto treap<T, Compare, Alloc, Stats>::insert(value_type const & value)
+    -> iterator
+{
+    auto hold = base::_construct_node(_node_alloc, value);
+    auto const [root, left] = _find_multi_slot(hold->value());
+    return iterator{_link(root, left, std::move(hold))};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr
+auto treap<T, Compare, Alloc, Stats>::insert(value_type && value)
+    -> iterator
+{
+    auto hold = base::_construct_node(_node_alloc, std::move(value));
+    auto const [root, left] = _find_multi_slot(hold->value());
+    return iterator{_link(root, left, std::move(hold))};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::insert(node_type && n)
+    -> iterator
+{
+    auto hold = _hold_ptr(n._storage, _node_deallocator(_node_alloc));
+    hold.get_deleter().constructed = 2;
+    n._storage = nullptr;
+    n._consume();
+    auto const [root, left] = _find_multi_slot(hold->value());
+    return iterator{_link(root, left, std::move(hold))};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::insert(const_iterator it, node_type && n)
+    -> iterator
+{
+    auto hold = _hold_ptr(n._storage, _node_deallocator(_node_alloc));
+    hold.get_deleter().constructed = 2;
+    n._storage = nullptr;
+    n._consume();
+    if (empty()) {
+        return iterator{_link(std::addressof(_end), false, std::move(hold))};
+    }
+    auto const from = const_cast<node_pointer>(it != end() ? it._current : base::_last());
+    auto const [root, left] = detail::_finger_slot(from, hold->value(), base::_comparator(), std::addressof(_end));
+    return iterator{_link(root, left, std::move(hold))};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::insert_unique(value_type const & value)
+    -> iterator
+{
+    return try_emplace_unique(value).first;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::insert_unique(value_type && value)
+    -> iterator
+{
+    return try_emplace_unique(value, std::move(value)).first;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr
+auto treap<T, Compare, Alloc, Stats>::insert_unique(node_type && n)
+    -> iterator
+{
+    auto const [found, root, left] = _find_slot(n.value());
+    if (found != nullptr) {
+        return iterator{found};
+    }
+
+    auto hold = _hold_ptr(n._storage, _node_deallocator(_node_alloc));
+    hold.get_deleter().constructed = 2;
+    n._storage = nullptr;
+    n._consume();
+    return iterator{_link(root, left, std::move(hold))};
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename ...Args>
+constexpr
+auto treap<T, Compare, Alloc, Stats>::emplace_unique(Args &&... args)
+    -> std::pair<iterator, bool>
+{
+    if constexpr ((sizeof...(Args) == 1) and (std::is_same_v<std::remove_cvref_t<Args>, value_type> and ...)) {
+        return try_emplace_unique(args..., std::forward<Args>(args)...);
+    } else {
+        auto hold = base::_construct_node(_node_alloc, std::forward<Args>(args)...);
+        auto const [found, root, left] = _find_slot(hold->value());
+        if (found != nullptr) {
+            _discard(std::move(hold));
+            return {iterator{found}, false};
+        }
+        return {iterator{_link(root, left, std::move(hold))}, true};
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename K, typename ...Args>
+    requires std::is_same_v<K, T> or meta::is_transparent_compare<Compare>
+constexpr
+auto treap<T, Compare, Alloc, Stats>::try_emplace_unique(K const & key, Args &&... args)
+    -> std::pair<iterator, bool>
+{
+    auto const [found, root, left] = _find_slot(key);
+    if (found != nullptr) {
+        return {iterator{found}, false};
+    }
+    if constexpr (sizeof...(Args) == 0) {
+        return {iterator{_link(root, left, base::_construct_node(_node_alloc, key))}, true};
+    } else {
+        return {iterator{_link(root, left, base::_construct_node(_node_alloc, std::forward<Args>(args)...))}, true};
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename ...Args>
+constexpr
+auto treap<T, Compare, Alloc, Stats>::emplace(Args&&... args)
+    -> reference
+{
+    auto hold = base::_construct_node(_node_alloc, std::forward<Args>(args)...);
+    auto const [root, left] = _find_multi_slot(hold->value());
+    return _link(root, left, std::move(hold))->value();
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename Cmp2>
+constexpr
+void treap<T, Compare, Alloc, Stats>::merge(treap<value_type, Cmp2, allocator_type, Stats> & source)
+{
+    auto it = source.begin();
+    auto tmp = it++;
+    auto hint = insert(source.extract(tmp));
+    while (it != source.end()) {
+        tmp = it++;
+        hint = insert(hint, source.extract(tmp));
+    }
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename Cmp2>
+constexpr
+void treap<T, Compare, Alloc, Stats>::merge(treap<value_type, Cmp2, allocator_type, Stats> && source)
+{
+    auto it = source.begin();
+    while (it != source.end()) {
+        auto tmp = it++;
+        insert(source.extract(tmp));
+    }
+}
+
+// Links the node held by `hold` as the `left` (or right) child of `root`, where a descent ended, and rotates it
+// up to its place in the heap; `root` is `_end` if the tree is empty
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::_link(node_pointer root, bool left, _hold_ptr && hold) noexcept
+    -> node_pointer
+{
+    auto const n = hold.release();
+    _link(root, left, n);
+    return n;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+void treap<T, Compare, Alloc, Stats>::_link(node_pointer root, bool left, node_pointer n) noexcept
+{
+    detail::_link_leaf(root, left, n, std::addressof(_end));
+    ++_size;
+    detail::_treap_sift_up(n, std::addressof(_end), _stats_update());
+}
+
+// Rotates the node at `it` down until it has at most one child, then unlinks it
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+void treap<T, Compare, Alloc, Stats>::_unlink(iterator it) noexcept
+{
+    detail::_treap_sift_down(it._current, std::addressof(_end), _stats_update());
+    base::_extract(it);
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::split(value_type const & key)
+    -> treap
+{ return _split(key); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr inline
+auto treap<T, Compare, Alloc, Stats>::split(U const & key)
+    -> treap
+{ return _split(key); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U>
+constexpr
+auto treap<T, Compare, Alloc, Stats>::_split(U const & key)
+    -> treap
+{
+    auto result = treap(get_allocator());
+    result._cmp = _cmp;
+    auto const at = base::lower_bound(key);
+    if (at == end()) {
+        return result;
+    }
+    // Walks from `at` in both directions, until either end is reached
+    auto kept = size_type{0};
+    for (auto forward = at, backward = at; ; ++kept) {
+        if (backward == begin()) {
+            break;
+        }
+        if (++forward == end()) {
+            kept = size() - kept - 1;
+            break;
+        }
+        --backward;
+    }
+
+    auto const last = base::_last();
+    auto const new_last = kept != 0 ? std::prev(at)._current : nullptr;
+    auto const [left, right] = detail::_treap_split(base::_root(), [this, &key](node_pointer n) {
+        return not base::_compare(n->value(), key);
+    });
+
+    result._end.root = right;
+    right->root = std::addressof(result._end);
+    result._first() = at._current;
+    result._last() = last;
+    result._size = size() - kept;
+    if (left == nullptr) {
+        base::_set_end();
+    } else {
+        _end.root = left;
+        left->root = std::addressof(_end);
+        base::_last() = new_last;
+    }
+    _size = kept;
+    return result;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr
+void treap<T, Compare, Alloc, Stats>::join(treap && other)
+{
+    if (other.empty()) {
+        return;
+    }
+    if (not empty() and base::_compare(other.front(), back())) {
+        throw std::invalid_argument{"treap::join: the elements to append precede the ones of the treap"};
+    }
+    if (_node_alloc != other._node_alloc) {
+        for (auto const & x : other) {
+            _link(empty() ? std::addressof(_end) : base::_last(), false, base::_construct_node(_node_alloc, x));
+        }
+        other.clear();
+        return;
+    }
+
+    auto const root = detail::_treap_join(empty() ? nullptr : base::_root(), other._root());
+    _end.root = root;
+    root->root = std::addressof(_end);
+    if (empty()) {
+        base::_first() = other._first();
+    }
+    base::_last() = other._last();
+    _size += other._size;
+    other._set_end();
+    other._size = 0;
+}
+
+// Links the elements in a treap in O(n), without comparing them
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename Make>
+constexpr
+void treap<T, Compare, Alloc, Stats>::_assign_sorted(size_type n, Make && make)
+{
+    base::_recycle();
+    if (n == 0) {
+        return;
+    }
+    auto const [head, tail] = base::_sorted_chain(n, make);
+    auto const root = detail::_treap_build(head);
+    _end.root = root;
+    root->root = std::addressof(_end);
+    base::_first() = head;
+    base::_last() = tail;
+    _size = n;
+}
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline bool treap<T, Compare, Alloc, Stats>::contains(value_type const & x) const
+{ return base::contains(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr inline auto treap<T, Compare, Alloc, Stats>::contains(U const & x) const
+    -> bool
+{ return base::contains(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto treap<T, Compare, Alloc, Stats>::find(value_type const & x)
+    -> iterator
+{ return base::find(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto treap<T, Compare, Alloc, Stats>::find(value_type const & x) const
+    -> const_iterator
+{ return base::find(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto treap<T, Compare, Alloc, Stats>::find(U const & x)
+    -> iterator
+{ return base::find(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto treap<T, Compare, Alloc, Stats>::find(U const & x) const
+    -> const_iterator
+{ return base::find(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto treap<T, Compare, Alloc, Stats>::lower_bound(value_type const & x)
+    -> iterator
+{ return base::lower_bound(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto treap<T, Compare, Alloc, Stats>::lower_bound(value_type const & x) const
+    -> const_iterator
+{ return base::lower_bound(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto treap<T, Compare, Alloc, Stats>::lower_bound(U const & x)
+    -> iterator
+{ return base::lower_bound(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto treap<T, Compare, Alloc, Stats>::lower_bound(U const & x) const
+    -> const_iterator
+{ return base::lower_bound(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto treap<T, Compare, Alloc, Stats>::upper_bound(value_type const & x)
+    -> iterator
+{ return base::upper_bound(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto treap<T, Compare, Alloc, Stats>::upper_bound(value_type const & x) const
+    -> const_iterator
+{ return base::upper_bound(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto treap<T, Compare, Alloc, Stats>::upper_bound(U const & x)
+    -> iterator
+{ return base::upper_bound(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto treap<T, Compare, Alloc, Stats>::upper_bound(U const & x) const
+    -> const_iterator
+{ return base::upper_bound(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto treap<T, Compare, Alloc, Stats>::equal_range(value_type const & x)
+    -> std::pair<iterator, iterator>
+{ return base::equal_range(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline auto treap<T, Compare, Alloc, Stats>::equal_range(value_type const & x) const
+    -> std::pair<const_iterator, const_iterator>
+{ return base::equal_range(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto treap<T, Compare, Alloc, Stats>::equal_range(U const & x)
+    -> std::pair<iterator, iterator>
+{ return base::equal_range(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto treap<T, Compare, Alloc, Stats>::equal_range(U const & x) const
+    -> std::pair<const_iterator, const_iterator>
+{ return base::equal_range(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr auto treap<T, Compare, Alloc, Stats>::count(value_type const & x) const
+    -> difference_type
+{ return base::count(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+template <typename U> requires meta::is_transparent_compare<Compare>
+constexpr auto treap<T, Compare, Alloc, Stats>::count(U const & x) const
+    -> difference_type
+{ return base::count(x); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+void swap(treap<T, Compare, Alloc, Stats> & lhs, treap<T, Compare, Alloc, Stats> & rhs)
+    noexcept(noexcept(lhs.swap(rhs)))
+{ lhs.swap(rhs); }
+
+template <typename T, typename Compare, typename Alloc, typename Stats, typename Pred>
+constexpr
+auto erase_if(treap<T, Compare, Alloc, Stats> & tree, Pred pred)
+    -> typename treap<T, Compare, Alloc, Stats>::size_type
+{
+    auto const old_size = tree.size();
+    auto it = tree.begin();
+    while (it != tree.end()) {
+        if (not pred(*it)) {
+            ++it;
+            continue;
+        }
+        auto last = std::next(it);
+        while (last != tree.end() and pred(*last)) {
+            ++last;
+        }
+        it = tree.erase(it, last);
+    }
+    return old_size - tree.size();
+}
+
+
+} // namespace forest
+
+namespace std
+{
+template <typename T, typename Compare, typename Alloc, typename Stats>
+constexpr inline
+void std::swap(forest::treap<T, Compare, Alloc, Stats> & lhs, forest::treap<T, Compare, Alloc, Stats> & rhs)
+    noexcept(noexcept(forest::swap(lhs, rhs)))
+{ forest::swap(lhs, rhs); }
+} // namespace std
+
+
+#endif /* TREAP_HPP */
+
@@ -0,0 +1,77 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : tree_stats
+ * @created     : lunedì ott 19, 2026 03:52:27 CEST
+ * @license     : MIT
+ * */
+
+#ifndef TREE_STATS_HPP
+#define TREE_STATS_HPP
+
+#include <algorithm> //std::max
+#include <cstddef>   //std::size_t
+
+namespace forest
+{
+
+// The statistics policies of `binary_search_tree` and `avl_tree`. The tree tells its policy about each call to
+// the comparator, each rotation and each step of the rebalancing after a modification, each node it allocates,
+// and the depth reached by each descent from the root.
+// `no_stats`, the default, ignores all of them and takes no space, so that the tree compiles to the same code
+struct no_stats
+{
+    constexpr inline void compared() const noexcept {}
+    constexpr inline void rotated() const noexcept {}
+    constexpr inline void rebalanced() const noexcept {}
+    constexpr inline void allocated() const noexcept {}
+    constexpr inline void descended(std::size_t) const noexcept {}
+    constexpr inline void reset() noexcept {}
+}; // struct no_stats
+
+// Counts everything. The counters are updated by the lookups too, so a tree using it must not be read by many
+// threads at once
+struct tree_stats
+{
+    std::size_t comparisons = 0;
+    std::size_t rotations = 0;
+    std::size_t rebalance_steps = 0;
+    std::size_t allocations = 0;
+    std::size_t max_depth = 0;
+
+    constexpr inline void compared() noexcept { ++comparisons; }
+    constexpr inline void rotated() noexcept { ++rotations; }
+    constexpr inline void rebalanced() noexcept { ++rebalance_steps; }
+    constexpr inline void allocated() noexcept { ++allocations; }
+    constexpr inline void descended(std::size_t depth) noexcept { max_depth = std::max(max_depth, depth); }
+    constexpr inline void reset() noexcept { *this = tree_stats{}; }
+}; // struct tree_stats
+
+namespace detail
+{
+// Counts the levels visited by a descent, and reports them to the policy when the descent ends
+template <class Stats>
+struct _descent
+{
+    Stats & stats;
+    std::size_t depth = 0;
+
+    constexpr inline void step() noexcept { ++depth; }
+    constexpr inline ~_descent() { stats.descended(depth); }
+}; // struct _descent
+
+// The `Update` given to the AVL algorithms, to report the rotations and the steps of the rebalancing
+template <class Stats>
+struct _stats_update
+{
+    Stats & stats;
+
+    template <class Node>
+    constexpr inline void operator()(Node *) const noexcept {}
+    constexpr inline void rotated() const noexcept { stats.rotated(); }
+    constexpr inline void rebalanced() const noexcept { stats.rebalanced(); }
+}; // struct _stats_update
+} // namespace detail
+
+} // namespace forest
+
+#endif /* TREE_STATS_HPP */
@@ -0,0 +1,151 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : augmented_avl_test
+ * @created     : domenica ott 18, 2026 16:12:45 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+
+#include "catch2/catch.hpp"
+#include "forest/augmented_avl_tree.hpp"
+
+using forest::augmented_avl_tree;
+
+namespace
+{
+// Not commutative: checks that the aggregates follow the order of the keys
+struct concat
+{
+    using result_type = std::string;
+    result_type identity() const { return {}; }
+    result_type lift(int v) const { return std::to_string(v) + ","; }
+    result_type operator()(result_type const & a, result_type const & b) const { return a + b; }
+};
+
+struct order
+{
+    int price;
+    int volume;
+};
+
+struct by_price
+{
+    using is_transparent = void;
+    bool operator()(order const & a, order const & b) const { return a.price < b.price; }
+    bool operator()(order const & a, int b) const { return a.price < b; }
+    bool operator()(int a, order const & b) const { return a < b.price; }
+};
+
+struct volume
+{
+    using result_type = long;
+    result_type identity() const { return 0; }
+    result_type lift(order const & o) const { return o.volume; }
+    result_type operator()(result_type a, result_type b) const { return a + b; }
+};
+} // namespace
+
+TEST_CASE("augmented_avl_trees can be constructed and assigned", "[construction][assignment]")
+{
+    auto _0 = augmented_avl_tree{8, 1, 64, 2, 32, 4, 16, 128};
+    REQUIRE(_0.size() == 8);
+    REQUIRE(std::is_sorted(_0.begin(), _0.end()));
+    REQUIRE(_0.aggregate() == 255);
+
+    auto _1 = _0;
+    REQUIRE(_1 == _0);
+    REQUIRE(_1.aggregate() == 255);
+    auto _2 = std::move(_1);
+    REQUIRE(_1.empty());
+    REQUIRE(_1.aggregate() == 0);
+    REQUIRE(_2.aggregate() == 255);
+    _1 = {3, 2, 1};
+    swap(_1, _2);
+    REQUIRE(_1.aggregate() == 255);
+    REQUIRE(_2.aggregate() == 6);
+    REQUIRE(*std::prev(_1.end()) == 128);
+}
+
+TEST_CASE("augmented_avl_tree aggregates ranges of keys", "[aggregate]")
+{
+    auto _0 = augmented_avl_tree<int>{};
+    for (auto i = 1; i <= 100; ++i) { _0.insert(i); }
+
+    REQUIRE(_0.aggregate() == 5050);
+    REQUIRE(_0.aggregate(1, 100) == 5050);
+    REQUIRE(_0.aggregate(10, 20) == 165);
+    REQUIRE(_0.aggregate(50, 50) == 50);
+    REQUIRE(_0.aggregate(-10, 0) == 0);
+    REQUIRE(_0.aggregate(101, 200) == 0);
+    REQUIRE(_0.aggregate(20, 10) == 0);
+
+    SECTION("the aggregates survive erasures") {
+        _0.erase(_0.lower_bound(11), _0.upper_bound(19));
+        REQUIRE(_0.aggregate(10, 20) == 30);
+        REQUIRE(erase_if(_0, [](int x) { return x % 2 == 0; }) == 46);
+        REQUIRE(_0.aggregate() == std::accumulate(_0.begin(), _0.end(), 0));
+    }
+    SECTION("node handles carry values between trees") {
+        auto _1 = augmented_avl_tree<int>{};
+        _1.insert(_0.extract(42));
+        _1.insert(_0.extract(_0.find(58)));
+        REQUIRE(_0.aggregate() == 4950);
+        REQUIRE(_1.aggregate() == 100);
+        REQUIRE(_1.aggregate(50, 60) == 58);
+        REQUIRE(_0.extract(1000).empty());
+    }
+    SECTION("min and max are available") {
+        auto _1 = augmented_avl_tree<int, std::less<>, std::allocator<int>, forest::min_monoid<int>>{5, 3, 9, 7, 1};
+        REQUIRE(_1.aggregate() == 1);
+        REQUIRE(_1.aggregate(4, 10) == 5);
+        auto _2 = augmented_avl_tree<int, std::less<>, std::allocator<int>, forest::max_monoid<int>>{5, 3, 9, 7, 1};
+        REQUIRE(_2.aggregate(0, 8) == 7);
+    }
+}
+
+TEST_CASE("augmented_avl_tree can aggregate a projection of its values", "[aggregate]")
+{
+    auto book = augmented_avl_tree<order, by_price, std::allocator<order>, volume>{};
+    book.insert({100, 5});
+    book.insert({101, 7});
+    book.insert({99, 2});
+    book.insert({101, 1});
+    book.insert({105, 10});
+    REQUIRE(book.aggregate() == 25);
+    REQUIRE(book.aggregate(100, 101) == 13);
+    REQUIRE(book.aggregate(order{102, 0}, order{200, 0}) == 10);
+    REQUIRE(book.count(101) == 2);
+}
+
+TEST_CASE("augmented_avl_tree agrees with a linear scan", "[random]")
+{
+    auto rng = std::mt19937{7};
+    auto _0 = augmented_avl_tree<int, std::less<>, std::allocator<int>, concat>{};
+    auto oracle = std::multiset<int>{};
+    auto const scan = [&oracle](int lo, int hi) {
+        auto res = std::string{};
+        for (auto it = oracle.lower_bound(lo); it != oracle.upper_bound(hi); ++it) { res += std::to_string(*it) + ","; }
+        return res;
+    };
+
+    for (auto round = 0; round < 2000; ++round) {
+        auto const x = static_cast<int>(rng() % 200);
+        if (rng() % 3 == 0 and oracle.contains(x)) {
+            _0.erase(_0.find(x));
+            oracle.erase(oracle.find(x));
+        } else {
+            _0.insert(x);
+            oracle.insert(x);
+        }
+        auto const lo = static_cast<int>(rng() % 200);
+        auto const hi = lo + static_cast<int>(rng() % 50);
+        REQUIRE(_0.aggregate(lo, hi) == scan(lo, hi));
+    }
+    REQUIRE(_0.aggregate() == scan(0, 200));
+}
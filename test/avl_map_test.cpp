@@ -0,0 +1,123 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : avl_map_test
+ * @created     : domenica ott 18, 2026 18:41:07 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "catch2/catch.hpp"
+#include "forest/avl_map.hpp"
+
+using forest::avl_map;
+using forest::avl_multimap;
+
+TEST_CASE("avl_maps can be constructed and assigned", "[construction][assignment]")
+{
+    auto _0 = avl_map<int, std::string>{{3, "three"}, {1, "one"}, {2, "two"}, {1, "uno"}};
+    REQUIRE(_0.size() == 3);
+    REQUIRE(_0.front().second == "one");
+    REQUIRE(_0.back().first == 3);
+
+    auto _1 = _0;
+    REQUIRE(_1 == _0);
+    auto _2 = std::move(_1);
+    REQUIRE(_1.empty());
+    REQUIRE(_2 == _0);
+    _1 = {{4, "four"}};
+    swap(_1, _2);
+    REQUIRE(_1.size() == 3);
+    REQUIRE(_2.at(4) == "four");
+}
+
+TEST_CASE("avl_map updates the mapped values in place", "[access][modifiers]")
+{
+    auto _0 = avl_map<std::string, int>{};
+    for (auto const * w : {"a", "b", "a", "c", "a", "b"}) { ++_0[w]; }
+    REQUIRE(_0.size() == 3);
+    REQUIRE(_0.at("a") == 3);
+    REQUIRE(_0.at("b") == 2);
+    REQUIRE_THROWS_AS(_0.at("z"), std::out_of_range);
+
+    SECTION("iterators give mutable access to the mapped values") {
+        for (auto & [k, v] : _0) { v *= 10; }
+        REQUIRE(_0.find("c")->second == 10);
+        auto const & c = _0;
+        REQUIRE(c.at("a") == 30);
+    }
+    SECTION("try_emplace does not overwrite, insert_or_assign does") {
+        auto const [it, inserted] = _0.try_emplace("a", 100);
+        REQUIRE(not inserted);
+        REQUIRE(it->second == 3);
+        REQUIRE(_0.try_emplace("d", 4).second);
+        REQUIRE(not _0.insert_or_assign("a", 100).second);
+        REQUIRE(_0.at("a") == 100);
+        REQUIRE(_0.insert_or_assign("e", 5).second);
+        REQUIRE(_0.size() == 5);
+    }
+    SECTION("insert reports the existing element") {
+        auto const [it, inserted] = _0.insert({"b", 42});
+        REQUIRE(not inserted);
+        REQUIRE(it->second == 2);
+    }
+    SECTION("erasure by key and position") {
+        REQUIRE(_0.erase("a") == 1);
+        REQUIRE(_0.erase("a") == 0);
+        REQUIRE(_0.erase(_0.begin())->first == "c");
+        REQUIRE(_0.size() == 1);
+        REQUIRE(erase_if(_0, [](auto const & p) { return p.second == 1; }) == 1);
+        REQUIRE(_0.empty());
+    }
+    SECTION("node handles move entries between maps") {
+        auto _1 = avl_map<std::string, int>{{"a", -1}};
+        REQUIRE(not _1.insert(_0.extract("a")).second);
+        REQUIRE(_1.insert(_0.extract("b")).second);
+        REQUIRE(_0.size() == 1);
+        REQUIRE(_1.at("b") == 2);
+        REQUIRE(_0.extract("z").empty());
+    }
+}
+
+TEST_CASE("avl_multimap keeps every entry", "[multimap]")
+{
+    auto _0 = avl_multimap<int, int>{};
+    for (auto i = 0; i < 20; ++i) { _0.emplace(i % 3, i); }
+    REQUIRE(_0.size() == 20);
+    REQUIRE(_0.count(0) == 7);
+    REQUIRE(_0.count(1) == 7);
+    REQUIRE(_0.count(2) == 6);
+
+    auto [f, l] = _0.equal_range(1);
+    auto expected = 1;
+    for (; f != l; ++f, expected += 3) {
+        REQUIRE(f->second == expected); // equal keys keep their insertion order
+        f->second = -f->second;
+    }
+    REQUIRE(_0.lower_bound(1)->second == -1);
+    REQUIRE(_0.erase(1) == 7);
+    REQUIRE(_0.size() == 13);
+    REQUIRE(not _0.contains(1));
+}
+
+TEST_CASE("avl_map agrees with std::map", "[random]")
+{
+    auto rng = std::mt19937{13};
+    auto _0 = avl_map<int, int>{};
+    auto oracle = std::map<int, int>{};
+    for (auto round = 0; round < 3000; ++round) {
+        auto const k = static_cast<int>(rng() % 300);
+        switch (rng() % 4) {
+        case 0: REQUIRE(_0.erase(k) == oracle.erase(k)); break;
+        case 1: REQUIRE(_0.insert_or_assign(k, round).second == oracle.insert_or_assign(k, round).second); break;
+        default: _0[k] += round; oracle[k] += round; break;
+        }
+    }
+    REQUIRE(_0.size() == oracle.size());
+    REQUIRE(std::equal(_0.begin(), _0.end(), oracle.begin(), oracle.end()));
+}
@@ -7,8 +7,16 @@
 
 #define CATCH_CONFIG_MAIN
 
+#include <algorithm>
+#include <array>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "catch2/catch.hpp"
 #include "forest/avl_tree.hpp"
+#include "forest/shape_report.hpp"
 
 using forest::avl_tree;
 
@@ -201,7 +209,7 @@ TEMPLATE_LIST_TEST_CASE("avl-tree can be templated on various allocators",
                         "[allocator][construction][assignment]", allocators)
 {
     GIVEN("an allocator") {
-        auto buffer = std::array<std::byte, 128>{0};
+        auto buffer = std::array<std::byte, 128>{};
         auto pool = std::pmr::monotonic_buffer_resource{ std::data(buffer), std::size(buffer) };
 
         THEN("the tree is default_constructible") {
@@ -223,21 +231,21 @@ TEMPLATE_LIST_TEST_CASE("avl-tree can be templated on various allocators",
             THEN("avl-tree is copy-constructible") {
                 auto _1 = _0;
                 REQUIRE(_0.size() == _1.size());
-                REQUIRE(std::equal(begin(_0), end(_0), begin(_1), end(_1)));
+                REQUIRE(std::equal(std::begin(_0), std::end(_0), std::begin(_1), std::end(_1)));
             }
             THEN("avl-tree is copy-assignable") {
                 auto _2 = _0;
                 _2.emplace(*std::prev(_2.end()) + *std::prev(_2.end(), 2));
                 auto _1 = _2;
                 REQUIRE(_0.size() + 1 == _1.size());
-                REQUIRE(std::equal(begin(_0), end(_0), begin(_1), std::prev(end(_1))));
+                REQUIRE(std::equal(std::begin(_0), std::end(_0), std::begin(_1), std::prev(std::end(_1))));
                 REQUIRE(_1.back() == 13);
             }
             THEN("avl-tree is move-constructible") {
                 auto _2 = _0;
                 auto _1 = std::move(_2);
                 REQUIRE(_0.size() == _1.size());
-                REQUIRE(std::equal(begin(_0), end(_0), begin(_1), end(_1)));
+                REQUIRE(std::equal(std::begin(_0), std::end(_0), std::begin(_1), std::end(_1)));
             }
             THEN("avl-tree is move-assignable") {
                 auto _2 = _0;
@@ -245,7 +253,7 @@ TEMPLATE_LIST_TEST_CASE("avl-tree can be templated on various allocators",
                 auto _1 = decltype(_0){};
                 _1 = std::move(_2);
                 REQUIRE(_0.size() + 1 == _1.size());
-                REQUIRE(std::equal(begin(_0), end(_0), begin(_1), std::prev(end(_1))));
+                REQUIRE(std::equal(std::begin(_0), std::end(_0), std::begin(_1), std::prev(std::end(_1))));
                 REQUIRE(_1.back() == 13);
             }
         }
@@ -394,6 +402,150 @@ TEST_CASE("It is possible to extract and insert nodes, and merge trees", "[extra
             REQUIRE(std::equal(begin(unified), end(unified), begin(a2), end(a2)));
             REQUIRE(b2.empty());
         }
+        THEN("node handles can be moved around before being inserted") {
+            auto nodes = std::vector<avl_tree<int>::node_type>{};
+            while (not b.empty()) {
+                nodes.push_back(b.extract(b.begin()));
+            }
+            auto n = std::move(nodes.back());
+            REQUIRE(nodes.back().empty());
+            nodes.back() = std::move(nodes.front());
+            REQUIRE(nodes.front().empty());
+            a.insert(std::move(n));
+            a.insert(std::move(nodes.back()));
+            REQUIRE(a.size() == 7);
+            REQUIRE(a.front() == 0);
+            REQUIRE(a.back() == 34);
+        }
+    }
+}
+
+TEST_CASE("It is possible to erase single elements and ranges", "[erase]")
+{
+    GIVEN("a avl-tree with some repeated elements") {
+        auto tree = avl_tree<int>{8, 3, 5, 1, 3, 9, 7, 3, 2, 6, 4, 0};
+        auto model = std::multiset<int>(tree.begin(), tree.end());
+
+        THEN("`erase(iterator)` must return the iterator following the erased one") {
+            auto it = tree.erase(tree.find(5));
+            REQUIRE(*it == 6);
+            model.erase(model.find(5));
+            REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+            REQUIRE(tree.erase(std::prev(tree.end())) == tree.end());
+            REQUIRE(tree.back() == 8);
+            tree.erase(tree.begin());
+            REQUIRE(tree.front() == 1);
+        }
+        THEN("`erase(value)` must erase every equivalent element") {
+            REQUIRE(tree.erase(3) == 3);
+            REQUIRE(tree.erase(42) == 0);
+            REQUIRE(tree.size() == model.size() - 3);
+            REQUIRE(not tree.contains(3));
+        }
+        THEN("`erase(first, last)` must erase the whole range") {
+            auto it = tree.erase(tree.lower_bound(2), tree.lower_bound(7));
+            REQUIRE(*it == 7);
+            model.erase(model.lower_bound(2), model.lower_bound(7));
+            REQUIRE(tree.size() == model.size());
+            REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+            REQUIRE(std::equal(tree.rbegin(), tree.rend(), model.rbegin(), model.rend()));
+
+            tree.erase(tree.begin(), std::next(tree.begin(), 2));
+            REQUIRE(tree.front() == 7);
+            tree.erase(tree.find(8), tree.end());
+            REQUIRE(tree.back() == 7);
+            REQUIRE(tree.size() == 1);
+            tree.erase(tree.begin(), tree.end());
+            REQUIRE(tree.empty());
+            REQUIRE(tree.begin() == tree.end());
+        }
+        THEN("`erase_if` must erase every element satisfying the predicate") {
+            REQUIRE(forest::erase_if(tree, [](int x) { return x % 3 != 2; }) == 9);
+            REQUIRE(std::equal(tree.begin(), tree.end(), std::begin({2, 5, 8})));
+        }
+    }
+    GIVEN("a large avl-tree") {
+        auto tree = avl_tree<int>{};
+        auto model = std::multiset<int>{};
+        for (int i = 0; i < 1000; ++i) {
+            auto const x = (i * 7919) % 251;
+            tree.insert(x);
+            model.insert(x);
+        }
+        THEN("erasing ranges and single elements must keep the tree sorted") {
+            for (int i = 0; i < 50; ++i) {
+                auto const lo = (i * 37) % 251, hi = lo + i % 13;
+                tree.erase(tree.lower_bound(lo), tree.upper_bound(hi));
+                model.erase(model.lower_bound(lo), model.upper_bound(hi));
+                if (auto it = tree.find(i * 5); it != tree.end()) {
+                    tree.erase(it);
+                    model.erase(model.find(i * 5));
+                }
+                REQUIRE(tree.size() == model.size());
+            }
+            REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+            REQUIRE(std::equal(tree.rbegin(), tree.rend(), model.rbegin(), model.rend()));
+        }
+    }
+}
+
+TEST_CASE("It is possible to modify elements in place", "[modify]")
+{
+    GIVEN("an avl-tree with some repeated elements") {
+        auto tree = avl_tree<int>{8, 3, 5, 1, 3, 9, 7, 3, 2, 6, 4, 0};
+        auto model = std::multiset<int>(tree.begin(), tree.end());
+
+        THEN("a change which keeps the order must leave the node in place") {
+            auto const it = tree.find(5);
+            auto const address = std::addressof(*it);
+            REQUIRE(tree.modify(it, [](int & x) { x = 4; }) == it);
+            REQUIRE(std::addressof(*it) == address);
+            REQUIRE(tree.count(4) == 2);
+            REQUIRE(not tree.contains(5));
+        }
+        THEN("a change which breaks the order must move the same node") {
+            auto const it = tree.find(1);
+            auto const address = std::addressof(*it);
+            auto const moved = tree.modify(it, [](int & x) { x = 7; });
+            REQUIRE(*moved == 7);
+            REQUIRE(std::addressof(*moved) == address);
+            REQUIRE(tree.front() == 0);
+            REQUIRE(tree.count(7) == 2);
+            tree.modify(std::prev(tree.end()), [](int & x) { x = -1; });
+            REQUIRE(tree.front() == -1);
+            REQUIRE(tree.back() == 8);
+            REQUIRE(tree.size() == model.size());
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+            REQUIRE(std::is_sorted(tree.rbegin(), tree.rend(), std::greater{}));
+        }
+        THEN("if the change throws, the element must be erased") {
+            REQUIRE_THROWS(tree.modify(tree.find(3), [](int & x) { x = 42; throw 0; }));
+            REQUIRE(tree.size() == model.size() - 1);
+            REQUIRE(tree.count(3) == 2);
+            REQUIRE(not tree.contains(42));
+        }
+    }
+    GIVEN("a large avl-tree") {
+        auto tree = avl_tree<int>{};
+        auto model = std::multiset<int>{};
+        for (int i = 0; i < 500; ++i) {
+            tree.insert(i * 2);
+            model.insert(i * 2);
+        }
+        THEN("shifting the elements must keep the tree sorted") {
+            for (int i = 0; i < 500; ++i) {
+                auto const x = (i * 7919) % 1000;
+                auto const delta = i % 7 - 3 + (i % 50 == 0 ? 300 : 0);
+                if (auto it = tree.lower_bound(x); it != tree.end()) {
+                    model.insert(*it + delta);
+                    model.erase(model.find(*it));
+                    tree.modify(it, [delta](int & y) { y += delta; });
+                }
+            }
+            REQUIRE(tree.size() == model.size());
+            REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+            REQUIRE(std::equal(tree.rbegin(), tree.rend(), model.rbegin(), model.rend()));
+        }
     }
 }
 
@@ -420,3 +572,158 @@ TEST_CASE("It is possible to compare trees", "[compare]")
         }
     }
 }
+
+TEST_CASE("avl-tree can collect statistics through its policy", "[stats]")
+{
+    using counted_tree = avl_tree<int, std::less<>, std::allocator<int>, forest::tree_stats>;
+    static_assert(sizeof(avl_tree<int>) < sizeof(counted_tree));
+
+    auto tree = counted_tree{};
+    REQUIRE(tree.stats().comparisons == 0);
+    for (auto i = 0; i < 1023; ++i) {
+        tree.insert(i);
+    }
+    GIVEN("a tree filled with sorted values") {
+        auto const & stats = tree.stats();
+        THEN("insertions are counted") {
+            REQUIRE(stats.allocations == 1023);
+            REQUIRE(stats.comparisons > 1023);
+            // Sorted insertions keep rotating the right spine
+            REQUIRE(stats.rotations > 1000);
+            REQUIRE(stats.rebalance_steps >= 1023);
+            REQUIRE(stats.max_depth <= 12);
+        }
+        WHEN("the statistics are reset before a lookup") {
+            tree.reset_stats();
+            REQUIRE(tree.contains(0));
+            THEN("only the lookup is counted") {
+                REQUIRE(stats.allocations == 0);
+                REQUIRE(stats.rotations == 0);
+                REQUIRE(stats.rebalance_steps == 0);
+                REQUIRE(stats.comparisons >= 1);
+                // The root is at depth 0, and each level takes at most two comparisons
+                REQUIRE(stats.max_depth >= 9);
+                REQUIRE(stats.max_depth <= 11);
+                REQUIRE(stats.comparisons <= 2 * (stats.max_depth + 1));
+            }
+        }
+        WHEN("elements are erased") {
+            tree.reset_stats();
+            for (auto i = 0; i < 512; ++i) {
+                tree.erase(tree.find(i));
+            }
+            THEN("the rebalancing is counted, and nothing is allocated") {
+                REQUIRE(stats.allocations == 0);
+                REQUIRE(stats.rotations > 0);
+                REQUIRE(stats.rebalance_steps > 0);
+                REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+            }
+        }
+    }
+}
+
+TEST_CASE("avl-tree stays balanced whatever the order of the insertions", "[shape]")
+{
+    auto tree = forest::avl_tree<int>{};
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert(i);
+    }
+    auto const shape = forest::shape_report(tree);
+    REQUIRE(shape.size == 1000);
+    REQUIRE(shape.min_height == 10);
+    REQUIRE(shape.height <= 14); // 1.44 * log2(1000)
+    REQUIRE(shape.depth_histogram.front() == 1);
+    REQUIRE(shape.average_path_length < shape.height);
+    for (auto it = tree.begin(); it != tree.end(); ++it) {
+        REQUIRE(depth(it) < shape.height);
+    }
+}
+
+TEST_CASE("avl-tree reuses its nodes when assigned", "[assign][capacity]")
+{
+    using counted_tree = avl_tree<int, std::less<>, std::allocator<int>, forest::tree_stats>;
+    auto tree = counted_tree{};
+    auto other = counted_tree{};
+    for (auto i = 0; i < 100; ++i) {
+        tree.insert(i);
+        other.insert(-i);
+    }
+    tree.reset_stats();
+    GIVEN("a tree assigned another one as large") {
+        tree = other;
+        THEN("the elements are copied into the old nodes") {
+            REQUIRE(tree.stats().allocations == 0);
+            REQUIRE(tree == other);
+            REQUIRE(tree.capacity() == 100);
+        }
+    }
+    GIVEN("a tree assigned fewer elements") {
+        tree = {3, 1, 2};
+        THEN("the nodes left over are kept until shrink_to_fit") {
+            REQUIRE(tree.stats().allocations == 0);
+            REQUIRE(tree.size() == 3);
+            REQUIRE(tree.capacity() == 100);
+            tree.assign(other.begin(), other.end());
+            REQUIRE(tree.stats().allocations == 0);
+            tree.clear();
+            tree.shrink_to_fit();
+            REQUIRE(tree.capacity() == 0);
+        }
+    }
+    GIVEN("a tree with reserved nodes") {
+        tree.clear();
+        tree.reserve(200);
+        REQUIRE(tree.capacity() == 200);
+        REQUIRE(tree.stats().allocations == 200);
+        tree.reset_stats();
+        THEN("insertions take them before allocating") {
+            for (auto i = 0; i < 201; ++i) {
+                tree.insert(i);
+            }
+            REQUIRE(tree.stats().allocations == 1);
+            REQUIRE(tree.capacity() == 201);
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+        }
+    }
+}
+
+TEST_CASE("avl-tree inserts unique elements with a single descent", "[insert_unique]")
+{
+    using counted_tree = avl_tree<std::string, std::less<>, std::allocator<std::string>, forest::tree_stats>;
+    auto tree = counted_tree{"b", "d", "f"};
+    tree.reset_stats();
+    GIVEN("an element equivalent to one in the tree") {
+        THEN("it is neither inserted nor constructed") {
+            auto const [it, inserted] = tree.try_emplace_unique(std::string_view{"d"}, 3, 'd');
+            REQUIRE_FALSE(inserted);
+            REQUIRE(*it == "d");
+            REQUIRE(tree.size() == 3);
+            REQUIRE(tree.stats().allocations == 0);
+            REQUIRE(tree.stats().comparisons <= 2 * (tree.stats().max_depth + 1));
+            REQUIRE_FALSE(tree.emplace_unique(std::string{"b"}).second);
+            REQUIRE(*tree.insert_unique(std::string{"f"}) == "f");
+            REQUIRE(tree.stats().allocations == 0);
+        }
+        THEN("emplacing it from other arguments keeps the node aside") {
+            auto const [it, inserted] = tree.emplace_unique(1, 'b');
+            REQUIRE_FALSE(inserted);
+            REQUIRE(*it == "b");
+            REQUIRE(tree.capacity() == 4);
+            REQUIRE(tree.stats().allocations == 1);
+            REQUIRE(tree.emplace_unique(1, 'c').second);
+            REQUIRE(tree.stats().allocations == 1);
+            REQUIRE(tree.capacity() == 4);
+        }
+    }
+    GIVEN("new elements") {
+        THEN("they are inserted in order") {
+            REQUIRE(tree.try_emplace_unique(std::string_view{"e"}, "e").second);
+            REQUIRE(tree.emplace_unique("a").second);
+            REQUIRE(*tree.insert_unique(std::string{"c"}) == "c");
+            REQUIRE(tree.try_emplace_unique(std::string{"g"}).second);
+            REQUIRE(tree.size() == 7);
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+            REQUIRE(std::adjacent_find(tree.begin(), tree.end()) == tree.end());
+        }
+    }
+}
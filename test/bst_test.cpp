@@ -7,8 +7,16 @@
 
 #define CATCH_CONFIG_MAIN
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
 #include "catch2/catch.hpp"
 #include "forest/binary_search_tree.hpp"
+#include "forest/shape_report.hpp"
 
 using forest::binary_search_tree;
 
@@ -311,6 +319,135 @@ TEST_CASE("It is possible to extract and insert nodes, and merge trees", "[extra
     }
 }
 
+TEST_CASE("It is possible to erase single elements and ranges", "[erase]")
+{
+    GIVEN("a bst with some repeated elements") {
+        auto tree = binary_search_tree<int>{8, 3, 5, 1, 3, 9, 7, 3, 2, 6, 4, 0};
+        auto model = std::multiset<int>(tree.begin(), tree.end());
+
+        THEN("`erase(iterator)` must return the iterator following the erased one") {
+            auto it = tree.erase(tree.find(5));
+            REQUIRE(*it == 6);
+            model.erase(model.find(5));
+            REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+            REQUIRE(tree.erase(std::prev(tree.end())) == tree.end());
+            REQUIRE(tree.back() == 8);
+            tree.erase(tree.begin());
+            REQUIRE(tree.front() == 1);
+        }
+        THEN("`erase(value)` must erase every equivalent element") {
+            REQUIRE(tree.erase(3) == 3);
+            REQUIRE(tree.erase(42) == 0);
+            REQUIRE(tree.size() == model.size() - 3);
+            REQUIRE(not tree.contains(3));
+        }
+        THEN("`erase(first, last)` must erase the whole range") {
+            auto it = tree.erase(tree.lower_bound(2), tree.lower_bound(7));
+            REQUIRE(*it == 7);
+            model.erase(model.lower_bound(2), model.lower_bound(7));
+            REQUIRE(tree.size() == model.size());
+            REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+            REQUIRE(std::equal(tree.rbegin(), tree.rend(), model.rbegin(), model.rend()));
+
+            tree.erase(tree.begin(), std::next(tree.begin(), 2));
+            REQUIRE(tree.front() == 7);
+            tree.erase(tree.find(8), tree.end());
+            REQUIRE(tree.back() == 7);
+            REQUIRE(tree.size() == 1);
+            tree.erase(tree.begin(), tree.end());
+            REQUIRE(tree.empty());
+            REQUIRE(tree.begin() == tree.end());
+        }
+        THEN("`erase_if` must erase every element satisfying the predicate") {
+            REQUIRE(forest::erase_if(tree, [](int x) { return x % 3 != 2; }) == 9);
+            REQUIRE(std::equal(tree.begin(), tree.end(), std::begin({2, 5, 8})));
+        }
+    }
+    GIVEN("a large bst") {
+        auto tree = binary_search_tree<int>{};
+        auto model = std::multiset<int>{};
+        for (int i = 0; i < 1000; ++i) {
+            auto const x = (i * 7919) % 251;
+            tree.insert(x);
+            model.insert(x);
+        }
+        THEN("erasing ranges and single elements must keep the tree sorted") {
+            for (int i = 0; i < 50; ++i) {
+                auto const lo = (i * 37) % 251, hi = lo + i % 13;
+                tree.erase(tree.lower_bound(lo), tree.upper_bound(hi));
+                model.erase(model.lower_bound(lo), model.upper_bound(hi));
+                if (auto it = tree.find(i * 5); it != tree.end()) {
+                    tree.erase(it);
+                    model.erase(model.find(i * 5));
+                }
+                REQUIRE(tree.size() == model.size());
+            }
+            REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+            REQUIRE(std::equal(tree.rbegin(), tree.rend(), model.rbegin(), model.rend()));
+        }
+    }
+}
+
+TEST_CASE("It is possible to modify elements in place", "[modify]")
+{
+    GIVEN("a bst with some repeated elements") {
+        auto tree = binary_search_tree<int>{8, 3, 5, 1, 3, 9, 7, 3, 2, 6, 4, 0};
+        auto model = std::multiset<int>(tree.begin(), tree.end());
+
+        THEN("a change which keeps the order must leave the node in place") {
+            auto const it = tree.find(5);
+            auto const address = std::addressof(*it);
+            REQUIRE(tree.modify(it, [](int & x) { x = 4; }) == it);
+            REQUIRE(std::addressof(*it) == address);
+            REQUIRE(tree.count(4) == 2);
+            REQUIRE(not tree.contains(5));
+        }
+        THEN("a change which breaks the order must move the same node") {
+            auto const it = tree.find(1);
+            auto const address = std::addressof(*it);
+            auto const moved = tree.modify(it, [](int & x) { x = 7; });
+            REQUIRE(*moved == 7);
+            REQUIRE(std::addressof(*moved) == address);
+            REQUIRE(tree.front() == 0);
+            REQUIRE(tree.count(7) == 2);
+            tree.modify(std::prev(tree.end()), [](int & x) { x = -1; });
+            REQUIRE(tree.front() == -1);
+            REQUIRE(tree.back() == 8);
+            REQUIRE(tree.size() == model.size());
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+            REQUIRE(std::is_sorted(tree.rbegin(), tree.rend(), std::greater{}));
+        }
+        THEN("if the change throws, the element must be erased") {
+            REQUIRE_THROWS(tree.modify(tree.find(3), [](int & x) { x = 42; throw 0; }));
+            REQUIRE(tree.size() == model.size() - 1);
+            REQUIRE(tree.count(3) == 2);
+            REQUIRE(not tree.contains(42));
+        }
+    }
+    GIVEN("a large bst") {
+        auto tree = binary_search_tree<int>{};
+        auto model = std::multiset<int>{};
+        for (int i = 0; i < 500; ++i) {
+            tree.insert(i * 2);
+            model.insert(i * 2);
+        }
+        THEN("shifting the elements must keep the tree sorted") {
+            for (int i = 0; i < 500; ++i) {
+                auto const x = (i * 7919) % 1000;
+                auto const delta = i % 7 - 3 + (i % 50 == 0 ? 300 : 0);
+                if (auto it = tree.lower_bound(x); it != tree.end()) {
+                    model.insert(*it + delta);
+                    model.erase(model.find(*it));
+                    tree.modify(it, [delta](int & y) { y += delta; });
+                }
+            }
+            REQUIRE(tree.size() == model.size());
+            REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+            REQUIRE(std::equal(tree.rbegin(), tree.rend(), model.rbegin(), model.rend()));
+        }
+    }
+}
+
 TEST_CASE("It is possible to compare trees", "[compare]")
 {
     auto const a = binary_search_tree<int>{0, 1, 2};
@@ -335,3 +472,124 @@ TEST_CASE("It is possible to compare trees", "[compare]")
     }
 }
 
+
+TEST_CASE("It is possible to measure the shape of a tree", "[shape]")
+{
+    GIVEN("an empty bst") {
+        auto const tree = binary_search_tree<int>{};
+        THEN("its shape is empty") {
+            auto const shape = forest::shape_report(tree);
+            REQUIRE(shape.size == 0);
+            REQUIRE(shape.height == 0);
+            REQUIRE(shape.depth_histogram.empty());
+            REQUIRE(shape.total_bytes == sizeof(tree));
+        }
+    }
+    GIVEN("a bst filled in order") {
+        auto tree = binary_search_tree<int>{};
+        for (int i = 0; i < 100; ++i) {
+            tree.insert(i);
+        }
+        THEN("it has degenerated into a list") {
+            auto const shape = forest::shape_report(tree);
+            REQUIRE(shape.size == 100);
+            REQUIRE(shape.height == 100);
+            REQUIRE(shape.min_height == 7);
+            REQUIRE(std::all_of(shape.depth_histogram.begin(), shape.depth_histogram.end(),
+                                [](auto n) { return n == 1; }));
+            REQUIRE(shape.average_path_length == Approx(50.5));
+            REQUIRE(shape.total_bytes == 100 * shape.node_size + sizeof(tree));
+        }
+        THEN("the depth of an element counts the links from the root") {
+            REQUIRE(depth(tree.find(0)) == 0);
+            REQUIRE(depth(tree.find(42)) == 42);
+            REQUIRE(depth(std::as_const(tree).find(99)) == 99);
+        }
+    }
+    GIVEN("a bst filled in a balanced order") {
+        auto tree = binary_search_tree<int>{3, 1, 5, 0, 2, 4, 6};
+        THEN("every level is full") {
+            auto const shape = forest::shape_report(tree);
+            REQUIRE(shape.height == 3);
+            REQUIRE(shape.min_height == 3);
+            REQUIRE(shape.depth_histogram == std::vector<std::size_t>{1, 2, 4});
+            REQUIRE(shape.average_path_length == Approx(17.0 / 7));
+            REQUIRE(depth(tree.find(6)) == 2);
+        }
+    }
+}
+
+TEST_CASE("A scapegoat bst rebuilds the subtrees grown too deep", "[scapegoat][shape]")
+{
+    using scapegoat_tree = binary_search_tree<int, std::less<>, std::allocator<int>, forest::tree_stats,
+                                              forest::scapegoat<>>;
+    // With alpha = 2/3, no element is deeper than log_{3/2}(n)
+    auto const levels = [](std::size_t n) { return std::floor(std::log(n) / std::log(1.5)) + 1; };
+    auto tree = scapegoat_tree{};
+    for (int i = 0; i < 10000; ++i) {
+        tree.insert(i);
+    }
+    GIVEN("a tree filled in order") {
+        THEN("it has not degenerated into a list") {
+            auto const shape = forest::shape_report(tree);
+            REQUIRE(shape.height <= levels(tree.size()));
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+            REQUIRE(tree.front() == 0);
+            REQUIRE(tree.back() == 9999);
+            REQUIRE(tree.stats().rebalance_steps > 0);
+        }
+    }
+    WHEN("most elements are erased") {
+        tree.reset_stats();
+        tree.erase(tree.begin(), tree.find(9000));
+        THEN("the whole tree is rebuilt each time it shrinks below 2/3 of its size") {
+            // At 6666, 4443, 2961, 1973 and 1315 elements
+            auto const shape = forest::shape_report(tree);
+            REQUIRE(tree.size() == 1000);
+            REQUIRE(tree.stats().rebalance_steps == 5);
+            REQUIRE(shape.height <= shape.min_height + 1);
+            REQUIRE(*tree.begin() == 9000);
+        }
+    }
+    WHEN("elements are inserted as unique, or moved in place") {
+        for (int i = -1; i > -1000; --i) {
+            REQUIRE(tree.emplace_unique(i).second);
+        }
+        tree.modify(tree.find(5000), [](int & x) { x = -5000; });
+        THEN("they are placed in balanced subtrees too") {
+            REQUIRE(forest::shape_report(tree).height <= levels(tree.size()));
+            REQUIRE(tree.front() == -5000);
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+        }
+    }
+}
+
+TEST_CASE("A scapegoat bst stays sorted and shallow under random updates", "[scapegoat][random]")
+{
+    auto rng = std::mt19937{11};
+    auto values = std::uniform_int_distribution<int>{0, 4095};
+    auto tree = binary_search_tree<int, std::less<>, std::allocator<int>, forest::no_stats, forest::scapegoat<3, 4>>{};
+    auto reference = std::multiset<int>{};
+    auto max_size = std::size_t{0};
+    for (auto round = 0; round < 20000; ++round) {
+        auto const x = values(rng);
+        if (round % 3 == 2) {
+            if (auto const it = tree.lower_bound(x); it != tree.end()) {
+                reference.erase(reference.find(*it));
+                tree.erase(it);
+            }
+        } else {
+            tree.insert(x);
+            reference.insert(x);
+            max_size = std::max(max_size, tree.size());
+        }
+        if (round % 1000 == 999) {
+            REQUIRE(std::equal(tree.begin(), tree.end(), reference.begin(), reference.end()));
+            REQUIRE(forest::shape_report(tree).height <= std::log(max_size) / std::log(4.0 / 3) + 2);
+        }
+    }
+    while (not tree.empty()) {
+        tree.erase(std::next(tree.begin(), static_cast<std::ptrdiff_t>(tree.size() / 2)));
+    }
+    REQUIRE(tree.begin() == tree.end());
+}
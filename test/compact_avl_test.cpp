@@ -0,0 +1,224 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : compact_avl_test
+ * @created     : lunedì ott 19, 2026 12:31:15 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/compact_avl_tree.hpp"
+
+using forest::compact_avl_tree;
+
+template <class T>
+using packed_avl_tree = compact_avl_tree<T, std::less<>, std::allocator<T>, forest::packed_balance>;
+
+namespace
+{
+// Counts the bytes allocated through it and its copies, and not yet freed
+template <typename T>
+struct counting_allocator
+{
+    using value_type = T;
+
+    std::size_t * bytes;
+
+    explicit counting_allocator(std::size_t * b) noexcept : bytes{b} {}
+    template <typename U>
+    counting_allocator(counting_allocator<U> const & other) noexcept : bytes{other.bytes} {}
+
+    T * allocate(std::size_t n) { *bytes += n * sizeof(T); return std::allocator<T>{}.allocate(n); }
+    void deallocate(T * p, std::size_t n) noexcept { *bytes -= n * sizeof(T); std::allocator<T>{}.deallocate(p, n); }
+
+    friend bool operator==(counting_allocator const & lhs, counting_allocator const & rhs) noexcept
+    { return lhs.bytes == rhs.bytes; }
+};
+} // namespace
+
+TEST_CASE("compact_avl_trees can be constructed and assigned", "[construction][assignment]")
+{
+    auto empty = compact_avl_tree<int>{};
+    REQUIRE(empty.empty());
+    REQUIRE(empty.begin() == empty.end());
+
+    auto tree = compact_avl_tree{5, 3, 1, 4, 1};
+    REQUIRE(tree.size() == 5);
+    REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector{1, 1, 3, 4, 5});
+    REQUIRE(std::vector(tree.rbegin(), tree.rend()) == std::vector{5, 4, 3, 1, 1});
+    REQUIRE(tree.front() == 1);
+    REQUIRE(tree.back() == 5);
+
+    auto copy = tree;
+    REQUIRE(copy == tree);
+    auto moved = std::move(copy);
+    REQUIRE(moved == tree);
+    REQUIRE(copy.empty());
+
+    moved = {2, 7};
+    REQUIRE(std::vector(moved.begin(), moved.end()) == std::vector{2, 7});
+    REQUIRE(tree < moved);
+    copy = tree;
+    REQUIRE(copy == tree);
+    swap(copy, moved);
+    REQUIRE(copy.size() == 2);
+}
+
+TEST_CASE("compact-avl-tree inserts, finds and erases elements", "[insert][lookup][erase]")
+{
+    auto tree = compact_avl_tree<std::string>{"b", "d", "f"};
+    GIVEN("equivalent elements") {
+        auto const first = tree.insert("d");
+        auto const second = tree.emplace(1, 'd');
+        THEN("they are kept after the ones already there") {
+            REQUIRE(std::distance(tree.begin(), first) == 2);
+            REQUIRE(std::distance(tree.begin(), second) == 3);
+            REQUIRE(tree.count("d") == 3);
+            REQUIRE(tree.erase("d") == 3);
+            REQUIRE(not tree.contains("d"));
+            REQUIRE(tree.size() == 2);
+        }
+    }
+    GIVEN("a range to erase") {
+        auto const next = tree.erase(tree.find("b"), tree.find("f"));
+        THEN("the elements after it are left") {
+            REQUIRE(*next == "f");
+            REQUIRE(tree.size() == 1);
+            REQUIRE(tree.lower_bound("a") == tree.begin());
+            REQUIRE(tree.upper_bound("f") == tree.end());
+        }
+    }
+    GIVEN("elements erased through iterators") {
+        auto const next = tree.erase(tree.find("d"));
+        THEN("the iterator to the following element is returned") {
+            REQUIRE(*next == "f");
+            REQUIRE(tree.erase(std::prev(tree.end())) == tree.end());
+            REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector<std::string>{"b"});
+            REQUIRE(erase_if(tree, [](auto const & s) { return s == "b"; }) == 1);
+            REQUIRE(tree.empty());
+        }
+    }
+}
+
+TEST_CASE("compact-avl-tree stays sorted under random insertions and erasures", "[random]")
+{
+    auto rng = std::mt19937{5};
+    auto values = std::uniform_int_distribution<int>{0, 4095};
+    auto tree = compact_avl_tree<int>{};
+    auto reference = std::multiset<int>{};
+    for (auto round = 0; round < 20000; ++round) {
+        auto const x = values(rng);
+        if (round % 3 == 2) {
+            if (auto const it = tree.lower_bound(x); it != tree.end()) {
+                reference.erase(reference.find(*it));
+                auto const next = tree.erase(it);
+                REQUIRE((next == tree.end() or *next >= x));
+            }
+        } else {
+            REQUIRE(*tree.insert(x) == x);
+            reference.insert(x);
+        }
+        if (round % 1000 == 999) {
+            REQUIRE(std::equal(tree.begin(), tree.end(), reference.begin(), reference.end()));
+            REQUIRE(std::equal(tree.rbegin(), tree.rend(), reference.rbegin(), reference.rend()));
+        }
+    }
+    while (not tree.empty()) {
+        tree.erase(std::next(tree.begin(), static_cast<std::ptrdiff_t>(tree.size() / 2)));
+    }
+    REQUIRE(tree.begin() == tree.end());
+}
+
+TEST_CASE("compact-avl-tree with packed balances stays sorted under random updates", "[random][packed]")
+{
+    auto rng = std::mt19937{7};
+    auto values = std::uniform_int_distribution<int>{0, 4095};
+    auto tree = packed_avl_tree<int>{};
+    auto reference = std::multiset<int>{};
+    for (auto round = 0; round < 20000; ++round) {
+        auto const x = values(rng);
+        if (round % 3 == 2) {
+            if (auto const it = tree.lower_bound(x); it != tree.end()) {
+                reference.erase(reference.find(*it));
+                auto const next = tree.erase(it);
+                REQUIRE((next == tree.end() or *next >= x));
+            }
+        } else {
+            REQUIRE(*tree.insert(x) == x);
+            reference.insert(x);
+        }
+        if (round % 1000 == 999) {
+            REQUIRE(std::equal(tree.begin(), tree.end(), reference.begin(), reference.end()));
+            REQUIRE(std::equal(tree.rbegin(), tree.rend(), reference.rbegin(), reference.rend()));
+        }
+    }
+    auto copy = tree;
+    REQUIRE(copy == tree);
+    copy.erase(copy.lower_bound(1024), copy.lower_bound(3072));
+    REQUIRE(copy.size() == reference.size() - static_cast<std::size_t>(
+        std::distance(reference.lower_bound(1024), reference.lower_bound(3072))
+    ));
+    REQUIRE(erase_if(tree, [](int x) { return x % 2 == 0; }) > 0);
+    REQUIRE(std::all_of(tree.begin(), tree.end(), [](int x) { return x % 2 == 1; }));
+}
+
+TEST_CASE("compact-avl-tree nodes are smaller than the ones of avl_tree", "[memory]")
+{
+    auto compact_bytes = std::size_t{0};
+    auto avl_bytes = std::size_t{0};
+    {
+        auto compact = compact_avl_tree<std::uint32_t, std::less<>, counting_allocator<std::uint32_t>>{
+            counting_allocator<std::uint32_t>{&compact_bytes}
+        };
+        auto avl = forest::avl_tree<std::uint32_t, std::less<>, counting_allocator<std::uint32_t>>{
+            counting_allocator<std::uint32_t>{&avl_bytes}
+        };
+        for (std::uint32_t i = 0; i < 1000; ++i) {
+            compact.insert(i);
+            avl.insert(i);
+        }
+        // At least the parent link is saved, and on 64 bit targets the height fits in the padding too
+        REQUIRE(avl_bytes - compact_bytes >= 1000 * sizeof(void *));
+        if constexpr (sizeof(void *) == 8) {
+            REQUIRE(avl_bytes == 1000 * 40);
+            REQUIRE(compact_bytes == 1000 * 24);
+        }
+    }
+    REQUIRE(compact_bytes == 0);
+}
+
+TEST_CASE("packed balances save the height of each node", "[memory][packed]")
+{
+    using value = std::uint64_t;
+    auto compact_bytes = std::size_t{0};
+    auto packed_bytes = std::size_t{0};
+    {
+        auto compact = compact_avl_tree<value, std::less<>, counting_allocator<value>>{
+            counting_allocator<value>{&compact_bytes}
+        };
+        auto packed = compact_avl_tree<value, std::less<>, counting_allocator<value>, forest::packed_balance>{
+            counting_allocator<value>{&packed_bytes}
+        };
+        for (value i = 0; i < 1000; ++i) {
+            compact.insert(i);
+            packed.insert(i);
+        }
+        REQUIRE(std::equal(compact.begin(), compact.end(), packed.begin(), packed.end()));
+        // Only the links and the value are left, while the height took a word of its own after the value
+        REQUIRE(packed_bytes == 1000 * (2 * sizeof(void *) + sizeof(value)));
+        if constexpr (sizeof(void *) == 8) {
+            REQUIRE(compact_bytes == 1000 * 32);
+            REQUIRE(packed_bytes == 1000 * 24);
+        }
+    }
+    REQUIRE(packed_bytes == 0);
+}
@@ -0,0 +1,211 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : concurrent_avl_test
+ * @created     : domenica ott 18, 2026 20:31:26 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <atomic>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/concurrent_avl_tree.hpp"
+
+using forest::concurrent_avl_tree;
+
+namespace
+{
+template <class Tree>
+auto collect(Tree const & tree)
+{
+    auto res = std::vector<int>{};
+    tree.for_each([&res](int x) { res.push_back(x); });
+    return res;
+}
+
+// Counts its live instances, to tell which nodes were freed
+struct tracked
+{
+    static inline std::atomic<int> live = 0;
+    int value;
+
+    tracked(int v) noexcept : value{v} { ++live; }
+    tracked(tracked const & other) noexcept : value{other.value} { ++live; }
+    ~tracked() { --live; }
+    friend bool operator<(tracked const & lhs, tracked const & rhs) noexcept { return lhs.value < rhs.value; }
+};
+} // namespace
+
+TEST_CASE("concurrent_avl_tree behaves as a multiset", "[lookup][modifiers]")
+{
+    auto tree = concurrent_avl_tree<int>{8, 3, 5, 1, 3, 9, 7, 3, 2, 6, 4, 0};
+    REQUIRE(tree.size() == 12);
+    REQUIRE(collect(tree) == std::vector<int>{0, 1, 2, 3, 3, 3, 4, 5, 6, 7, 8, 9});
+
+    REQUIRE(tree.contains(5));
+    REQUIRE(not tree.contains(42));
+    REQUIRE(tree.find(7) == 7);
+    REQUIRE(not tree.find(-1).has_value());
+    REQUIRE(tree.lower_bound(3) == 3);
+    REQUIRE(tree.upper_bound(3) == 4);
+    REQUIRE(not tree.upper_bound(9).has_value());
+    REQUIRE(tree.lower_bound(-10) == 0);
+
+    REQUIRE(not tree.insert_unique(3));
+    REQUIRE(tree.insert_unique(10));
+    REQUIRE(tree.erase(3) == 3);
+    REQUIRE(tree.erase(3) == 0);
+    REQUIRE(tree.size() == 10);
+    REQUIRE(tree.upper_bound(2) == 4);
+
+    tree.clear();
+    REQUIRE(tree.empty());
+    REQUIRE(not tree.lower_bound(0).has_value());
+    tree.reclaim();
+    tree.insert(1);
+    REQUIRE(collect(tree) == std::vector<int>{1});
+}
+
+TEST_CASE("concurrent_avl_tree agrees with std::multiset", "[random]")
+{
+    auto rng = std::mt19937{17};
+    auto tree = concurrent_avl_tree<int>{};
+    auto model = std::multiset<int>{};
+    for (auto round = 0; round < 5000; ++round) {
+        auto const x = static_cast<int>(rng() % 400);
+        if (rng() % 3 == 0) {
+            REQUIRE(tree.erase(x) == model.erase(x));
+        } else {
+            tree.insert(x);
+            model.insert(x);
+        }
+        auto const lb = model.lower_bound(x);
+        REQUIRE(tree.lower_bound(x) == (lb != model.end() ? std::optional{*lb} : std::nullopt));
+        auto const ub = model.upper_bound(x);
+        REQUIRE(tree.upper_bound(x) == (ub != model.end() ? std::optional{*ub} : std::nullopt));
+    }
+    REQUIRE(tree.size() == model.size());
+    REQUIRE(collect(tree) == std::vector<int>(model.begin(), model.end()));
+}
+
+// Multiples of 4 are always in the tree, numbers equal to 1 modulo 4 come and go, the others are never inserted.
+// Readers check that every lookup is consistent with that, while the writers keep rotating the tree
+TEST_CASE("concurrent_avl_tree lookups are consistent with concurrent writers", "[concurrency]")
+{
+    constexpr auto n = 4096;
+    constexpr auto writers = 2;
+    constexpr auto readers = 6;
+    auto tree = concurrent_avl_tree<int>{};
+    for (auto i = 0; i < n; i += 4) {
+        tree.insert(i);
+    }
+
+    auto done = std::atomic<bool>{false};
+    auto errors = std::atomic<int>{0};
+    auto threads = std::vector<std::thread>{};
+    for (auto w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            auto rng = std::mt19937{static_cast<unsigned>(w)};
+            for (auto round = 0; round < 20000; ++round) {
+                auto const x = static_cast<int>(rng() % (n / 4)) * 4 + 1;
+                if (rng() % 2 == 0) {
+                    tree.insert_unique(x);
+                } else {
+                    tree.erase(x);
+                }
+            }
+        });
+    }
+    for (auto r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            auto rng = std::mt19937{static_cast<unsigned>(100 + r)};
+            while (not done.load()) {
+                auto const x = static_cast<int>(rng() % (n / 4)) * 4;
+                if (not tree.contains(x) or tree.find(x) != x) {
+                    ++errors;
+                }
+                if (tree.contains(x + 2) or tree.contains(x + 3)) {
+                    ++errors;
+                }
+                if (tree.lower_bound(x + 2) != (x + 4 < n ? std::optional{x + 4} : std::nullopt)) {
+                    ++errors;
+                }
+                if (auto const next = tree.upper_bound(x); next != x + 1 and next != x + 4 and x + 4 < n) {
+                    ++errors;
+                }
+            }
+        });
+    }
+    for (auto w = 0; w < writers; ++w) {
+        threads[static_cast<std::size_t>(w)].join();
+    }
+    done = true;
+    for (auto t = writers; t < writers + readers; ++t) {
+        threads[static_cast<std::size_t>(t)].join();
+    }
+
+    REQUIRE(errors == 0);
+    auto const values = collect(tree);
+    REQUIRE(values.size() == tree.size());
+    REQUIRE(std::is_sorted(values.begin(), values.end()));
+    REQUIRE(std::adjacent_find(values.begin(), values.end()) == values.end());
+    REQUIRE(std::count_if(values.begin(), values.end(), [](int x) { return x % 4 == 0; }) == n / 4);
+}
+
+TEST_CASE("concurrent_avl_tree frees the erased nodes once no reader can reach them", "[reclamation]")
+{
+    {
+        auto tree = concurrent_avl_tree<tracked>{};
+        for (auto i = 0; i < 1000; ++i) {
+            tree.insert(i);
+        }
+        REQUIRE(tracked::live == 1000);
+        for (auto i = 0; i < 1000; ++i) {
+            tree.erase(i);
+        }
+        // Without readers, everything but the last `reclaim_threshold` erased nodes is freed on the way
+        REQUIRE(tracked::live < static_cast<int>(concurrent_avl_tree<tracked>::reclaim_threshold));
+        tree.reclaim();
+        REQUIRE(tracked::live == 0);
+
+        auto done = std::atomic<bool>{false};
+        auto errors = std::atomic<int>{0};
+        auto readers = std::vector<std::thread>{};
+        for (auto r = 0; r < 4; ++r) {
+            readers.emplace_back([&tree, &done, &errors, r] {
+                auto rng = std::mt19937{static_cast<unsigned>(r)};
+                while (not done.load()) {
+                    auto const x = static_cast<int>(rng() % 512);
+                    if (auto const found = tree.find(x); found.has_value() and found->value != x) {
+                        ++errors;
+                    }
+                }
+            });
+        }
+        auto rng = std::mt19937{42};
+        for (auto round = 0; round < 20000; ++round) {
+            auto const x = static_cast<int>(rng() % 512);
+            if (rng() % 2 == 0) {
+                tree.insert_unique(x);
+            } else {
+                tree.erase(x);
+            }
+        }
+        done = true;
+        for (auto & t : readers) {
+            t.join();
+        }
+        REQUIRE(errors == 0);
+        tree.reclaim();
+        REQUIRE(tracked::live == static_cast<int>(tree.size()));
+        tree.clear();
+        tree.reclaim();
+        REQUIRE(tracked::live == 0);
+    }
+    REQUIRE(tracked::live == 0);
+}
@@ -0,0 +1,218 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : concurrent_skiplist_test
+ * @created     : lunedì ott 19, 2026 01:02:37 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/concurrent_skiplist.hpp"
+
+using forest::concurrent_skiplist;
+
+namespace
+{
+template <class List>
+auto collect(List const & list)
+{
+    auto res = std::vector<int>{};
+    list.for_each([&res](int x) { res.push_back(x); });
+    return res;
+}
+
+// Counts its live instances, to tell which nodes were freed
+struct tracked
+{
+    static inline std::atomic<int> live = 0;
+    int value;
+
+    tracked(int v) noexcept : value{v} { ++live; }
+    tracked(tracked const & other) noexcept : value{other.value} { ++live; }
+    ~tracked() { --live; }
+    friend bool operator<(tracked const & lhs, tracked const & rhs) noexcept { return lhs.value < rhs.value; }
+};
+} // namespace
+
+TEST_CASE("concurrent_skiplist behaves as a multiset", "[lookup][modifiers]")
+{
+    auto list = concurrent_skiplist<int>{8, 3, 5, 1, 3, 9, 7, 3, 2, 6, 4, 0};
+    REQUIRE(list.size() == 12);
+    REQUIRE(collect(list) == std::vector<int>{0, 1, 2, 3, 3, 3, 4, 5, 6, 7, 8, 9});
+
+    REQUIRE(list.contains(5));
+    REQUIRE(not list.contains(42));
+    REQUIRE(list.count(3) == 3);
+    REQUIRE(list.find(7) == 7);
+    REQUIRE(not list.find(-1).has_value());
+    REQUIRE(list.lower_bound(3) == 3);
+    REQUIRE(list.upper_bound(3) == 4);
+    REQUIRE(not list.upper_bound(9).has_value());
+    REQUIRE(list.equal_range(3) == std::pair{std::optional{3}, std::optional{4}});
+
+    REQUIRE(not list.insert_unique(3));
+    REQUIRE(list.insert_unique(10));
+    list.emplace(-5);
+    REQUIRE(list.extract(3) == 3);
+    REQUIRE(list.erase(3) == 2);
+    REQUIRE(list.erase(3) == 0);
+    REQUIRE(not list.extract(42).has_value());
+    REQUIRE(collect(list) == std::vector<int>{-5, 0, 1, 2, 4, 5, 6, 7, 8, 9, 10});
+    REQUIRE(list.size() == 11);
+
+    list.clear();
+    REQUIRE(list.empty());
+    REQUIRE(collect(list).empty());
+    REQUIRE(not list.lower_bound(0).has_value());
+}
+
+TEST_CASE("concurrent_skiplist agrees with std::multiset", "[lookup][modifiers]")
+{
+    auto list = concurrent_skiplist<int>{};
+    auto model = std::multiset<int>{};
+    auto rng = std::mt19937{42};
+    for (auto i = 0; i < 20000; ++i) {
+        auto const x = static_cast<int>(rng() % 1000);
+        switch (rng() % 4) {
+            case 0:
+                REQUIRE(list.extract(x).has_value() == (model.count(x) != 0));
+                if (auto const it = model.find(x); it != model.end()) {
+                    model.erase(it);
+                }
+                break;
+            case 1:
+                REQUIRE(list.insert_unique(x) == (model.count(x) == 0));
+                if (model.count(x) == 0) {
+                    model.insert(x);
+                }
+                break;
+            default:
+                list.insert(x);
+                model.insert(x);
+        }
+        auto const lb = model.lower_bound(x);
+        REQUIRE(list.lower_bound(x) == (lb != model.end() ? std::optional{*lb} : std::nullopt));
+    }
+    REQUIRE(list.size() == model.size());
+    REQUIRE(collect(list) == std::vector<int>(model.begin(), model.end()));
+    for (auto x = 0; x < 1000; x += 37) {
+        REQUIRE(list.count(x) == static_cast<std::ptrdiff_t>(model.count(x)));
+    }
+}
+
+TEST_CASE("concurrent_skiplist can be modified by many threads", "[concurrency]")
+{
+    constexpr auto writers = 8;
+    constexpr auto per_writer = 4000;
+
+    SECTION("insertions and extractions keep the list sorted and its size exact") {
+        auto list = concurrent_skiplist<int>{};
+        auto inserted = std::atomic<int>{0};
+        auto extracted = std::atomic<int>{0};
+        auto errors = std::atomic<int>{0};
+        auto threads = std::vector<std::thread>{};
+        for (auto w = 0; w < writers; ++w) {
+            threads.emplace_back([&, w] {
+                auto rng = std::mt19937{static_cast<unsigned>(w)};
+                for (auto i = 0; i < per_writer; ++i) {
+                    auto const x = static_cast<int>(rng() % 512);
+                    if (rng() % 3 == 0) {
+                        if (auto const found = list.extract(x); found.has_value()) {
+                            extracted += *found == x ? 1 : 0;
+                            errors += *found == x ? 0 : 1;
+                        }
+                    } else {
+                        list.insert(x);
+                        ++inserted;
+                    }
+                    if (auto const lb = list.lower_bound(x); lb.has_value() and *lb < x) {
+                        ++errors;
+                    }
+                }
+            });
+        }
+        for (auto & t : threads) {
+            t.join();
+        }
+        REQUIRE(errors == 0);
+        auto const values = collect(list);
+        REQUIRE(std::is_sorted(values.begin(), values.end()));
+        REQUIRE(values.size() == list.size());
+        REQUIRE(static_cast<int>(list.size()) == inserted - extracted);
+    }
+    SECTION("unique insertions of the same keys insert each key once") {
+        auto list = concurrent_skiplist<int>{};
+        auto successes = std::atomic<int>{0};
+        auto threads = std::vector<std::thread>{};
+        for (auto w = 0; w < writers; ++w) {
+            threads.emplace_back([&list, &successes] {
+                for (auto x = 0; x < 1000; ++x) {
+                    successes += list.insert_unique(x) ? 1 : 0;
+                }
+            });
+        }
+        for (auto & t : threads) {
+            t.join();
+        }
+        REQUIRE(successes == 1000);
+        auto expected = std::vector<int>(1000);
+        std::iota(expected.begin(), expected.end(), 0);
+        REQUIRE(collect(list) == expected);
+    }
+}
+
+TEST_CASE("concurrent_skiplist frees the extracted nodes once no thread can reach them", "[reclamation]")
+{
+    {
+        auto list = concurrent_skiplist<tracked>{};
+        for (auto i = 0; i < 1000; ++i) {
+            list.insert(i);
+        }
+        REQUIRE(tracked::live == 1000);
+        for (auto i = 0; i < 1000; ++i) {
+            list.erase(i);
+        }
+        // Nodes are freed on the way, but for the ones retired since the last reclamation
+        REQUIRE(tracked::live < 2 * static_cast<int>(concurrent_skiplist<tracked>::reclaim_threshold));
+        list.reclaim();
+        REQUIRE(tracked::live == 0);
+
+        auto errors = std::atomic<int>{0};
+        auto threads = std::vector<std::thread>{};
+        for (auto w = 0; w < 4; ++w) {
+            threads.emplace_back([&list, &errors, w] {
+                auto rng = std::mt19937{static_cast<unsigned>(w)};
+                for (auto i = 0; i < 5000; ++i) {
+                    auto const x = static_cast<int>(rng() % 256);
+                    if (i % 2 == 0) {
+                        list.insert(x);
+                    } else if (auto const found = list.extract(x); found.has_value() and found->value != x) {
+                        ++errors;
+                    }
+                    if (auto const found = list.find(x); found.has_value() and found->value != x) {
+                        ++errors;
+                    }
+                }
+            });
+        }
+        for (auto & t : threads) {
+            t.join();
+        }
+        REQUIRE(errors == 0);
+        list.reclaim();
+        REQUIRE(tracked::live == static_cast<int>(list.size()));
+        list.clear();
+        list.reclaim();
+        REQUIRE(tracked::live == 0);
+    }
+    REQUIRE(tracked::live == 0);
+}
@@ -0,0 +1,137 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : interval_test
+ * @created     : domenica ott 18, 2026 17:35:52 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/interval_tree.hpp"
+
+using forest::interval_tree;
+using interval = std::pair<int, int>;
+
+namespace
+{
+template <class Range>
+auto collect(Range const & r)
+{
+    auto res = std::vector<interval>{};
+    for (auto const & x : r) { res.push_back(x); }
+    return res;
+}
+
+struct span
+{
+    double from;
+    double to;
+};
+} // namespace
+
+template <>
+struct forest::interval_traits<span>
+{
+    using bound_type = double;
+    static constexpr double const & lower(span const & s) noexcept { return s.from; }
+    static constexpr double const & upper(span const & s) noexcept { return s.to; }
+};
+
+TEST_CASE("interval_trees can be constructed and assigned", "[construction][assignment]")
+{
+    auto _0 = interval_tree<interval>{{5, 10}, {1, 3}, {4, 4}, {1, 2}, {7, 20}};
+    REQUIRE(_0.size() == 5);
+    REQUIRE(std::is_sorted(_0.begin(), _0.end()));
+    REQUIRE(_0.front() == interval{1, 2});
+    REQUIRE(_0.max_upper() == 20);
+
+    auto _1 = _0;
+    REQUIRE(_1 == _0);
+    auto _2 = std::move(_1);
+    REQUIRE(_1.empty());
+    REQUIRE(_2 == _0);
+    _1 = {{0, 1}};
+    swap(_1, _2);
+    REQUIRE(_1.size() == 5);
+    REQUIRE(_2.max_upper() == 1);
+}
+
+TEST_CASE("interval_tree finds the overlapping intervals", "[overlap]")
+{
+    auto _0 = interval_tree<interval>{{5, 10}, {1, 3}, {4, 4}, {1, 2}, {7, 20}, {12, 15}, {0, 100}};
+
+    REQUIRE(collect(_0.overlapping(4)) == std::vector<interval>{{0, 100}, {4, 4}});
+    REQUIRE(collect(_0.overlapping(3, 5)) == std::vector<interval>{{0, 100}, {1, 3}, {4, 4}, {5, 10}});
+    REQUIRE(collect(_0.overlapping(11, 11)) == std::vector<interval>{{0, 100}, {7, 20}});
+    REQUIRE(collect(_0.overlapping(101, 200)).empty());
+    REQUIRE(_0.overlapping(-5, -1).empty());
+
+    SECTION("an overlapping interval can be erased through its position") {
+        auto const r = _0.overlapping(50);
+        REQUIRE(*r.begin() == interval{0, 100});
+        _0.erase(r.begin().base());
+        REQUIRE(_0.overlapping(50).empty());
+        REQUIRE(_0.max_upper() == 20);
+    }
+    SECTION("node handles move intervals between trees") {
+        auto _1 = interval_tree<interval>{};
+        _1.insert(_0.extract(interval{7, 20}));
+        REQUIRE(_0.size() == 6);
+        REQUIRE(_0.max_upper() == 100);
+        REQUIRE(collect(_1.overlapping(19)) == std::vector<interval>{{7, 20}});
+        REQUIRE(collect(_0.overlapping(16, 19)) == std::vector<interval>{{0, 100}});
+    }
+    SECTION("lookups use the lower bound") {
+        REQUIRE(_0.count(1) == 2);
+        REQUIRE(*_0.lower_bound(6) == interval{7, 20});
+        REQUIRE(_0.contains(interval{12, 15}));
+        REQUIRE(not _0.contains(interval{12, 16}));
+    }
+}
+
+TEST_CASE("interval_tree supports custom interval types", "[traits]")
+{
+    auto _0 = interval_tree<span>{};
+    _0.insert({0.5, 1.5});
+    _0.insert({1.0, 2.0});
+    _0.insert({3.0, 4.0});
+    auto const r = _0.overlapping(1.2);
+    REQUIRE(std::distance(r.begin(), r.end()) == 2);
+    REQUIRE(_0.max_upper() == 4.0);
+}
+
+TEST_CASE("interval_tree agrees with a linear scan", "[random]")
+{
+    auto rng = std::mt19937{11};
+    auto _0 = interval_tree<interval>{};
+    auto all = std::vector<interval>{};
+    auto const scan = [&all](int lo, int hi) {
+        auto res = std::vector<interval>{};
+        for (auto const & x : all) {
+            if (x.first <= hi and lo <= x.second) { res.push_back(x); }
+        }
+        std::sort(res.begin(), res.end());
+        return res;
+    };
+
+    for (auto round = 0; round < 1500; ++round) {
+        if (rng() % 4 == 0 and not all.empty()) {
+            auto const i = rng() % all.size();
+            _0.erase(_0.find(all[i]));
+            all.erase(all.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            auto const lo = static_cast<int>(rng() % 1000);
+            auto const x = interval{lo, lo + static_cast<int>(rng() % 100)};
+            _0.insert(x);
+            all.push_back(x);
+        }
+        auto const lo = static_cast<int>(rng() % 1100);
+        auto const hi = lo + static_cast<int>(rng() % 20);
+        REQUIRE(collect(_0.overlapping(lo, hi)) == scan(lo, hi));
+    }
+}
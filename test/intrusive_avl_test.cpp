@@ -0,0 +1,194 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : intrusive_avl_test
+ * @created     : domenica ott 18, 2026 14:51:09 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <list>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/intrusive_avl_tree.hpp"
+
+using forest::intrusive_avl_tree;
+
+namespace
+{
+struct item : forest::avl_hook
+{
+    int key;
+    explicit item(int k) : key{k} {}
+    friend bool operator<(item const & lhs, item const & rhs) { return lhs.key < rhs.key; }
+    friend bool operator<(item const & lhs, int rhs) { return lhs.key < rhs; }
+    friend bool operator<(int lhs, item const & rhs) { return lhs < rhs.key; }
+    friend bool operator==(item const & lhs, item const & rhs) { return lhs.key == rhs.key; }
+};
+
+struct member
+{
+    double payload = 0.;
+    int key;
+    forest::avl_hook hook;
+    explicit member(int k) : key{k} {}
+    friend bool operator<(member const & lhs, member const & rhs) { return lhs.key < rhs.key; }
+};
+
+template <class Tree>
+auto keys(Tree const & t)
+{
+    auto res = std::vector<int>{};
+    for (auto const & x : t) { res.push_back(x.key); }
+    return res;
+}
+} // namespace
+
+TEST_CASE("intrusive_avl_trees link existing objects", "[construction][insert]")
+{
+    auto items = std::list<item>{};
+    for (auto k : {8, 1, 64, 2, 32, 4, 16, 128}) { items.emplace_back(k); }
+
+    auto _0 = intrusive_avl_tree<item>{};
+    REQUIRE(_0.empty());
+    REQUIRE(_0.begin() == _0.end());
+    for (auto & x : items) {
+        REQUIRE(not x.is_linked());
+        _0.insert(x);
+        REQUIRE(x.is_linked());
+    }
+    REQUIRE(_0.size() == 8);
+    REQUIRE(keys(_0) == std::vector{1, 2, 4, 8, 16, 32, 64, 128});
+    REQUIRE(_0.front().key == 1);
+    REQUIRE(_0.back().key == 128);
+    REQUIRE(std::prev(_0.end())->key == 128);
+    REQUIRE(std::is_sorted(_0.rbegin(), _0.rend(), [](auto & a, auto & b) { return b < a; }));
+
+    SECTION("an element links to its own position") {
+        auto & x = *std::next(items.begin(), 2); // 64
+        REQUIRE(&*_0.iterator_to(x) == &x);
+        REQUIRE(std::next(_0.iterator_to(x))->key == 128);
+    }
+    SECTION("copies of an element are not linked") {
+        auto copy = items.front();
+        REQUIRE(not copy.is_linked());
+    }
+    SECTION("insert_unique does not link duplicates") {
+        auto dup = item{16};
+        auto const [it, inserted] = _0.insert_unique(dup);
+        REQUIRE(not inserted);
+        REQUIRE(&*it != &dup);
+        REQUIRE(not dup.is_linked());
+        auto fresh = item{17};
+        REQUIRE(_0.insert_unique(fresh).second);
+        REQUIRE(_0.size() == 9);
+        _0.erase(_0.iterator_to(fresh));
+    }
+    SECTION("the tree is movable and swappable") {
+        auto _1 = std::move(_0);
+        REQUIRE(_0.empty());
+        REQUIRE(keys(_1) == std::vector{1, 2, 4, 8, 16, 32, 64, 128});
+        auto _2 = intrusive_avl_tree<item>{};
+        swap(_1, _2);
+        REQUIRE(_1.empty());
+        REQUIRE(_2.size() == 8);
+        REQUIRE(keys(_2) == std::vector{1, 2, 4, 8, 16, 32, 64, 128});
+        _0 = std::move(_2);
+        REQUIRE(_0.size() == 8);
+        REQUIRE(_0.front().key == 1);
+    }
+    SECTION("clearing unlinks every element") {
+        _0.clear();
+        REQUIRE(_0.empty());
+        REQUIRE(std::none_of(items.begin(), items.end(), [](auto & x) { return x.is_linked(); }));
+    }
+    _0.clear();
+}
+
+TEST_CASE("One can search for objects in an intrusive_avl_tree", "[lookup]")
+{
+    auto items = std::vector<item>{};
+    for (auto k : {5, 3, 3, 9, 1, 7, 3}) { items.emplace_back(k); }
+    auto _0 = intrusive_avl_tree<item>{};
+    for (auto & x : items) { _0.insert(x); }
+
+    REQUIRE(_0.contains(9));
+    REQUIRE(not _0.contains(4));
+    REQUIRE(_0.find(7)->key == 7);
+    REQUIRE(_0.find(8) == _0.end());
+    REQUIRE(_0.count(3) == 3);
+    REQUIRE(_0.count(item{5}) == 1);
+    REQUIRE(_0.lower_bound(4)->key == 5);
+    REQUIRE(_0.upper_bound(3)->key == 5);
+    REQUIRE(_0.lower_bound(10) == _0.end());
+    auto const [f, l] = std::as_const(_0).equal_range(3);
+    REQUIRE(std::distance(f, l) == 3);
+    REQUIRE(std::all_of(f, l, [](auto & x) { return x.key == 3; }));
+    _0.clear();
+}
+
+TEST_CASE("It is possible to unlink elements from an intrusive_avl_tree", "[erase]")
+{
+    auto items = std::vector<item>{};
+    for (auto k = 0; k < 32; ++k) { items.emplace_back(k % 8); }
+    auto _0 = intrusive_avl_tree<item>{};
+    for (auto & x : items) { _0.insert(x); }
+
+    REQUIRE(_0.erase(item{3}) == 4);
+    REQUIRE(not _0.contains(3));
+    REQUIRE(_0.size() == 28);
+    REQUIRE(std::count_if(items.begin(), items.end(), [](auto & x) { return x.is_linked(); }) == 28);
+
+    auto it = _0.erase(_0.begin());
+    REQUIRE(it->key == 0);
+    _0.erase(_0.lower_bound(5), _0.end());
+    REQUIRE(_0.back().key == 4);
+    REQUIRE(_0.size() == 15);
+
+    auto disposed = 0;
+    while (not _0.empty()) {
+        _0.erase_and_dispose(std::prev(_0.end()), [&disposed](item * x) { ++disposed; REQUIRE(not x->is_linked()); });
+    }
+    REQUIRE(disposed == 15);
+    REQUIRE(_0.begin() == _0.end());
+}
+
+TEST_CASE("intrusive_avl_tree can use a member hook", "[hook]")
+{
+    using tree = intrusive_avl_tree<member, forest::member_hook<member, &member::hook>>;
+    auto items = std::vector<member>{};
+    for (auto k : {4, 2, 6, 1, 3, 5, 7}) { items.emplace_back(k); }
+    auto _0 = tree{};
+    for (auto & x : items) { _0.insert(x); }
+    REQUIRE(keys(_0) == std::vector{1, 2, 3, 4, 5, 6, 7});
+    REQUIRE(&*_0.find(items[2]) == &items[2]);
+    _0.clear_and_dispose([](member * m) { m->payload = 1.; });
+    REQUIRE(std::all_of(items.begin(), items.end(), [](auto & x) { return x.payload == 1.; }));
+}
+
+TEST_CASE("intrusive_avl_tree behaves like a std::multiset", "[random]")
+{
+    auto rng = std::mt19937{42};
+    auto items = std::vector<item>{};
+    for (auto i = 0; i < 512; ++i) { items.emplace_back(static_cast<int>(rng() % 128)); }
+
+    auto _0 = intrusive_avl_tree<item>{};
+    auto oracle = std::multiset<int>{};
+    for (auto round = 0; round < 4096; ++round) {
+        auto & x = items[rng() % items.size()];
+        if (x.is_linked()) {
+            _0.erase(_0.iterator_to(x));
+            oracle.erase(oracle.find(x.key));
+        } else {
+            _0.insert(x);
+            oracle.insert(x.key);
+        }
+    }
+    REQUIRE(_0.size() == oracle.size());
+    REQUIRE(std::equal(_0.begin(), _0.end(), oracle.begin(), oracle.end(),
+                       [](auto & a, auto b) { return a.key == b; }));
+    _0.clear();
+}
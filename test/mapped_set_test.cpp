@@ -0,0 +1,128 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : mapped_set_test
+ * @created     : lunedì ott 19, 2026 03:14:02 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/mapped_set.hpp"
+
+using forest::mapped_set;
+
+namespace
+{
+// A file in the temporary directory, removed at the end of the scope
+struct temporary_file
+{
+    std::filesystem::path path;
+
+    explicit temporary_file(char const * name) : path{std::filesystem::temp_directory_path() / name} {}
+    ~temporary_file() { std::filesystem::remove(path); }
+};
+
+template <class Tree>
+void write(Tree const & tree, std::filesystem::path const & path)
+{
+    auto os = std::ofstream{path, std::ios::binary};
+    forest::save_mapped(tree, os);
+    REQUIRE(os.good());
+}
+
+struct alignas(32) wide
+{
+    long long key;
+    char payload[24];
+    friend constexpr bool operator<(wide const & lhs, wide const & rhs) noexcept { return lhs.key < rhs.key; }
+};
+} // namespace
+
+TEST_CASE("mapped_set reads a tree written by save_mapped", "[lookup][iterators]")
+{
+    auto const file = temporary_file{"forest_mapped_set_test.bin"};
+    auto tree = forest::avl_tree<int>{};
+    auto rng = std::mt19937{42};
+    for (auto i = 0; i < 50'000; ++i) {
+        tree.insert(static_cast<int>(rng() % 20'000) * 2);
+    }
+    write(tree, file.path);
+
+    auto const set = mapped_set<int>{file.path};
+    REQUIRE(set.size() == tree.size());
+    REQUIRE(std::equal(set.begin(), set.end(), tree.begin(), tree.end()));
+    REQUIRE(std::equal(set.rbegin(), set.rend(), tree.rbegin(), tree.rend()));
+    REQUIRE(set.front() == tree.front());
+    REQUIRE(set.back() == tree.back());
+    REQUIRE(reinterpret_cast<std::uintptr_t>(set.data()) % 64 == 0);
+
+    for (auto x = -1; x < 40'002; x += 7) {
+        REQUIRE(set.contains(x) == tree.contains(x));
+        REQUIRE(set.count(x) == tree.count(x));
+        auto const lb = set.lower_bound(x);
+        auto const tlb = tree.lower_bound(x);
+        REQUIRE((lb == set.end()) == (tlb == tree.end()));
+        if (lb != set.end()) {
+            REQUIRE(*lb == *tlb);
+        }
+        auto const ub = set.upper_bound(x);
+        REQUIRE(ub - set.begin() == std::distance(tree.begin(), tree.upper_bound(x)));
+        auto const [f, l] = set.equal_range(x);
+        REQUIRE(f == lb);
+        REQUIRE(l == ub);
+        REQUIRE((set.find(x) != set.end()) == tree.contains(x));
+    }
+}
+
+TEST_CASE("mapped_set handles empty trees, alignment and moves", "[construction]")
+{
+    auto const file = temporary_file{"forest_mapped_set_test_2.bin"};
+    SECTION("an empty tree") {
+        write(forest::avl_tree<int>{}, file.path);
+        auto const set = mapped_set<int>{file.path};
+        REQUIRE(set.empty());
+        REQUIRE(set.begin() == set.end());
+        REQUIRE(not set.contains(0));
+    }
+    SECTION("over-aligned elements") {
+        auto tree = forest::avl_tree<wide>{};
+        for (auto i = 0ll; i < 100; ++i) {
+            tree.insert(wide{99 - i, {}});
+        }
+        write(tree, file.path);
+        auto set = mapped_set<wide>{file.path};
+        REQUIRE(reinterpret_cast<std::uintptr_t>(set.data()) % alignof(wide) == 0);
+        REQUIRE(set.find(wide{42, {}})->key == 42);
+
+        auto moved = std::move(set);
+        REQUIRE(set.empty());
+        REQUIRE(moved.size() == 100);
+        REQUIRE(moved.lower_bound(wide{50, {}})->key == 50);
+    }
+}
+
+TEST_CASE("mapped_set rejects files it cannot read", "[construction]")
+{
+    auto const file = temporary_file{"forest_mapped_set_test_3.bin"};
+    REQUIRE_THROWS_AS(mapped_set<int>{file.path}, std::system_error);
+
+    write(forest::avl_tree<int>{1, 2, 3}, file.path);
+    REQUIRE_THROWS_AS(mapped_set<long long>{file.path}, forest::archive_error);
+
+    std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 1);
+    REQUIRE_THROWS_AS(mapped_set<int>{file.path}, forest::archive_error);
+
+    {
+        auto os = std::ofstream{file.path, std::ios::binary};
+        os << "definitely not a mapped tree, but long enough";
+    }
+    REQUIRE_THROWS_AS(mapped_set<int>{file.path}, forest::archive_error);
+}
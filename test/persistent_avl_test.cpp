@@ -0,0 +1,229 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : persistent_avl_test
+ * @created     : domenica ott 18, 2026 22:14:53 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/persistent_avl_tree.hpp"
+
+using forest::persistent_avl_tree;
+
+namespace
+{
+// Counts the allocations done through it and its copies
+template <typename T>
+struct counting_allocator
+{
+    using value_type = T;
+
+    std::size_t * count;
+
+    explicit counting_allocator(std::size_t * c) noexcept : count{c} {}
+    template <typename U>
+    counting_allocator(counting_allocator<U> const & other) noexcept : count{other.count} {}
+
+    T * allocate(std::size_t n) { ++*count; return std::allocator<T>{}.allocate(n); }
+    void deallocate(T * p, std::size_t n) noexcept { std::allocator<T>{}.deallocate(p, n); }
+
+    friend bool operator==(counting_allocator const & lhs, counting_allocator const & rhs) noexcept
+    { return lhs.count == rhs.count; }
+};
+
+template <class Tree>
+auto collect(Tree const & tree)
+{
+    return std::vector<int>(tree.begin(), tree.end());
+}
+} // namespace
+
+SCENARIO("persistent_avl_tree behaves as a multiset", "[lookup][modifiers][iterators]")
+{
+    GIVEN("a tree with some repeated values") {
+        auto tree = persistent_avl_tree<int>{8, 3, 5, 1, 3, 9, 7, 3, 2, 6, 4, 0};
+
+        THEN("it is sorted, and can be walked both ways") {
+            REQUIRE(tree.size() == 12);
+            REQUIRE(collect(tree) == std::vector<int>{0, 1, 2, 3, 3, 3, 4, 5, 6, 7, 8, 9});
+            REQUIRE(std::vector<int>(tree.rbegin(), tree.rend()) == std::vector<int>{9, 8, 7, 6, 5, 4, 3, 3, 3, 2, 1, 0});
+            REQUIRE(tree.front() == 0);
+            REQUIRE(tree.back() == 9);
+        }
+        THEN("lookups find the elements") {
+            REQUIRE(tree.contains(5));
+            REQUIRE(not tree.contains(42));
+            REQUIRE(*tree.find(7) == 7);
+            REQUIRE(tree.find(42) == tree.end());
+            REQUIRE(tree.count(3) == 3);
+            REQUIRE(std::distance(tree.begin(), tree.lower_bound(3)) == 3);
+            REQUIRE(std::distance(tree.begin(), tree.upper_bound(3)) == 6);
+            REQUIRE(tree.lower_bound(10) == tree.end());
+            REQUIRE(*std::prev(tree.lower_bound(10)) == 9);
+        }
+        THEN("insert returns the position of the new element, after its equivalents") {
+            auto const it = tree.insert(3);
+            REQUIRE(std::distance(tree.begin(), it) == 6);
+            REQUIRE(*it == 3);
+            REQUIRE(*std::next(it) == 4);
+            REQUIRE(tree.count(3) == 4);
+        }
+        THEN("erase removes the elements") {
+            auto const next = tree.erase(tree.find(5));
+            REQUIRE(*next == 6);
+            REQUIRE(tree.erase(3) == 3);
+            REQUIRE(tree.erase(3) == 0);
+            REQUIRE(collect(tree) == std::vector<int>{0, 1, 2, 4, 6, 7, 8, 9});
+            REQUIRE(erase_if(tree, [](int x) { return x % 2 == 0; }) == 5);
+            REQUIRE(collect(tree) == std::vector<int>{1, 7, 9});
+            tree.clear();
+            REQUIRE(tree.empty());
+            REQUIRE(tree.begin() == tree.end());
+        }
+    }
+}
+
+SCENARIO("persistent_avl_tree snapshots are not affected by updates", "[snapshot]")
+{
+    GIVEN("a tree and a snapshot of it") {
+        auto tree = persistent_avl_tree<int>{};
+        for (auto i = 0; i < 100; ++i) {
+            tree.insert(i);
+        }
+        auto const snapshot = tree.snapshot();
+        REQUIRE(snapshot == tree);
+
+        WHEN("the tree is updated") {
+            for (auto i = 0; i < 100; i += 2) {
+                tree.erase(i);
+            }
+            tree.insert(1000);
+            THEN("the snapshot keeps the old values") {
+                REQUIRE(snapshot.size() == 100);
+                auto expected = std::vector<int>(100);
+                std::iota(expected.begin(), expected.end(), 0);
+                REQUIRE(collect(snapshot) == expected);
+                REQUIRE(tree.size() == 51);
+                REQUIRE(tree.back() == 1000);
+                REQUIRE(snapshot != tree);
+            }
+        }
+        WHEN("the snapshot is updated") {
+            auto other = snapshot;
+            other.clear();
+            other.insert(-1);
+            THEN("the tree is unchanged") {
+                REQUIRE(tree.size() == 100);
+                REQUIRE(tree == snapshot);
+                REQUIRE(collect(other) == std::vector<int>{-1});
+            }
+        }
+    }
+}
+
+SCENARIO("persistent_avl_tree copies only the updated path", "[snapshot][allocator]")
+{
+    auto allocations = std::size_t{0};
+    using tree_t = persistent_avl_tree<int, std::less<>, counting_allocator<int>>;
+    auto tree = tree_t{counting_allocator<int>{&allocations}};
+    for (auto i = 0; i < 1024; ++i) {
+        tree.insert(i);
+    }
+    REQUIRE(allocations == 1024);
+
+    auto const snapshot = tree.snapshot();
+    auto const copy = tree;
+    REQUIRE(allocations == 1024);
+
+    tree.insert(512);
+    // The new node, the path to it and at most a couple of siblings touched by a rotation
+    REQUIRE(allocations > 1025);
+    REQUIRE(allocations <= 1025 + 2 * 12);
+    auto const after_insert = allocations;
+    tree.insert(513);
+    REQUIRE(allocations <= after_insert + 1 + 2 * 12);
+    auto const after_second_insert = allocations;
+
+    tree.erase(100);
+    REQUIRE(allocations <= after_second_insert + 3 * 12);
+    REQUIRE(snapshot.size() == 1024);
+    REQUIRE(copy == snapshot);
+    REQUIRE(tree.size() == 1025);
+}
+
+SCENARIO("persistent_avl_tree agrees with std::multiset", "[random]")
+{
+    auto rng = std::mt19937{23};
+    auto tree = persistent_avl_tree<int>{};
+    auto model = std::multiset<int>{};
+    auto versions = std::vector<std::pair<persistent_avl_tree<int>, std::multiset<int>>>{};
+    for (auto round = 0; round < 4000; ++round) {
+        auto const x = static_cast<int>(rng() % 300);
+        if (rng() % 3 == 0) {
+            REQUIRE(tree.erase(x) == model.erase(x));
+        } else {
+            tree.insert(x);
+            model.insert(x);
+        }
+        if (round % 100 == 0) {
+            versions.emplace_back(tree.snapshot(), model);
+        }
+        auto const lb = tree.lower_bound(x);
+        REQUIRE(std::distance(tree.begin(), lb) == std::distance(model.begin(), model.lower_bound(x)));
+        REQUIRE(tree.count(x) == static_cast<std::ptrdiff_t>(model.count(x)));
+    }
+    REQUIRE(tree.size() == model.size());
+    REQUIRE(collect(tree) == std::vector<int>(model.begin(), model.end()));
+    for (auto const & [version, expected] : versions) {
+        REQUIRE(collect(version) == std::vector<int>(expected.begin(), expected.end()));
+    }
+}
+
+SCENARIO("persistent_avl_tree snapshots can be read while the tree is updated", "[snapshot][concurrency]")
+{
+    constexpr auto n = 2048;
+    auto tree = persistent_avl_tree<int>{};
+    for (auto i = 0; i < n; ++i) {
+        tree.insert(i * 2);
+    }
+
+    auto done = std::atomic<bool>{false};
+    auto errors = std::atomic<int>{0};
+    auto readers = std::vector<std::thread>{};
+    for (auto r = 0; r < 4; ++r) {
+        readers.emplace_back([&errors, &done, snapshot = tree.snapshot()] {
+            while (not done.load()) {
+                auto expected = 0;
+                for (auto x : snapshot) {
+                    errors += x != expected ? 1 : 0;
+                    expected += 2;
+                }
+                errors += expected != 2 * n ? 1 : 0;
+            }
+        });
+    }
+    auto rng = std::mt19937{5};
+    for (auto round = 0; round < 20000; ++round) {
+        auto const x = static_cast<int>(rng() % (2 * n));
+        if (rng() % 2 == 0) {
+            tree.insert(x);
+        } else {
+            tree.erase(x);
+        }
+    }
+    done = true;
+    for (auto & t : readers) {
+        t.join();
+    }
+    REQUIRE(errors == 0);
+    REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+}
@@ -0,0 +1,190 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : serialization_test
+ * @created     : lunedì ott 19, 2026 02:10:33 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <bit>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/avl_map.hpp"
+#include "forest/avl_tree.hpp"
+#include "forest/binary_search_tree.hpp"
+#include "forest/serialization.hpp"
+#include "forest/threaded_avl_tree.hpp"
+
+using forest::avl_tree;
+
+namespace
+{
+// Counts the comparisons, to tell that `load` makes none and that the loaded tree is balanced
+struct counting_less
+{
+    static inline std::size_t comparisons = 0;
+    template <typename T>
+    bool operator()(T const & lhs, T const & rhs) const { ++comparisons; return lhs < rhs; }
+};
+
+// Trivially copyable, but not default constructible
+struct point
+{
+    int x, y;
+    constexpr point(int x, int y) noexcept : x{x}, y{y} {}
+    friend constexpr bool operator<(point const & lhs, point const & rhs) noexcept
+    { return lhs.x < rhs.x or (lhs.x == rhs.x and lhs.y < rhs.y); }
+    friend constexpr bool operator==(point const &, point const &) noexcept = default;
+};
+
+// Not trivially copyable: its traits fail after a given number of elements
+struct fragile
+{
+    static inline int countdown = -1;
+    static inline int live = 0;
+    int value;
+
+    fragile(int v) : value{v} { ++live; }
+    fragile(fragile const & other) : value{other.value} { ++live; }
+    ~fragile() { --live; }
+    friend bool operator<(fragile const & lhs, fragile const & rhs) noexcept { return lhs.value < rhs.value; }
+};
+
+template <class Tree>
+auto round_trip(Tree const & tree)
+{
+    auto stream = std::stringstream{};
+    forest::save(tree, stream);
+    REQUIRE(stream.good());
+    return forest::load<Tree>(stream);
+}
+} // namespace
+
+template <>
+struct forest::serial_traits<fragile>
+{
+    static void save(std::ostream & os, fragile const & f) { detail::_save_value(os, f.value); }
+    static fragile load(std::istream & is)
+    {
+        if (fragile::countdown-- == 0) {
+            throw std::runtime_error{"fragile"};
+        }
+        return fragile{detail::_load_value<int>(is)};
+    }
+};
+
+TEST_CASE("Trees can be saved and loaded back", "[save][load]")
+{
+    SECTION("trivially copyable elements") {
+        auto rng = std::mt19937{42};
+        auto tree = avl_tree<int>{};
+        for (auto i = 0; i < 100'000; ++i) {
+            tree.insert(static_cast<int>(rng() % 50'000));
+        }
+        REQUIRE(round_trip(tree) == tree);
+        REQUIRE(round_trip(avl_tree<int>{}).empty());
+
+        auto points = forest::binary_search_tree<point>{{3, 1}, {1, 2}, {1, 1}, {2, 5}};
+        REQUIRE(round_trip(points) == points);
+    }
+    SECTION("strings and maps, through serial_traits") {
+        auto words = avl_tree<std::string>{"pear", "apple", "", "fig", "apple"};
+        REQUIRE(round_trip(words) == words);
+
+        auto map = forest::avl_map<std::string, int>{{"one", 1}, {"two", 2}, {"three", 3}};
+        auto const loaded = round_trip(map);
+        REQUIRE(loaded == map);
+        REQUIRE(loaded.at("three") == 3);
+
+        auto multimap = forest::avl_multimap<int, std::string>{{1, "a"}, {0, "b"}, {1, "c"}};
+        REQUIRE(round_trip(multimap) == multimap);
+    }
+    SECTION("trees which cannot be linked directly insert the elements") {
+        auto tree = forest::threaded_avl_tree<int>{5, 3, 8, 1, 3};
+        auto const loaded = round_trip(tree);
+        REQUIRE(std::equal(loaded.begin(), loaded.end(), tree.begin(), tree.end()));
+    }
+}
+
+TEST_CASE("Loaded trees are balanced and built without comparisons", "[load]")
+{
+    constexpr auto size = (1 << 16) - 1;
+    auto tree = avl_tree<int, counting_less>{};
+    for (auto i = 0; i < size; ++i) {
+        tree.insert(i);
+    }
+    auto stream = std::stringstream{};
+    forest::save(tree, stream);
+
+    counting_less::comparisons = 0;
+    auto loaded = forest::load<avl_tree<int, counting_less>>(stream);
+    REQUIRE(counting_less::comparisons == 0);
+    REQUIRE(loaded.size() == size);
+    REQUIRE(loaded.front() == 0);
+    REQUIRE(loaded.back() == size - 1);
+
+    // A perfect tree of 2^16 - 1 elements has 16 levels
+    for (auto x : {0, 1, size / 2, size - 1, size}) {
+        counting_less::comparisons = 0;
+        [[maybe_unused]] auto const it = loaded.lower_bound(x);
+        REQUIRE(counting_less::comparisons <= 16);
+    }
+
+    // The heights are right, so the tree keeps working as an avl_tree
+    auto model = std::multiset<int>{loaded.begin(), loaded.end()};
+    auto rng = std::mt19937{7};
+    for (auto i = 0; i < 20'000; ++i) {
+        auto const x = static_cast<int>(rng() % (2 * size));
+        if (i % 2 == 0) {
+            loaded.insert(x);
+            model.insert(x);
+        } else {
+            loaded.erase(x);
+            model.erase(x);
+        }
+    }
+    REQUIRE(std::equal(loaded.begin(), loaded.end(), model.begin(), model.end()));
+    counting_less::comparisons = 0;
+    [[maybe_unused]] auto const it = loaded.lower_bound(size);
+    REQUIRE(counting_less::comparisons <= 24);
+}
+
+TEST_CASE("Loading fails cleanly on bad streams", "[load]")
+{
+    auto tree = avl_tree<int>{1, 2, 3, 4, 5};
+    auto stream = std::stringstream{};
+    forest::save(tree, stream);
+    auto const bytes = stream.str();
+
+    SECTION("the header must match") {
+        auto other = std::stringstream{"not a tree at all"};
+        REQUIRE_THROWS_AS(forest::load<avl_tree<int>>(other), forest::archive_error);
+        auto wrong_type = std::stringstream{bytes};
+        REQUIRE_THROWS_AS(forest::load<avl_tree<long long>>(wrong_type), forest::archive_error);
+        auto wrong_kind = std::stringstream{bytes};
+        REQUIRE_THROWS_AS(forest::load<avl_tree<std::string>>(wrong_kind), forest::archive_error);
+    }
+    SECTION("a truncated stream throws") {
+        auto truncated = std::stringstream{bytes.substr(0, bytes.size() - 1)};
+        REQUIRE_THROWS_AS(forest::load<avl_tree<int>>(truncated), forest::archive_error);
+    }
+    SECTION("the elements read before a failure are freed") {
+        auto fragiles = avl_tree<fragile>{};
+        for (auto i = 0; i < 10; ++i) {
+            fragiles.insert(i);
+        }
+        auto saved = std::stringstream{};
+        forest::save(fragiles, saved);
+        auto const live = fragile::live;
+        fragile::countdown = 6;
+        REQUIRE_THROWS_AS(forest::load<avl_tree<fragile>>(saved), std::runtime_error);
+        REQUIRE(fragile::live == live);
+        fragile::countdown = -1;
+    }
+}
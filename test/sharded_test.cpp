@@ -0,0 +1,153 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : sharded_test
+ * @created     : domenica ott 18, 2026 23:34:20 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/sharded_tree.hpp"
+#include "forest/threaded_avl_tree.hpp"
+
+using forest::sharded_tree;
+
+SCENARIO("sharded_tree behaves as a multiset", "[lookup][modifiers][iterators]")
+{
+    GIVEN("a tree split in 4 shards") {
+        auto tree = sharded_tree<int>{{8, 3, 5, 1, 3, 9, 7, 3, 2, 6, 4, 0}, 4};
+        REQUIRE(tree.shard_count() == 4);
+        REQUIRE(tree.split_points().size() == 3);
+
+        THEN("iterators visit the elements of all the shards in order") {
+            REQUIRE(tree.size() == 12);
+            REQUIRE(std::vector<int>(tree.begin(), tree.end()) == std::vector<int>{0, 1, 2, 3, 3, 3, 4, 5, 6, 7, 8, 9});
+            REQUIRE(std::vector<int>(tree.rbegin(), tree.rend()) == std::vector<int>{9, 8, 7, 6, 5, 4, 3, 3, 3, 2, 1, 0});
+        }
+        THEN("lookups find the elements, and bounds cross the shards") {
+            REQUIRE(tree.contains(5));
+            REQUIRE(not tree.contains(42));
+            REQUIRE(tree.count(3) == 3);
+            REQUIRE(tree.find(7) == 7);
+            REQUIRE(not tree.find(-1).has_value());
+            for (auto x = -1; x < 10; ++x) {
+                REQUIRE(tree.lower_bound(x) == std::max(x, 0));
+                REQUIRE(tree.upper_bound(x) == (x < 9 ? std::optional{x + 1} : std::nullopt));
+            }
+        }
+        THEN("elements can be inserted and erased") {
+            REQUIRE(not tree.insert_unique(3));
+            REQUIRE(tree.insert_unique(10));
+            tree.emplace(-5);
+            REQUIRE(tree.erase(3) == 3);
+            REQUIRE(tree.erase(3) == 0);
+            REQUIRE(std::vector<int>(tree.begin(), tree.end()) == std::vector<int>{-5, 0, 1, 2, 4, 5, 6, 7, 8, 9, 10});
+            tree.clear();
+            REQUIRE(tree.empty());
+            REQUIRE(tree.begin() == tree.end());
+            REQUIRE(not tree.lower_bound(0).has_value());
+        }
+    }
+    GIVEN("a tree with explicit split points") {
+        auto tree = sharded_tree<int>{std::vector<int>{100, 200}};
+        for (auto i = 0; i < 300; i += 7) {
+            tree.insert(i);
+        }
+        THEN("the split points are kept") {
+            REQUIRE(tree.shard_count() == 3);
+            REQUIRE(tree.split_points() == std::vector<int>{100, 200});
+            REQUIRE(tree.lower_bound(99) == 105);
+            REQUIRE(tree.upper_bound(196) == 203);
+        }
+    }
+}
+
+SCENARIO("sharded_tree rebalances its shards from a sample", "[rebalance]")
+{
+    GIVEN("a tree whose elements all went to the same shard") {
+        auto tree = sharded_tree<int, std::less<>, std::allocator<int>, forest::threaded_avl_tree>{
+            std::vector<int>{1'000'000, 2'000'000, 3'000'000}
+        };
+        for (auto i = 0; i < 4000; ++i) {
+            tree.insert(i);
+        }
+        WHEN("it is rebalanced") {
+            tree.rebalance();
+            THEN("the split points divide the elements evenly, and no element is lost") {
+                auto const splits = tree.split_points();
+                REQUIRE(splits.size() == 3);
+                for (auto k = 0u; k < 3; ++k) {
+                    REQUIRE(std::abs(splits[k] - static_cast<int>(1000 * (k + 1))) < 100);
+                }
+                auto expected = std::vector<int>(4000);
+                std::iota(expected.begin(), expected.end(), 0);
+                REQUIRE(std::vector<int>(tree.begin(), tree.end()) == expected);
+                REQUIRE(tree.size() == 4000);
+            }
+        }
+    }
+    GIVEN("a tree growing on one end") {
+        auto tree = sharded_tree<int>(4);
+        auto model = std::multiset<int>{};
+        for (auto i = 0; i < 20000; ++i) {
+            tree.insert(i / 3);
+            model.insert(i / 3);
+        }
+        THEN("the writers rebalanced it on the way") {
+            auto const splits = tree.split_points();
+            REQUIRE(splits.size() == 3);
+            REQUIRE(std::is_sorted(splits.begin(), splits.end()));
+            REQUIRE(splits.back() > 3000);
+            REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+            for (auto x : {0, 1500, 6666}) {
+                REQUIRE(tree.count(x) == static_cast<std::ptrdiff_t>(model.count(x)));
+            }
+        }
+    }
+}
+
+SCENARIO("sharded_tree can be written by many threads", "[concurrency]")
+{
+    constexpr auto writers = 8;
+    constexpr auto per_writer = 5000;
+    auto tree = sharded_tree<int>(static_cast<std::size_t>(writers));
+
+    auto errors = std::atomic<int>{0};
+    auto threads = std::vector<std::thread>{};
+    for (auto w = 0; w < writers; ++w) {
+        threads.emplace_back([&tree, &errors, w] {
+            auto rng = std::mt19937{static_cast<unsigned>(w)};
+            for (auto i = 0; i < per_writer; ++i) {
+                // Mostly disjoint ranges, with some overlap with the neighbours
+                auto const x = w * per_writer + static_cast<int>(rng() % (per_writer + per_writer / 4));
+                tree.insert(x);
+                if (i % 4 == 0) {
+                    tree.erase(x);
+                }
+                if (auto const lb = tree.lower_bound(x); lb.has_value() and *lb < x) {
+                    ++errors;
+                }
+            }
+        });
+    }
+    for (auto & t : threads) {
+        t.join();
+    }
+    REQUIRE(errors == 0);
+
+    auto values = std::vector<int>{};
+    tree.for_each([&values](int x) { values.push_back(x); });
+    REQUIRE(values.size() == tree.size());
+    REQUIRE(std::is_sorted(values.begin(), values.end()));
+    REQUIRE(std::vector<int>(tree.begin(), tree.end()) == values);
+}
@@ -0,0 +1,183 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : splay_test
+ * @created     : lunedì ott 19, 2026 10:02:44 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/shape_report.hpp"
+#include "forest/splay_tree.hpp"
+
+using forest::splay_tree;
+
+template <class Splay>
+using counted_splay_tree = splay_tree<int, std::less<>, std::allocator<int>, forest::tree_stats, Splay>;
+
+TEST_CASE("splay_trees can be constructed and assigned", "[construction][assignment]")
+{
+    auto empty = splay_tree<int>{};
+    REQUIRE(empty.empty());
+    REQUIRE(empty.find(3) == empty.end());
+    REQUIRE(empty.lower_bound(3) == empty.end());
+
+    auto tree = splay_tree{5, 3, 1, 4, 1};
+    REQUIRE(tree.size() == 5);
+    REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector{1, 1, 3, 4, 5});
+
+    auto copy = tree;
+    REQUIRE(copy == tree);
+    auto moved = std::move(copy);
+    REQUIRE(moved == tree);
+    REQUIRE(copy.empty());
+
+    moved = {2, 7};
+    REQUIRE(std::vector(moved.begin(), moved.end()) == std::vector{2, 7});
+    REQUIRE(moved.capacity() == 5);
+}
+
+TEST_CASE("splay-tree inserts, finds and erases elements", "[insert][lookup][erase]")
+{
+    auto tree = splay_tree<std::string>{"b", "d", "f"};
+    GIVEN("equivalent elements") {
+        tree.insert("d");
+        tree.emplace(1, 'd');
+        THEN("they can be counted and erased together") {
+            REQUIRE(tree.count("d") == 3);
+            REQUIRE(tree.erase("d") == 3);
+            REQUIRE(tree.find("d") == tree.end());
+            REQUIRE(tree.size() == 2);
+        }
+    }
+    GIVEN("unique insertions") {
+        REQUIRE(*tree.insert_unique(std::string{"b"}) == "b");
+        REQUIRE(tree.try_emplace_unique(std::string_view{"c"}, "c").second);
+        REQUIRE_FALSE(tree.emplace_unique(1, 'f').second);
+        THEN("only the new elements are inserted") {
+            REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector<std::string>{"b", "c", "d", "f"});
+        }
+    }
+    GIVEN("elements modified in place, extracted and inserted back") {
+        auto it = tree.modify(tree.find("b"), [](auto & s) { s = "z"; });
+        REQUIRE(std::prev(tree.end()) == it);
+        tree.insert(tree.begin(), tree.extract(it));
+        THEN("the order is kept") {
+            REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector<std::string>{"d", "f", "z"});
+        }
+    }
+}
+
+TEST_CASE("splay-tree moves the elements it finds toward the root", "[splay]")
+{
+    auto tree = counted_splay_tree<forest::full_splay>{};
+    for (auto i = 0; i < 1000; ++i) {
+        tree.insert(i);
+    }
+    GIVEN("a tree filled with sorted values") {
+        THEN("each insertion took a single rotation, leaving a path") {
+            REQUIRE(tree.stats().rotations == 999);
+            REQUIRE(forest::shape_report(tree).height == 1000);
+        }
+    }
+    WHEN("an element is found") {
+        auto const it = tree.find(0);
+        THEN("it becomes the root, and the path is halved") {
+            REQUIRE(depth(it) == 0);
+            REQUIRE(forest::shape_report(tree).height < 520);
+        }
+    }
+    WHEN("a missing element is looked for") {
+        REQUIRE(tree.find(-1) == tree.end());
+        THEN("the last node reached becomes the root") {
+            REQUIRE(depth(tree.begin()) == 0);
+        }
+    }
+    WHEN("an element is found in a const tree") {
+        tree.reset_stats();
+        auto const & view = std::as_const(tree);
+        auto const it = view.find(0);
+        THEN("nothing moves") {
+            REQUIRE(depth(it) == 999);
+            REQUIRE(tree.stats().rotations == 0);
+            REQUIRE(view.lower_bound(500) == tree.find(500));
+            REQUIRE(depth(view.lower_bound(500)) == 0);
+        }
+    }
+    WHEN("bounds are looked for") {
+        auto const lo = tree.lower_bound(250);
+        REQUIRE(depth(lo) == 0);
+        auto const hi = tree.upper_bound(1000);
+        THEN("the element found, or the last one, is splayed") {
+            REQUIRE(*lo == 250);
+            REQUIRE(hi == tree.end());
+            REQUIRE(depth(std::prev(tree.end())) == 0);
+        }
+    }
+}
+
+TEST_CASE("semi-splaying writes fewer links", "[splay][semi]")
+{
+    auto full = counted_splay_tree<forest::full_splay>{};
+    auto semi = counted_splay_tree<forest::semi_splay>{};
+    for (auto i = 0; i < 1000; ++i) {
+        full.insert(i);
+        semi.insert(i);
+    }
+    full.reset_stats();
+    semi.reset_stats();
+    REQUIRE(*full.find(0) == 0);
+    REQUIRE(*semi.find(0) == 0);
+    THEN("the element climbs only part of the way, with about half of the rotations") {
+        REQUIRE(full.stats().rotations == 999);
+        REQUIRE(semi.stats().rotations < 600);
+        REQUIRE(depth(semi.find(0)) < 999);
+        REQUIRE(forest::shape_report(semi).height < 600);
+    }
+}
+
+TEST_CASE("splay-tree stays sorted under random updates and lookups", "[random]")
+{
+    auto rng = std::mt19937{3};
+    auto values = std::uniform_int_distribution<int>{0, 4095};
+    auto full = splay_tree<int>{};
+    auto semi = splay_tree<int, std::less<>, std::allocator<int>, forest::no_stats, forest::semi_splay>{};
+    auto reference = std::multiset<int>{};
+    for (auto round = 0; round < 20000; ++round) {
+        auto const x = values(rng);
+        switch (round % 4) {
+        case 0:
+        case 1:
+            full.insert(x);
+            semi.insert(x);
+            reference.insert(x);
+            break;
+        case 2:
+            REQUIRE((full.find(x) != full.end()) == reference.contains(x));
+            REQUIRE((semi.find(x) != semi.end()) == reference.contains(x));
+            break;
+        default:
+            if (auto const it = full.lower_bound(x); it != full.end()) {
+                reference.erase(reference.find(*it));
+                full.erase(it);
+                semi.erase(semi.lower_bound(x));
+            }
+        }
+        if (round % 1000 == 999) {
+            REQUIRE(std::equal(full.begin(), full.end(), reference.begin(), reference.end()));
+            REQUIRE(std::equal(semi.begin(), semi.end(), reference.begin(), reference.end()));
+        }
+    }
+    full.erase(full.begin(), full.lower_bound(2048));
+    REQUIRE(full.front() >= 2048);
+    REQUIRE(std::equal(full.begin(), full.end(), reference.lower_bound(2048), reference.end()));
+}
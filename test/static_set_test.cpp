@@ -0,0 +1,104 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : static_set_test
+ * @created     : lunedì ott 19, 2026 05:34:50 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+
+#include "catch2/catch.hpp"
+#include "forest/static_set.hpp"
+
+using forest::static_set;
+using namespace std::string_view_literals;
+
+namespace
+{
+constexpr auto opcodes = static_set{std::to_array({"mov"sv, "add"sv, "jmp"sv, "cmp"sv, "sub"sv, "call"sv, "ret"sv})};
+
+static_assert(opcodes.size() == 7);
+static_assert(opcodes.contains("call"sv));
+static_assert(not opcodes.contains("nop"sv));
+static_assert(*opcodes.begin() == "add"sv);
+static_assert(opcodes.back() == "sub"sv);
+static_assert(*opcodes.lower_bound("d"sv) == "jmp"sv);
+static_assert(opcodes.upper_bound("zzz"sv) == opcodes.end());
+
+constexpr auto descending = static_set{std::array{1, 2, 3, 4, 5}, std::greater<>{}};
+static_assert(*descending.begin() == 5);
+static_assert(*descending.lower_bound(3) == 3 and *descending.upper_bound(3) == 2);
+
+// Every size from 0 to `Max` lays the elements out correctly
+template <std::size_t... Ns>
+constexpr bool iterates_in_order(std::index_sequence<Ns...>)
+{
+    auto check = []<std::size_t N>(std::integral_constant<std::size_t, N>) {
+        auto values = std::array<int, N>{};
+        for (std::size_t i = 0; i < N; ++i) {
+            values[i] = static_cast<int>(N - i) * 2;
+        }
+        auto const set = static_set{values};
+        auto expected = 2;
+        for (auto x : set) {
+            if (x != expected) {
+                return false;
+            }
+            expected += 2;
+        }
+        return expected == static_cast<int>(N) * 2 + 2;
+    };
+    return (check(std::integral_constant<std::size_t, Ns>{}) and ...);
+}
+static_assert(iterates_in_order(std::make_index_sequence<20>{}));
+} // namespace
+
+TEST_CASE("static_set is built at compile time", "[construction]")
+{
+    REQUIRE(std::is_sorted(opcodes.begin(), opcodes.end()));
+    REQUIRE(std::distance(opcodes.begin(), opcodes.end()) == 7);
+    REQUIRE(std::equal(opcodes.rbegin(), opcodes.rend(), std::set{"mov"sv, "add"sv, "jmp"sv, "cmp"sv, "sub"sv, "call"sv,
+                                                                   "ret"sv}.rbegin()));
+    REQUIRE(static_set<int, 0>{{}}.empty());
+    REQUIRE(static_set<int, 0>{{}}.begin() == static_set<int, 0>{{}}.end());
+    REQUIRE_THROWS_AS((static_set{std::array{1, 2, 2}}), std::invalid_argument);
+}
+
+TEST_CASE("static_set finds what a std::set finds", "[lookup]")
+{
+    auto rng = std::mt19937{42};
+    auto values = std::array<int, 1000>{};
+    std::iota(values.begin(), values.end(), 0);
+    std::transform(values.begin(), values.end(), values.begin(), [](int x) { return x * 3; });
+    std::shuffle(values.begin(), values.end(), rng);
+    auto const set = static_set{values};
+    auto const model = std::set<int>(values.begin(), values.end());
+
+    REQUIRE(std::equal(set.begin(), set.end(), model.begin(), model.end()));
+    REQUIRE(std::equal(set.rbegin(), set.rend(), model.rbegin(), model.rend()));
+    for (int x = -2; x < 3002; ++x) {
+        REQUIRE(set.contains(x) == model.contains(x));
+        REQUIRE(set.count(x) == model.count(x));
+        auto const lower = set.lower_bound(x);
+        auto const upper = set.upper_bound(x);
+        REQUIRE((lower == set.end()) == (model.lower_bound(x) == model.end()));
+        REQUIRE((upper == set.end()) == (model.upper_bound(x) == model.end()));
+        if (lower != set.end()) {
+            REQUIRE(*lower == *model.lower_bound(x));
+        }
+        if (upper != set.end()) {
+            REQUIRE(*upper == *model.upper_bound(x));
+        }
+        auto const [first, last] = set.equal_range(x);
+        REQUIRE(std::distance(first, last) == static_cast<std::ptrdiff_t>(model.count(x)));
+    }
+}
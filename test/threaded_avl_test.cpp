@@ -0,0 +1,124 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : threaded_avl_test
+ * @created     : domenica ott 18, 2026 12:20:14 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <set>
+
+#include "catch2/catch.hpp"
+#include "forest/threaded_avl_tree.hpp"
+
+using forest::threaded_avl_tree;
+
+TEST_CASE("threaded_avl_trees can be constructed and assigned", "[construction][assignment]")
+{
+    SECTION("is default constructible") {
+        auto _0 = threaded_avl_tree<int>{};
+        REQUIRE(_0.empty());
+        REQUIRE(_0.begin() == _0.end());
+        REQUIRE(_0.rbegin() == _0.rend());
+    }
+
+    GIVEN("a generic threaded_avl_tree") {
+        auto _0 = threaded_avl_tree{8, 1, 64, 2, 32, 4, 16, 128};
+        REQUIRE(_0.size() == 8);
+        REQUIRE(std::is_sorted(_0.begin(), _0.end()));
+        REQUIRE(_0.front() == 1);
+        REQUIRE(_0.back() == 128);
+
+        THEN("it is copy-constructible and copy-assignable") {
+            auto _1 = _0;
+            REQUIRE(_1 == _0);
+            auto _2 = threaded_avl_tree{3, 2, 1};
+            _2 = _1;
+            REQUIRE(_2 == _0);
+        }
+        THEN("it is move-constructible and move-assignable") {
+            auto _1 = _0;
+            auto _2 = std::move(_1);
+            REQUIRE(_2 == _0);
+            REQUIRE(_1.empty());
+            _1 = std::move(_2);
+            REQUIRE(_1 == _0);
+            REQUIRE(std::equal(_1.rbegin(), _1.rend(), _0.rbegin(), _0.rend()));
+        }
+        THEN("it is swappable") {
+            auto _1 = threaded_avl_tree<int>{};
+            swap(_0, _1);
+            REQUIRE(_0.empty());
+            REQUIRE(_1.size() == 8);
+            REQUIRE(*std::prev(_1.end()) == 128);
+            REQUIRE(*_1.begin() == 1);
+        }
+    }
+}
+
+TEST_CASE("threaded_avl_tree can be traversed using iterators", "[iterator]")
+{
+    auto _0 = threaded_avl_tree<int>{5, 3, 1, 2, 1, 0};
+    auto it = _0.cbegin();
+    REQUIRE(*it++ == 0);
+    REQUIRE(*it++ == 1);
+    REQUIRE(*it++ == 1);
+    REQUIRE(*it++ == 2);
+    REQUIRE(*it++ == 3);
+    REQUIRE(*it++ == 5);
+    REQUIRE(it == _0.cend());
+    REQUIRE(*--it == 5);
+    REQUIRE(*std::prev(_0.end(), 6) == 0);
+}
+
+TEST_CASE("One can search for objects in a threaded_avl_tree", "[lookup]")
+{
+    auto tree = threaded_avl_tree<int>{0, 1, 1, 1, 2, 3, 5, 8, 8};
+    REQUIRE(tree.contains(5));
+    REQUIRE(not tree.contains(4));
+    REQUIRE(*tree.find(3) == 3);
+    REQUIRE(tree.find(42) == tree.end());
+    REQUIRE(*tree.lower_bound(4) == 5);
+    REQUIRE(*tree.upper_bound(5) == 8);
+    REQUIRE(tree.upper_bound(8) == tree.end());
+    REQUIRE(tree.count(1) == 3);
+    REQUIRE(tree.count(8) == 2);
+    REQUIRE(tree.count(4) == 0);
+    auto const [f, l] = tree.equal_range(1);
+    REQUIRE(std::distance(f, l) == 3);
+    REQUIRE(*std::prev(f) == 0);
+    REQUIRE(*l == 2);
+}
+
+TEST_CASE("It is possible to erase elements from a threaded_avl_tree", "[erase]")
+{
+    auto tree = threaded_avl_tree<int>{};
+    auto model = std::multiset<int>{};
+    for (int i = 0; i < 2000; ++i) {
+        auto const x = (i * 7919) % 331;
+        tree.insert(x);
+        model.insert(x);
+    }
+
+    for (int i = 0; i < 300; ++i) {
+        auto const x = (i * 104729) % 331;
+        if (auto it = tree.find(x); it != tree.end()) {
+            tree.erase(it);
+            model.erase(model.find(x));
+        }
+    }
+    REQUIRE(tree.size() == model.size());
+    REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+
+    REQUIRE(tree.erase(7) == model.erase(7));
+    tree.erase(tree.lower_bound(100), tree.upper_bound(200));
+    model.erase(model.lower_bound(100), model.upper_bound(200));
+    REQUIRE(forest::erase_if(tree, [](int x) { return x % 2 == 0; }) == std::erase_if(model, [](int x) { return x % 2 == 0; }));
+    REQUIRE(std::equal(tree.begin(), tree.end(), model.begin(), model.end()));
+    REQUIRE(std::equal(tree.rbegin(), tree.rend(), model.rbegin(), model.rend()));
+
+    tree.erase(tree.begin(), tree.end());
+    REQUIRE(tree.empty());
+    REQUIRE(tree.begin() == tree.end());
+}
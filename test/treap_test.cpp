@@ -0,0 +1,176 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : treap_test
+ * @created     : lunedì ott 19, 2026 08:21:36 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <algorithm>
+#include <bit>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/serialization.hpp"
+#include "forest/shape_report.hpp"
+#include "forest/treap.hpp"
+
+using forest::treap;
+
+TEST_CASE("treaps can be constructed and assigned", "[construction][assignment]")
+{
+    auto empty = treap<int>{};
+    REQUIRE(empty.empty());
+    REQUIRE(empty.begin() == empty.end());
+
+    auto tree = treap{5, 3, 1, 4, 1};
+    REQUIRE(tree.size() == 5);
+    REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector{1, 1, 3, 4, 5});
+    REQUIRE(tree.front() == 1);
+    REQUIRE(tree.back() == 5);
+
+    auto copy = tree;
+    REQUIRE(copy == tree);
+    auto moved = std::move(copy);
+    REQUIRE(moved == tree);
+    REQUIRE(copy.empty());
+
+    moved = {2, 7};
+    REQUIRE(std::vector(moved.begin(), moved.end()) == std::vector{2, 7});
+    REQUIRE(moved.capacity() == 5);
+}
+
+TEST_CASE("treap inserts, finds and erases elements", "[insert][lookup][erase]")
+{
+    auto tree = treap<std::string>{"b", "d", "f"};
+    GIVEN("equivalent elements") {
+        tree.insert("d");
+        tree.emplace(1, 'd');
+        THEN("they can be counted and erased together") {
+            REQUIRE(tree.count("d") == 3);
+            REQUIRE(tree.erase("d") == 3);
+            REQUIRE(not tree.contains("d"));
+            REQUIRE(tree.size() == 2);
+        }
+    }
+    GIVEN("unique insertions") {
+        REQUIRE(*tree.insert_unique(std::string{"b"}) == "b");
+        REQUIRE(tree.try_emplace_unique(std::string_view{"c"}, "c").second);
+        REQUIRE_FALSE(tree.emplace_unique(1, 'f').second);
+        THEN("only the new elements are inserted") {
+            REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector<std::string>{"b", "c", "d", "f"});
+        }
+    }
+    GIVEN("elements modified in place") {
+        auto it = tree.modify(tree.find("b"), [](auto & s) { s = "z"; });
+        THEN("their nodes are moved where they belong") {
+            REQUIRE(*it == "z");
+            REQUIRE(std::prev(tree.end()) == it);
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+        }
+    }
+    GIVEN("nodes extracted and inserted back") {
+        tree.insert(tree.end(), tree.extract(tree.begin()));
+        tree.insert(tree.extract("f"));
+        THEN("the order is kept") {
+            REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector<std::string>{"b", "d", "f"});
+        }
+    }
+}
+
+TEST_CASE("treaps can be split and joined", "[split][join]")
+{
+    auto tree = treap<int>{};
+    for (auto i = 0; i < 1000; ++i) {
+        tree.insert(i / 2);
+    }
+    GIVEN("a split in the middle") {
+        auto upper = tree.split(250);
+        THEN("the elements not less than the key are moved") {
+            REQUIRE(tree.size() == 500);
+            REQUIRE(upper.size() == 500);
+            REQUIRE(tree.back() == 249);
+            REQUIRE(upper.front() == 250);
+            REQUIRE(upper.back() == 499);
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+            REQUIRE(std::is_sorted(upper.begin(), upper.end()));
+            REQUIRE(std::distance(upper.lower_bound(499), upper.end()) == 2);
+        }
+        THEN("joining them gives the tree back") {
+            tree.join(std::move(upper));
+            REQUIRE(upper.empty());
+            REQUIRE(tree.size() == 1000);
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+            REQUIRE(tree.count(250) == 2);
+            tree.insert(1000);
+            REQUIRE(tree.back() == 1000);
+        }
+        THEN("a treap cannot be joined with one preceding it") {
+            REQUIRE_THROWS_AS(upper.join(std::move(tree)), std::invalid_argument);
+            REQUIRE(tree.size() == 500);
+        }
+    }
+    GIVEN("a split at either end") {
+        auto all = tree.split(-1);
+        auto none = all.split(500);
+        THEN("one of the trees is empty") {
+            REQUIRE(tree.empty());
+            REQUIRE(tree.begin() == tree.end());
+            REQUIRE(none.empty());
+            REQUIRE(all.size() == 1000);
+            tree.insert(-5);
+            tree.join(std::move(all));
+            REQUIRE(tree.front() == -5);
+            REQUIRE(tree.size() == 1001);
+        }
+    }
+}
+
+TEST_CASE("treap stays sorted and shallow under random updates", "[shape][random]")
+{
+    auto rng = std::mt19937{7};
+    auto values = std::uniform_int_distribution<int>{0, 4095};
+    auto tree = treap<int>{};
+    auto reference = std::multiset<int>{};
+    for (auto round = 0; round < 20000; ++round) {
+        auto const x = values(rng);
+        if (round % 3 == 2) {
+            if (auto const it = tree.lower_bound(x); it != tree.end()) {
+                reference.erase(reference.find(*it));
+                tree.erase(it);
+            }
+        } else {
+            tree.insert(x);
+            reference.insert(x);
+        }
+        if (round % 1000 == 999) {
+            REQUIRE(std::equal(tree.begin(), tree.end(), reference.begin(), reference.end()));
+            // The expected height is about 3 log2(n): twice as much is already very unlikely
+            REQUIRE(forest::shape_report(tree).height <= 6 * std::bit_width(tree.size()));
+        }
+    }
+}
+
+TEST_CASE("treap is loaded without comparisons", "[serialization][stats]")
+{
+    using counted_treap = treap<int, std::less<>, std::allocator<int>, forest::tree_stats>;
+    auto tree = counted_treap{};
+    for (auto i = 0; i < 1000; ++i) {
+        tree.insert(i);
+    }
+    // Sorted insertions take less than two rotations each, on average
+    REQUIRE(tree.stats().rotations < 2000);
+    auto stream = std::stringstream{};
+    forest::save(tree, stream);
+    auto const loaded = forest::load<counted_treap>(stream);
+    REQUIRE(loaded == tree);
+    REQUIRE(loaded.stats().comparisons == 0);
+    REQUIRE(forest::shape_report(loaded).height <= 6 * std::bit_width(loaded.size()));
+}
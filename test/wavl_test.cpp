@@ -0,0 +1,169 @@
+/**
+ * @author      : Riccardo Brugo (brugo.riccardo@gmail.com)
+ * @file        : wavl_test
+ * @created     : lunedì ott 19, 2026 06:40:03 CEST
+ * @license     : MIT
+ */
+
+#define CATCH_CONFIG_MAIN
+
+#include <algorithm>
+#include <bit>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch.hpp"
+#include "forest/wavl_tree.hpp"
+#include "forest/shape_report.hpp"
+
+using forest::wavl_tree;
+
+TEST_CASE("wavl_trees can be constructed and assigned", "[construction][assignment]")
+{
+    auto empty = wavl_tree<int>{};
+    REQUIRE(empty.empty());
+    REQUIRE(empty.begin() == empty.end());
+
+    auto tree = wavl_tree{5, 3, 1, 4, 1};
+    REQUIRE(tree.size() == 5);
+    REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector{1, 1, 3, 4, 5});
+    REQUIRE(tree.front() == 1);
+    REQUIRE(tree.back() == 5);
+
+    auto copy = tree;
+    REQUIRE(copy == tree);
+    auto moved = std::move(copy);
+    REQUIRE(moved == tree);
+    REQUIRE(copy.empty());
+
+    moved = {2, 7};
+    REQUIRE(std::vector(moved.begin(), moved.end()) == std::vector{2, 7});
+    REQUIRE(moved.capacity() == 5);
+    REQUIRE(tree < moved);
+    REQUIRE_FALSE(moved < tree);
+}
+
+TEST_CASE("wavl-tree inserts, finds and erases elements", "[insert][lookup][erase]")
+{
+    auto tree = wavl_tree<std::string>{"b", "d", "f"};
+    GIVEN("equivalent elements") {
+        tree.insert("d");
+        tree.emplace(1, 'd');
+        THEN("they are kept after the ones already there") {
+            REQUIRE(tree.count("d") == 3);
+            auto const [f, l] = tree.equal_range("d");
+            REQUIRE(std::distance(f, l) == 3);
+            REQUIRE(tree.erase("d") == 3);
+            REQUIRE(not tree.contains("d"));
+            REQUIRE(tree.size() == 2);
+        }
+    }
+    GIVEN("unique insertions") {
+        REQUIRE(*tree.insert_unique(std::string{"b"}) == "b");
+        REQUIRE(tree.try_emplace_unique(std::string_view{"c"}, "c").second);
+        REQUIRE_FALSE(tree.emplace_unique(1, 'f').second);
+        THEN("only the new elements are inserted") {
+            REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector<std::string>{"b", "c", "d", "f"});
+        }
+    }
+    GIVEN("a range to erase") {
+        auto const next = tree.erase(tree.find("b"), tree.find("f"));
+        THEN("the elements after it are left") {
+            REQUIRE(*next == "f");
+            REQUIRE(tree.size() == 1);
+            REQUIRE(tree.lower_bound("a") == tree.begin());
+            REQUIRE(tree.upper_bound("f") == tree.end());
+        }
+    }
+    GIVEN("elements modified in place") {
+        auto it = tree.modify(tree.find("b"), [](auto & s) { s = "z"; });
+        THEN("their nodes are moved where they belong") {
+            REQUIRE(*it == "z");
+            REQUIRE(std::prev(tree.end()) == it);
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+        }
+    }
+}
+
+TEST_CASE("wavl-tree can extract, insert nodes and merge", "[extract][merge]")
+{
+    auto tree = wavl_tree{1, 2, 3, 4, 5, 6};
+    auto handle = tree.extract(4);
+    REQUIRE(handle.value() == 4);
+    REQUIRE(tree.size() == 5);
+    tree.insert(tree.find(5), std::move(handle));
+    REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector{1, 2, 3, 4, 5, 6});
+    tree.insert(tree.end(), tree.extract(tree.begin()));
+    REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+
+    auto other = wavl_tree{0, 3, 9};
+    tree.merge(other);
+    REQUIRE(other.empty());
+    REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector{0, 1, 2, 3, 3, 4, 5, 6, 9});
+    REQUIRE(erase_if(tree, [](int x) { return x % 3 == 0; }) == 5);
+    REQUIRE(std::vector(tree.begin(), tree.end()) == std::vector{1, 2, 4, 5});
+}
+
+TEST_CASE("wavl-tree stays balanced under random insertions and erasures", "[shape][random]")
+{
+    auto rng = std::mt19937{42};
+    auto values = std::uniform_int_distribution<int>{0, 4095};
+    auto tree = wavl_tree<int>{};
+    auto reference = std::multiset<int>{};
+    for (auto round = 0; round < 20000; ++round) {
+        auto const x = values(rng);
+        if (round % 3 == 2 and not reference.empty()) {
+            auto const it = tree.lower_bound(x);
+            if (it != tree.end()) {
+                reference.erase(reference.find(*it));
+                tree.erase(it);
+            }
+        } else {
+            tree.insert(x);
+            reference.insert(x);
+        }
+        if (round % 1000 == 999) {
+            REQUIRE(std::equal(tree.begin(), tree.end(), reference.begin(), reference.end()));
+            // A weak AVL tree is never higher than 2 log2(n)
+            auto const shape = forest::shape_report(tree);
+            REQUIRE(shape.height <= 2 * std::bit_width(tree.size()));
+        }
+    }
+    while (not tree.empty()) {
+        tree.erase(std::next(tree.begin(), static_cast<std::ptrdiff_t>(tree.size() / 2)));
+    }
+    REQUIRE(tree.begin() == tree.end());
+}
+
+TEST_CASE("wavl-tree rebalances with a bounded number of rotations", "[stats]")
+{
+    using counted_tree = wavl_tree<int, std::less<>, std::allocator<int>, forest::tree_stats>;
+    auto tree = counted_tree{};
+    for (auto i = 0; i < 1023; ++i) {
+        tree.insert(i);
+    }
+    GIVEN("a tree filled with sorted values") {
+        THEN("without erasures it is as balanced as an avl_tree") {
+            REQUIRE(tree.stats().allocations == 1023);
+            REQUIRE(tree.stats().max_depth <= 14);
+            REQUIRE(forest::shape_report(tree).height <= 14);
+        }
+    }
+    WHEN("every other element is erased") {
+        tree.reset_stats();
+        for (auto it = tree.begin(); it != tree.end(); ) {
+            if (it = tree.erase(it); it != tree.end()) {
+                ++it;
+            }
+        }
+        THEN("each erasure rotates at most twice, and the rank changes are amortized") {
+            REQUIRE(tree.size() == 511);
+            REQUIRE(tree.stats().rotations <= 2 * 512);
+            REQUIRE(tree.stats().rebalance_steps <= 4 * 512);
+            REQUIRE(std::is_sorted(tree.begin(), tree.end()));
+        }
+    }
+}